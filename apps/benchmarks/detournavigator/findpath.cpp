@@ -0,0 +1,181 @@
+#include <benchmark/benchmark.h>
+
+#include <components/detournavigator/navigatorimpl.hpp>
+#include <components/detournavigator/navigatorutils.hpp>
+#include <components/detournavigator/navmeshdb.hpp>
+#include <components/detournavigator/settings.hpp>
+#include <components/esm3/loadland.hpp>
+#include <components/loadinglistener/loadinglistener.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace DetourNavigator;
+
+    constexpr int cellSize = ESM::Land::REAL_SIZE;
+    constexpr int cellVertices = ESM::Land::LAND_SIZE;
+    constexpr int worldCells = 3;
+    constexpr float wallHeight = 2048;
+
+    Settings makeSettings(int hierarchicalPathTileDistance)
+    {
+        Settings result;
+        result.mRecast.mBorderSize = 16;
+        result.mRecast.mCellHeight = 0.2f;
+        result.mRecast.mCellSize = 0.2f;
+        result.mRecast.mDetailSampleDist = 6;
+        result.mRecast.mDetailSampleMaxError = 1;
+        result.mRecast.mMaxClimb = 34;
+        result.mRecast.mMaxSimplificationError = 1.3f;
+        result.mRecast.mMaxSlope = 49;
+        result.mRecast.mRecastScaleFactor = 0.017647058823529415f;
+        result.mRecast.mSwimHeightScale = 0.89999997615814208984375f;
+        result.mRecast.mMaxEdgeLen = 12;
+        result.mRecast.mMaxVertsPerPoly = 6;
+        result.mRecast.mRegionMergeArea = 400;
+        result.mRecast.mRegionMinArea = 64;
+        result.mRecast.mTileSize = 64;
+        result.mDetour.mMaxNavMeshQueryNodes = 2048;
+        result.mDetour.mMaxPolygonPathSize = 4096;
+        result.mDetour.mMaxSmoothPathSize = 4096;
+        result.mDetour.mMaxPolys = 4096;
+        result.mDetour.mHierarchicalPathTileDistance = hierarchicalPathTileDistance;
+        result.mWaitUntilMinDistanceToPlayer = std::numeric_limits<int>::max();
+        result.mAsyncNavMeshUpdaterThreads = 4;
+        result.mMaxNavMeshTilesCacheSize = 64 * 1024 * 1024;
+        result.mMaxTilesNumber = 4096;
+        result.mMinUpdateInterval = std::chrono::milliseconds(0);
+        return result;
+    }
+
+    // Rolling hills split into regions by walls along the x axis with a single passage each, so paths between the
+    // regions have to take a detour.
+    float getHeight(float x, float y)
+    {
+        float result = 200 * std::sin(x / 1500) * std::cos(y / 1100);
+        const float regionSize = cellSize;
+        const float wallX = std::fmod(x, regionSize);
+        const int region = static_cast<int>(x / regionSize);
+        const float passageY = regionSize * (region % 2 == 0 ? 0.8f : 2.2f);
+        if (std::abs(wallX - regionSize / 2) < 256 && std::abs(y - passageY) > 512)
+            result += wallHeight;
+        return result;
+    }
+
+    struct World
+    {
+        std::vector<std::vector<float>> mHeights;
+        std::map<int, std::unique_ptr<Navigator>> mNavigators;
+    };
+
+    const AgentBounds agentBounds{ CollisionShapeType::Aabb, { 29, 29, 66 } };
+
+    Navigator& getNavigator(World& world, int hierarchicalPathTileDistance)
+    {
+        auto it = world.mNavigators.find(hierarchicalPathTileDistance);
+        if (it != world.mNavigators.end())
+            return *it->second;
+
+        auto navigator = std::make_unique<NavigatorImpl>(makeSettings(hierarchicalPathTileDistance), nullptr);
+        navigator->addAgent(agentBounds);
+
+        if (world.mHeights.empty())
+        {
+            for (int cellX = 0; cellX < worldCells; ++cellX)
+                for (int cellY = 0; cellY < worldCells; ++cellY)
+                {
+                    std::vector<float>& heights = world.mHeights.emplace_back(cellVertices * cellVertices);
+                    const float step = static_cast<float>(cellSize) / (cellVertices - 1);
+                    for (int y = 0; y < cellVertices; ++y)
+                        for (int x = 0; x < cellVertices; ++x)
+                            heights[y * cellVertices + x]
+                                = getHeight(cellX * cellSize + x * step, cellY * cellSize + y * step);
+                }
+        }
+
+        for (int cellX = 0; cellX < worldCells; ++cellX)
+            for (int cellY = 0; cellY < worldCells; ++cellY)
+            {
+                const std::vector<float>& heights = world.mHeights[cellX * worldCells + cellY];
+                const auto [minHeight, maxHeight] = std::minmax_element(heights.begin(), heights.end());
+                const HeightfieldSurface surface{ heights.data(), static_cast<std::size_t>(cellVertices),
+                    *minHeight, *maxHeight };
+                navigator->addHeightfield(osg::Vec2i(cellX, cellY), cellSize, surface, nullptr);
+            }
+
+        const float worldSize = static_cast<float>(worldCells * cellSize);
+        navigator->update(osg::Vec3f(worldSize / 2, worldSize / 2, 0), nullptr);
+        Loading::Listener listener;
+        navigator->wait(WaitConditionType::allJobsDone, &listener);
+
+        return *world.mNavigators.emplace(hierarchicalPathTileDistance, std::move(navigator)).first->second;
+    }
+
+    World& getWorld()
+    {
+        static World world;
+        return world;
+    }
+
+    // Start and end are in different regions at the opposite sides of the world
+    std::vector<std::pair<osg::Vec3f, osg::Vec3f>> generateRoutes(std::size_t count)
+    {
+        std::minstd_rand random;
+        std::uniform_real_distribution<float> startXs(256, cellSize / 2 - 256);
+        std::uniform_real_distribution<float> endXs(
+            worldCells * cellSize - cellSize / 2 + 256, worldCells * cellSize - 256);
+        std::uniform_real_distribution<float> ys(256, worldCells * cellSize - 256);
+        std::vector<std::pair<osg::Vec3f, osg::Vec3f>> result;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float startX = startXs(random);
+            const float startY = ys(random);
+            const float endX = endXs(random);
+            const float endY = ys(random);
+            result.emplace_back(osg::Vec3f(startX, startY, getHeight(startX, startY)),
+                osg::Vec3f(endX, endY, getHeight(endX, endY)));
+        }
+        return result;
+    }
+
+    void findPathAcrossRegions(benchmark::State& state)
+    {
+        Navigator& navigator = getNavigator(getWorld(), static_cast<int>(state.range(0)));
+        const std::vector<std::pair<osg::Vec3f, osg::Vec3f>> routes = generateRoutes(64);
+        const AreaCosts areaCosts;
+        const float stepSize = 28.333332061767578125f;
+        std::vector<osg::Vec3f> path;
+        std::size_t routeIndex = 0;
+        std::size_t found = 0;
+
+        for (auto _ : state)
+        {
+            const auto& [start, end] = routes[routeIndex++ % routes.size()];
+            path.clear();
+            const Status status = findPath(navigator, agentBounds, stepSize, start, end, Flag_walk, areaCosts, 0,
+                std::back_inserter(path));
+            if (status == Status::Success)
+                ++found;
+            benchmark::DoNotOptimize(path.data());
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+        state.counters["found"] = benchmark::Counter(static_cast<double>(found) / state.iterations());
+    }
+}
+
+// Argument is hierarchical path tile distance, 0 finds the whole path over polygons
+BENCHMARK(findPathAcrossRegions)->Arg(0)->Arg(4)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -5,6 +5,7 @@
 #include <components/esm3/loadland.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <random>
 
 namespace
@@ -278,6 +279,76 @@ namespace
     {
         setToBoundedNonEmptyCache<64 * 1024 * 1024>(state);
     }
+    // Shared by all threads of a multithreaded run, set up and torn down by the first one.
+    std::unique_ptr<NavMeshTilesCache> sharedCache;
+    std::vector<Key> sharedKeys;
+
+    template <std::size_t maxCacheSize>
+    void getFromFilledCacheConcurrently(benchmark::State& state)
+    {
+        if (state.thread_index == 0)
+        {
+            sharedCache = std::make_unique<NavMeshTilesCache>(maxCacheSize, static_cast<std::size_t>(state.range(0)));
+            std::minstd_rand random;
+            fillCache(std::back_inserter(sharedKeys), random, *sharedCache);
+        }
+        std::size_t n = static_cast<std::size_t>(state.thread_index) * 7919;
+
+        for (auto _ : state)
+        {
+            const auto& key = sharedKeys[n++ % sharedKeys.size()];
+            const auto result = sharedCache->get(key.mAgentBounds, key.mTilePosition, key.mRecastMesh);
+            benchmark::DoNotOptimize(result);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+
+        if (state.thread_index == 0)
+        {
+            sharedCache.reset();
+            sharedKeys.clear();
+        }
+    }
+
+    void getFromFilledCacheConcurrently_16m(benchmark::State& state)
+    {
+        getFromFilledCacheConcurrently<16 * 1024 * 1024>(state);
+    }
+
+    template <std::size_t maxCacheSize>
+    void setToBoundedNonEmptyCacheConcurrently(benchmark::State& state)
+    {
+        if (state.thread_index == 0)
+        {
+            sharedCache = std::make_unique<NavMeshTilesCache>(maxCacheSize, static_cast<std::size_t>(state.range(0)));
+            std::minstd_rand random;
+            fillCache(std::back_inserter(sharedKeys), random, *sharedCache);
+            generateKeys(std::back_inserter(sharedKeys), sharedKeys.size() * 2, random);
+            std::reverse(sharedKeys.begin(), sharedKeys.end());
+        }
+        std::size_t n = static_cast<std::size_t>(state.thread_index) * 7919;
+
+        for (auto _ : state)
+        {
+            const auto& key = sharedKeys[n++ % sharedKeys.size()];
+            const auto result = sharedCache->set(
+                key.mAgentBounds, key.mTilePosition, key.mRecastMesh, std::make_unique<PreparedNavMeshData>());
+            benchmark::DoNotOptimize(result);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+
+        if (state.thread_index == 0)
+        {
+            sharedCache.reset();
+            sharedKeys.clear();
+        }
+    }
+
+    void setToBoundedNonEmptyCacheConcurrently_16m(benchmark::State& state)
+    {
+        setToBoundedNonEmptyCacheConcurrently<16 * 1024 * 1024>(state);
+    }
 } // namespace
 
 BENCHMARK(getFromFilledCache_1m_100hit);
@@ -292,5 +363,8 @@ BENCHMARK(setToBoundedNonEmptyCache_1m);
 BENCHMARK(setToBoundedNonEmptyCache_4m);
 BENCHMARK(setToBoundedNonEmptyCache_16m);
 BENCHMARK(setToBoundedNonEmptyCache_64m);
+// Argument is the number of cache shards
+BENCHMARK(getFromFilledCacheConcurrently_16m)->Arg(1)->Arg(8)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(setToBoundedNonEmptyCacheConcurrently_16m)->Arg(1)->Arg(8)->ThreadRange(1, 8)->UseRealTime();
 
 BENCHMARK_MAIN();
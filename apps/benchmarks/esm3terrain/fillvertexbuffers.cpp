@@ -0,0 +1,186 @@
+#include <benchmark/benchmark.h>
+
+#include <components/esm/defs.hpp>
+#include <components/esm3/esmreader.hpp>
+#include <components/esm3/loadland.hpp>
+#include <components/esm3terrain/storage.hpp>
+#include <components/files/conversion.hpp>
+
+#include <osg/Array>
+#include <osg/ref_ptr>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // Loaded once from the content file given on the command line or generated, see main.
+    std::vector<ESM::Land> lands;
+
+    class LandStorage final : public ESMTerrain::Storage
+    {
+    public:
+        explicit LandStorage(const std::vector<ESM::Land>& lands)
+            : ESMTerrain::Storage(nullptr)
+        {
+            for (const ESM::Land& land : lands)
+                mLands.emplace(std::pair(land.mX, land.mY),
+                    new ESMTerrain::LandObject(
+                        &land, ESM::Land::DATA_VCLR | ESM::Land::DATA_VHGT | ESM::Land::DATA_VNML));
+        }
+
+        osg::ref_ptr<const ESMTerrain::LandObject> getLand(int cellX, int cellY) override
+        {
+            const auto it = mLands.find(std::pair(cellX, cellY));
+            if (it == mLands.end())
+                return nullptr;
+            return it->second;
+        }
+
+        const ESM::LandTexture* getLandTexture(int index, short plugin) override { return nullptr; }
+
+        bool hasData(int cellX, int cellY) override { return mLands.find(std::pair(cellX, cellY)) != mLands.end(); }
+
+        void getBounds(float& minX, float& maxX, float& minY, float& maxY) override
+        {
+            minX = 0;
+            minY = 0;
+            maxX = 0;
+            maxY = 0;
+
+            for (const auto& [position, land] : mLands)
+            {
+                minX = std::min(minX, static_cast<float>(position.first));
+                maxX = std::max(maxX, static_cast<float>(position.first));
+                minY = std::min(minY, static_cast<float>(position.second));
+                maxY = std::max(maxY, static_cast<float>(position.second));
+            }
+
+            maxX += 1;
+            maxY += 1;
+        }
+
+    private:
+        std::map<std::pair<int, int>, osg::ref_ptr<const ESMTerrain::LandObject>> mLands;
+    };
+
+    void loadLands(const std::filesystem::path& path)
+    {
+        try
+        {
+            ESM::ESMReader reader;
+            reader.open(path);
+            while (reader.hasMoreRecs())
+            {
+                const ESM::NAME name = reader.getRecName();
+                reader.getRecHeader();
+                if (name.toInt() != ESM::REC_LAND)
+                {
+                    reader.skipRecord();
+                    continue;
+                }
+                bool isDeleted = false;
+                ESM::Land& land = lands.emplace_back();
+                land.load(reader, isDeleted);
+                if (isDeleted)
+                    lands.pop_back();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to load " << path << ": " << e.what() << std::endl;
+        }
+    }
+
+    // Rolling hills over a square of cells when no content file is given
+    void generateLands(int size)
+    {
+        for (int cellX = -size / 2; cellX < size / 2; ++cellX)
+            for (int cellY = -size / 2; cellY < size / 2; ++cellY)
+            {
+                ESM::Land& land = lands.emplace_back();
+                land.mX = cellX;
+                land.mY = cellY;
+                land.blank();
+                ESM::Land::LandData& data = *land.getLandData();
+                for (int y = 0; y < ESM::Land::LAND_SIZE; ++y)
+                    for (int x = 0; x < ESM::Land::LAND_SIZE; ++x)
+                    {
+                        const int index = y * ESM::Land::LAND_SIZE + x;
+                        const float worldX = static_cast<float>(cellX * (ESM::Land::LAND_SIZE - 1) + x);
+                        const float worldY = static_cast<float>(cellY * (ESM::Land::LAND_SIZE - 1) + y);
+                        data.mHeights[index] = 512 * std::sin(worldX / 40) * std::cos(worldY / 30);
+                        data.mNormals[index * 3] = static_cast<signed char>(64 * std::cos(worldX / 40));
+                        data.mNormals[index * 3 + 1] = static_cast<signed char>(64 * std::sin(worldY / 30));
+                        data.mColours[index * 3] = static_cast<unsigned char>(x * 3);
+                        data.mColours[index * 3 + 1] = static_cast<unsigned char>(y * 3);
+                    }
+            }
+    }
+
+    // Arguments are LOD level and chunk size in cells. Every iteration fills the buffers of a chunk starting at the
+    // next land, so the whole world is covered as it would be by the terrain quad tree.
+    void fillVertexBuffers(benchmark::State& state)
+    {
+        if (lands.empty())
+        {
+            state.SkipWithError("No lands");
+            return;
+        }
+
+        LandStorage storage(lands);
+        const int lodLevel = static_cast<int>(state.range(0));
+        const float size = static_cast<float>(state.range(1));
+        osg::ref_ptr<osg::Vec3Array> positions = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec4ubArray> colours = new osg::Vec4ubArray;
+        std::size_t landIndex = 0;
+        std::size_t numVerts = 0;
+
+        for (auto _ : state)
+        {
+            const ESM::Land& land = lands[landIndex++ % lands.size()];
+            const osg::Vec2f center(land.mX + size / 2, land.mY + size / 2);
+            storage.fillVertexBuffers(lodLevel, size, center, positions, normals, colours);
+            numVerts += positions->size();
+            benchmark::DoNotOptimize(positions->getDataPointer());
+            benchmark::DoNotOptimize(normals->getDataPointer());
+            benchmark::DoNotOptimize(colours->getDataPointer());
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(numVerts));
+    }
+}
+
+BENCHMARK(fillVertexBuffers)
+    ->Args({ 0, 1 })
+    ->Args({ 1, 1 })
+    ->Args({ 2, 1 })
+    ->Args({ 2, 4 })
+    ->Args({ 3, 8 })
+    ->Unit(benchmark::kMicrosecond);
+
+// Usage: openmw_esm3terrain_fillvertexbuffers_benchmark [benchmark options] [content file, e.g. Morrowind.esm]
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    for (int i = 1; i < argc; ++i)
+        loadLands(Files::pathFromUnicodeString(argv[i]));
+
+    if (lands.empty())
+        generateLands(32);
+
+    std::cout << "Loaded " << lands.size() << " lands" << std::endl;
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
@@ -0,0 +1,276 @@
+#include <benchmark/benchmark.h>
+
+#include <components/files/constrainedfilestream.hpp>
+#include <components/files/conversion.hpp>
+#include <components/misc/strings/algorithm.hpp>
+#include <components/nif/base.hpp>
+#include <components/nif/controller.hpp>
+#include <components/nif/data.hpp>
+#include <components/nif/extra.hpp>
+#include <components/nif/niffile.hpp>
+#include <components/nifosg/controller.hpp>
+#include <components/nifosg/matrixtransform.hpp>
+#include <components/nifosg/packedanimation.hpp>
+#include <components/sceneutil/controller.hpp>
+#include <components/sceneutil/keyframe.hpp>
+
+#include <osg/NodeVisitor>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    enum class Layout
+    {
+        Float,
+        Packed,
+    };
+
+    // Controllers of a KF file in both layouts, loaded once from the KF files given on the command line, see main.
+    struct Animation
+    {
+        osg::ref_ptr<SceneUtil::KeyframeHolder> mFloat = new SceneUtil::KeyframeHolder;
+        osg::ref_ptr<SceneUtil::KeyframeHolder> mPacked = new SceneUtil::KeyframeHolder;
+    };
+
+    std::vector<Animation> animations;
+    std::size_t floatMemoryUsage = 0;
+    std::size_t packedMemoryUsage = 0;
+
+    bool isKf(const std::filesystem::path& path)
+    {
+        return Misc::StringUtils::ciEqual(Files::pathToUnicodeString(path.extension()), ".kf");
+    }
+
+    const Nif::NiKeyframeData* getKeyframeData(const Nif::NiKeyframeController& controller)
+    {
+        if (controller.mInterpolator.empty())
+            return controller.mData.getPtr();
+        if (controller.mInterpolator->recType == Nif::RC_NiTransformInterpolator)
+            return static_cast<const Nif::NiTransformInterpolator*>(controller.mInterpolator.getPtr())->data.getPtr();
+        return nullptr;
+    }
+
+    template <class MapT>
+    std::size_t getMemoryUsage(const std::shared_ptr<MapT>& keys)
+    {
+        if (keys == nullptr)
+            return 0;
+        return keys->mTimes.capacity() * sizeof(float)
+            + keys->mKeys.capacity() * sizeof(typename MapT::KeyType);
+    }
+
+    // Same controllers as NifOsg::Loader::loadKf creates, with and without the packed animation
+    void loadKf(const std::filesystem::path& path)
+    {
+        try
+        {
+            Nif::NIFFile file(path);
+            Nif::Reader reader(file);
+            reader.parse(Files::openConstrainedFileStream(path));
+
+            const Nif::NiSequenceStreamHelper* seq = nullptr;
+            for (const Nif::Record* root : file.mRoots)
+                if (root != nullptr && root->recType == Nif::RC_NiSequenceStreamHelper)
+                    seq = static_cast<const Nif::NiSequenceStreamHelper*>(root);
+            if (seq == nullptr || seq->extra.empty())
+                return;
+
+            Animation animation;
+            const auto packedAnimation = std::make_shared<NifOsg::PackedAnimation>();
+            Nif::ExtraPtr extra = seq->extra->next;
+            Nif::ControllerPtr ctrl = seq->controller;
+            for (; !extra.empty() && !ctrl.empty(); (extra = extra->next), (ctrl = ctrl->next))
+            {
+                if (extra->recType != Nif::RC_NiStringExtraData || ctrl->recType != Nif::RC_NiKeyframeController)
+                    continue;
+                const std::string& name = static_cast<const Nif::NiStringExtraData*>(extra.getPtr())->string;
+                const auto* key = static_cast<const Nif::NiKeyframeController*>(ctrl.getPtr());
+                const Nif::NiKeyframeData* data = getKeyframeData(*key);
+                if (data == nullptr || animation.mFloat->mKeyframeControllers.contains(name))
+                    continue;
+
+                const auto function = std::make_shared<NifOsg::ControllerFunction>(key);
+                osg::ref_ptr<SceneUtil::KeyframeController> floatController = new NifOsg::KeyframeController(key);
+                floatController->setFunction(function);
+                animation.mFloat->mKeyframeControllers.emplace(name, floatController);
+                osg::ref_ptr<SceneUtil::KeyframeController> packedController
+                    = new NifOsg::KeyframeController(key, packedAnimation);
+                packedController->setFunction(function);
+                animation.mPacked->mKeyframeControllers.emplace(name, packedController);
+
+                floatMemoryUsage += getMemoryUsage(data->mRotations) + getMemoryUsage(data->mXRotations)
+                    + getMemoryUsage(data->mYRotations) + getMemoryUsage(data->mZRotations)
+                    + getMemoryUsage(data->mTranslations) + getMemoryUsage(data->mScales);
+            }
+            packedAnimation->shrinkToFit();
+
+            if (!animation.mFloat->mKeyframeControllers.empty())
+            {
+                packedMemoryUsage += packedAnimation->getMemoryUsage();
+                animations.push_back(std::move(animation));
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to load " << path << ": " << e.what() << std::endl;
+        }
+    }
+
+    class TimeSource : public SceneUtil::ControllerSource
+    {
+    public:
+        float getValue(osg::NodeVisitor* nv) override { return mTime; }
+
+        float mTime = 0;
+    };
+
+    struct Bone
+    {
+        osg::ref_ptr<NifOsg::MatrixTransform> mNode;
+        osg::ref_ptr<SceneUtil::KeyframeController> mController;
+    };
+
+    // Bones of an NPC animated by the cloned controllers of a KF file, like MWRender::Animation does
+    struct Skeleton
+    {
+        std::shared_ptr<TimeSource> mTime = std::make_shared<TimeSource>();
+        float mDuration = 0;
+        std::vector<Bone> mBones;
+    };
+
+    std::vector<Skeleton> makeSkeletons(std::size_t count, Layout layout)
+    {
+        std::vector<Skeleton> skeletons(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Skeleton& skeleton = skeletons[i];
+            const Animation& animation = animations[i % animations.size()];
+            const SceneUtil::KeyframeHolder& holder = layout == Layout::Packed ? *animation.mPacked : *animation.mFloat;
+            for (const auto& [name, controller] : holder.mKeyframeControllers)
+            {
+                Bone& bone = skeleton.mBones.emplace_back();
+                bone.mNode = new NifOsg::MatrixTransform;
+                bone.mController = osg::clone(controller.get(), osg::CopyOp::SHALLOW_COPY);
+                bone.mController->setSource(skeleton.mTime);
+                if (const auto function = bone.mController->getFunction())
+                    skeleton.mDuration = std::max(skeleton.mDuration, function->getMaximum());
+            }
+        }
+        return skeletons;
+    }
+
+    void update(Skeleton& skeleton, osg::NodeVisitor& visitor)
+    {
+        for (const Bone& bone : skeleton.mBones)
+            bone.mController->getAsCallback()->run(bone.mNode.get(), &visitor);
+    }
+
+    // Arguments are the number of NPCs and the layout of the keys. Every iteration is a frame at 60 FPS, each NPC plays
+    // its animation from a different point in time.
+    void playAnimations(benchmark::State& state)
+    {
+        if (animations.empty())
+        {
+            state.SkipWithError("No KF files given");
+            return;
+        }
+
+        std::vector<Skeleton> skeletons
+            = makeSkeletons(static_cast<std::size_t>(state.range(0)), static_cast<Layout>(state.range(1)));
+        osg::NodeVisitor visitor;
+        std::minstd_rand random;
+        for (Skeleton& skeleton : skeletons)
+            skeleton.mTime->mTime = std::uniform_real_distribution<float>(0, skeleton.mDuration)(random);
+        std::size_t numBones = 0;
+
+        for (auto _ : state)
+        {
+            for (Skeleton& skeleton : skeletons)
+            {
+                skeleton.mTime->mTime = skeleton.mDuration > 0
+                    ? std::fmod(skeleton.mTime->mTime + 1.f / 60.f, skeleton.mDuration)
+                    : 0.f;
+                update(skeleton, visitor);
+                numBones += skeleton.mBones.size();
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(numBones));
+    }
+
+    // Same as playAnimations but every frame seeks to a random point in time, like when animations are switched.
+    void seekAnimations(benchmark::State& state)
+    {
+        if (animations.empty())
+        {
+            state.SkipWithError("No KF files given");
+            return;
+        }
+
+        std::vector<Skeleton> skeletons
+            = makeSkeletons(static_cast<std::size_t>(state.range(0)), static_cast<Layout>(state.range(1)));
+        osg::NodeVisitor visitor;
+        std::minstd_rand random;
+        std::uniform_real_distribution<float> fraction(0, 1);
+        std::size_t numBones = 0;
+
+        for (auto _ : state)
+        {
+            for (Skeleton& skeleton : skeletons)
+            {
+                skeleton.mTime->mTime = fraction(random) * skeleton.mDuration;
+                update(skeleton, visitor);
+                numBones += skeleton.mBones.size();
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(numBones));
+    }
+}
+
+BENCHMARK(playAnimations)
+    ->ArgsProduct({ { 1, 100 }, { static_cast<int>(Layout::Float), static_cast<int>(Layout::Packed) } })
+    ->ArgNames({ "npcs", "packed" })
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(seekAnimations)
+    ->ArgsProduct({ { 1, 100 }, { static_cast<int>(Layout::Float), static_cast<int>(Layout::Packed) } })
+    ->ArgNames({ "npcs", "packed" })
+    ->Unit(benchmark::kMicrosecond);
+
+// Usage: openmw_nifosg_keyframecontroller_benchmark [benchmark options] <KF file or directory>...
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::filesystem::path path = Files::pathFromUnicodeString(argv[i]);
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+                if (entry.is_regular_file() && isKf(entry.path()))
+                    loadKf(entry.path());
+        }
+        else
+            loadKf(path);
+    }
+
+    std::cout << "Loaded " << animations.size() << " animations, keys take " << floatMemoryUsage
+              << " bytes in float layout and " << packedMemoryUsage << " bytes packed" << std::endl;
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    animations.clear();
+
+    return 0;
+}
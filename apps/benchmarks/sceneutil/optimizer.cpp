@@ -0,0 +1,187 @@
+#include <benchmark/benchmark.h>
+
+#include <components/files/constrainedfilestream.hpp>
+#include <components/files/conversion.hpp>
+#include <components/misc/strings/algorithm.hpp>
+#include <components/nif/niffile.hpp>
+#include <components/nifosg/nifloader.hpp>
+#include <components/resource/imagemanager.hpp>
+#include <components/sceneutil/optimizer.hpp>
+#include <components/sceneutil/workqueue.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <osg/Group>
+#include <osg/Math>
+#include <osg/MatrixTransform>
+#include <osg/Node>
+#include <osg/Notify>
+
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Loaded once from the NIF files given on the command line, see main.
+    std::vector<osg::ref_ptr<osg::Node>> corpus;
+
+    constexpr unsigned int modelOptions = SceneUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS
+        | SceneUtil::Optimizer::REMOVE_REDUNDANT_NODES | SceneUtil::Optimizer::MERGE_GEOMETRY;
+
+    bool isNif(const std::filesystem::path& path)
+    {
+        return Misc::StringUtils::ciEqual(Files::pathToUnicodeString(path.extension()), ".nif");
+    }
+
+    void loadNif(const std::filesystem::path& path, Resource::ImageManager& imageManager)
+    {
+        try
+        {
+            Nif::NIFFile file(path);
+            Nif::Reader reader(file);
+            reader.parse(Files::openConstrainedFileStream(path));
+            corpus.push_back(NifOsg::Loader::load(file, &imageManager));
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to load " << path << ": " << e.what() << std::endl;
+        }
+    }
+
+    osg::ref_ptr<SceneUtil::WorkQueue> makeWorkQueue(const benchmark::State& state)
+    {
+        const auto numThreads = static_cast<std::size_t>(state.range(0));
+        if (numThreads == 0)
+            return nullptr;
+        return new SceneUtil::WorkQueue(numThreads);
+    }
+
+    void optimizeModels(benchmark::State& state)
+    {
+        if (corpus.empty())
+        {
+            state.SkipWithError("No NIF files given");
+            return;
+        }
+
+        const osg::ref_ptr<SceneUtil::WorkQueue> workQueue = makeWorkQueue(state);
+        std::size_t numModels = 0;
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            std::vector<osg::ref_ptr<osg::Node>> models;
+            models.reserve(corpus.size());
+            for (const osg::ref_ptr<osg::Node>& node : corpus)
+                models.push_back(static_cast<osg::Node*>(node->clone(osg::CopyOp::DEEP_COPY_ALL)));
+            state.ResumeTiming();
+
+            for (const osg::ref_ptr<osg::Node>& model : models)
+            {
+                SceneUtil::Optimizer optimizer;
+                optimizer.setWorkQueue(workQueue);
+                optimizer.optimize(model, modelOptions);
+            }
+            numModels += models.size();
+
+            state.PauseTiming();
+            models.clear();
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(numModels));
+
+        if (workQueue)
+            workQueue->stop();
+    }
+
+    // Same layout as the merged groups of MWRender::ObjectPaging: one static transform per instance, with the
+    // drawables copied but sharing the arrays of the template.
+    void optimizePagedChunk(benchmark::State& state)
+    {
+        if (corpus.empty())
+        {
+            state.SkipWithError("No NIF files given");
+            return;
+        }
+
+        const osg::ref_ptr<SceneUtil::WorkQueue> workQueue = makeWorkQueue(state);
+        const std::size_t numInstances = 1024;
+        std::minstd_rand random;
+        std::uniform_real_distribution<float> position(-8192.f, 8192.f);
+        std::uniform_real_distribution<float> angle(0.f, osg::PI * 2);
+        std::size_t numChunks = 0;
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            osg::ref_ptr<osg::Group> chunk = new osg::Group;
+            for (std::size_t i = 0; i < numInstances; ++i)
+            {
+                osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(
+                    osg::Matrix::rotate(angle(random), osg::Vec3f(0, 0, 1))
+                    * osg::Matrix::translate(position(random), position(random), 0));
+                transform->setDataVariance(osg::Object::STATIC);
+                const osg::Node* const source = corpus[i % corpus.size()];
+                transform->addChild(static_cast<osg::Node*>(
+                    source->clone(osg::CopyOp::DEEP_COPY_NODES | osg::CopyOp::DEEP_COPY_DRAWABLES)));
+                chunk->addChild(transform);
+            }
+            state.ResumeTiming();
+
+            SceneUtil::Optimizer optimizer;
+            optimizer.setMergeAlphaBlending(true);
+            optimizer.setWorkQueue(workQueue);
+            optimizer.optimize(chunk, modelOptions);
+            ++numChunks;
+
+            state.PauseTiming();
+            chunk = nullptr;
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(numChunks * numInstances));
+
+        if (workQueue)
+            workQueue->stop();
+    }
+}
+
+BENCHMARK(optimizeModels)->Arg(0)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond);
+BENCHMARK(optimizePagedChunk)->Arg(0)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond);
+
+// Usage: openmw_sceneutil_optimizer_benchmark [benchmark options] <NIF file or directory>...
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    osg::setNotifyLevel(osg::FATAL);
+
+    VFS::Manager vfs(false);
+    vfs.buildIndex();
+    Resource::ImageManager imageManager(&vfs);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::filesystem::path path = Files::pathFromUnicodeString(argv[i]);
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+                if (entry.is_regular_file() && isNif(entry.path()))
+                    loadNif(entry.path(), imageManager);
+        }
+        else
+            loadNif(path, imageManager);
+    }
+
+    std::cout << "Loaded " << corpus.size() << " models" << std::endl;
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    corpus.clear();
+
+    return 0;
+}
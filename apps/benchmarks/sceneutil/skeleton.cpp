@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <components/sceneutil/skeleton.hpp>
+
+#include <osg/Math>
+#include <osg/MatrixTransform>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Close to the number of bones in the Morrowind NPC skeleton used for skinning
+    constexpr std::size_t numBones = 64;
+
+    std::string getBoneName(std::size_t index)
+    {
+        return "Bone " + std::to_string(index);
+    }
+
+    // Every bone is attached to one of the few bones added before it, which gives chains like limbs and the spine
+    osg::ref_ptr<SceneUtil::Skeleton> makeSkeleton(std::minstd_rand& random)
+    {
+        osg::ref_ptr<SceneUtil::Skeleton> skeleton = new SceneUtil::Skeleton;
+        std::vector<osg::ref_ptr<osg::MatrixTransform>> bones;
+        std::uniform_real_distribution<float> angle(-osg::PI, osg::PI);
+        for (std::size_t i = 0; i < numBones; ++i)
+        {
+            osg::ref_ptr<osg::MatrixTransform> bone = new osg::MatrixTransform(
+                osg::Matrix::rotate(angle(random), osg::Vec3f(1, 0, 0), angle(random), osg::Vec3f(0, 1, 0),
+                    angle(random), osg::Vec3f(0, 0, 1))
+                * osg::Matrix::translate(0, 0, 10));
+            bone->setName(getBoneName(i));
+            if (i == 0)
+                skeleton->addChild(bone);
+            else
+                bones[std::uniform_int_distribution<std::size_t>(i < 4 ? 0 : i - 4, i - 1)(random)]->addChild(bone);
+            bones.push_back(std::move(bone));
+        }
+        // Like RigGeometry does, only bones referenced by a skin are updated
+        for (std::size_t i = 0; i < numBones; ++i)
+            skeleton->getBone(getBoneName(i));
+        return skeleton;
+    }
+
+    // Argument is the number of skeletons. Every iteration is a frame where all the skeletons update their bone
+    // matrices once.
+    void updateBoneMatrices(benchmark::State& state)
+    {
+        std::minstd_rand random;
+        std::vector<osg::ref_ptr<SceneUtil::Skeleton>> skeletons;
+        for (std::int64_t i = 0; i < state.range(0); ++i)
+            skeletons.push_back(makeSkeleton(random));
+        unsigned int frameNumber = 0;
+
+        for (auto _ : state)
+        {
+            ++frameNumber;
+            for (const osg::ref_ptr<SceneUtil::Skeleton>& skeleton : skeletons)
+            {
+                skeleton->updateBoneMatrices(frameNumber);
+                benchmark::DoNotOptimize(skeleton->getBoneMatrices().data());
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(numBones));
+    }
+}
+
+BENCHMARK(updateBoneMatrices)->Arg(1)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
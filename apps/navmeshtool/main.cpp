@@ -1,4 +1,6 @@
 #include "navmesh.hpp"
+#include "shard.hpp"
+#include "shardprocesses.hpp"
 #include "worldspacedata.hpp"
 
 #include <components/debug/debugging.hpp>
@@ -31,14 +33,19 @@
 
 #include <osg/Vec3f>
 
+#include <boost/process/search_path.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <type_traits>
 #include <utility>
@@ -127,11 +134,103 @@ namespace NavMeshTool
             addOption("write-binary-log", bpo::value<bool>()->implicit_value(true)->default_value(false),
                 "write progress in binary messages to be consumed by the launcher");
 
+            addOption("processes", bpo::value<std::size_t>()->default_value(1),
+                "number of processes to generate navmesh tiles, each one generates own shard into a separate "
+                "database, shards are merged into the navmesh database when all are done, threads are split between "
+                "processes");
+
+            addOption("shard-count", bpo::value<std::size_t>()->default_value(1),
+                "split navmesh tiles into given number of shards and generate only one of them (see --shard-index) "
+                "into a separate database (see --shard-db) to be merged later by --merge-db");
+
+            addOption("shard-index", bpo::value<std::size_t>()->default_value(0),
+                "index of the shard to generate, from 0 to shard count - 1");
+
+            addOption("shard-db",
+                bpo::value<Files::MaybeQuotedPath>()->default_value(Files::MaybeQuotedPath(), ""),
+                "path to the database for the generated shard, navmesh.shard-<index>.db in the user data directory by "
+                "default");
+
+            addOption("merge-db",
+                bpo::value<Files::MaybeQuotedPathContainer>()
+                    ->default_value(Files::MaybeQuotedPathContainer(), "")
+                    ->multitoken(),
+                "merge given shard databases into the navmesh database and quit");
+
             Files::ConfigurationManager::addCommonOptions(result);
 
             return result;
         }
 
+        std::filesystem::path getShardDbPath(const std::filesystem::path& userDataPath, std::size_t index)
+        {
+            return userDataPath / ("navmesh.shard-" + std::to_string(index) + ".db");
+        }
+
+        void removeDb(const std::filesystem::path& path)
+        {
+            for (const std::string_view suffix : { "", "-wal", "-shm" })
+            {
+                std::filesystem::path file = path;
+                file += suffix;
+                std::filesystem::remove(file);
+            }
+        }
+
+        // Shard processes run concurrently so each one needs own log file.
+        std::string makeShardApplicationName(const Shard& shard)
+        {
+            return std::string(applicationName) + ".shard-" + std::to_string(shard.mIndex);
+        }
+
+        std::filesystem::path getExecutablePath(const char* argv0)
+        {
+            const std::filesystem::path path = Files::pathFromUnicodeString(argv0);
+            if (path.has_parent_path())
+                return path;
+            return Files::pathFromUnicodeString(boost::process::search_path(argv0).string());
+        }
+
+        // Shard processes get the same options except the ones defining the work split and progress reporting.
+        std::vector<std::string> makeShardArguments(const bpo::parsed_options& options)
+        {
+            static const std::set<std::string, std::less<>> excluded = {
+                "processes",
+                "threads",
+                "write-binary-log",
+                "shard-count",
+                "shard-index",
+                "shard-db",
+                "merge-db",
+            };
+            std::vector<std::string> result;
+            for (const bpo::option& option : options.options)
+                if (excluded.find(option.string_key) == excluded.end())
+                    result.insert(result.end(), option.original_tokens.begin(), option.original_tokens.end());
+            return result;
+        }
+
+        void logStatus(Status status, const std::string& dbPath)
+        {
+            switch (status)
+            {
+                case Status::Ok:
+                    Log(Debug::Info) << "Done";
+                    break;
+                case Status::Cancelled:
+                    Log(Debug::Warning) << "Cancelled";
+                    break;
+                case Status::NotEnoughSpace:
+                    Log(Debug::Warning)
+                        << "Navmesh generation is cancelled due to running out of disk space or limits "
+                        << "for navmesh db. Check disk space at the db location \"" << dbPath
+                        << "\". If there is enough space, adjust \"max navmeshdb file size\" setting (see "
+                        << "https://openmw.readthedocs.io/en/latest/reference/modding/settings/"
+                           "navigator.html?highlight=navmesh#max-navmeshdb-file-size).";
+                    break;
+            }
+        }
+
         int runNavMeshTool(int argc, char* argv[])
         {
             Platform::init();
@@ -187,6 +286,32 @@ namespace NavMeshTool
             const bool processInteriorCells = variables["process-interior-cells"].as<bool>();
             const bool removeUnusedTiles = variables["remove-unused-tiles"].as<bool>();
             const bool writeBinaryLog = variables["write-binary-log"].as<bool>();
+            const std::size_t processesNumber = variables["processes"].as<std::size_t>();
+            const Shard shard{
+                variables["shard-index"].as<std::size_t>(),
+                variables["shard-count"].as<std::size_t>(),
+            };
+            const Files::PathContainer mergeDbs(
+                asPathContainer(variables["merge-db"].as<Files::MaybeQuotedPathContainer>()));
+
+            if (processesNumber < 1)
+            {
+                std::cerr << "Invalid processes number: " << processesNumber << ", expected >= 1";
+                return -1;
+            }
+
+            if (shard.mCount < 1 || shard.mIndex >= shard.mCount)
+            {
+                std::cerr << "Invalid shard index: " << shard.mIndex << " for shard count: " << shard.mCount
+                          << ", expected 0 <= index < count";
+                return -1;
+            }
+
+            if (processesNumber > 1 && shard.mCount > 1)
+            {
+                std::cerr << "Processes number and shard count can't be both greater than 1";
+                return -1;
+            }
 
 #ifdef WIN32
             if (writeBinaryLog)
@@ -201,7 +326,10 @@ namespace NavMeshTool
 
             Settings::Manager::load(config);
 
-            setupLogging(config.getLogPath(), applicationName);
+            if (shard.mCount > 1)
+                setupLogging(config.getLogPath(), makeShardApplicationName(shard));
+            else
+                setupLogging(config.getLogPath(), applicationName);
 
             const auto agentCollisionShape = DetourNavigator::toCollisionShapeType(
                 Settings::Manager::getInt("actor collision shape type", "Game"));
@@ -213,6 +341,35 @@ namespace NavMeshTool
 
             DetourNavigator::NavMeshDb db(dbPath, maxDbFileSize);
 
+            if (!mergeDbs.empty())
+            {
+                const Status status = mergeShardDbs(mergeDbs, removeUnusedTiles, maxDbFileSize, db);
+                logStatus(status, dbPath);
+                return static_cast<int>(status);
+            }
+
+            if (processesNumber > 1)
+            {
+                std::vector<std::filesystem::path> shardDbs;
+                for (std::size_t i = 0; i < processesNumber; ++i)
+                    shardDbs.push_back(getShardDbPath(config.getUserDataPath(), i));
+
+                std::vector<std::string> arguments = makeShardArguments(options);
+                arguments.push_back("--threads");
+                arguments.push_back(std::to_string(std::max<std::size_t>(threadsNumber / processesNumber, 1)));
+
+                Status status = runShardProcesses(getExecutablePath(argv[0]), arguments, shardDbs, writeBinaryLog);
+                if (status == Status::Ok)
+                    status = mergeShardDbs(shardDbs, removeUnusedTiles, maxDbFileSize, db);
+                if (status == Status::Ok)
+                    for (const std::filesystem::path& path : shardDbs)
+                        removeDb(path);
+
+                logStatus(status, dbPath);
+
+                return static_cast<int>(status);
+            }
+
             ESM::ReadersCache readers;
             EsmLoader::Query query;
             query.mLoadActivators = true;
@@ -237,27 +394,31 @@ namespace NavMeshTool
             WorldspaceData cellsData = gatherWorldspaceData(
                 navigatorSettings, readers, vfs, bulletShapeManager, esmData, processInteriorCells, writeBinaryLog);
 
-            const Status status = generateAllNavMeshTiles(agentBounds, navigatorSettings, threadsNumber,
-                removeUnusedTiles, writeBinaryLog, cellsData, std::move(db));
-
-            switch (status)
+            if (shard.mCount > 1)
             {
-                case Status::Ok:
-                    Log(Debug::Info) << "Done";
-                    break;
-                case Status::Cancelled:
-                    Log(Debug::Warning) << "Cancelled";
-                    break;
-                case Status::NotEnoughSpace:
-                    Log(Debug::Warning)
-                        << "Navmesh generation is cancelled due to running out of disk space or limits "
-                        << "for navmesh db. Check disk space at the db location \"" << dbPath
-                        << "\". If there is enough space, adjust \"max navmeshdb file size\" setting (see "
-                        << "https://openmw.readthedocs.io/en/latest/reference/modding/settings/"
-                           "navigator.html?highlight=navmesh#max-navmeshdb-file-size).";
-                    break;
+                // Shard db is always generated from scratch and the navmesh db is used only to skip up to date tiles.
+                // Unused tiles can be removed only by merging.
+                const std::filesystem::path shardDbOption = variables["shard-db"].as<Files::MaybeQuotedPath>();
+                const std::filesystem::path shardDbFile
+                    = shardDbOption.empty() ? getShardDbPath(config.getUserDataPath(), shard.mIndex) : shardDbOption;
+                removeDb(shardDbFile);
+                DetourNavigator::NavMeshDb shardDb(Files::pathToUnicodeString(shardDbFile), maxDbFileSize);
+                auto baseDb = std::make_unique<DetourNavigator::NavMeshDb>(std::move(db));
+                initShardDb(*baseDb, cellsData, shardDb);
+
+                const Status status = generateAllNavMeshTiles(agentBounds, navigatorSettings, threadsNumber, false,
+                    writeBinaryLog, cellsData, std::move(shardDb), shard, std::move(baseDb));
+
+                logStatus(status, Files::pathToUnicodeString(shardDbFile));
+
+                return static_cast<int>(status);
             }
 
+            const Status status = generateAllNavMeshTiles(agentBounds, navigatorSettings, threadsNumber,
+                removeUnusedTiles, writeBinaryLog, cellsData, std::move(db), shard, nullptr);
+
+            logStatus(status, dbPath);
+
             return 0;
         }
     }
@@ -1,5 +1,6 @@
 #include "navmesh.hpp"
 
+#include "shard.hpp"
 #include "worldspacedata.hpp"
 
 #include <components/debug/debugging.hpp>
@@ -9,6 +10,7 @@
 #include <components/detournavigator/navmeshdb.hpp>
 #include <components/detournavigator/navmeshdbutils.hpp>
 #include <components/detournavigator/preparednavmeshdata.hpp>
+#include <components/detournavigator/recastglobalallocator.hpp>
 #include <components/detournavigator/recastmesh.hpp>
 #include <components/detournavigator/recastmeshprovider.hpp>
 #include <components/detournavigator/serialization.hpp>
@@ -24,6 +26,7 @@
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <memory>
 #include <random>
 #include <string_view>
 #include <utility>
@@ -78,8 +81,10 @@ namespace NavMeshTool
         public:
             std::atomic_size_t mExpected{ 0 };
 
-            explicit NavMeshTileConsumer(NavMeshDb&& db, bool removeUnusedTiles, bool writeBinaryLog)
+            explicit NavMeshTileConsumer(
+                NavMeshDb&& db, std::unique_ptr<NavMeshDb>&& baseDb, bool removeUnusedTiles, bool writeBinaryLog)
                 : mDb(std::move(db))
+                , mBaseDb(std::move(baseDb))
                 , mRemoveUnusedTiles(removeUnusedTiles)
                 , mWriteBinaryLog(writeBinaryLog)
                 , mTransaction(mDb.startTransaction(Sqlite3::TransactionMode::Immediate))
@@ -111,7 +116,20 @@ namespace NavMeshTool
             {
                 std::optional<NavMeshTileInfo> result;
                 std::lock_guard lock(mMutex);
-                if (const auto tile = mDb.findTile(worldspace, tilePosition, input))
+                if (mBaseDb != nullptr)
+                {
+                    // Shard db is merged into the base db so only the tiles missing or outdated there are written.
+                    // Such tile is reported as not found to be inserted into the shard db with its input.
+                    const auto tile = mBaseDb->findTile(worldspace, tilePosition, input);
+                    if (tile.has_value() && tile->mVersion == DetourNavigator::navMeshFormatVersion)
+                    {
+                        NavMeshTileInfo info;
+                        info.mTileId = tile->mTileId;
+                        info.mVersion = tile->mVersion;
+                        result.emplace(info);
+                    }
+                }
+                else if (const auto tile = mDb.findTile(worldspace, tilePosition, input))
                 {
                     NavMeshTileInfo info;
                     info.mTileId = tile->mTileId;
@@ -234,6 +252,7 @@ namespace NavMeshTool
             Status mStatus = Status::Ok;
             mutable std::mutex mMutex;
             NavMeshDb mDb;
+            const std::unique_ptr<NavMeshDb> mBaseDb;
             const bool mRemoveUnusedTiles;
             const bool mWriteBinaryLog;
             Transaction mTransaction;
@@ -255,13 +274,17 @@ namespace NavMeshTool
     }
 
     Status generateAllNavMeshTiles(const AgentBounds& agentBounds, const Settings& settings, std::size_t threadsNumber,
-        bool removeUnusedTiles, bool writeBinaryLog, WorldspaceData& data, NavMeshDb&& db)
+        bool removeUnusedTiles, bool writeBinaryLog, WorldspaceData& data, NavMeshDb&& db, const Shard& shard,
+        std::unique_ptr<NavMeshDb>&& baseDb)
     {
         Log(Debug::Info) << "Generating navmesh tiles by " << threadsNumber << " parallel workers...";
 
+        if (shard.mCount > 1)
+            Log(Debug::Info) << "Generating only tiles of shard " << shard.mIndex << " out of " << shard.mCount;
+
         SceneUtil::WorkQueue workQueue(threadsNumber);
-        auto navMeshTileConsumer
-            = std::make_shared<NavMeshTileConsumer>(std::move(db), removeUnusedTiles, writeBinaryLog);
+        auto navMeshTileConsumer = std::make_shared<NavMeshTileConsumer>(
+            std::move(db), std::move(baseDb), removeUnusedTiles, writeBinaryLog);
         std::size_t tiles = 0;
         std::mt19937_64 random;
 
@@ -275,8 +298,10 @@ namespace NavMeshTool
 
             std::vector<TilePosition> worldspaceTiles;
 
-            DetourNavigator::getTilesPositions(
-                range, [&](const TilePosition& tilePosition) { worldspaceTiles.push_back(tilePosition); });
+            DetourNavigator::getTilesPositions(range, [&](const TilePosition& tilePosition) {
+                if (isInShard(shard, input->mWorldspace, tilePosition))
+                    worldspaceTiles.push_back(tilePosition);
+            });
 
             tiles += worldspaceTiles.size();
 
@@ -304,6 +329,11 @@ namespace NavMeshTool
         Log(Debug::Info) << "Generated navmesh for " << navMeshTileConsumer->getProvided() << " tiles, " << inserted
                          << " are inserted, " << updated << " updated and " << deleted << " deleted";
 
+        const DetourNavigator::RecastAllocatorStats allocatorStats = DetourNavigator::RecastGlobalAllocator::getStats();
+        Log(Debug::Verbose) << "Recast allocations: " << allocatorStats.mArenaAllocations << " from arenas, "
+                            << allocatorStats.mHeapAllocations << " from heap, max arena size is "
+                            << allocatorStats.mArenaHighWaterMark << " bytes";
+
         if (inserted + updated + deleted > 0)
         {
             Log(Debug::Info) << "Vacuuming the database...";
@@ -2,6 +2,7 @@
 #define OPENMW_NAVMESHTOOL_NAVMESH_H
 
 #include <cstddef>
+#include <memory>
 
 namespace DetourNavigator
 {
@@ -13,6 +14,7 @@ namespace DetourNavigator
 namespace NavMeshTool
 {
     struct WorldspaceData;
+    struct Shard;
 
     enum class Status
     {
@@ -23,7 +25,8 @@ namespace NavMeshTool
 
     Status generateAllNavMeshTiles(const DetourNavigator::AgentBounds& agentBounds,
         const DetourNavigator::Settings& settings, std::size_t threadsNumber, bool removeUnusedTiles,
-        bool writeBinaryLog, WorldspaceData& cellsData, DetourNavigator::NavMeshDb&& db);
+        bool writeBinaryLog, WorldspaceData& cellsData, DetourNavigator::NavMeshDb&& db, const Shard& shard,
+        std::unique_ptr<DetourNavigator::NavMeshDb>&& baseDb);
 }
 
 #endif
@@ -0,0 +1,216 @@
+#include "shard.hpp"
+
+#include "navmesh.hpp"
+#include "worldspacedata.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/detournavigator/navmeshdb.hpp>
+#include <components/detournavigator/preparednavmeshdata.hpp>
+#include <components/detournavigator/serialization.hpp>
+#include <components/files/conversion.hpp>
+#include <components/resource/bulletshape.hpp>
+#include <components/sqlite3/transaction.hpp>
+
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace NavMeshTool
+{
+    namespace
+    {
+        using DetourNavigator::NavMeshDb;
+        using DetourNavigator::PreparedNavMeshData;
+        using DetourNavigator::ShapeId;
+        using DetourNavigator::ShapeRecord;
+        using DetourNavigator::ShapeType;
+        using DetourNavigator::TileId;
+        using DetourNavigator::TilePosition;
+        using DetourNavigator::TileRecord;
+
+        constexpr std::size_t mergeBatchSize = 256;
+
+        // FNV-1a
+        struct StableHash
+        {
+            std::uint64_t mValue = 14695981039346656037ull;
+
+            void operator()(std::uint8_t value)
+            {
+                mValue ^= value;
+                mValue *= 1099511628211ull;
+            }
+
+            void operator()(std::string_view value)
+            {
+                for (const char v : value)
+                    (*this)(static_cast<std::uint8_t>(v));
+            }
+
+            void operator()(std::int32_t value)
+            {
+                const auto unsignedValue = static_cast<std::uint32_t>(value);
+                for (int shift = 0; shift < 32; shift += 8)
+                    (*this)(static_cast<std::uint8_t>(unsignedValue >> shift));
+            }
+        };
+
+        Sqlite3::ConstBlob makeBlob(const std::string& value)
+        {
+            return Sqlite3::ConstBlob{ value.data(), static_cast<int>(value.size()) };
+        }
+
+        Sqlite3::ConstBlob makeBlob(const std::vector<std::byte>& value)
+        {
+            return Sqlite3::ConstBlob{ reinterpret_cast<const char*>(value.data()), static_cast<int>(value.size()) };
+        }
+    }
+
+    bool isInShard(const Shard& shard, std::string_view worldspace, const TilePosition& tilePosition)
+    {
+        if (shard.mCount <= 1)
+            return true;
+        StableHash hash;
+        hash(worldspace);
+        hash(static_cast<std::int32_t>(tilePosition.x()));
+        hash(static_cast<std::int32_t>(tilePosition.y()));
+        return hash.mValue % shard.mCount == shard.mIndex;
+    }
+
+    void initShardDb(NavMeshDb& baseDb, const WorldspaceData& data, NavMeshDb& shardDb)
+    {
+        for (const ShapeRecord& shape : baseDb.getShapes())
+            shardDb.insertShape(shape.mShapeId, shape.mName, shape.mType, makeBlob(shape.mHash));
+
+        std::set<std::tuple<std::string_view, ShapeType, std::string_view>> shapes;
+        for (const BulletObject& object : data.mObjects)
+        {
+            const Resource::BulletShapeInstance& instance = *object.getShapeInstance();
+            const Resource::BulletShape& source = *instance.getSource();
+            shapes.emplace(source.mFileName, ShapeType::Collision, source.mFileHash);
+            if (instance.mAvoidCollisionShape != nullptr)
+                shapes.emplace(source.mFileName, ShapeType::Avoid, source.mFileHash);
+        }
+
+        ShapeId nextShapeId(shardDb.getMaxShapeId() + 1);
+        for (const auto& [name, type, hash] : shapes)
+        {
+            const Sqlite3::ConstBlob hashData{ hash.data(), static_cast<int>(hash.size()) };
+            if (shardDb.findShapeId(name, type, hashData).has_value())
+                continue;
+            shardDb.insertShape(nextShapeId, name, type, hashData);
+            ++nextShapeId;
+        }
+
+        Log(Debug::Info) << "Initialized shard db with " << shapes.size() << " object shapes";
+    }
+
+    MergeStats mergeShardDb(NavMeshDb& shardDb, bool removeUnusedTiles, NavMeshDb& targetDb)
+    {
+        MergeStats stats;
+
+        for (const ShapeRecord& shape : shardDb.getShapes())
+        {
+            const auto shapeId = targetDb.findShapeId(shape.mName, shape.mType, makeBlob(shape.mHash));
+            if (!shapeId.has_value())
+                targetDb.insertShape(shape.mShapeId, shape.mName, shape.mType, makeBlob(shape.mHash));
+            else if (*shapeId != shape.mShapeId)
+                throw std::runtime_error("Shard db " + shape.mName + " shape id " + std::to_string(shape.mShapeId)
+                    + " does not match target db shape id " + std::to_string(*shapeId));
+        }
+
+        TileId nextTileId(targetDb.getMaxTileId() + 1);
+        TileId lastTileId{ 0 };
+
+        while (true)
+        {
+            std::vector<TileRecord> tiles = shardDb.getTiles(lastTileId, mergeBatchSize);
+
+            if (tiles.empty())
+                break;
+
+            lastTileId = tiles.back().mTileId;
+
+            for (TileRecord& tile : tiles)
+            {
+                const auto existing = targetDb.findTile(tile.mWorldspace, tile.mTilePosition, tile.mInput);
+
+                if (existing.has_value() && existing->mVersion >= tile.mVersion)
+                {
+                    ++stats.mSkipped;
+                    continue;
+                }
+
+                // Tile id is stored inside the navmesh data as user id of the tile.
+                PreparedNavMeshData data;
+                if (!deserialize(tile.mData, data))
+                    throw std::runtime_error("Failed to deserialize shard db tile " + std::to_string(tile.mTileId));
+
+                const TileId tileId = existing.has_value() ? existing->mTileId : nextTileId++;
+                data.mUserId = static_cast<unsigned>(tileId);
+
+                if (existing.has_value())
+                {
+                    targetDb.updateTile(tileId, tile.mVersion, serialize(data));
+                    ++stats.mUpdated;
+                }
+                else
+                {
+                    targetDb.insertTile(
+                        tileId, tile.mWorldspace, tile.mTilePosition, tile.mVersion, tile.mInput, serialize(data));
+                    ++stats.mInserted;
+                }
+
+                if (removeUnusedTiles)
+                    stats.mDeleted += static_cast<std::size_t>(
+                        targetDb.deleteTilesAtExcept(tile.mWorldspace, tile.mTilePosition, tileId));
+            }
+        }
+
+        return stats;
+    }
+
+    Status mergeShardDbs(const std::vector<std::filesystem::path>& shardDbs, bool removeUnusedTiles,
+        std::uint64_t maxDbFileSize, DetourNavigator::NavMeshDb& db)
+    {
+        MergeStats total;
+        try
+        {
+            Sqlite3::Transaction transaction = db.startTransaction(Sqlite3::TransactionMode::Immediate);
+            for (const std::filesystem::path& path : shardDbs)
+            {
+                Log(Debug::Info) << "Merging shard db " << path << "...";
+                DetourNavigator::NavMeshDb shardDb(Files::pathToUnicodeString(path), maxDbFileSize);
+                const MergeStats stats = mergeShardDb(shardDb, removeUnusedTiles, db);
+                total.mInserted += stats.mInserted;
+                total.mUpdated += stats.mUpdated;
+                total.mSkipped += stats.mSkipped;
+                total.mDeleted += stats.mDeleted;
+            }
+            transaction.commit();
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to merge shard dbs: " << e.what();
+            if (std::string_view(e.what()).find("database or disk is full") != std::string_view::npos)
+                return Status::NotEnoughSpace;
+            return Status::Cancelled;
+        }
+
+        Log(Debug::Info) << "Merged " << shardDbs.size() << " shard dbs, " << total.mInserted
+                         << " tiles are inserted, " << total.mUpdated << " updated, " << total.mSkipped
+                         << " skipped as duplicates and " << total.mDeleted << " deleted";
+
+        if (total.mInserted + total.mUpdated + total.mDeleted > 0)
+        {
+            Log(Debug::Info) << "Vacuuming the database...";
+            db.vacuum();
+        }
+
+        return Status::Ok;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef OPENMW_NAVMESHTOOL_SHARD_H
+#define OPENMW_NAVMESHTOOL_SHARD_H
+
+#include <components/detournavigator/tileposition.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace DetourNavigator
+{
+    class NavMeshDb;
+}
+
+namespace NavMeshTool
+{
+    struct WorldspaceData;
+    enum class Status;
+
+    // Part of the tiles space generated by a single process into a separate database.
+    struct Shard
+    {
+        std::size_t mIndex = 0;
+        std::size_t mCount = 1;
+    };
+
+    // Uses a hash stable across processes and platforms so each tile belongs to exactly one shard.
+    bool isInShard(const Shard& shard, std::string_view worldspace, const DetourNavigator::TilePosition& tilePosition);
+
+    // Shape ids are a part of the tile input so they have to be the same in all shards and in the database they are
+    // merged into. Copies the shapes from the base database and adds the shapes of all objects in a deterministic
+    // order.
+    void initShardDb(
+        DetourNavigator::NavMeshDb& baseDb, const WorldspaceData& data, DetourNavigator::NavMeshDb& shardDb);
+
+    struct MergeStats
+    {
+        std::size_t mInserted = 0;
+        std::size_t mUpdated = 0;
+        std::size_t mSkipped = 0;
+        std::size_t mDeleted = 0;
+    };
+
+    // Copies the tiles from the shard database when there is no such tile in the target database or it has older
+    // version. Tiles ids are reassigned.
+    MergeStats mergeShardDb(
+        DetourNavigator::NavMeshDb& shardDb, bool removeUnusedTiles, DetourNavigator::NavMeshDb& targetDb);
+
+    // Merges all the shard databases into the target database in a single transaction and vacuums it when anything
+    // has changed.
+    Status mergeShardDbs(const std::vector<std::filesystem::path>& shardDbs, bool removeUnusedTiles,
+        std::uint64_t maxDbFileSize, DetourNavigator::NavMeshDb& db);
+}
+
+#endif
@@ -0,0 +1,248 @@
+#include "shardprocesses.hpp"
+
+#include <components/debug/debugging.hpp>
+#include <components/debug/debuglog.hpp>
+#include <components/files/conversion.hpp>
+#include <components/misc/progressreporter.hpp>
+#include <components/navmeshtool/protocol.hpp>
+
+#include <boost/process/args.hpp>
+#include <boost/process/child.hpp>
+#include <boost/process/exe.hpp>
+#include <boost/process/io.hpp>
+#include <boost/process/pipe.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace NavMeshTool
+{
+    namespace
+    {
+        namespace bp = boost::process;
+
+        struct ShardProgress
+        {
+            std::uint64_t mExpectedCells = 0;
+            std::uint64_t mProcessedCells = 0;
+            std::uint64_t mExpectedTiles = 0;
+            std::uint64_t mGeneratedTiles = 0;
+        };
+
+        template <class T>
+        void serializeToStderr(const T& value)
+        {
+            const std::vector<std::byte> data = serialize(value);
+            getLockedRawStderr()->write(
+                reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+
+        struct LogGeneratedTiles
+        {
+            void operator()(std::size_t provided, std::size_t expected) const
+            {
+                Log(Debug::Info) << provided << "/" << expected << " ("
+                                 << (static_cast<double>(provided) / static_cast<double>(expected) * 100)
+                                 << "%) navmesh tiles are generated by all shards";
+            }
+        };
+
+        struct UpdateShardProgress
+        {
+            ShardProgress& mProgress;
+
+            void operator()(const ExpectedCells& message) const { mProgress.mExpectedCells = message.mCount; }
+
+            void operator()(const ProcessedCells& message) const { mProgress.mProcessedCells = message.mCount; }
+
+            void operator()(const ExpectedTiles& message) const { mProgress.mExpectedTiles = message.mCount; }
+
+            void operator()(const GeneratedTiles& message) const { mProgress.mGeneratedTiles = message.mCount; }
+        };
+
+        // Each shard process handles all cells but only a part of tiles so the cells progress is the slowest shard
+        // one and the tiles progress is the sum.
+        class ShardsProgress
+        {
+        public:
+            explicit ShardsProgress(std::size_t shards, bool writeBinaryLog)
+                : mShards(shards)
+                , mWriteBinaryLog(writeBinaryLog)
+            {
+            }
+
+            void update(std::size_t shard, const TypedMessage& message)
+            {
+                const std::lock_guard lock(mMutex);
+                std::visit(UpdateShardProgress{ mShards[shard] }, message);
+                const ShardProgress total = getTotal();
+                if (mWriteBinaryLog)
+                {
+                    if (total.mExpectedCells != mReported.mExpectedCells)
+                        serializeToStderr(ExpectedCells{ total.mExpectedCells });
+                    if (total.mProcessedCells != mReported.mProcessedCells)
+                        serializeToStderr(ProcessedCells{ total.mProcessedCells });
+                    if (total.mExpectedTiles != mReported.mExpectedTiles)
+                        serializeToStderr(ExpectedTiles{ total.mExpectedTiles });
+                    if (total.mGeneratedTiles != mReported.mGeneratedTiles)
+                        serializeToStderr(GeneratedTiles{ total.mGeneratedTiles });
+                }
+                if (total.mGeneratedTiles != mReported.mGeneratedTiles)
+                    mReporter(total.mGeneratedTiles, total.mExpectedTiles);
+                mReported = total;
+            }
+
+            ShardProgress getReported() const
+            {
+                const std::lock_guard lock(mMutex);
+                return mReported;
+            }
+
+        private:
+            mutable std::mutex mMutex;
+            std::vector<ShardProgress> mShards;
+            const bool mWriteBinaryLog;
+            ShardProgress mReported;
+            Misc::ProgressReporter<LogGeneratedTiles> mReporter;
+
+            ShardProgress getTotal() const
+            {
+                ShardProgress result;
+                result.mProcessedCells = mShards.front().mProcessedCells;
+                for (const ShardProgress& shard : mShards)
+                {
+                    result.mExpectedCells = std::max(result.mExpectedCells, shard.mExpectedCells);
+                    result.mProcessedCells = std::min(result.mProcessedCells, shard.mProcessedCells);
+                    result.mExpectedTiles += shard.mExpectedTiles;
+                    result.mGeneratedTiles += shard.mGeneratedTiles;
+                }
+                return result;
+            }
+        };
+
+        void readMessages(std::istream& stream, std::size_t shard, ShardsProgress& progress)
+        {
+            std::vector<std::byte> data;
+            bool enabled = true;
+            char value;
+            while (stream.get(value))
+            {
+                data.push_back(static_cast<std::byte>(value));
+                if (const std::streamsize available = stream.rdbuf()->in_avail(); available > 0)
+                {
+                    const std::size_t size = data.size();
+                    data.resize(size + static_cast<std::size_t>(available));
+                    stream.read(reinterpret_cast<char*>(data.data() + size), available);
+                    data.resize(size + static_cast<std::size_t>(stream.gcount()));
+                }
+                // Keep reading the pipe even if messages can't be decoded to not block the process.
+                if (!enabled)
+                {
+                    data.clear();
+                    continue;
+                }
+                const std::byte* const begin = data.data();
+                const std::byte* const end = begin + data.size();
+                const std::byte* position = begin;
+                try
+                {
+                    while (true)
+                    {
+                        Message message;
+                        const std::byte* const nextPosition = deserialize(position, end, message);
+                        if (nextPosition == position)
+                            break;
+                        position = nextPosition;
+                        progress.update(shard, decode(message));
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Error) << "Failed to deserialize shard " << shard
+                                      << " navmeshtool message: " << e.what();
+                    enabled = false;
+                }
+                data.erase(data.begin(), data.begin() + (position - begin));
+            }
+        }
+
+        Status getStatus(int exitCode)
+        {
+            if (exitCode == static_cast<int>(Status::Ok))
+                return Status::Ok;
+            if (exitCode == static_cast<int>(Status::NotEnoughSpace))
+                return Status::NotEnoughSpace;
+            return Status::Cancelled;
+        }
+    }
+
+    Status runShardProcesses(const std::filesystem::path& executable, const std::vector<std::string>& arguments,
+        const std::vector<std::filesystem::path>& shardDbs, bool writeBinaryLog)
+    {
+        Log(Debug::Info) << "Generating navmesh tiles by " << shardDbs.size() << " shard processes...";
+
+        ShardsProgress progress(shardDbs.size(), writeBinaryLog);
+        std::vector<std::unique_ptr<bp::ipstream>> streams;
+        std::vector<bp::child> children;
+        std::vector<std::thread> readers;
+        Status status = Status::Ok;
+
+        try
+        {
+            for (std::size_t i = 0; i < shardDbs.size(); ++i)
+            {
+                std::vector<std::string> shardArguments = arguments;
+                shardArguments.insert(shardArguments.end(),
+                    {
+                        "--shard-count",
+                        std::to_string(shardDbs.size()),
+                        "--shard-index",
+                        std::to_string(i),
+                        "--shard-db",
+                        Files::pathToUnicodeString(shardDbs[i]),
+                        "--write-binary-log",
+                    });
+                auto& stream = *streams.emplace_back(std::make_unique<bp::ipstream>());
+                children.emplace_back(bp::exe = Files::pathToUnicodeString(executable), bp::args = shardArguments,
+                    bp::std_err > stream);
+                readers.emplace_back([&stream, i, &progress] { readMessages(stream, i, progress); });
+            }
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to start shard process: " << e.what();
+            for (bp::child& child : children)
+                child.terminate();
+            status = Status::Cancelled;
+        }
+
+        for (std::size_t i = 0; i < children.size(); ++i)
+        {
+            children[i].wait();
+            const int exitCode = children[i].exit_code();
+            if (exitCode == 0)
+                continue;
+            Log(Debug::Warning) << "Shard " << i << " process has finished with exit code " << exitCode;
+            if (status == Status::Ok)
+                status = getStatus(exitCode);
+        }
+
+        for (std::thread& reader : readers)
+            reader.join();
+
+        const ShardProgress total = progress.getReported();
+        Log(Debug::Info) << "Generated navmesh for " << total.mGeneratedTiles << "/" << total.mExpectedTiles
+                         << " tiles by " << children.size() << " shard processes";
+
+        return status;
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef OPENMW_NAVMESHTOOL_SHARDPROCESSES_H
+#define OPENMW_NAVMESHTOOL_SHARDPROCESSES_H
+
+#include "navmesh.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace NavMeshTool
+{
+    // Runs the executable with given arguments for each shard db adding the shard options and binary log to aggregate
+    // progress of all processes. Returns after all processes are finished.
+    Status runShardProcesses(const std::filesystem::path& executable, const std::vector<std::string>& arguments,
+        const std::vector<std::filesystem::path>& shardDbs, bool writeBinaryLog);
+}
+
+#endif
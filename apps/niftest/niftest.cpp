@@ -1,10 +1,19 @@
 /// Program to test .nif files both on the FileSystem and in BSA archives.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <exception>
 #include <filesystem>
+#include <functional>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -72,14 +81,153 @@ std::unique_ptr<VFS::Archive> makeArchive(const std::filesystem::path& path)
     return nullptr;
 }
 
-/// Check all the nif files in a given VFS::Archive
+/// A nif file and the way to open it
+struct NifJob
+{
+    std::filesystem::path mPath;
+    std::function<Files::IStreamPtr()> mOpen;
+};
+
+struct FileStats
+{
+    std::filesystem::path mPath;
+    std::size_t mSize = 0;
+    std::chrono::steady_clock::duration mTime{};
+};
+
+/// Totals of the parsed nif files
+struct ParseStats
+{
+    static constexpr std::size_t sSlowestFilesCount = 10;
+
+    std::size_t mFiles = 0;
+    std::size_t mRecords = 0;
+    std::size_t mBytes = 0;
+    std::chrono::steady_clock::duration mTime{};
+    std::vector<FileStats> mSlowestFiles;
+    Nif::RecordTypeStatsMap mRecordTypes;
+
+    void addSlowestFile(FileStats&& file)
+    {
+        mSlowestFiles.push_back(std::move(file));
+        std::sort(mSlowestFiles.begin(), mSlowestFiles.end(),
+            [](const FileStats& lhs, const FileStats& rhs) { return lhs.mTime > rhs.mTime; });
+        if (mSlowestFiles.size() > sSlowestFilesCount)
+            mSlowestFiles.pop_back();
+    }
+
+    void merge(ParseStats&& other)
+    {
+        mFiles += other.mFiles;
+        mRecords += other.mRecords;
+        mBytes += other.mBytes;
+        mTime += other.mTime;
+        for (FileStats& file : other.mSlowestFiles)
+            addSlowestFile(std::move(file));
+        for (const auto& [type, recordType] : other.mRecordTypes)
+        {
+            Nif::RecordTypeStats& total = mRecordTypes[type];
+            total.mCount += recordType.mCount;
+            total.mTime += recordType.mTime;
+        }
+    }
+};
+
+void parseNif(const NifJob& job, bool measureRecordTypes, ParseStats& stats)
+{
+    const auto start = std::chrono::steady_clock::now();
+    Nif::NIFFile file(job.mPath);
+    Nif::Reader reader(file);
+    if (measureRecordTypes)
+        reader.setRecordTypeStats(&stats.mRecordTypes);
+    reader.parse(job.mOpen());
+    const auto time = std::chrono::steady_clock::now() - start;
+    ++stats.mFiles;
+    stats.mRecords += file.mRecords.size();
+    stats.mBytes += reader.getSize();
+    stats.mTime += time;
+    stats.addSlowestFile(FileStats{ job.mPath, reader.getSize(), time });
+}
+
+/// Parse the files by the given number of threads taking the next file from the list
+ParseStats parseNifs(const std::vector<NifJob>& jobs, std::size_t threads, bool measureRecordTypes)
+{
+    std::atomic_size_t next = 0;
+    std::mutex mutex;
+    ParseStats result;
+
+    const auto work = [&] {
+        ParseStats stats;
+        for (std::size_t i = next++; i < jobs.size(); i = next++)
+        {
+            try
+            {
+                parseNif(jobs[i], measureRecordTypes, stats);
+            }
+            catch (std::exception& e)
+            {
+                const std::lock_guard lock(mutex);
+                std::cerr << "ERROR, an exception has occurred while parsing \""
+                          << Files::pathToUnicodeString(jobs[i].mPath) << "\":  " << e.what() << std::endl;
+            }
+        }
+        const std::lock_guard lock(mutex);
+        result.merge(std::move(stats));
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; ++i)
+        workers.emplace_back(work);
+    work();
+    for (std::thread& worker : workers)
+        worker.join();
+
+    return result;
+}
+
+double toMilliseconds(std::chrono::steady_clock::duration value)
+{
+    return std::chrono::duration<double, std::milli>(value).count();
+}
+
+void printStats(const ParseStats& stats, std::chrono::steady_clock::duration wallTime, std::size_t threads)
+{
+    constexpr double megabyte = 1024 * 1024;
+    const double seconds = std::chrono::duration<double>(wallTime).count();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Parsed " << stats.mFiles << " nif files, " << stats.mBytes / megabyte << " MB, " << stats.mRecords
+              << " records in " << seconds << " s by " << threads << " thread(s)";
+    if (seconds > 0)
+        std::cout << ": " << stats.mFiles / seconds << " files/s, " << stats.mBytes / megabyte / seconds << " MB/s";
+    std::cout << std::endl;
+
+    std::cout << "Slowest files:" << std::endl;
+    for (const FileStats& file : stats.mSlowestFiles)
+        std::cout << "  " << toMilliseconds(file.mTime) << " ms " << Files::pathToUnicodeString(file.mPath) << " ("
+                  << file.mSize << " bytes)" << std::endl;
+
+    std::vector<std::pair<std::string_view, Nif::RecordTypeStats>> recordTypes(
+        stats.mRecordTypes.begin(), stats.mRecordTypes.end());
+    std::sort(recordTypes.begin(), recordTypes.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.second.mTime > rhs.second.mTime; });
+
+    std::cout << "Record read time by type:" << std::endl;
+    for (const auto& [type, recordType] : recordTypes)
+        std::cout << "  " << toMilliseconds(recordType.mTime) << " ms " << type << " (" << recordType.mCount
+                  << " records, " << toMilliseconds(recordType.mTime) * 1000 / recordType.mCount << " us each)"
+                  << std::endl;
+}
+
+/// Collect all the nif files in a given VFS::Archive. The managers keep the archives open.
 /// \note Can not read a bsa file inside of a bsa file.
-void readVFS(std::unique_ptr<VFS::Archive>&& anArchive, const std::filesystem::path& archivePath = {})
+void readVFS(std::unique_ptr<VFS::Archive>&& anArchive, std::vector<NifJob>& jobs,
+    std::vector<std::unique_ptr<VFS::Manager>>& managers, const std::filesystem::path& archivePath = {})
 {
     if (anArchive == nullptr)
         return;
 
-    VFS::Manager myManager(true);
+    VFS::Manager& myManager = *managers.emplace_back(std::make_unique<VFS::Manager>(true));
     myManager.addArchive(std::move(anArchive));
     myManager.buildIndex();
 
@@ -89,17 +237,14 @@ void readVFS(std::unique_ptr<VFS::Archive>&& anArchive, const std::filesystem::p
         {
             if (isNIF(name))
             {
-                //           std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile file(archivePath / name);
-                Nif::Reader reader(file);
-                reader.parse(myManager.get(name));
+                jobs.push_back(NifJob{ archivePath / name, [&myManager, name] { return myManager.get(name); } });
             }
             else if (isBSA(name))
             {
                 if (!archivePath.empty() && !isBSA(archivePath))
                 {
                     //                     std::cout << "Reading BSA File: " << name << std::endl;
-                    readVFS(makeBsaArchive(archivePath / name), archivePath / name);
+                    readVFS(makeBsaArchive(archivePath / name), jobs, managers, archivePath / name);
                     //                     std::cout << "Done with BSA File: " << name << std::endl;
                 }
             }
@@ -112,7 +257,7 @@ void readVFS(std::unique_ptr<VFS::Archive>&& anArchive, const std::filesystem::p
 }
 
 bool parseOptions(int argc, char** argv, std::vector<Files::MaybeQuotedPath>& files, bool& writeDebugLog,
-    std::vector<Files::MaybeQuotedPath>& archives)
+    bool& printParseStats, std::size_t& threads, std::vector<Files::MaybeQuotedPath>& archives)
 {
     bpo::options_description desc(R"(Ensure that OpenMW can use the provided NIF and BSA files
 
@@ -124,6 +269,11 @@ Allowed options)");
     auto addOption = desc.add_options();
     addOption("help,h", "print help message.");
     addOption("write-debug-log,v", "write debug log for unsupported nif files");
+    addOption("stats,s",
+        "print the parsing throughput, the slowest files and the read time of each record type after checking the "
+        "files");
+    addOption("threads,j", bpo::value<std::size_t>()->default_value(1),
+        "number of threads parsing nif files, 0 to use all the cores");
     addOption("archives", bpo::value<Files::MaybeQuotedPathContainer>(), "path to archive files to provide files");
     addOption("input-file", bpo::value<Files::MaybeQuotedPathContainer>(), "input file");
 
@@ -143,6 +293,8 @@ Allowed options)");
             return false;
         }
         writeDebugLog = variables.count("write-debug-log") > 0;
+        printParseStats = variables.count("stats") > 0;
+        threads = variables["threads"].as<std::size_t>();
         if (variables.count("input-file"))
         {
             files = variables["input-file"].as<Files::MaybeQuotedPathContainer>();
@@ -166,10 +318,15 @@ int main(int argc, char** argv)
 {
     std::vector<Files::MaybeQuotedPath> files;
     bool writeDebugLog = false;
+    bool printParseStats = false;
+    std::size_t threads = 1;
     std::vector<Files::MaybeQuotedPath> archives;
-    if (!parseOptions(argc, argv, files, writeDebugLog, archives))
+    if (!parseOptions(argc, argv, files, writeDebugLog, printParseStats, threads, archives))
         return 1;
 
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
     Nif::Reader::setLoadUnsupportedFiles(true);
     Nif::Reader::setWriteNifDebugLog(writeDebugLog);
 
@@ -185,6 +342,9 @@ int main(int argc, char** argv)
         vfs->buildIndex();
     }
 
+    std::vector<NifJob> jobs;
+    std::vector<std::unique_ptr<VFS::Manager>> managers;
+
     //     std::cout << "Reading Files" << std::endl;
     for (const auto& path : files)
     {
@@ -193,16 +353,14 @@ int main(int argc, char** argv)
             if (isNIF(path))
             {
                 // std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile file(path);
-                Nif::Reader reader(file);
                 if (vfs != nullptr)
-                    reader.parse(vfs->get(Files::pathToUnicodeString(path)));
+                    jobs.push_back(NifJob{ path, [&vfs, path] { return vfs->get(Files::pathToUnicodeString(path)); } });
                 else
-                    reader.parse(Files::openConstrainedFileStream(path));
+                    jobs.push_back(NifJob{ path, [path] { return Files::openConstrainedFileStream(path); } });
             }
             else if (auto archive = makeArchive(path))
             {
-                readVFS(std::move(archive), path);
+                readVFS(std::move(archive), jobs, managers, path);
             }
             else
             {
@@ -215,5 +373,13 @@ int main(int argc, char** argv)
             std::cerr << "ERROR, an exception has occurred:  " << e.what() << std::endl;
         }
     }
+
+    const auto start = std::chrono::steady_clock::now();
+    const ParseStats stats = parseNifs(jobs, threads, printParseStats);
+    const auto wallTime = std::chrono::steady_clock::now() - start;
+
+    if (printParseStats)
+        printStats(stats, wallTime, threads);
+
     return 0;
 }
@@ -1,7 +1,9 @@
 #include "engine.hpp"
 
+#include <algorithm>
 #include <cerrno>
 #include <chrono>
+#include <cstdint>
 #include <system_error>
 #include <thread>
 
@@ -21,6 +23,7 @@
 #include <components/sdlutil/imagetosurface.hpp>
 #include <components/sdlutil/sdlgraphicswindow.hpp>
 
+#include <components/resource/imagemanager.hpp>
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/scenemanager.hpp>
 #include <components/resource/stats.hpp>
@@ -400,6 +403,11 @@ OMW::Engine::~Engine()
     mScriptContext = nullptr;
 
     mUnrefQueue = nullptr;
+    if (mResourceSystem != nullptr)
+    {
+        mResourceSystem->getSceneManager()->setWorkQueue(nullptr);
+        mResourceSystem->getImageManager()->setWorkQueue(nullptr);
+    }
     mWorkQueue = nullptr;
 
     mViewer = nullptr;
@@ -668,12 +676,23 @@ void OMW::Engine::prepareEngine()
     mResourceSystem->getSceneManager()->setFilterSettings(Settings::Manager::getString("texture mag filter", "General"),
         Settings::Manager::getString("texture min filter", "General"),
         Settings::Manager::getString("texture mipmap", "General"), Settings::Manager::getInt("anisotropy", "General"));
+    mResourceSystem->getSceneManager()->setOptimizerThreads(
+        std::max(0, Settings::Manager::getInt("optimizer threads", "Models")));
+    if (Settings::Manager::getBool("binary scene cache", "Models"))
+        mResourceSystem->getSceneManager()->setBinarySceneCache(mCfgMgr.getUserDataPath() / "models",
+            static_cast<std::uint64_t>(std::max(0, Settings::Manager::getInt("binary scene cache size", "Models")))
+                * 1024 * 1024,
+            Version::getOpenmwVersionDescription(mResDir));
     mEnvironment.setResourceSystem(*mResourceSystem);
 
     int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
     if (numThreads <= 0)
         throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
     mWorkQueue = new SceneUtil::WorkQueue(numThreads);
+    mResourceSystem->getSceneManager()->setWorkQueue(mWorkQueue);
+    mResourceSystem->getImageManager()->setWorkQueue(mWorkQueue);
+    mResourceSystem->getImageManager()->setMaxCacheSize(
+        static_cast<std::size_t>(std::max(0, Settings::Manager::getInt("image cache size", "Cells"))) * 1024 * 1024);
     mUnrefQueue = std::make_unique<SceneUtil::UnrefQueue>();
 
     mScreenCaptureOperation = new SceneUtil::AsyncScreenCaptureOperation(mWorkQueue,
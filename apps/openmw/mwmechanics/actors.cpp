@@ -1,5 +1,7 @@
 #include "actors.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <optional>
 
 #include <components/esm3/esmreader.hpp>
@@ -229,6 +231,14 @@ namespace
         ptr.getClass().getCreatureStats(ptr).getActiveSpells().unloadActor(ptr);
     }
 
+    // Every further multiple of the LOD distance adds a frame between animation updates
+    unsigned int getAnimationUpdateInterval(float distance, float lodDistance, int maxInterval)
+    {
+        if (lodDistance <= 0 || maxInterval <= 1)
+            return 1;
+        return static_cast<unsigned int>(std::min(1.f + std::floor(distance / lodDistance), float(maxInterval)));
+    }
+
 }
 
 namespace MWMechanics
@@ -1166,6 +1176,8 @@ namespace MWMechanics
 
     Actors::Actors()
         : mSmoothMovement(Settings::Manager::getBool("smooth movement", "Game"))
+        , mAnimationLodDistance(Settings::Manager::getFloat("animation lod distance", "Game"))
+        , mAnimationLodMaxUpdateInterval(Settings::Manager::getInt("animation lod max update interval", "Game"))
     {
         mTimerDisposeSummonsCorpses
             = 0.2f; // We should add a delay between summoned creature death and its corpse despawning
@@ -1689,6 +1701,10 @@ namespace MWMechanics
 
                 CharacterController& ctrl = actor.getCharacterController();
                 ctrl.setActive(active);
+                // Distant actors are animated at a reduced rate, game logic still advances their animation every frame
+                ctrl.setAnimationUpdateInterval(isPlayer
+                        ? 1
+                        : getAnimationUpdateInterval(dist, mAnimationLodDistance, mAnimationLodMaxUpdateInterval));
 
                 if (!inRange)
                 {
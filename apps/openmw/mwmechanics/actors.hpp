@@ -188,6 +188,8 @@ namespace MWMechanics
         float mSneakSkillTimer = 0; // Times sneak skill progress from "avoid notice"
         float mActorsProcessingRange;
         bool mSmoothMovement;
+        float mAnimationLodDistance;
+        int mAnimationLodMaxUpdateInterval;
         MusicType mCurrentMusic = MusicType::Title;
 
         void updateVisibility(const MWWorld::Ptr& ptr, CharacterController& ctrl) const;
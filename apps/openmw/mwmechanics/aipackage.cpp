@@ -133,6 +133,9 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
 
     mLastDestinationTolerance = destTolerance;
 
+    if (mPathFinder.isPathPending() && mPathFinder.updatePendingPath(actor, getPathGridGraph(actor.getCell())))
+        mRotateOnTheRunChecks = 3;
+
     const float distToTarget = distance(position, dest);
     const bool isDestReached = (distToTarget <= destTolerance);
     const bool actorCanMoveByZ = canActorMoveByZAxis(actor);
@@ -151,14 +154,17 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const osg::Vec3f&
 
         if (!mIsShortcutting)
         {
-            if (wasShortcutting || doesPathNeedRecalc(dest, actor)) // if need to rebuild path
+            // Actor keeps following the previous path while the new one is being found
+            if (wasShortcutting || (!mPathFinder.isPathPending() && doesPathNeedRecalc(dest, actor)))
             {
-                mPathFinder.buildLimitedPath(actor, position, dest, actor.getCell(), getPathGridGraph(actor.getCell()),
-                    agentBounds, getNavigatorFlags(actor), getAreaCosts(actor), endTolerance, pathType);
-                mRotateOnTheRunChecks = 3;
+                mPathFinder.requestLimitedPath(actor, position, dest, actor.getCell(),
+                    getPathGridGraph(actor.getCell()), agentBounds, getNavigatorFlags(actor), getAreaCosts(actor),
+                    endTolerance, pathType);
+                if (!mPathFinder.isPathPending())
+                    mRotateOnTheRunChecks = 3;
 
                 // give priority to go directly on target if there is minimal opportunity
-                if (destInLOS && mPathFinder.getPath().size() > 1)
+                if (destInLOS && !mPathFinder.isPathPending() && mPathFinder.getPath().size() > 1)
                 {
                     // get point just before dest
                     auto pPointBeforeDest = mPathFinder.getPath().rbegin() + 1;
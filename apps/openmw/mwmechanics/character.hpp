@@ -311,6 +311,9 @@ namespace MWMechanics
         /// @see Animation::setActive
         void setActive(int active) const;
 
+        /// @see Animation::setUpdateInterval
+        void setAnimationUpdateInterval(unsigned int interval) const;
+
         /// Make this character turn its head towards \a target. To turn off head tracking, pass an empty Ptr.
         void setHeadTrackTarget(const MWWorld::ConstPtr& target);
 
@@ -6,6 +6,7 @@
 #include <osg/io_utils>
 
 #include <components/debug/debuglog.hpp>
+#include <components/detournavigator/asyncpathfinder.hpp>
 #include <components/detournavigator/debug.hpp>
 #include <components/detournavigator/navigatorutils.hpp>
 #include <components/misc/coordinateconverter.hpp>
@@ -82,6 +83,26 @@ namespace
         return 2 * std::max(realHalfExtents.x(), realHalfExtents.y());
     }
 
+    void logBuildPathError(const MWWorld::ConstPtr& actor, DetourNavigator::Status status,
+        const osg::Vec3f& startPoint, const osg::Vec3f& endPoint, DetourNavigator::Flags flags)
+    {
+        Log(Debug::Debug) << "Build path by navigator error: \"" << DetourNavigator::getMessage(status) << "\" for \""
+                          << actor.getClass().getName(actor) << "\" (" << actor.getBase() << ") from " << startPoint
+                          << " to " << endPoint << " with flags (" << DetourNavigator::WriteFlags{ flags } << ")";
+    }
+
+    osg::Vec3f getLimitedPathEnd(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint)
+    {
+        const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
+        const auto maxDistance
+            = std::min(navigator->getMaxNavmeshAreaRealRadius(), static_cast<float>(Constants::CellSizeInUnits));
+        const auto startToEnd = endPoint - startPoint;
+        const auto distance = startToEnd.length();
+        if (distance <= maxDistance)
+            return endPoint;
+        return startPoint + startToEnd * maxDistance / distance;
+    }
+
     float getHeight(const MWWorld::ConstPtr& actor)
     {
         const auto world = MWBase::Environment::get().getWorld();
@@ -361,6 +382,7 @@ namespace MWMechanics
 
     void PathFinder::buildStraightPath(const osg::Vec3f& endPoint)
     {
+        mPendingPath = nullptr;
         mPath.clear();
         mPath.push_back(endPoint);
         mConstructed = true;
@@ -369,6 +391,7 @@ namespace MWMechanics
     void PathFinder::buildPathByPathgrid(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
         const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph)
     {
+        mPendingPath = nullptr;
         mPath.clear();
         mCell = cell;
 
@@ -381,6 +404,7 @@ namespace MWMechanics
         const osg::Vec3f& endPoint, const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Flags flags,
         const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType)
     {
+        mPendingPath = nullptr;
         mPath.clear();
 
         // If it's not possible to build path over navmesh due to disabled navmesh generation fallback to straight path
@@ -401,6 +425,7 @@ namespace MWMechanics
         const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Flags flags,
         const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType)
     {
+        mPendingPath = nullptr;
         mPath.clear();
         mCell = cell;
 
@@ -448,12 +473,7 @@ namespace MWMechanics
             return DetourNavigator::Status::Success;
 
         if (status != DetourNavigator::Status::Success)
-        {
-            Log(Debug::Debug) << "Build path by navigator error: \"" << DetourNavigator::getMessage(status)
-                              << "\" for \"" << actor.getClass().getName(actor) << "\" (" << actor.getBase()
-                              << ") from " << startPoint << " to " << endPoint << " with flags ("
-                              << DetourNavigator::WriteFlags{ flags } << ")";
-        }
+            logBuildPathError(actor, status, startPoint, endPoint, flags);
 
         return status;
     }
@@ -483,10 +503,7 @@ namespace MWMechanics
 
         if (status != DetourNavigator::Status::Success)
         {
-            Log(Debug::Debug) << "Build path by navigator error: \"" << DetourNavigator::getMessage(status)
-                              << "\" for \"" << actor.getClass().getName(actor) << "\" (" << actor.getBase()
-                              << ") from " << startPoint << " to " << mPath.front() << " with flags ("
-                              << DetourNavigator::WriteFlags{ flags } << ")";
+            logBuildPathError(actor, status, startPoint, mPath.front(), flags);
             return;
         }
 
@@ -504,15 +521,92 @@ namespace MWMechanics
         const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Flags flags,
         const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType)
     {
-        const auto navigator = MWBase::Environment::get().getWorld()->getNavigator();
-        const auto maxDistance
-            = std::min(navigator->getMaxNavmeshAreaRealRadius(), static_cast<float>(Constants::CellSizeInUnits));
-        const auto startToEnd = endPoint - startPoint;
-        const auto distance = startToEnd.length();
-        if (distance <= maxDistance)
-            return buildPath(actor, startPoint, endPoint, cell, pathgridGraph, agentBounds, flags, areaCosts,
+        buildPath(actor, startPoint, getLimitedPathEnd(startPoint, endPoint), cell, pathgridGraph, agentBounds, flags,
+            areaCosts, endTolerance, pathType);
+    }
+
+    void PathFinder::requestLimitedPath(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
+        const osg::Vec3f& endPoint, const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph,
+        const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Flags flags,
+        const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType)
+    {
+        const auto world = MWBase::Environment::get().getWorld();
+        DetourNavigator::AsyncPathFinder* const asyncPathFinder = world->getAsyncPathFinder();
+
+        if (asyncPathFinder == nullptr || actor.getClass().isPureWaterCreature(actor)
+            || actor.getClass().isPureFlyingCreature(actor))
+            return buildLimitedPath(actor, startPoint, endPoint, cell, pathgridGraph, agentBounds, flags, areaCosts,
                 endTolerance, pathType);
-        const auto end = startPoint + startToEnd * maxDistance / distance;
-        buildPath(actor, startPoint, end, cell, pathgridGraph, agentBounds, flags, areaCosts, endTolerance, pathType);
+
+        const DetourNavigator::PathQuery query{
+            .mAgentBounds = agentBounds,
+            .mStepSize = getPathStepSize(actor),
+            .mStart = startPoint,
+            .mEnd = getLimitedPathEnd(startPoint, endPoint),
+            .mIncludeFlags = flags,
+            .mAreaCosts = areaCosts,
+            .mEndTolerance = endTolerance,
+        };
+
+        mPendingPath = asyncPathFinder->post(*world->getNavigator(), query);
+
+        // There is no navmesh for the actor so the path doesn't depend on it and is cheap to build right now
+        if (mPendingPath == nullptr)
+            return buildPath(actor, startPoint, query.mEnd, cell, pathgridGraph, agentBounds, flags, areaCosts,
+                endTolerance, pathType);
+
+        mPendingCell = cell;
+        mPendingPathType = pathType;
+    }
+
+    bool PathFinder::updatePendingPath(const MWWorld::ConstPtr& actor, const PathgridGraph& pathgridGraph)
+    {
+        if (mPendingPath == nullptr)
+            return false;
+
+        const auto world = MWBase::Environment::get().getWorld();
+        DetourNavigator::AsyncPathFinder* const asyncPathFinder = world->getAsyncPathFinder();
+        const DetourNavigator::PathQueryResult* const result = asyncPathFinder->getResult(*mPendingPath);
+        if (result == nullptr)
+            return false;
+
+        const DetourNavigator::PathQuery& query = mPendingPath->mQuery;
+        DetourNavigator::Status status = result->mStatus;
+
+        if (mPendingPathType == PathType::Partial && status == DetourNavigator::Status::PartialPath)
+            status = DetourNavigator::Status::Success;
+
+        if (status != DetourNavigator::Status::Success)
+            logBuildPathError(actor, status, query.mStart, query.mEnd, query.mIncludeFlags);
+
+        // Same fallback as for buildPath
+        if (status != DetourNavigator::Status::Success && status != DetourNavigator::Status::NavMeshNotFound
+            && (query.mIncludeFlags & DetourNavigator::Flag_usePathgrid) == 0)
+        {
+            DetourNavigator::PathQuery withPathgrid = query;
+            withPathgrid.mIncludeFlags |= DetourNavigator::Flag_usePathgrid;
+            if (auto job = asyncPathFinder->post(*world->getNavigator(), withPathgrid))
+            {
+                mPendingPath = std::move(job);
+                return false;
+            }
+        }
+
+        mPath.clear();
+        mCell = mPendingCell;
+
+        if (status == DetourNavigator::Status::Success)
+            mPath.assign(result->mPath.begin(), result->mPath.end());
+
+        if (mPath.empty())
+            buildPathByPathgridImpl(query.mStart, query.mEnd, pathgridGraph, std::back_inserter(mPath));
+
+        if (status == DetourNavigator::Status::NavMeshNotFound && mPath.empty())
+            mPath.push_back(query.mEnd);
+
+        mConstructed = !mPath.empty();
+        mPendingPath = nullptr;
+
+        return true;
     }
 }
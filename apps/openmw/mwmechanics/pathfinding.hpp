@@ -4,6 +4,7 @@
 #include <cassert>
 #include <deque>
 #include <iterator>
+#include <memory>
 
 #include <components/detournavigator/areatype.hpp>
 #include <components/detournavigator/flags.hpp>
@@ -21,6 +22,7 @@ namespace MWWorld
 namespace DetourNavigator
 {
     struct AgentBounds;
+    struct PathQueryJob;
 }
 
 namespace MWMechanics
@@ -98,6 +100,7 @@ namespace MWMechanics
             mConstructed = false;
             mPath.clear();
             mCell = nullptr;
+            mPendingPath = nullptr;
         }
 
         void buildStraightPath(const osg::Vec3f& endPoint);
@@ -124,11 +127,23 @@ namespace MWMechanics
             const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Flags flags,
             const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType);
 
+        /// Same as buildLimitedPath but the navmesh part is done by background threads when they are enabled.
+        /// Current path is kept until updatePendingPath applies the result.
+        void requestLimitedPath(const MWWorld::ConstPtr& actor, const osg::Vec3f& startPoint,
+            const osg::Vec3f& endPoint, const MWWorld::CellStore* cell, const PathgridGraph& pathgridGraph,
+            const DetourNavigator::AgentBounds& agentBounds, const DetourNavigator::Flags flags,
+            const DetourNavigator::AreaCosts& areaCosts, float endTolerance, PathType pathType);
+
+        /// Replaces current path by the requested one when it's ready, returns true if the path is replaced
+        bool updatePendingPath(const MWWorld::ConstPtr& actor, const PathgridGraph& pathgridGraph);
+
+        bool isPathPending() const { return mPendingPath != nullptr; }
+
         /// Remove front point if exist and within tolerance
         void update(const osg::Vec3f& position, float pointTolerance, float destinationTolerance,
             UpdateFlags updateFlags, const DetourNavigator::AgentBounds& agentBounds, DetourNavigator::Flags pathFlags);
 
-        bool checkPathCompleted() const { return mConstructed && mPath.empty(); }
+        bool checkPathCompleted() const { return mConstructed && mPath.empty() && mPendingPath == nullptr; }
 
         /// In radians
         float getZAngleToNext(float x, float y) const;
@@ -208,6 +223,9 @@ namespace MWMechanics
         bool mConstructed = false;
         std::deque<osg::Vec3f> mPath;
         const MWWorld::CellStore* mCell = nullptr;
+        std::shared_ptr<DetourNavigator::PathQueryJob> mPendingPath;
+        const MWWorld::CellStore* mPendingCell = nullptr;
+        PathType mPendingPathType = PathType::Full;
 
         void buildPathByPathgridImpl(const osg::Vec3f& startPoint, const osg::Vec3f& endPoint,
             const PathgridGraph& pathgridGraph, std::back_insert_iterator<std::deque<osg::Vec3f>> out);
@@ -1,5 +1,8 @@
 #include "objectpaging.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 
@@ -8,6 +11,7 @@
 #include <osg/MatrixTransform>
 #include <osg/Sequence>
 #include <osg/Switch>
+#include <osg/UserDataContainer>
 #include <osgAnimation/BasicAnimationManager>
 #include <osgUtil/IncrementalCompileOperation>
 
@@ -95,6 +99,7 @@ namespace MWRender
         {
             osg::ref_ptr<osg::Node> node = createChunk(size, center, activeGrid, viewPoint, compile, lod);
             mCache->addEntryToObjectCache(id, node.get());
+            ++mNumRebuilds;
             return node;
         }
     }
@@ -324,6 +329,198 @@ namespace MWRender
         std::vector<ESM::RefNum> mRefnums;
     };
 
+    /// Location of the geometry of one reference inside a chunk.
+    struct ChunkRefRange
+    {
+        /// Child indices leading from the chunk root to the node.
+        std::vector<unsigned int> mPath;
+        unsigned int mFirstVertex;
+        /// 0 if the whole node belongs to the reference.
+        unsigned int mNumVertices;
+    };
+
+    /// Per-reference ranges of a chunk, used to hide or show single references without rebuilding the chunk.
+    /// The merged geometries of a chunk are its sub-batches, their refnum markers give the per-reference vertex ranges.
+    class ChunkIndex : public osg::Object
+    {
+    public:
+        ChunkIndex() {}
+        ChunkIndex(const ChunkIndex& copy, const osg::CopyOp&)
+            : mRanges(copy.mRanges)
+            , mExcluded(copy.mExcluded)
+        {
+        }
+        META_Object(MWRender, ChunkIndex)
+        std::map<ESM::RefNum, std::vector<ChunkRefRange>> mRanges;
+        /// References left out of the chunk because they were disabled when it was created.
+        std::set<ESM::RefNum> mExcluded;
+    };
+
+    /// Marks a chunk as a patched copy of the chunk that was originally created.
+    class ChunkPatch : public osg::Object
+    {
+    public:
+        ChunkPatch() {}
+        ChunkPatch(const ChunkPatch& copy, const osg::CopyOp&)
+            : mOriginal(copy.mOriginal)
+        {
+        }
+        META_Object(MWRender, ChunkPatch)
+        osg::ref_ptr<osg::Node> mOriginal;
+    };
+
+    void indexChunk(osg::Node& node, std::vector<unsigned int>& path, ChunkIndex& index)
+    {
+        if (osg::UserDataContainer* udc = node.getUserDataContainer())
+        {
+            unsigned int firstVertex = 0;
+            for (unsigned int i = 0; i < udc->getNumUserObjects(); ++i)
+            {
+                if (const RefnumMarker* marker = dynamic_cast<const RefnumMarker*>(udc->getUserObject(i)))
+                {
+                    index.mRanges[marker->mRefnum].push_back(ChunkRefRange{ path, firstVertex, marker->mNumVertices });
+                    firstVertex += marker->mNumVertices;
+                }
+            }
+        }
+        if (osg::Group* group = node.asGroup())
+        {
+            for (unsigned int i = 0; i < group->getNumChildren(); ++i)
+            {
+                path.push_back(i);
+                indexChunk(*group->getChild(i), path, index);
+                path.pop_back();
+            }
+        }
+    }
+
+    using VertexRanges = std::vector<std::pair<unsigned int, unsigned int>>;
+    using ChunkEdits = std::map<std::vector<unsigned int>, VertexRanges>;
+
+    template <class DrawElementsType>
+    osg::ref_ptr<osg::PrimitiveSet> filterPrimitiveSet(
+        const osg::PrimitiveSet& primitiveSet, unsigned int primitiveSize, const VertexRanges& hidden)
+    {
+        const auto isHidden = [&](unsigned int vertex) {
+            auto it = std::upper_bound(
+                hidden.begin(), hidden.end(), std::make_pair(vertex, std::numeric_limits<unsigned int>::max()));
+            return it != hidden.begin() && vertex < std::prev(it)->first + std::prev(it)->second;
+        };
+
+        osg::ref_ptr<DrawElementsType> result = new DrawElementsType(primitiveSet.getMode());
+        const unsigned int numIndices = primitiveSet.getNumIndices();
+        result->reserve(numIndices);
+        for (unsigned int i = 0; i + primitiveSize <= numIndices; i += primitiveSize)
+        {
+            bool visible = true;
+            for (unsigned int j = 0; j < primitiveSize && visible; ++j)
+                visible = !isHidden(primitiveSet.index(i + j));
+            if (visible)
+                for (unsigned int j = 0; j < primitiveSize; ++j)
+                    result->push_back(primitiveSet.index(i + j));
+        }
+        return result;
+    }
+
+    osg::ref_ptr<osg::Node> hideVertexRanges(const osg::Geometry& geometry, VertexRanges ranges, std::size_t& dataSize)
+    {
+        std::sort(ranges.begin(), ranges.end());
+
+        const osg::Array* vertices = geometry.getVertexArray();
+        const bool shortIndices = vertices && vertices->getNumElements() <= std::numeric_limits<GLushort>::max();
+
+        osg::ref_ptr<osg::Geometry> copy = osg::clone(&geometry, osg::CopyOp::SHALLOW_COPY);
+        for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+        {
+            const osg::PrimitiveSet& primitiveSet = *geometry.getPrimitiveSet(i);
+            unsigned int primitiveSize = 0;
+            switch (primitiveSet.getMode())
+            {
+                case GL_POINTS:
+                    primitiveSize = 1;
+                    break;
+                case GL_LINES:
+                    primitiveSize = 2;
+                    break;
+                case GL_TRIANGLES:
+                    primitiveSize = 3;
+                    break;
+                default:
+                    // strips and fans share vertices between primitives, can't cut references out of them
+                    return nullptr;
+            }
+            osg::ref_ptr<osg::PrimitiveSet> filtered = shortIndices
+                ? filterPrimitiveSet<osg::DrawElementsUShort>(primitiveSet, primitiveSize, ranges)
+                : filterPrimitiveSet<osg::DrawElementsUInt>(primitiveSet, primitiveSize, ranges);
+            dataSize += filtered->getTotalDataSize();
+            copy->setPrimitiveSet(i, filtered);
+        }
+        return copy;
+    }
+
+    /// Copy-on-write the nodes of the chunk that are affected by the edits in [begin, end), which all share the path
+    /// to node up to depth. Unaffected subgraphs are shared with the original chunk.
+    osg::ref_ptr<osg::Node> patchNode(const osg::Node& node, std::size_t depth, ChunkEdits::const_iterator begin,
+        ChunkEdits::const_iterator end, std::size_t& dataSize)
+    {
+        if (begin->first.size() == depth)
+        {
+            // a reference owns either a whole node or vertex ranges of a geometry, never both
+            const VertexRanges& ranges = begin->second;
+            if (std::any_of(ranges.begin(), ranges.end(), [](const auto& range) { return range.second == 0; }))
+                return new osg::Group;
+            const osg::Geometry* geometry = node.asGeometry();
+            if (!geometry)
+                return nullptr;
+            return hideVertexRanges(*geometry, ranges, dataSize);
+        }
+
+        const osg::Group* group = node.asGroup();
+        if (!group)
+            return nullptr;
+        osg::ref_ptr<osg::Group> copy = osg::clone(group, osg::CopyOp::SHALLOW_COPY);
+        for (auto it = begin; it != end;)
+        {
+            const unsigned int childIndex = it->first[depth];
+            auto next = it;
+            while (next != end && next->first[depth] == childIndex)
+                ++next;
+            if (childIndex >= group->getNumChildren())
+                return nullptr;
+            osg::ref_ptr<osg::Node> child = patchNode(*group->getChild(childIndex), depth + 1, it, next, dataSize);
+            if (!child)
+                return nullptr;
+            copy->setChild(childIndex, child);
+            it = next;
+        }
+        return copy;
+    }
+
+    class DataSizeVisitor : public osg::NodeVisitor
+    {
+    public:
+        DataSizeVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+        {
+        }
+        void apply(osg::Geometry& geometry) override
+        {
+            for (const osg::Array* array : geometry.getVertexAttribArrayList())
+                if (array)
+                    mDataSize += array->getTotalDataSize();
+            for (const osg::Array* array : geometry.getTexCoordArrayList())
+                if (array)
+                    mDataSize += array->getTotalDataSize();
+            for (const osg::Array* array :
+                { geometry.getVertexArray(), geometry.getNormalArray(), geometry.getColorArray() })
+                if (array)
+                    mDataSize += array->getTotalDataSize();
+            for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+                mDataSize += geometry.getPrimitiveSet(i)->getTotalDataSize();
+        }
+        std::size_t mDataSize = 0;
+    };
+
     class AnalyzeVisitor : public osg::NodeVisitor
     {
     public:
@@ -556,6 +753,7 @@ namespace MWRender
         typedef std::map<osg::ref_ptr<const osg::Node>, InstanceList> NodeMap;
         NodeMap nodes;
         osg::ref_ptr<RefnumSet> refnumSet = activeGrid ? new RefnumSet : nullptr;
+        osg::ref_ptr<ChunkIndex> chunkIndex = new ChunkIndex;
 
         // Mask_UpdateVisitor is used in such cases in NIF loader:
         // 1. For collision nodes, which is not supposed to be rendered.
@@ -653,7 +851,10 @@ namespace MWRender
             {
                 std::lock_guard<std::mutex> lock(mRefTrackerMutex);
                 if (getRefTracker().mDisabled.count(pair.first))
+                {
+                    chunkIndex->mExcluded.insert(pair.first);
                     continue;
+                }
             }
 
             float radius2 = cnode->getBound().radius2() * ref.mScale * ref.mScale;
@@ -754,19 +955,16 @@ namespace MWRender
                 copyop.copy(cnode, trans);
                 copyop.mNodePath.pop_back();
 
-                if (activeGrid)
+                if (merge)
                 {
-                    if (merge)
-                    {
-                        AddRefnumMarkerVisitor visitor(ref.mRefNum);
-                        trans->accept(visitor);
-                    }
-                    else
-                    {
-                        osg::ref_ptr<RefnumMarker> marker = new RefnumMarker;
-                        marker->mRefnum = ref.mRefNum;
-                        trans->getOrCreateUserDataContainer()->addUserObject(marker);
-                    }
+                    AddRefnumMarkerVisitor visitor(ref.mRefNum);
+                    trans->accept(visitor);
+                }
+                else
+                {
+                    osg::ref_ptr<RefnumMarker> marker = new RefnumMarker;
+                    marker->mRefnum = ref.mRefNum;
+                    trans->getOrCreateUserDataContainer()->addUserObject(marker);
                 }
 
                 osg::Group* attachTo = merge ? mergeGroup : group;
@@ -799,6 +997,7 @@ namespace MWRender
                 optimizer.setMergeAlphaBlending(true);
             }
             optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+            optimizer.setWorkQueue(mSceneManager->getOptimizerWorkQueue());
             unsigned int options = SceneUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS
                 | SceneUtil::Optimizer::REMOVE_REDUNDANT_NODES | SceneUtil::Optimizer::MERGE_GEOMETRY;
 
@@ -816,6 +1015,10 @@ namespace MWRender
                 stateToCompile._mode = osgUtil::GLObjectsVisitor::COMPILE_DISPLAY_LISTS;
                 mergeGroup->accept(stateToCompile);
             }
+
+            DataSizeVisitor dataSizeVisitor;
+            mergeGroup->accept(dataSizeVisitor);
+            mChurnedDataSize += dataSizeVisitor.mDataSize;
         }
 
         auto ico = mSceneManager->getIncrementalCompileOperation();
@@ -839,6 +1042,10 @@ namespace MWRender
         }
         udc->addUserObject(templateRefs);
 
+        std::vector<unsigned int> path;
+        indexChunk(*group, path, *chunkIndex);
+        udc->addUserObject(chunkIndex);
+
         return group;
     }
 
@@ -896,11 +1103,7 @@ namespace MWRender
         ccf.mPosition = pos;
         ccf.mCell = cell;
         mCache->call(ccf);
-        if (ccf.mToClear.empty())
-            return false;
-        for (const auto& chunk : ccf.mToClear)
-            mCache->removeFromObjectCache(chunk);
-        return true;
+        return updateChunks(ccf.mToClear, refnum);
     }
 
     bool ObjectPaging::blacklistObject(
@@ -922,11 +1125,120 @@ namespace MWRender
         ccf.mCell = cell;
         ccf.mActiveGridOnly = true;
         mCache->call(ccf);
-        if (ccf.mToClear.empty())
-            return false;
-        for (const auto& chunk : ccf.mToClear)
-            mCache->removeFromObjectCache(chunk);
-        return true;
+        return updateChunks(ccf.mToClear, refnum);
+    }
+
+    bool ObjectPaging::updateChunks(const std::set<ChunkId>& chunks, const ESM::RefNum& refnum)
+    {
+        bool needsRebuild = false;
+        for (const auto& chunk : chunks)
+        {
+            osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(chunk);
+            if (!obj)
+                continue;
+            osg::ref_ptr<osg::Node> patched = patchChunk(static_cast<osg::Node&>(*obj), refnum);
+            if (patched.get() == obj.get())
+                continue;
+            if (patched)
+            {
+                mCache->addEntryToObjectCache(chunk, patched.get());
+                ++mNumPatches;
+            }
+            else
+                mCache->removeFromObjectCache(chunk);
+            needsRebuild = true;
+        }
+        return needsRebuild;
+    }
+
+    osg::ref_ptr<osg::Node> ObjectPaging::patchChunk(osg::Node& chunk, const ESM::RefNum& refnum)
+    {
+        osg::Node* original = &chunk;
+        const ChunkIndex* index = nullptr;
+        if (osg::UserDataContainer* udc = chunk.getUserDataContainer())
+        {
+            for (unsigned int i = 0; i < udc->getNumUserObjects(); ++i)
+            {
+                osg::Object* object = udc->getUserObject(i);
+                if (ChunkPatch* patch = dynamic_cast<ChunkPatch*>(object))
+                    original = patch->mOriginal.get();
+                else if (const ChunkIndex* found = dynamic_cast<const ChunkIndex*>(object))
+                    index = found;
+            }
+        }
+        if (!index)
+            return nullptr;
+
+        ChunkEdits edits;
+        std::vector<ESM::RefNum> blacklisted;
+        bool hidden = false;
+        {
+            std::lock_guard<std::mutex> lock(mRefTrackerMutex);
+            const RefTracker& refTracker = getRefTracker();
+            hidden = refTracker.mDisabled.count(refnum) || refTracker.mBlacklist.count(refnum);
+            if (index->mExcluded.count(refnum))
+            {
+                // a reference that was left out when the chunk was created can't be patched in
+                return hidden ? &chunk : nullptr;
+            }
+            if (!index->mRanges.count(refnum))
+                return &chunk;
+
+            const auto addEdits = [&](const std::set<ESM::RefNum>& refnums, bool blacklist) {
+                for (const ESM::RefNum& hiddenRefnum : refnums)
+                {
+                    auto found = index->mRanges.find(hiddenRefnum);
+                    if (found == index->mRanges.end())
+                        continue;
+                    for (const ChunkRefRange& range : found->second)
+                        edits[range.mPath].emplace_back(range.mFirstVertex, range.mNumVertices);
+                    if (blacklist)
+                        blacklisted.push_back(hiddenRefnum);
+                }
+            };
+            addEdits(refTracker.mDisabled, false);
+            addEdits(refTracker.mBlacklist, true);
+        }
+
+        if (edits.empty())
+            return original;
+
+        std::size_t dataSize = 0;
+        osg::ref_ptr<osg::Node> patched = patchNode(*original, 0, edits.begin(), edits.end(), dataSize);
+        if (!patched)
+            return nullptr;
+        mChurnedDataSize += dataSize;
+
+        osg::ref_ptr<osg::DefaultUserDataContainer> udc = new osg::DefaultUserDataContainer;
+        if (const osg::UserDataContainer* originalUdc = original->getUserDataContainer())
+        {
+            for (unsigned int i = 0; i < originalUdc->getNumUserObjects(); ++i)
+            {
+                osg::ref_ptr<osg::Object> object = const_cast<osg::Object*>(originalUdc->getUserObject(i));
+                if (const RefnumSet* refnumSet = dynamic_cast<const RefnumSet*>(object.get());
+                    refnumSet && !blacklisted.empty())
+                {
+                    // blacklisted references are no longer paged
+                    std::sort(blacklisted.begin(), blacklisted.end());
+                    osg::ref_ptr<RefnumSet> filtered = new RefnumSet;
+                    std::set_difference(refnumSet->mRefnums.begin(), refnumSet->mRefnums.end(), blacklisted.begin(),
+                        blacklisted.end(), std::back_inserter(filtered->mRefnums));
+                    object = filtered;
+                }
+                udc->addUserObject(object);
+            }
+        }
+        osg::ref_ptr<ChunkPatch> patch = new ChunkPatch;
+        patch->mOriginal = original;
+        udc->addUserObject(patch);
+        patched->setUserDataContainer(udc);
+
+        // the light list callback caches per-frame state, don't share it with the original chunk
+        if (dynamic_cast<SceneUtil::LightListCallback*>(patched->getCullCallback()))
+            patched->setCullCallback(new SceneUtil::LightListCallback);
+
+        patched->getBound();
+        return patched;
     }
 
     void ObjectPaging::clear()
@@ -994,6 +1306,9 @@ namespace MWRender
     void ObjectPaging::reportStats(unsigned int frameNumber, osg::Stats* stats) const
     {
         stats->setAttribute(frameNumber, "Object Chunk", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Object Chunk Rebuild", mNumRebuilds);
+        stats->setAttribute(frameNumber, "Object Chunk Patch", mNumPatches);
+        stats->setAttribute(frameNumber, "Object Chunk Churn", mChurnedDataSize / 1024);
     }
 
 }
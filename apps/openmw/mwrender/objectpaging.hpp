@@ -5,6 +5,7 @@
 #include <components/resource/resourcemanager.hpp>
 #include <components/terrain/quadtreeworld.hpp>
 
+#include <atomic>
 #include <mutex>
 
 namespace Resource
@@ -53,6 +54,14 @@ namespace MWRender
         void getPagedRefnums(const osg::Vec4i& activeGrid, std::vector<ESM::RefNum>& out);
 
     private:
+        /// Replace the given cached chunks by copies that hide or show the reference according to the ref tracker,
+        /// or remove them from the cache when they can't be patched.
+        /// @return true if view needs rebuild
+        bool updateChunks(const std::set<ChunkId>& chunks, const ESM::RefNum& refnum);
+
+        /// @return the patched chunk, the chunk itself if it is not affected, or nullptr if it needs a rebuild
+        osg::ref_ptr<osg::Node> patchChunk(osg::Node& chunk, const ESM::RefNum& refnum);
+
         Resource::SceneManager* mSceneManager;
         bool mActiveGrid;
         bool mDebugBatches;
@@ -86,6 +95,10 @@ namespace MWRender
         typedef std::pair<std::string, unsigned char> LODNameCacheKey; // Key: mesh name, lod level
         typedef std::map<LODNameCacheKey, std::string> LODNameCache; // Cache: key, mesh name to use
         LODNameCache mLODNameCache;
+
+        std::atomic<unsigned int> mNumRebuilds{ 0 };
+        std::atomic<unsigned int> mNumPatches{ 0 };
+        std::atomic<std::size_t> mChurnedDataSize{ 0 };
     };
 
     class RefnumMarker : public osg::Object
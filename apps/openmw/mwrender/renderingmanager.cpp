@@ -485,6 +485,8 @@ namespace MWRender
             mTerrain = std::make_unique<Terrain::QuadTreeWorld>(sceneRoot, mRootNode, mResourceSystem,
                 mTerrainStorage.get(), Mask_Terrain, Mask_PreCompile, Mask_Debug, compMapResolution, compMapLevel,
                 lodFactor, vertexLodMod, maxCompGeometrySize, debugChunks);
+            static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())
+                ->setTraversalThreads(std::max(0, Settings::Manager::getInt("traversal threads", "Terrain")));
             if (Settings::Manager::getBool("object paging", "Terrain"))
             {
                 mObjectPaging = std::make_unique<ObjectPaging>(mResourceSystem->getSceneManager());
@@ -497,6 +499,7 @@ namespace MWRender
                 mTerrainStorage.get(), Mask_Terrain, Mask_PreCompile, Mask_Debug);
 
         mTerrain->setTargetFrameRate(Settings::Manager::getFloat("target framerate", "Cells"));
+        mTerrain->setWorkQueue(mWorkQueue.get());
 
         if (groundcover)
         {
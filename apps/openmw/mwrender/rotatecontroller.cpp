@@ -2,6 +2,8 @@
 
 #include <osg/MatrixTransform>
 
+#include <components/sceneutil/skeleton.hpp>
+
 namespace MWRender
 {
 
@@ -28,7 +30,8 @@ namespace MWRender
 
     void RotateController::operator()(osg::MatrixTransform* node, osg::NodeVisitor* nv)
     {
-        if (!mEnabled)
+        // Applied on top of the keyframe animation, which doesn't reset the bone on skipped frames
+        if (!mEnabled || SceneUtil::Skeleton::isBoneUpdateSkipped())
         {
             traverse(node, nv);
             return;
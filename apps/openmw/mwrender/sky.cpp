@@ -1,5 +1,7 @@
 #include "sky.hpp"
 
+#include <chrono>
+
 #include <osg/Depth>
 #include <osg/PositionAttitudeTransform>
 
@@ -761,28 +763,38 @@ namespace MWRender
         if (mNextClouds != weather.mNextCloudTexture)
         {
             mNextClouds = weather.mNextCloudTexture;
+            mNextCloudImage = {};
 
             if (!mNextClouds.empty())
             {
                 std::string texture = Misc::ResourceHelpers::correctTexturePath(mNextClouds, mSceneManager->getVFS());
 
-                osg::ref_ptr<osg::Texture2D> cloudTex
-                    = new osg::Texture2D(mSceneManager->getImageManager()->getImage(texture));
-                cloudTex->setWrap(osg::Texture::WRAP_S, osg::Texture::REPEAT);
-                cloudTex->setWrap(osg::Texture::WRAP_T, osg::Texture::REPEAT);
-
-                mNextCloudUpdater->setTexture(cloudTex);
+                // A weather transition starts with transparent next clouds, there is time to load them in the
+                // background instead of stalling the frame
+                mNextCloudImage = mSceneManager->getImageManager()->requestImage(texture);
+                mNextCloudMesh->setNodeMask(0);
                 mNextStormDirection = weather.mStormDirection;
             }
         }
 
+        if (mNextCloudImage.valid() && mNextCloudImage.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            osg::ref_ptr<osg::Texture2D> cloudTex = new osg::Texture2D(mNextCloudImage.get());
+            cloudTex->setWrap(osg::Texture::WRAP_S, osg::Texture::REPEAT);
+            cloudTex->setWrap(osg::Texture::WRAP_T, osg::Texture::REPEAT);
+
+            mNextCloudUpdater->setTexture(cloudTex);
+            mNextCloudImage = {};
+            mNextCloudMesh->setNodeMask(mCloudBlendFactor > 0.f ? ~0u : 0);
+        }
+
         if (mCloudBlendFactor != weather.mCloudBlendFactor)
         {
             mCloudBlendFactor = std::clamp(weather.mCloudBlendFactor, 0.f, 1.f);
 
             mCloudUpdater->setOpacity(1.f - mCloudBlendFactor);
             mNextCloudUpdater->setOpacity(mCloudBlendFactor);
-            mNextCloudMesh->setNodeMask(mCloudBlendFactor > 0.f ? ~0u : 0);
+            mNextCloudMesh->setNodeMask(mCloudBlendFactor > 0.f && !mNextCloudImage.valid() ? ~0u : 0);
         }
 
         if (mCloudColour != weather.mFogColor)
@@ -1,6 +1,7 @@
 #ifndef OPENMW_MWRENDER_SKY_H
 #define OPENMW_MWRENDER_SKY_H
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -14,6 +15,7 @@
 namespace osg
 {
     class Group;
+    class Image;
     class Node;
     class Material;
     class PositionAttitudeTransform;
@@ -175,6 +177,8 @@ namespace MWRender
         // remember some settings so we don't have to apply them again if they didn't change
         std::string mClouds;
         std::string mNextClouds;
+        // Texture of the next clouds being loaded in the background, they are hidden until it's ready
+        std::shared_future<osg::ref_ptr<osg::Image>> mNextCloudImage;
         float mCloudBlendFactor;
         float mCloudSpeed;
         float mStarsOpacity;
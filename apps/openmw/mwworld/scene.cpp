@@ -202,6 +202,8 @@ namespace
 
         bool operator()(const MWWorld::Ptr& ptr);
 
+        void requestModels(Resource::SceneManager& sceneManager, const std::vector<ESM::RefNum>& pagedRefs) const;
+
         template <class AddObject>
         void insert(AddObject&& addObject);
     };
@@ -220,6 +222,25 @@ namespace
         return true;
     }
 
+    // Models missed by the preloader are converted on the work queue while the objects are inserted, instead of one
+    // after another on the main thread
+    void InsertVisitor::requestModels(
+        Resource::SceneManager& sceneManager, const std::vector<ESM::RefNum>& pagedRefs) const
+    {
+        for (const MWWorld::Ptr& ptr : mToInsert)
+        {
+            // Animated objects use a different model, see Objects::insertModel
+            if (ptr.getRefData().isDeleted() || !ptr.getRefData().isEnabled() || ptr.getClass().useAnim())
+                continue;
+            const ESM::RefNum& refnum = ptr.getCellRef().getRefNum();
+            if (refnum.hasContentFile() && std::binary_search(pagedRefs.begin(), pagedRefs.end(), refnum))
+                continue;
+            const std::string model = getModel(ptr);
+            if (!model.empty())
+                sceneManager.requestTemplate(model);
+        }
+    }
+
     template <class AddObject>
     void InsertVisitor::insert(AddObject&& addObject)
     {
@@ -955,6 +976,7 @@ namespace MWWorld
     {
         InsertVisitor insertVisitor(cell, loadingListener);
         cell.forEach(insertVisitor);
+        insertVisitor.requestModels(*mRendering.getResourceSystem()->getSceneManager(), mPagedRefs);
         insertVisitor.insert(
             [&](const MWWorld::Ptr& ptr) { addObject(ptr, mWorld, mPagedRefs, *mPhysics, mRendering); });
         insertVisitor.insert(
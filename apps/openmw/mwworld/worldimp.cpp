@@ -42,7 +42,11 @@
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/workqueue.hpp>
 
+#include <components/terrain/chunkdiskcache.hpp>
+#include <components/terrain/world.hpp>
+
 #include <components/detournavigator/agentbounds.hpp>
+#include <components/detournavigator/asyncpathfinder.hpp>
 #include <components/detournavigator/debug.hpp>
 #include <components/detournavigator/navigator.hpp>
 #include <components/detournavigator/navigatorimpl.hpp>
@@ -298,6 +302,8 @@ namespace MWWorld
             auto navigatorSettings = DetourNavigator::makeSettingsFromSettingsManager();
             navigatorSettings.mRecast.mSwimHeightScale = mSwimHeightScale;
             mNavigator = DetourNavigator::makeNavigator(navigatorSettings, userDataPath);
+            if (navigatorSettings.mAsyncPathFinderThreads > 0)
+                mAsyncPathFinder = std::make_unique<DetourNavigator::AsyncPathFinder>(navigatorSettings);
         }
         else
         {
@@ -306,6 +312,9 @@ namespace MWWorld
 
         mRendering = std::make_unique<MWRender::RenderingManager>(
             viewer, rootNode, resourceSystem, workQueue, *mNavigator, mGroundcoverStore, unrefQueue);
+        if (Settings::Manager::getBool("chunk disk cache", "Terrain"))
+            mRendering->getTerrain()->setChunkDiskCache(std::make_unique<Terrain::ChunkDiskCache>(
+                userDataPath / "terrain", Terrain::makeContentDigest(fileCollections, contentFiles)));
         mProjectileManager = std::make_unique<ProjectileManager>(
             mRendering->getLightRoot()->asGroup(), resourceSystem, mRendering.get(), mPhysics.get());
         mRendering->preloadCommonAssets();
@@ -3900,6 +3909,11 @@ namespace MWWorld
         return mNavigator.get();
     }
 
+    DetourNavigator::AsyncPathFinder* World::getAsyncPathFinder() const
+    {
+        return mAsyncPathFinder.get();
+    }
+
     void World::updateActorPath(const MWWorld::ConstPtr& actor, const std::deque<osg::Vec3f>& path,
         const DetourNavigator::AgentBounds& agentBounds, const osg::Vec3f& start, const osg::Vec3f& end) const
     {
@@ -3956,6 +3970,8 @@ namespace MWWorld
     void World::reportStats(unsigned int frameNumber, osg::Stats& stats) const
     {
         DetourNavigator::reportStats(mNavigator->getStats(), frameNumber, stats);
+        if (mAsyncPathFinder != nullptr)
+            DetourNavigator::reportStats(mAsyncPathFinder->takeStats(), frameNumber, stats);
         mPhysics->reportStats(frameNumber, stats);
     }
 
@@ -1,3 +1,4 @@
+#include "../testing_util.hpp"
 #include "settings.hpp"
 
 #include <components/detournavigator/asyncnavmeshupdater.hpp>
@@ -5,7 +6,9 @@
 #include <components/detournavigator/makenavmesh.hpp>
 #include <components/detournavigator/navmeshdbutils.hpp>
 #include <components/detournavigator/serialization.hpp>
+#include <components/files/conversion.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
+#include <components/sqlite3/db.hpp>
 
 #include <BulletCollision/CollisionShapes/btBoxShape.h>
 
@@ -13,8 +16,13 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <filesystem>
 #include <limits>
 #include <map>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace
 {
@@ -55,6 +63,28 @@ namespace
         const std::string mWorldspace = "sys::default";
         const btBoxShape mBox{ btVector3(100, 100, 20) };
         Loading::Listener mListener;
+
+        // Readers need a database file, in memory database can't be shared between connections
+        static std::string makeDbFilePath(const std::string& name)
+        {
+            const std::filesystem::path path = TestingOpenMW::outputFilePath(name);
+            for (const char* suffix : { "", "-wal", "-shm" })
+                std::filesystem::remove(path.string() + suffix);
+            return Files::pathToUnicodeString(path);
+        }
+
+        bool hasTile(NavMeshDb& db, const TilePosition& tilePosition)
+        {
+            const auto recastMesh = mRecastMeshManager.getMesh(mWorldspace, tilePosition);
+            if (recastMesh == nullptr)
+                return false;
+            const std::optional<std::vector<DbRefGeometryObject>> objects = makeDbRefGeometryObjects(
+                recastMesh->getMeshSources(), [&](const MeshSource& v) { return resolveMeshSource(db, v); });
+            if (!objects.has_value())
+                return false;
+            const std::vector<std::byte> input = serialize(mSettings.mRecast, mAgentBounds, *recastMesh, *objects);
+            return db.findTile(mWorldspace, tilePosition, input).has_value();
+        }
     };
 
     TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, for_all_jobs_done_when_empty_wait_should_terminate)
@@ -127,6 +157,31 @@ namespace
         }
     }
 
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, repeated_post_for_unchanged_tile_should_skip_rebuild)
+    {
+        mRecastMeshManager.setWorldspace(mWorldspace, nullptr);
+        addHeightFieldPlane(mRecastMeshManager);
+        AsyncNavMeshUpdater updater(mSettings, mRecastMeshManager, mOffMeshConnectionsManager, nullptr);
+        const auto navMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(1, mSettings);
+        const std::map<TilePosition, ChangeType> changedTiles{ { TilePosition{ 0, 0 }, ChangeType::update } };
+        updater.post(mAgentBounds, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+        updater.wait(WaitConditionType::allJobsDone, &mListener);
+        {
+            const auto stats = updater.getStats();
+            ASSERT_EQ(stats.mPerformedRebuilds, 1);
+            ASSERT_EQ(stats.mSkippedRebuilds, 0);
+        }
+        const auto version = navMeshCacheItem->lockConst()->getVersion();
+        updater.post(mAgentBounds, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+        updater.wait(WaitConditionType::allJobsDone, &mListener);
+        {
+            const auto stats = updater.getStats();
+            EXPECT_EQ(stats.mPerformedRebuilds, 1);
+            EXPECT_EQ(stats.mSkippedRebuilds, 1);
+        }
+        EXPECT_EQ(navMeshCacheItem->lockConst()->getVersion(), version);
+    }
+
     TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, post_should_write_generated_tile_to_db)
     {
         mRecastMeshManager.setWorldspace(mWorldspace, nullptr);
@@ -153,6 +208,30 @@ namespace
         EXPECT_EQ(tile->mVersion, navMeshFormatVersion);
     }
 
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, post_should_report_written_tiles)
+    {
+        mRecastMeshManager.setWorldspace(mWorldspace, nullptr);
+        addHeightFieldPlane(mRecastMeshManager);
+        addObject(mBox, mRecastMeshManager);
+        auto db = std::make_unique<NavMeshDb>(":memory:", std::numeric_limits<std::uint64_t>::max());
+        AsyncNavMeshUpdater updater(mSettings, mRecastMeshManager, mOffMeshConnectionsManager, std::move(db));
+        const auto navMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(1, mSettings);
+        const std::map<TilePosition, ChangeType> changedTiles{
+            { TilePosition{ 0, 0 }, ChangeType::add },
+            { TilePosition{ 0, 1 }, ChangeType::add },
+            { TilePosition{ 1, 0 }, ChangeType::add },
+            { TilePosition{ 1, 1 }, ChangeType::add },
+        };
+        updater.post(mAgentBounds, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+        updater.wait(WaitConditionType::allJobsDone, &mListener);
+        updater.stop();
+        const auto stats = updater.getStats();
+        ASSERT_TRUE(stats.mDb.has_value());
+        EXPECT_EQ(stats.mDb->mWrittenTiles, changedTiles.size());
+        EXPECT_GE(stats.mDb->mWriteTransactions, 1);
+        EXPECT_LE(stats.mDb->mWriteTransactions, changedTiles.size());
+    }
+
     TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, post_when_writing_to_db_disabled_should_not_write_tiles)
     {
         mRecastMeshManager.setWorldspace(mWorldspace, nullptr);
@@ -257,6 +336,9 @@ namespace
         addObject(mBox, mRecastMeshManager);
         auto db = std::make_unique<NavMeshDb>(":memory:", 4097);
         NavMeshDb* const dbPtr = db.get();
+        // A failed job is dropped alone but the limit may also be reached on commit discarding the whole batch, write
+        // tiles one by one to get deterministic result
+        mSettings.mNavMeshDbWriteBatchSize = 1;
         AsyncNavMeshUpdater updater(mSettings, mRecastMeshManager, mOffMeshConnectionsManager, std::move(db));
         const auto navMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(1, mSettings);
         std::map<TilePosition, ChangeType> changedTiles;
@@ -298,4 +380,80 @@ namespace
                     << " present=" << (present.find(tilePosition) != present.end());
             }
     }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, failed_writing_job_should_not_prevent_writing_other_tiles_of_batch)
+    {
+        mRecastMeshManager.setWorldspace(mWorldspace, nullptr);
+        for (int x = 0; x <= 1; ++x)
+            for (int y = 0; y <= 1; ++y)
+                addHeightFieldPlane(mRecastMeshManager, osg::Vec2i(x, y));
+        addObject(mBox, mRecastMeshManager);
+        const std::string path = makeDbFilePath("navmeshdb_failed_writing_job.sqlite3");
+        auto db = std::make_unique<NavMeshDb>(path, std::numeric_limits<std::uint64_t>::max());
+        const TilePosition failingTile(1, 0);
+        Sqlite3::makeDb(path,
+            "CREATE TRIGGER fail_tile_insert BEFORE INSERT ON tiles "
+            "WHEN NEW.tile_position_x = 1 AND NEW.tile_position_y = 0 "
+            "BEGIN SELECT RAISE(ABORT, 'test failure'); END");
+        AsyncNavMeshUpdater updater(mSettings, mRecastMeshManager, mOffMeshConnectionsManager, std::move(db));
+        const auto navMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(1, mSettings);
+        const std::map<TilePosition, ChangeType> changedTiles{
+            { TilePosition{ 0, 0 }, ChangeType::add },
+            { TilePosition{ 0, 1 }, ChangeType::add },
+            { failingTile, ChangeType::add },
+            { TilePosition{ 1, 1 }, ChangeType::add },
+        };
+        updater.post(mAgentBounds, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+        updater.wait(WaitConditionType::allJobsDone, &mListener);
+        updater.stop();
+        const auto stats = updater.getStats();
+        ASSERT_TRUE(stats.mDb.has_value());
+        EXPECT_EQ(stats.mDb->mWrittenTiles, changedTiles.size() - 1);
+        NavMeshDb check(path, std::numeric_limits<std::uint64_t>::max());
+        for (const auto& [tilePosition, changeType] : changedTiles)
+            EXPECT_EQ(hasTile(check, tilePosition), tilePosition != failingTile)
+                << tilePosition.x() << " " << tilePosition.y();
+    }
+
+    TEST_F(DetourNavigatorAsyncNavMeshUpdaterTest, post_should_read_tiles_from_db_file_with_multiple_readers)
+    {
+        mRecastMeshManager.setWorldspace(mWorldspace, nullptr);
+        std::map<TilePosition, ChangeType> changedTiles;
+        for (int x = -1; x <= 1; ++x)
+            for (int y = -1; y <= 1; ++y)
+            {
+                addHeightFieldPlane(mRecastMeshManager, osg::Vec2i(x, y));
+                changedTiles.emplace(TilePosition{ x, y }, ChangeType::add);
+            }
+        addObject(mBox, mRecastMeshManager);
+        const std::string path = makeDbFilePath("navmeshdb_multiple_readers.sqlite3");
+        mSettings.mMaxNavMeshTilesCacheSize = 0;
+        mSettings.mNavMeshDbReaderThreads = 3;
+        {
+            AsyncNavMeshUpdater updater(mSettings, mRecastMeshManager, mOffMeshConnectionsManager,
+                std::make_unique<NavMeshDb>(path, std::numeric_limits<std::uint64_t>::max()));
+            const auto navMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(1, mSettings);
+            updater.post(mAgentBounds, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+            updater.wait(WaitConditionType::allJobsDone, &mListener);
+            updater.stop();
+            const auto stats = updater.getStats();
+            ASSERT_TRUE(stats.mDb.has_value());
+            ASSERT_EQ(stats.mDb->mWrittenTiles, changedTiles.size());
+        }
+        AsyncNavMeshUpdater updater(mSettings, mRecastMeshManager, mOffMeshConnectionsManager,
+            std::make_unique<NavMeshDb>(path, std::numeric_limits<std::uint64_t>::max()));
+        const auto navMeshCacheItem = std::make_shared<GuardedNavMeshCacheItem>(1, mSettings);
+        updater.post(mAgentBounds, navMeshCacheItem, mPlayerTile, mWorldspace, changedTiles);
+        updater.wait(WaitConditionType::allJobsDone, &mListener);
+        updater.stop();
+        const auto stats = updater.getStats();
+        ASSERT_TRUE(stats.mDb.has_value());
+        EXPECT_EQ(stats.mDb->mGetTileCount, changedTiles.size());
+        EXPECT_EQ(stats.mDbGetTileHits, changedTiles.size());
+        EXPECT_EQ(stats.mDb->mWrittenTiles, 0);
+        const auto navMesh = navMeshCacheItem->lockConst();
+        for (const auto& [tilePosition, changeType] : changedTiles)
+            EXPECT_NE(navMesh->getImpl().getTileRefAt(tilePosition.x(), tilePosition.y(), 0), 0u)
+                << tilePosition.x() << " " << tilePosition.y();
+    }
 }
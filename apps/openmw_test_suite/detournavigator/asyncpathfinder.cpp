@@ -0,0 +1,142 @@
+#include "operators.hpp"
+#include "settings.hpp"
+
+#include <components/detournavigator/asyncpathfinder.hpp>
+#include <components/detournavigator/navigatorimpl.hpp>
+#include <components/detournavigator/navigatorutils.hpp>
+#include <components/esm3/loadland.hpp>
+#include <components/loadinglistener/loadinglistener.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+    using namespace DetourNavigator::Tests;
+
+    struct DetourNavigatorAsyncPathFinderTest : Test
+    {
+        Settings mSettings = makeSettings();
+        std::unique_ptr<Navigator> mNavigator;
+        const AgentBounds mAgentBounds{ CollisionShapeType::Aabb, { 29, 29, 66 } };
+        const PathQuery mQuery{
+            .mAgentBounds = mAgentBounds,
+            .mStepSize = 28.333332061767578125f,
+            .mStart = osg::Vec3f(52, 460, 1),
+            .mEnd = osg::Vec3f(460, 52, 1),
+            .mIncludeFlags = Flag_walk,
+            .mAreaCosts = AreaCosts{},
+            .mEndTolerance = 0,
+        };
+        Loading::Listener mListener;
+
+        DetourNavigatorAsyncPathFinderTest()
+            : mNavigator(std::make_unique<NavigatorImpl>(mSettings, nullptr))
+        {
+        }
+
+        void addFlatHeightfield()
+        {
+            const int heightfieldTileSize = ESM::Land::REAL_SIZE / (ESM::Land::LAND_SIZE - 1);
+            ASSERT_TRUE(mNavigator->addAgent(mAgentBounds));
+            mNavigator->addHeightfield(osg::Vec2i(0, 0), heightfieldTileSize * 4, HeightfieldPlane{ 100 }, nullptr);
+            mNavigator->update(osg::Vec3f(256, 256, 0), nullptr);
+            mNavigator->wait(WaitConditionType::allJobsDone, &mListener);
+        }
+
+        std::vector<osg::Vec3f> findPathSync()
+        {
+            std::vector<osg::Vec3f> result;
+            findPath(*mNavigator, mQuery.mAgentBounds, mQuery.mStepSize, mQuery.mStart, mQuery.mEnd,
+                mQuery.mIncludeFlags, mQuery.mAreaCosts, mQuery.mEndTolerance, std::back_inserter(result));
+            return result;
+        }
+    };
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, post_should_return_nullptr_when_there_is_no_navmesh)
+    {
+        AsyncPathFinder pathFinder(mSettings);
+        EXPECT_EQ(pathFinder.post(*mNavigator, mQuery), nullptr);
+    }
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, get_result_should_provide_same_path_as_find_path)
+    {
+        addFlatHeightfield();
+        AsyncPathFinder pathFinder(mSettings);
+        const SharedPathQueryJob job = pathFinder.post(*mNavigator, mQuery);
+        ASSERT_NE(job, nullptr);
+        const PathQueryResult* result = nullptr;
+        while ((result = pathFinder.getResult(*job)) == nullptr)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_EQ(result->mStatus, Status::Success);
+        EXPECT_EQ(result->mPath, findPathSync()) << result->mPath;
+        EXPECT_EQ(pathFinder.takeStats().mProcessed, 1);
+    }
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, without_threads_get_result_should_find_path_by_caller)
+    {
+        addFlatHeightfield();
+        mSettings.mAsyncPathFinderThreads = 0;
+        AsyncPathFinder pathFinder(mSettings);
+        const SharedPathQueryJob job = pathFinder.post(*mNavigator, mQuery);
+        ASSERT_NE(job, nullptr);
+        const PathQueryResult* const result = pathFinder.getResult(*job);
+        ASSERT_NE(result, nullptr);
+        EXPECT_EQ(result->mStatus, Status::Success);
+        EXPECT_EQ(result->mPath, findPathSync()) << result->mPath;
+        const AsyncPathFinderStats stats = pathFinder.takeStats();
+        EXPECT_EQ(stats.mProcessed, 1);
+        EXPECT_EQ(stats.mProcessedByCaller, 1);
+    }
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, identical_waiting_queries_should_share_job)
+    {
+        addFlatHeightfield();
+        mSettings.mAsyncPathFinderThreads = 0;
+        AsyncPathFinder pathFinder(mSettings);
+        const SharedPathQueryJob first = pathFinder.post(*mNavigator, mQuery);
+        const SharedPathQueryJob second = pathFinder.post(*mNavigator, mQuery);
+        ASSERT_NE(first, nullptr);
+        EXPECT_EQ(first, second);
+        ASSERT_NE(pathFinder.getResult(*first), nullptr);
+        const AsyncPathFinderStats stats = pathFinder.takeStats();
+        EXPECT_EQ(stats.mPosted, 2);
+        EXPECT_EQ(stats.mDeduplicated, 1);
+        EXPECT_EQ(stats.mProcessed, 1);
+    }
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, processed_query_should_not_be_shared_with_new_one)
+    {
+        addFlatHeightfield();
+        mSettings.mAsyncPathFinderThreads = 0;
+        AsyncPathFinder pathFinder(mSettings);
+        const SharedPathQueryJob first = pathFinder.post(*mNavigator, mQuery);
+        ASSERT_NE(first, nullptr);
+        ASSERT_NE(pathFinder.getResult(*first), nullptr);
+        const SharedPathQueryJob second = pathFinder.post(*mNavigator, mQuery);
+        EXPECT_NE(first, second);
+    }
+
+    TEST_F(DetourNavigatorAsyncPathFinderTest, take_stats_should_reset_counters)
+    {
+        addFlatHeightfield();
+        mSettings.mAsyncPathFinderThreads = 0;
+        AsyncPathFinder pathFinder(mSettings);
+        const SharedPathQueryJob job = pathFinder.post(*mNavigator, mQuery);
+        ASSERT_NE(job, nullptr);
+        ASSERT_NE(pathFinder.getResult(*job), nullptr);
+        const AsyncPathFinderStats stats = pathFinder.takeStats();
+        EXPECT_EQ(std::accumulate(stats.mLatency.begin(), stats.mLatency.end(), std::size_t{ 0 }), 1);
+        const AsyncPathFinderStats next = pathFinder.takeStats();
+        EXPECT_EQ(next.mPosted, 0);
+        EXPECT_EQ(next.mProcessed, 0);
+    }
+}
@@ -1095,6 +1095,42 @@ namespace
             << mPath;
     }
 
+    TEST_F(DetourNavigatorNavigatorTest, find_path_to_far_destination_should_use_tile_graph)
+    {
+        // Too few nodes to find the whole path over polygons at once but enough for the parts between a few portals
+        mSettings.mDetour.mMaxNavMeshQueryNodes = 64;
+
+        const HeightfieldPlane plane{ 100 };
+        const int cellSize = mHeightfieldTileSize * 64;
+        const osg::Vec3f playerPosition(cellSize / 2, cellSize / 2, 0);
+        const osg::Vec3f start(256, 256, 101);
+        const osg::Vec3f end(cellSize - 256, cellSize - 256, 101);
+
+        const auto findFarPath = [&](int hierarchicalPathTileDistance) {
+            mSettings.mDetour.mHierarchicalPathTileDistance = hierarchicalPathTileDistance;
+            mNavigator.reset(new NavigatorImpl(mSettings, nullptr));
+            mPath.clear();
+            EXPECT_TRUE(mNavigator->addAgent(mAgentBounds));
+            mNavigator->addHeightfield(mCellPosition, cellSize, plane, nullptr);
+            mNavigator->update(playerPosition, nullptr);
+            mNavigator->wait(WaitConditionType::allJobsDone, &mListener);
+            return findPath(
+                *mNavigator, mAgentBounds, mStepSize, start, end, Flag_walk, mAreaCosts, mEndTolerance, mOut);
+        };
+
+        EXPECT_EQ(findFarPath(0), Status::PartialPath);
+        ASSERT_FALSE(mPath.empty());
+        EXPECT_GT((mPath.back() - end).length(), 2) << mPath;
+
+        EXPECT_EQ(findFarPath(2), Status::Success);
+        const auto navMesh = mNavigator->getNavMesh(mAgentBounds);
+        ASSERT_NE(navMesh, nullptr);
+        EXPECT_GT(navMesh->lockConst()->getTileGraph().getTilesCount(), 1);
+        ASSERT_FALSE(mPath.empty());
+        EXPECT_LT((mPath.front() - start).length(), 2) << mPath;
+        EXPECT_LT((mPath.back() - end).length(), 2) << mPath;
+    }
+
     TEST_F(DetourNavigatorNavigatorTest, for_not_reachable_destination_find_path_should_provide_partial_path)
     {
         const std::array<float, 5 * 5> heightfieldData{ {
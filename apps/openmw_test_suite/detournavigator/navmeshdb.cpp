@@ -168,6 +168,50 @@ namespace
                     << "x=" << x << " y=" << y;
     }
 
+    TEST_F(DetourNavigatorNavMeshDbTest, get_tiles_should_return_tiles_after_given_id_ordered_by_id)
+    {
+        const TileVersion version{ 1 };
+        const Tile tile5 = insertTile(TileId{ 5 }, version);
+        insertTile(TileId{ 2 }, version);
+        const Tile tile9 = insertTile(TileId{ 9 }, version);
+        const std::vector<TileRecord> result = mDb.getTiles(TileId{ 2 }, 10);
+        ASSERT_EQ(result.size(), 2);
+        EXPECT_EQ(result[0].mTileId, TileId{ 5 });
+        EXPECT_EQ(result[0].mWorldspace, tile5.mWorldspace);
+        EXPECT_EQ(result[0].mTilePosition, tile5.mTilePosition);
+        EXPECT_EQ(result[0].mVersion, version);
+        EXPECT_EQ(result[0].mInput, tile5.mInput);
+        EXPECT_EQ(result[0].mData, tile5.mData);
+        EXPECT_EQ(result[1].mTileId, TileId{ 9 });
+        EXPECT_EQ(result[1].mData, tile9.mData);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, get_tiles_should_return_not_more_than_given_number_of_tiles)
+    {
+        for (std::int64_t i = 1; i <= 5; ++i)
+            insertTile(TileId{ i }, TileVersion{ 1 });
+        const std::vector<TileRecord> result = mDb.getTiles(TileId{ 0 }, 3);
+        ASSERT_EQ(result.size(), 3);
+        EXPECT_EQ(result.back().mTileId, TileId{ 3 });
+    }
+
+    TEST_F(DetourNavigatorNavMeshDbTest, get_shapes_should_return_inserted_shapes)
+    {
+        const std::string hash = "hash";
+        const Sqlite3::ConstBlob hashData{ hash.data(), static_cast<int>(hash.size()) };
+        ASSERT_EQ(mDb.insertShape(ShapeId{ 3 }, "mesh.nif", ShapeType::Avoid, hashData), 1);
+        ASSERT_EQ(mDb.insertShape(ShapeId{ 1 }, "mesh.nif", ShapeType::Collision, hashData), 1);
+        const std::vector<ShapeRecord> result = mDb.getShapes();
+        ASSERT_EQ(result.size(), 2);
+        EXPECT_EQ(result[0].mShapeId, ShapeId{ 1 });
+        EXPECT_EQ(result[0].mName, "mesh.nif");
+        EXPECT_EQ(result[0].mType, ShapeType::Collision);
+        EXPECT_EQ(result[0].mHash, std::vector<std::byte>(reinterpret_cast<const std::byte*>(hash.data()),
+                                       reinterpret_cast<const std::byte*>(hash.data()) + hash.size()));
+        EXPECT_EQ(result[1].mShapeId, ShapeId{ 3 });
+        EXPECT_EQ(result[1].mType, ShapeType::Avoid);
+    }
+
     TEST_F(DetourNavigatorNavMeshDbTest, should_support_file_size_limit)
     {
         mDb = NavMeshDb(":memory:", 4096);
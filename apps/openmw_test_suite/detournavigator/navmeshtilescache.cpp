@@ -162,6 +162,30 @@ namespace
         EXPECT_EQ(result.get(), *copy);
     }
 
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_from_cache_with_multiple_shards_should_return_cached_value)
+    {
+        const std::size_t shards = 4;
+        const std::size_t maxSize = shards * (mRecastMeshSize + mPreparedNavMeshDataSize);
+        NavMeshTilesCache cache(maxSize, shards);
+        const auto copy = clone(*mPreparedNavMeshData);
+
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        const auto result = cache.get(mAgentBounds, mTilePosition, mRecastMesh);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(result.get(), *copy);
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_should_ignore_recast_mesh_version)
+    {
+        const std::size_t maxSize = mRecastMeshSize + mPreparedNavMeshDataSize;
+        NavMeshTilesCache cache(maxSize);
+        const Version otherVersion{ mVersion.mGeneration + 1, mVersion.mRevision + 1 };
+        const RecastMesh sameRecastMesh(otherVersion, mMesh, mWater, mHeightfields, mFlatHeightfields, mSources);
+
+        cache.set(mAgentBounds, mTilePosition, mRecastMesh, std::move(mPreparedNavMeshData));
+        EXPECT_TRUE(cache.get(mAgentBounds, mTilePosition, sameRecastMesh));
+    }
+
     TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_for_cache_miss_by_agent_half_extents_should_return_empty_value)
     {
         const std::size_t maxSize = 1;
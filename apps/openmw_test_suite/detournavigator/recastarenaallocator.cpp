@@ -0,0 +1,75 @@
+#include <components/detournavigator/recastarenaallocator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorRecastArenaAllocatorTest : Test
+    {
+        RecastArenaAllocator mAllocator{ 1024 };
+    };
+
+    TEST_F(DetourNavigatorRecastArenaAllocatorTest, alloc_should_return_aligned_tagged_memory)
+    {
+        void* const ptr = mAllocator.alloc(3);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignof(std::max_align_t), 0);
+        EXPECT_EQ(getDataPtrBufferType(ptr), BufferType_arena);
+        void* const next = mAllocator.alloc(3);
+        ASSERT_NE(next, nullptr);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(next) % alignof(std::max_align_t), 0);
+        EXPECT_NE(next, ptr);
+    }
+
+    TEST_F(DetourNavigatorRecastArenaAllocatorTest, alloc_should_use_single_chunk_while_it_has_space)
+    {
+        for (int i = 0; i < 8; ++i)
+            std::memset(mAllocator.alloc(16), 0xff, 16);
+        EXPECT_EQ(mAllocator.getAllocations(), 8);
+        EXPECT_EQ(mAllocator.getChunkAllocations(), 1);
+        EXPECT_EQ(mAllocator.getCapacity(), 1024);
+    }
+
+    TEST_F(DetourNavigatorRecastArenaAllocatorTest, alloc_should_support_size_greater_than_chunk_size)
+    {
+        void* const ptr = mAllocator.alloc(4096);
+        ASSERT_NE(ptr, nullptr);
+        std::memset(ptr, 0xff, 4096);
+        EXPECT_GE(mAllocator.getCapacity(), 4096);
+    }
+
+    TEST_F(DetourNavigatorRecastArenaAllocatorTest, reset_should_reuse_memory)
+    {
+        void* const ptr = mAllocator.alloc(16);
+        mAllocator.reset();
+        EXPECT_EQ(mAllocator.alloc(16), ptr);
+        EXPECT_EQ(mAllocator.getChunkAllocations(), 1);
+    }
+
+    TEST_F(DetourNavigatorRecastArenaAllocatorTest, reset_should_replace_chunks_by_one_of_high_water_mark_size)
+    {
+        for (int i = 0; i < 4; ++i)
+            mAllocator.alloc(1000);
+        ASSERT_GT(mAllocator.getChunkAllocations(), 1);
+        const std::size_t highWaterMark = mAllocator.getHighWaterMark();
+        mAllocator.reset();
+        EXPECT_EQ(mAllocator.getCapacity(), highWaterMark);
+        const std::size_t chunkAllocations = mAllocator.getChunkAllocations();
+        for (int i = 0; i < 4; ++i)
+            mAllocator.alloc(1000);
+        EXPECT_EQ(mAllocator.getChunkAllocations(), chunkAllocations);
+    }
+
+    TEST_F(DetourNavigatorRecastArenaAllocatorTest, reset_should_deactivate)
+    {
+        mAllocator.setActive(true);
+        mAllocator.reset();
+        EXPECT_FALSE(mAllocator.isActive());
+    }
+}
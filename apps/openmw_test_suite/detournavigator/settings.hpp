@@ -41,7 +41,12 @@ namespace DetourNavigator
             result.mDetour.mMaxPolys = 4096;
             result.mMaxTilesNumber = 512;
             result.mMinUpdateInterval = std::chrono::milliseconds(50);
+            result.mUpdateCoalescingWindow = std::chrono::milliseconds(0);
             result.mWriteToNavMeshDb = true;
+            result.mNavMeshDbReaderThreads = 1;
+            result.mNavMeshDbWriteBatchSize = 16;
+            result.mAsyncPathFinderThreads = 1;
+            result.mMaxPathQueryLatency = std::chrono::milliseconds(1000);
             return result;
         }
     }
@@ -0,0 +1,140 @@
+#include "operators.hpp"
+#include "settings.hpp"
+
+#include <components/detournavigator/navigatorimpl.hpp>
+#include <components/detournavigator/tilegraph.hpp>
+#include <components/esm3/loadland.hpp>
+#include <components/loadinglistener/loadinglistener.hpp>
+
+#include <DetourNavMesh.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+    using namespace DetourNavigator::Tests;
+
+    struct DetourNavigatorTileGraphTest : Test
+    {
+        Settings mSettings = makeSettings();
+        std::unique_ptr<Navigator> mNavigator;
+        const AgentBounds mAgentBounds{ CollisionShapeType::Aabb, { 29, 29, 66 } };
+        Loading::Listener mListener;
+        const osg::Vec2i mCellPosition{ 0, 0 };
+        const int mCellSize = ESM::Land::REAL_SIZE;
+        const osg::Vec3f mPlayerPosition{ ESM::Land::REAL_SIZE / 2, ESM::Land::REAL_SIZE / 2, 0 };
+        // Tile fully covered by the heightfield, so it has all the side neighbours
+        const TilePosition mInnerTile{ 5, 5 };
+
+        DetourNavigatorTileGraphTest() { mSettings.mDetour.mHierarchicalPathTileDistance = 2; }
+
+        void build()
+        {
+            mNavigator.reset(new NavigatorImpl(mSettings, nullptr));
+            ASSERT_TRUE(mNavigator->addAgent(mAgentBounds));
+            mNavigator->addHeightfield(mCellPosition, mCellSize, HeightfieldPlane{ 100 }, nullptr);
+            update();
+        }
+
+        void update()
+        {
+            mNavigator->update(mPlayerPosition, nullptr);
+            mNavigator->wait(WaitConditionType::allJobsDone, &mListener);
+        }
+
+        std::size_t getNumNavMeshTiles() const
+        {
+            const auto navMesh = mNavigator->getNavMesh(mAgentBounds)->lockConst();
+            std::size_t result = 0;
+            for (int i = 0; i < navMesh->getImpl().getMaxTiles(); ++i)
+            {
+                const dtMeshTile* const tile = navMesh->getImpl().getTile(i);
+                if (tile != nullptr && tile->header != nullptr)
+                    ++result;
+            }
+            return result;
+        }
+
+        template <class Function>
+        auto withTileGraph(Function&& function) const
+        {
+            const auto navMesh = mNavigator->getNavMesh(mAgentBounds)->lockConst();
+            return function(navMesh->getTileGraph());
+        }
+    };
+
+    TEST_F(DetourNavigatorTileGraphTest, should_have_each_navmesh_tile)
+    {
+        build();
+        const std::size_t numNavMeshTiles = getNumNavMeshTiles();
+        ASSERT_GT(numNavMeshTiles, 1);
+        EXPECT_EQ(withTileGraph([](const TileGraph& graph) { return graph.getTilesCount(); }), numNavMeshTiles);
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, should_connect_tile_to_side_neighbours)
+    {
+        build();
+        withTileGraph([&](const TileGraph& graph) {
+            const std::vector<TilePortal>* const portals = graph.getPortals(mInnerTile);
+            ASSERT_NE(portals, nullptr);
+            std::vector<TilePosition> neighbours;
+            for (const TilePortal& portal : *portals)
+                neighbours.push_back(portal.mNeighbour);
+            EXPECT_THAT(neighbours,
+                UnorderedElementsAre(mInnerTile + TilePosition(-1, 0), mInnerTile + TilePosition(1, 0),
+                    mInnerTile + TilePosition(0, -1), mInnerTile + TilePosition(0, 1)));
+        });
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, find_path_to_same_tile_should_return_no_portals)
+    {
+        build();
+        const std::optional<std::vector<osg::Vec3f>> portals
+            = withTileGraph([&](const TileGraph& graph) { return graph.findPath(mInnerTile, mInnerTile); });
+        ASSERT_TRUE(portals.has_value());
+        EXPECT_THAT(*portals, IsEmpty());
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, find_path_should_return_portal_for_each_crossed_tile_border)
+    {
+        build();
+        const TilePosition start(2, 3);
+        const TilePosition end(5, 7);
+        const std::optional<std::vector<osg::Vec3f>> portals
+            = withTileGraph([&](const TileGraph& graph) { return graph.findPath(start, end); });
+        ASSERT_TRUE(portals.has_value());
+        EXPECT_EQ(portals->size(), 7);
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, find_path_to_tile_without_navmesh_should_return_nullopt)
+    {
+        build();
+        const std::optional<std::vector<osg::Vec3f>> portals = withTileGraph(
+            [&](const TileGraph& graph) { return graph.findPath(mInnerTile, TilePosition(-5, -5)); });
+        EXPECT_FALSE(portals.has_value());
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, should_remove_tiles_removed_from_navmesh)
+    {
+        build();
+        mNavigator->removeHeightfield(mCellPosition, nullptr);
+        update();
+        EXPECT_EQ(getNumNavMeshTiles(), 0);
+        EXPECT_EQ(withTileGraph([](const TileGraph& graph) { return graph.getTilesCount(); }), 0);
+    }
+
+    TEST_F(DetourNavigatorTileGraphTest, should_not_be_updated_when_hierarchical_path_finding_is_disabled)
+    {
+        mSettings.mDetour.mHierarchicalPathTileDistance = 0;
+        build();
+        ASSERT_GT(getNumNavMeshTiles(), 1);
+        EXPECT_EQ(withTileGraph([](const TileGraph& graph) { return graph.getTilesCount(); }), 0);
+    }
+}
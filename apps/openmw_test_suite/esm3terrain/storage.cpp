@@ -0,0 +1,396 @@
+#include "../testing_util.hpp"
+
+#include <components/esm3/loadland.hpp>
+#include <components/esm3/loadltex.hpp>
+#include <components/esm3terrain/storage.hpp>
+#include <components/misc/constants.hpp>
+#include <components/vfs/manager.hpp>
+
+#include <osg/Array>
+#include <osg/Image>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+
+    class TestStorage final : public ESMTerrain::Storage
+    {
+    public:
+        explicit TestStorage(const VFS::Manager* vfs)
+            : ESMTerrain::Storage(vfs)
+        {
+        }
+
+        // Land texture of each vtex is chosen by the function of the texel coordinates
+        template <class F>
+        void addLand(int cellX, int cellY, F&& getTexture)
+        {
+            std::unique_ptr<ESM::Land>& land = mLands[std::pair(cellX, cellY)];
+            land = std::make_unique<ESM::Land>();
+            land->mX = cellX;
+            land->mY = cellY;
+            land->blank();
+            for (int y = 0; y < ESM::Land::LAND_TEXTURE_SIZE; ++y)
+                for (int x = 0; x < ESM::Land::LAND_TEXTURE_SIZE; ++x)
+                    land->getLandData()->mTextures[y * ESM::Land::LAND_TEXTURE_SIZE + x]
+                        = static_cast<std::uint16_t>(getTexture(x, y));
+        }
+
+        // Heights, normals and colours depend on the cell too, so the vertices on the cell borders differ between the
+        // adjacent cells like they do in the game data
+        void addLandWithVertexData(int cellX, int cellY)
+        {
+            addLand(cellX, cellY, [](int, int) { return 0; });
+            ESM::Land::LandData& data = *mLands[std::pair(cellX, cellY)]->getLandData();
+            for (int y = 0; y < ESM::Land::LAND_SIZE; ++y)
+                for (int x = 0; x < ESM::Land::LAND_SIZE; ++x)
+                {
+                    const int index = y * ESM::Land::LAND_SIZE + x;
+                    data.mHeights[index] = static_cast<float>(cellX * 1000 + cellY * 100 + x * 3 - y * 2);
+                    data.mNormals[index * 3] = static_cast<signed char>((x * 3 + cellX * 7 + 100) % 50 - 25);
+                    data.mNormals[index * 3 + 1] = static_cast<signed char>((y * 5 + cellY * 11 + 100) % 50 - 25);
+                    data.mNormals[index * 3 + 2] = static_cast<signed char>(64 + (x + y + cellX + 100) % 60);
+                    data.mColours[index * 3] = static_cast<unsigned char>(x * 3 + cellX * 13);
+                    data.mColours[index * 3 + 1] = static_cast<unsigned char>(y * 3 + cellY * 17);
+                    data.mColours[index * 3 + 2] = static_cast<unsigned char>(x + y + cellX * 5 + cellY * 3);
+                }
+        }
+
+        void addLandTexture(const std::string& texture)
+        {
+            ESM::LandTexture& landTexture = mLandTextures.emplace_back();
+            landTexture.mTexture = texture;
+            landTexture.mIndex = static_cast<int>(mLandTextures.size()) - 1;
+        }
+
+        osg::ref_ptr<const ESMTerrain::LandObject> getLand(int cellX, int cellY) override
+        {
+            const auto it = mLands.find(std::pair(cellX, cellY));
+            if (it == mLands.end())
+                return nullptr;
+            return new ESMTerrain::LandObject(it->second.get(),
+                ESM::Land::DATA_VTEX | ESM::Land::DATA_VHGT | ESM::Land::DATA_VNML | ESM::Land::DATA_VCLR);
+        }
+
+        const ESM::LandTexture* getLandTexture(int index, short plugin) override
+        {
+            if (index < 0 || static_cast<std::size_t>(index) >= mLandTextures.size())
+                return nullptr;
+            return &mLandTextures[index];
+        }
+
+        void getBounds(float& minX, float& maxX, float& minY, float& maxY) override
+        {
+            minX = 0;
+            maxX = 1;
+            minY = 0;
+            maxY = 1;
+        }
+
+    private:
+        std::map<std::pair<int, int>, std::unique_ptr<ESM::Land>> mLands;
+        std::vector<ESM::LandTexture> mLandTextures;
+    };
+
+    struct ESM3TerrainStorageTest : Test
+    {
+        std::unique_ptr<VFS::Manager> mVfs = TestingOpenMW::createTestVFS({});
+        TestStorage mStorage{ mVfs.get() };
+        Terrain::Storage::ImageVector mBlendmaps;
+        std::vector<Terrain::LayerInfo> mLayerList;
+
+        ESM3TerrainStorageTest()
+        {
+            for (int i = 0; i < 8; ++i)
+                mStorage.addLandTexture("texture" + std::to_string(i) + ".dds");
+        }
+
+        void getBlendmaps() { mStorage.getBlendmaps(1, osg::Vec2f(0.5f, 0.5f), mBlendmaps, mLayerList); }
+    };
+
+    TEST_F(ESM3TerrainStorageTest, get_blendmaps_should_not_create_images_for_single_layer)
+    {
+        mStorage.addLand(-1, 0, [](int, int) { return 1; });
+        mStorage.addLand(0, 0, [](int, int) { return 1; });
+        getBlendmaps();
+        EXPECT_EQ(mLayerList.size(), 1);
+        EXPECT_TRUE(mBlendmaps.empty());
+    }
+
+    TEST_F(ESM3TerrainStorageTest, get_blendmaps_should_pack_4_layers_into_each_image)
+    {
+        mStorage.addLand(0, 0, [](int x, int) { return x % 8; });
+        getBlendmaps();
+        ASSERT_EQ(mLayerList.size(), 8);
+        ASSERT_EQ(mBlendmaps.size(), 2);
+        for (const osg::ref_ptr<osg::Image>& image : mBlendmaps)
+        {
+            EXPECT_EQ(image->getPixelFormat(), static_cast<GLenum>(GL_RGBA));
+            EXPECT_EQ(image->s(), 34);
+            EXPECT_EQ(image->t(), 34);
+        }
+    }
+
+    TEST_F(ESM3TerrainStorageTest, get_blendmaps_should_set_single_layer_channel_for_each_texel)
+    {
+        mStorage.addLand(-1, 0, [](int, int) { return 3; });
+        mStorage.addLand(0, 0, [](int x, int y) { return (x + y) % 6; });
+        getBlendmaps();
+        ASSERT_EQ(mLayerList.size(), 6);
+        ASSERT_EQ(mBlendmaps.size(), 2);
+        const std::size_t size = static_cast<std::size_t>(mBlendmaps[0]->s()) * mBlendmaps[0]->t();
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            int sum = 0;
+            for (const osg::ref_ptr<osg::Image>& image : mBlendmaps)
+                for (std::size_t channel = 0; channel < 4; ++channel)
+                    sum += image->data()[i * 4 + channel];
+            EXPECT_EQ(sum, 255) << i;
+        }
+    }
+
+    // Previous implementation of ESMTerrain::Storage::fillVertexBuffers looking up the land data for every vertex,
+    // kept to check the current one produces the same vertices
+    class ReferenceVertexBuffers
+    {
+    public:
+        explicit ReferenceVertexBuffers(ESMTerrain::Storage& storage)
+            : mStorage(storage)
+        {
+        }
+
+        void fill(int lodLevel, float size, const osg::Vec2f& center, osg::Vec3Array& positions,
+            osg::Vec3Array& normals, osg::Vec4ubArray& colours)
+        {
+            const std::size_t increment = static_cast<std::size_t>(1) << lodLevel;
+            const osg::Vec2f origin = center - osg::Vec2f(size / 2.f, size / 2.f);
+            const int startCellX = static_cast<int>(std::floor(origin.x()));
+            const int startCellY = static_cast<int>(std::floor(origin.y()));
+            const std::size_t numVerts = static_cast<std::size_t>(size * (ESM::Land::LAND_SIZE - 1) / increment + 1);
+
+            positions.resize(numVerts * numVerts);
+            normals.resize(numVerts * numVerts);
+            colours.resize(numVerts * numVerts);
+
+            float vertY = 0;
+            float vertX = 0;
+            float vertY_ = 0;
+            for (int cellY = startCellY; cellY < startCellY + std::ceil(size); ++cellY)
+            {
+                float vertX_ = 0;
+                for (int cellX = startCellX; cellX < startCellX + std::ceil(size); ++cellX)
+                {
+                    const ESM::Land::LandData* heightData = getData(cellX, cellY, ESM::Land::DATA_VHGT);
+                    const ESM::Land::LandData* normalData = getData(cellX, cellY, ESM::Land::DATA_VNML);
+                    const ESM::Land::LandData* colourData = getData(cellX, cellY, ESM::Land::DATA_VCLR);
+
+                    int rowStart = 0;
+                    int colStart = 0;
+                    if (vertY_ != 0)
+                        colStart += increment;
+                    if (vertX_ != 0)
+                        rowStart += increment;
+
+                    rowStart += (origin.x() - startCellX) * ESM::Land::LAND_SIZE;
+                    colStart += (origin.y() - startCellY) * ESM::Land::LAND_SIZE;
+                    const int rowEnd
+                        = std::min(static_cast<int>(rowStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE - 1) + 1),
+                            static_cast<int>(ESM::Land::LAND_SIZE));
+                    const int colEnd
+                        = std::min(static_cast<int>(colStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE - 1) + 1),
+                            static_cast<int>(ESM::Land::LAND_SIZE));
+
+                    vertY = vertY_;
+                    for (int col = colStart; col < colEnd; col += increment)
+                    {
+                        vertX = vertX_;
+                        for (int row = rowStart; row < rowEnd; row += increment)
+                        {
+                            const int srcArrayIndex = col * ESM::Land::LAND_SIZE * 3 + row * 3;
+                            const std::size_t index = static_cast<std::size_t>(vertX * numVerts + vertY);
+
+                            float height = ESM::Land::DEFAULT_HEIGHT;
+                            if (heightData)
+                                height = heightData->mHeights[col * ESM::Land::LAND_SIZE + row];
+                            positions[index]
+                                = osg::Vec3f((vertX / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
+                                    (vertY / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits, height);
+
+                            osg::Vec3f normal(0, 0, 1);
+                            if (normalData)
+                            {
+                                for (int i = 0; i < 3; ++i)
+                                    normal[i] = normalData->mNormals[srcArrayIndex + i];
+                                normal.normalize();
+                            }
+                            if (col == ESM::Land::LAND_SIZE - 1 || row == ESM::Land::LAND_SIZE - 1)
+                                fixNormal(normal, cellX, cellY, col, row);
+                            if ((row == 0 || row == ESM::Land::LAND_SIZE - 1)
+                                && (col == 0 || col == ESM::Land::LAND_SIZE - 1))
+                                averageNormal(normal, cellX, cellY, col, row);
+                            normals[index] = normal;
+
+                            osg::Vec4ub color(255, 255, 255, 255);
+                            if (colourData)
+                                for (int i = 0; i < 3; ++i)
+                                    color[i] = colourData->mColours[srcArrayIndex + i];
+                            if (col == ESM::Land::LAND_SIZE - 1 || row == ESM::Land::LAND_SIZE - 1)
+                                fixColour(color, cellX, cellY, col, row);
+                            colours[index] = color;
+
+                            ++vertX;
+                        }
+                        ++vertY;
+                    }
+                    vertX_ = vertX;
+                }
+                vertY_ = vertY;
+                assert(vertX_ == numVerts);
+            }
+            assert(vertY_ == numVerts);
+        }
+
+    private:
+        ESMTerrain::Storage& mStorage;
+        std::map<std::pair<int, int>, osg::ref_ptr<const ESMTerrain::LandObject>> mLands;
+
+        const ESM::Land::LandData* getData(int cellX, int cellY, int flags)
+        {
+            const auto it = mLands.try_emplace(std::pair(cellX, cellY), mStorage.getLand(cellX, cellY)).first;
+            return it->second == nullptr ? nullptr : it->second->getData(flags);
+        }
+
+        void fixNormal(osg::Vec3f& normal, int cellX, int cellY, int col, int row)
+        {
+            while (col >= ESM::Land::LAND_SIZE - 1)
+            {
+                ++cellY;
+                col -= ESM::Land::LAND_SIZE - 1;
+            }
+            while (row >= ESM::Land::LAND_SIZE - 1)
+            {
+                ++cellX;
+                row -= ESM::Land::LAND_SIZE - 1;
+            }
+            while (col < 0)
+            {
+                --cellY;
+                col += ESM::Land::LAND_SIZE - 1;
+            }
+            while (row < 0)
+            {
+                --cellX;
+                row += ESM::Land::LAND_SIZE - 1;
+            }
+
+            if (const ESM::Land::LandData* data = getData(cellX, cellY, ESM::Land::DATA_VNML))
+            {
+                for (int i = 0; i < 3; ++i)
+                    normal[i] = data->mNormals[col * ESM::Land::LAND_SIZE * 3 + row * 3 + i];
+                normal.normalize();
+            }
+            else
+                normal = osg::Vec3f(0, 0, 1);
+        }
+
+        void averageNormal(osg::Vec3f& normal, int cellX, int cellY, int col, int row)
+        {
+            osg::Vec3f n1, n2, n3, n4;
+            fixNormal(n1, cellX, cellY, col + 1, row);
+            fixNormal(n2, cellX, cellY, col - 1, row);
+            fixNormal(n3, cellX, cellY, col, row + 1);
+            fixNormal(n4, cellX, cellY, col, row - 1);
+            normal = n1 + n2 + n3 + n4;
+            normal.normalize();
+        }
+
+        void fixColour(osg::Vec4ub& color, int cellX, int cellY, int col, int row)
+        {
+            if (col == ESM::Land::LAND_SIZE - 1)
+            {
+                ++cellY;
+                col = 0;
+            }
+            if (row == ESM::Land::LAND_SIZE - 1)
+            {
+                ++cellX;
+                row = 0;
+            }
+
+            if (const ESM::Land::LandData* data = getData(cellX, cellY, ESM::Land::DATA_VCLR))
+                for (int i = 0; i < 3; ++i)
+                    color[i] = data->mColours[col * ESM::Land::LAND_SIZE * 3 + row * 3 + i];
+            else
+                color = osg::Vec4ub(255, 255, 255, 255);
+        }
+    };
+
+    struct FillVertexBuffersParams
+    {
+        int mLodLevel;
+        float mSize;
+        osg::Vec2f mCenter;
+    };
+
+    struct ESM3TerrainStorageFillVertexBuffersTest : TestWithParam<FillVertexBuffersParams>
+    {
+        std::unique_ptr<VFS::Manager> mVfs = TestingOpenMW::createTestVFS({});
+        TestStorage mStorage{ mVfs.get() };
+
+        ESM3TerrainStorageFillVertexBuffersTest()
+        {
+            // Cell (-1, 0) is missing to cover the default vertex data
+            for (int cellY = -2; cellY < 2; ++cellY)
+                for (int cellX = -2; cellX < 2; ++cellX)
+                    if (cellX != -1 || cellY != 0)
+                        mStorage.addLandWithVertexData(cellX, cellY);
+        }
+    };
+
+    TEST_P(ESM3TerrainStorageFillVertexBuffersTest, should_match_reference_implementation)
+    {
+        const FillVertexBuffersParams& params = GetParam();
+
+        osg::ref_ptr<osg::Vec3Array> positions = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec4ubArray> colours = new osg::Vec4ubArray;
+        mStorage.fillVertexBuffers(params.mLodLevel, params.mSize, params.mCenter, positions, normals, colours);
+
+        osg::Vec3Array expectedPositions;
+        osg::Vec3Array expectedNormals;
+        osg::Vec4ubArray expectedColours;
+        ReferenceVertexBuffers(mStorage).fill(params.mLodLevel, params.mSize, params.mCenter, expectedPositions,
+            expectedNormals, expectedColours);
+
+        ASSERT_EQ(positions->size(), expectedPositions.size());
+        ASSERT_EQ(normals->size(), expectedNormals.size());
+        ASSERT_EQ(colours->size(), expectedColours.size());
+        for (std::size_t i = 0; i < expectedPositions.size(); ++i)
+        {
+            EXPECT_EQ((*positions)[i], expectedPositions[i]) << i;
+            // Allow for a different rounding of the vectorized normalization
+            EXPECT_NEAR(((*normals)[i] - expectedNormals[i]).length(), 0, 1e-6f) << i;
+            EXPECT_EQ((*colours)[i], expectedColours[i]) << i;
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(ChunksOverCellBorders, ESM3TerrainStorageFillVertexBuffersTest,
+        Values(FillVertexBuffersParams{ 0, 1, osg::Vec2f(0.5f, 0.5f) },
+            FillVertexBuffersParams{ 0, 2, osg::Vec2f(0, 0) }, FillVertexBuffersParams{ 1, 2, osg::Vec2f(0, 0) },
+            FillVertexBuffersParams{ 2, 4, osg::Vec2f(0, 0) }, FillVertexBuffersParams{ 3, 4, osg::Vec2f(1, 1) },
+            FillVertexBuffersParams{ 6, 1, osg::Vec2f(-0.5f, -0.5f) },
+            FillVertexBuffersParams{ 0, 0.5f, osg::Vec2f(0.25f, 0.75f) },
+            FillVertexBuffersParams{ 2, 0.25f, osg::Vec2f(-0.125f, 0.875f) }));
+}
@@ -0,0 +1,169 @@
+#include "../testing_util.hpp"
+
+#include <apps/navmeshtool/navmesh.hpp>
+#include <apps/navmeshtool/shard.hpp>
+
+#include <components/detournavigator/navmeshdb.hpp>
+#include <components/detournavigator/preparednavmeshdata.hpp>
+#include <components/detournavigator/serialization.hpp>
+#include <components/files/conversion.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace NavMeshTool;
+    using namespace DetourNavigator;
+
+    constexpr std::uint64_t maxDbFileSize = std::numeric_limits<std::uint64_t>::max();
+    const std::string worldspace = "sys::default";
+
+    std::vector<std::byte> makeInput(std::byte value)
+    {
+        return std::vector<std::byte>(8, value);
+    }
+
+    std::vector<std::byte> makeData()
+    {
+        return serialize(PreparedNavMeshData());
+    }
+
+    struct NavMeshToolShardTest : Test
+    {
+        const std::vector<std::filesystem::path> mShardDbs{
+            TestingOpenMW::outputFilePath("navmeshtool_shard_0.db"),
+            TestingOpenMW::outputFilePath("navmeshtool_shard_1.db"),
+        };
+        NavMeshDb mDb{ ":memory:", maxDbFileSize };
+
+        NavMeshToolShardTest()
+        {
+            for (const std::filesystem::path& path : mShardDbs)
+                std::filesystem::remove(path);
+        }
+
+        NavMeshDb openShardDb(std::size_t index) const
+        {
+            return NavMeshDb(Files::pathToUnicodeString(mShardDbs[index]), maxDbFileSize);
+        }
+    };
+
+    TEST(NavMeshToolIsInShardTest, single_shard_should_contain_all_tiles)
+    {
+        const Shard shard{ 0, 1 };
+        for (int x = -10; x < 10; ++x)
+            for (int y = -10; y < 10; ++y)
+                EXPECT_TRUE(isInShard(shard, worldspace, TilePosition(x, y))) << x << " " << y;
+    }
+
+    TEST(NavMeshToolIsInShardTest, each_tile_should_be_in_exactly_one_shard)
+    {
+        constexpr std::size_t count = 4;
+        for (int x = -10; x < 10; ++x)
+        {
+            for (int y = -10; y < 10; ++y)
+            {
+                std::size_t shards = 0;
+                for (std::size_t index = 0; index < count; ++index)
+                    shards += isInShard(Shard{ index, count }, worldspace, TilePosition(x, y));
+                EXPECT_EQ(shards, 1u) << x << " " << y;
+            }
+        }
+    }
+
+    TEST(NavMeshToolIsInShardTest, tiles_should_be_distributed_evenly_between_shards)
+    {
+        constexpr std::size_t count = 4;
+        constexpr int size = 32;
+        std::vector<std::size_t> tiles(count);
+        for (int x = -size / 2; x < size / 2; ++x)
+            for (int y = -size / 2; y < size / 2; ++y)
+                for (std::size_t index = 0; index < count; ++index)
+                    tiles[index] += isInShard(Shard{ index, count }, worldspace, TilePosition(x, y));
+        const std::size_t expected = size * size / count;
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            EXPECT_GT(tiles[index], expected * 3 / 4) << index;
+            EXPECT_LT(tiles[index], expected * 5 / 4) << index;
+        }
+    }
+
+    TEST(NavMeshToolIsInShardTest, shard_should_depend_on_worldspace)
+    {
+        constexpr std::size_t count = 4;
+        std::size_t different = 0;
+        for (int x = 0; x < 16; ++x)
+            for (std::size_t index = 0; index < count; ++index)
+                different += isInShard(Shard{ index, count }, "worldspace1", TilePosition(x, 0))
+                    != isInShard(Shard{ index, count }, "worldspace2", TilePosition(x, 0));
+        EXPECT_GT(different, 0u);
+    }
+
+    TEST_F(NavMeshToolShardTest, merge_shard_dbs_should_insert_tiles_of_all_shards)
+    {
+        {
+            NavMeshDb shard0 = openShardDb(0);
+            shard0.insertTile(TileId{ 1 }, worldspace, TilePosition(0, 0), TileVersion{ 1 }, makeInput(std::byte{ 1 }),
+                makeData());
+            NavMeshDb shard1 = openShardDb(1);
+            shard1.insertTile(TileId{ 1 }, worldspace, TilePosition(1, 0), TileVersion{ 1 }, makeInput(std::byte{ 2 }),
+                makeData());
+        }
+        EXPECT_EQ(mergeShardDbs(mShardDbs, false, maxDbFileSize, mDb), Status::Ok);
+        const auto tile0 = mDb.findTile(worldspace, TilePosition(0, 0), makeInput(std::byte{ 1 }));
+        const auto tile1 = mDb.findTile(worldspace, TilePosition(1, 0), makeInput(std::byte{ 2 }));
+        ASSERT_TRUE(tile0.has_value());
+        ASSERT_TRUE(tile1.has_value());
+        EXPECT_NE(tile0->mTileId, tile1->mTileId);
+        EXPECT_EQ(mDb.getMaxTileId(), TileId{ 2 });
+    }
+
+    TEST_F(NavMeshToolShardTest, merge_shard_dbs_should_keep_newer_version_of_same_tile)
+    {
+        mDb.insertTile(
+            TileId{ 7 }, worldspace, TilePosition(0, 0), TileVersion{ 2 }, makeInput(std::byte{ 1 }), makeData());
+        mDb.insertTile(
+            TileId{ 8 }, worldspace, TilePosition(1, 0), TileVersion{ 1 }, makeInput(std::byte{ 2 }), makeData());
+        {
+            NavMeshDb shard0 = openShardDb(0);
+            shard0.insertTile(TileId{ 1 }, worldspace, TilePosition(0, 0), TileVersion{ 1 }, makeInput(std::byte{ 1 }),
+                makeData());
+            NavMeshDb shard1 = openShardDb(1);
+            shard1.insertTile(TileId{ 1 }, worldspace, TilePosition(1, 0), TileVersion{ 3 }, makeInput(std::byte{ 2 }),
+                makeData());
+        }
+        EXPECT_EQ(mergeShardDbs(mShardDbs, false, maxDbFileSize, mDb), Status::Ok);
+        const auto tile0 = mDb.findTile(worldspace, TilePosition(0, 0), makeInput(std::byte{ 1 }));
+        ASSERT_TRUE(tile0.has_value());
+        EXPECT_EQ(tile0->mTileId, TileId{ 7 });
+        EXPECT_EQ(tile0->mVersion, TileVersion{ 2 });
+        const auto tile1 = mDb.findTile(worldspace, TilePosition(1, 0), makeInput(std::byte{ 2 }));
+        ASSERT_TRUE(tile1.has_value());
+        EXPECT_EQ(tile1->mTileId, TileId{ 8 });
+        EXPECT_EQ(tile1->mVersion, TileVersion{ 3 });
+    }
+
+    TEST_F(NavMeshToolShardTest, merge_shard_dbs_should_fail_without_changes_for_mismatching_shape_ids)
+    {
+        const std::string hash = "hash";
+        const Sqlite3::ConstBlob hashBlob{ hash.data(), static_cast<int>(hash.size()) };
+        mDb.insertShape(ShapeId{ 1 }, "shape", ShapeType::Collision, hashBlob);
+        {
+            NavMeshDb shard0 = openShardDb(0);
+            shard0.insertTile(TileId{ 1 }, worldspace, TilePosition(0, 0), TileVersion{ 1 }, makeInput(std::byte{ 1 }),
+                makeData());
+            NavMeshDb shard1 = openShardDb(1);
+            shard1.insertShape(ShapeId{ 2 }, "shape", ShapeType::Collision, hashBlob);
+        }
+        EXPECT_EQ(mergeShardDbs(mShardDbs, false, maxDbFileSize, mDb), Status::Cancelled);
+        EXPECT_FALSE(mDb.findTile(worldspace, TilePosition(0, 0), makeInput(std::byte{ 1 })).has_value());
+    }
+}
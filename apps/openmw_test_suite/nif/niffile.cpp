@@ -0,0 +1,192 @@
+#include <components/files/hash.hpp>
+#include <components/nif/exception.hpp>
+#include <components/nif/controller.hpp>
+#include <components/nif/extra.hpp>
+#include <components/nif/niffile.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    using namespace testing;
+
+    // Writes the Morrowind format file content
+    struct NifWriter
+    {
+        std::string mContent = "NetImmerse File Format, Version 4.0.0.2\n";
+
+        void writeUInt(std::uint32_t value)
+        {
+            char buffer[sizeof(value)];
+            std::memcpy(buffer, &value, sizeof(value));
+            mContent.append(buffer, sizeof(value));
+        }
+
+        void writeInt(std::int32_t value) { writeUInt(static_cast<std::uint32_t>(value)); }
+
+        void writeUShort(std::uint16_t value)
+        {
+            char buffer[sizeof(value)];
+            std::memcpy(buffer, &value, sizeof(value));
+            mContent.append(buffer, sizeof(value));
+        }
+
+        void writeFloat(float value)
+        {
+            char buffer[sizeof(value)];
+            std::memcpy(buffer, &value, sizeof(value));
+            mContent.append(buffer, sizeof(value));
+        }
+
+        void writeString(std::string_view value)
+        {
+            writeUInt(static_cast<std::uint32_t>(value.size()));
+            mContent.append(value);
+        }
+
+        void writeStringExtraData(std::int32_t next, std::string_view value)
+        {
+            writeString("NiStringExtraData");
+            writeInt(next);
+            writeUInt(0); // Record size
+            writeString(value);
+        }
+    };
+
+    struct NifNIFFileTest : Test
+    {
+        NifWriter mWriter;
+
+        NifNIFFileTest()
+        {
+            mWriter.writeUInt(Nif::NIFFile::VER_MW);
+            mWriter.writeUInt(3); // Number of records
+            mWriter.writeStringExtraData(2, "first");
+            mWriter.writeStringExtraData(-1, "second");
+            mWriter.writeStringExtraData(1, "third");
+        }
+
+        void writeRoots()
+        {
+            mWriter.writeUInt(1); // Number of roots
+            mWriter.writeInt(0);
+        }
+    };
+
+    TEST_F(NifNIFFileTest, parse_should_link_records_by_index)
+    {
+        writeRoots();
+        Nif::NIFFile file("test.nif");
+        Nif::Reader reader(file);
+        reader.parse(std::make_unique<std::istringstream>(mWriter.mContent));
+
+        ASSERT_EQ(file.mRecords.size(), 3);
+        ASSERT_EQ(file.mRoots.size(), 1);
+        EXPECT_EQ(file.mRoots[0], file.mRecords[0]);
+        const auto* first = dynamic_cast<const Nif::NiStringExtraData*>(file.mRecords[0]);
+        ASSERT_NE(first, nullptr);
+        EXPECT_EQ(first->string, "first");
+        ASSERT_FALSE(first->next.empty());
+        EXPECT_EQ(first->next.getPtr(), file.mRecords[2]);
+        EXPECT_EQ(static_cast<const Nif::NiStringExtraData&>(first->next.get()).string, "third");
+        ASSERT_FALSE(first->next->next.empty());
+        EXPECT_EQ(first->next->next.getPtr(), file.mRecords[1]);
+        EXPECT_TRUE(first->next->next->next.empty());
+    }
+
+    TEST_F(NifNIFFileTest, parse_should_compute_same_hash_as_for_stream)
+    {
+        writeRoots();
+        Nif::NIFFile file("test.nif");
+        Nif::Reader reader(file);
+        reader.parse(std::make_unique<std::istringstream>(mWriter.mContent));
+        std::istringstream stream(mWriter.mContent);
+        const std::array<std::uint64_t, 2> hash = Files::getHash("test.nif", stream);
+        EXPECT_EQ(file.mHash, std::string(reinterpret_cast<const char*>(hash.data()), sizeof(hash)));
+    }
+
+    TEST_F(NifNIFFileTest, parse_should_throw_on_truncated_file)
+    {
+        Nif::NIFFile file("test.nif");
+        Nif::Reader reader(file);
+        EXPECT_THROW(reader.parse(std::make_unique<std::istringstream>(mWriter.mContent)), std::runtime_error);
+    }
+
+    TEST(NifNIFFileGeomMorpherTest, parse_should_link_forward_referenced_interpolators_in_place)
+    {
+        NifWriter writer;
+        writer.mContent = "Gamebryo File Format, Version 20.2.0.7\n";
+        writer.writeUInt(Nif::NIFStream::generateVersion(20, 2, 0, 7));
+        writer.mContent += '\1'; // Little endian
+        writer.writeUInt(0); // User version
+        writer.writeUInt(2); // Number of records
+        writer.writeUShort(2); // Number of record types
+        writer.writeString("NiGeomMorpherController");
+        writer.writeString("NiFloatInterpolator");
+        writer.writeUShort(0);
+        writer.writeUShort(1);
+        writer.writeUInt(0); // Record sizes
+        writer.writeUInt(0);
+        writer.writeUInt(0); // Number of strings
+        writer.writeUInt(0); // Max string length
+        writer.writeUInt(0); // Number of groups
+
+        // NiGeomMorpherController
+        writer.writeInt(-1); // Next controller
+        writer.writeUShort(0); // Flags
+        writer.writeFloat(1); // Frequency
+        writer.writeFloat(0); // Phase
+        writer.writeFloat(0); // Start time
+        writer.writeFloat(0); // Stop time
+        writer.writeInt(-1); // Target
+        writer.writeUShort(0); // Update normals
+        writer.writeInt(-1); // Morph data
+        writer.mContent += '\0'; // Always active
+        writer.writeUInt(1); // Number of interpolators
+        writer.writeInt(1); // Interpolator defined after the controller
+        writer.writeFloat(0.5f); // Weight
+
+        // NiFloatInterpolator
+        writer.writeFloat(42); // Default value
+        writer.writeInt(-1); // Data
+
+        writer.writeUInt(1); // Number of roots
+        writer.writeInt(0);
+
+        Nif::Reader::setLoadUnsupportedFiles(true);
+        Nif::NIFFile file("test.nif");
+        Nif::Reader reader(file);
+        reader.parse(std::make_unique<std::istringstream>(writer.mContent));
+        Nif::Reader::setLoadUnsupportedFiles(false);
+
+        ASSERT_EQ(file.mRecords.size(), 2);
+        const auto* controller = dynamic_cast<const Nif::NiGeomMorpherController*>(file.mRecords[0]);
+        ASSERT_NE(controller, nullptr);
+        ASSERT_EQ(controller->mInterpolators.size(), 1);
+        ASSERT_FALSE(controller->mInterpolators[0].empty());
+        EXPECT_EQ(controller->mInterpolators[0].getPtr(), file.mRecords[1]);
+        ASSERT_EQ(controller->mWeights.size(), 1);
+        EXPECT_EQ(controller->mWeights[0], 0.5f);
+    }
+
+    TEST_F(NifNIFFileTest, parse_should_throw_on_link_to_missing_record)
+    {
+        NifWriter writer;
+        writer.writeUInt(Nif::NIFFile::VER_MW);
+        writer.writeUInt(1);
+        writer.writeStringExtraData(1, "first");
+        writer.writeUInt(0);
+        Nif::NIFFile file("test.nif");
+        Nif::Reader reader(file);
+        EXPECT_THROW(reader.parse(std::make_unique<std::istringstream>(writer.mContent)), Nif::Exception);
+    }
+}
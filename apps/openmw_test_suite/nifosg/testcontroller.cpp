@@ -0,0 +1,212 @@
+#include <components/nif/nifkey.hpp>
+#include <components/nifosg/controller.hpp>
+#include <components/nifosg/packedanimation.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace NifOsg;
+
+    std::shared_ptr<Nif::FloatKeyMap> makeKeys(
+        const std::vector<float>& times, const std::vector<float>& values, unsigned int type)
+    {
+        auto keys = std::make_shared<Nif::FloatKeyMap>();
+        keys->mInterpolationType = type;
+        keys->mTimes = times;
+        for (float value : values)
+            keys->mKeys.push_back(Nif::FloatKey{ value, 0, 0 });
+        return keys;
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_return_default_value_without_keys)
+    {
+        const FloatInterpolator interpolator(nullptr, 42.f);
+        EXPECT_TRUE(interpolator.empty());
+        EXPECT_EQ(interpolator.interpKey(1.f), 42.f);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_clamp_to_first_and_last_key)
+    {
+        const FloatInterpolator interpolator(makeKeys({ 1, 2, 3 }, { 10, 20, 30 }, Nif::InterpolationType_Linear));
+        EXPECT_EQ(interpolator.interpKey(0.f), 10.f);
+        EXPECT_EQ(interpolator.interpKey(1.f), 10.f);
+        EXPECT_EQ(interpolator.interpKey(3.f), 30.f);
+        EXPECT_EQ(interpolator.interpKey(4.f), 30.f);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_interpolate_linearly_between_keys)
+    {
+        const FloatInterpolator interpolator(makeKeys({ 1, 2, 4 }, { 10, 20, 40 }, Nif::InterpolationType_Linear));
+        EXPECT_FLOAT_EQ(interpolator.interpKey(1.5f), 15.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(2.f), 20.f);
+        EXPECT_FLOAT_EQ(interpolator.interpKey(3.f), 30.f);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_give_same_values_for_forward_playback_and_seeking)
+    {
+        std::vector<float> times;
+        std::vector<float> values;
+        for (int i = 0; i < 100; ++i)
+        {
+            times.push_back(i * 0.1f);
+            values.push_back(static_cast<float>(i % 7));
+        }
+        const auto keys = makeKeys(times, values, Nif::InterpolationType_Linear);
+        const FloatInterpolator playing(keys);
+        for (int i = 0; i < 1000; ++i)
+        {
+            const float time = i * 0.0113f;
+            const FloatInterpolator seeking(keys);
+            EXPECT_EQ(playing.interpKey(time), seeking.interpKey(time)) << time;
+        }
+        // Jump back to the start after reaching the end
+        for (const float time : { 0.05f, 9.85f, 0.15f, 5.f, 4.95f })
+        {
+            const FloatInterpolator seeking(keys);
+            EXPECT_EQ(playing.interpKey(time), seeking.interpKey(time)) << time;
+        }
+    }
+
+    TEST(NifOsgValueInterpolatorTest, should_use_nearest_key_for_constant_interpolation)
+    {
+        const FloatInterpolator interpolator(makeKeys({ 0, 1 }, { 10, 20 }, Nif::InterpolationType_Constant));
+        EXPECT_EQ(interpolator.interpKey(0.25f), 10.f);
+        EXPECT_EQ(interpolator.interpKey(0.75f), 20.f);
+    }
+
+    Nif::QuaternionKeyMap makeRotationKeys(const std::vector<float>& times, unsigned int type)
+    {
+        Nif::QuaternionKeyMap keys;
+        keys.mInterpolationType = type;
+        keys.mTimes = times;
+        for (std::size_t i = 0; i < times.size(); ++i)
+        {
+            const osg::Quat value(0.7 * static_cast<double>(i), osg::Vec3f(1, 2, static_cast<float>(i)));
+            keys.mKeys.push_back(Nif::QuaternionKey{ value, value, value });
+        }
+        return keys;
+    }
+
+    Nif::Vector3KeyMap makeTranslationKeys(const std::vector<float>& times, unsigned int type)
+    {
+        Nif::Vector3KeyMap keys;
+        keys.mInterpolationType = type;
+        keys.mTimes = times;
+        for (std::size_t i = 0; i < times.size(); ++i)
+        {
+            const osg::Vec3f value(static_cast<float>(i) * 10, -static_cast<float>(i * i), 100.f);
+            keys.mKeys.push_back(Nif::Vector3Key{ value, value, value });
+        }
+        return keys;
+    }
+
+    // Rotation difference in radians
+    double getAngle(const osg::Quat& lhs, const osg::Quat& rhs)
+    {
+        const double dot = lhs.x() * rhs.x() + lhs.y() * rhs.y() + lhs.z() * rhs.z() + lhs.w() * rhs.w();
+        return 2 * std::acos(std::min(1.0, std::abs(dot)));
+    }
+
+    TEST(NifOsgPackedAnimationTest, rotations_should_match_interpolator)
+    {
+        const std::vector<float> times{ 0, 0.5f, 1.2f, 1.3f, 2 };
+        const Nif::QuaternionKeyMap keys = makeRotationKeys(times, Nif::InterpolationType_Linear);
+        const QuaternionInterpolator interpolator(std::make_shared<Nif::QuaternionKeyMap>(keys));
+        PackedAnimation animation;
+        const std::uint32_t channel = animation.addRotations(keys);
+        ASSERT_NE(channel, PackedAnimation::sNoChannel);
+        std::uint32_t cursor = 0;
+        for (int i = -10; i < 230; ++i)
+        {
+            const float time = i * 0.01f;
+            EXPECT_LT(getAngle(animation.sampleRotation(channel, time, cursor), interpolator.interpKey(time)), 1e-4)
+                << time;
+        }
+    }
+
+    TEST(NifOsgPackedAnimationTest, translations_should_match_interpolator)
+    {
+        const std::vector<float> times{ 0, 0.5f, 1.2f, 1.3f, 2 };
+        const Nif::Vector3KeyMap keys = makeTranslationKeys(times, Nif::InterpolationType_Linear);
+        const Vec3Interpolator interpolator(std::make_shared<Nif::Vector3KeyMap>(keys));
+        PackedAnimation animation;
+        const std::uint32_t channel = animation.addTranslations(keys);
+        ASSERT_NE(channel, PackedAnimation::sNoChannel);
+        std::uint32_t cursor = 0;
+        for (int i = -10; i < 230; ++i)
+        {
+            const float time = i * 0.01f;
+            const osg::Vec3f expected = interpolator.interpKey(time);
+            EXPECT_LT((animation.sampleTranslation(channel, time, cursor) - expected).length(), 1e-3f) << time;
+        }
+    }
+
+    TEST(NifOsgPackedAnimationTest, scales_should_match_interpolator)
+    {
+        const auto keys = makeKeys({ 0, 1, 2, 4 }, { 1, 1.5f, 0.25f, 2 }, Nif::InterpolationType_Linear);
+        const FloatInterpolator interpolator(keys);
+        PackedAnimation animation;
+        const std::uint32_t channel = animation.addScales(*keys);
+        ASSERT_NE(channel, PackedAnimation::sNoChannel);
+        std::uint32_t cursor = 0;
+        for (int i = -10; i < 450; ++i)
+        {
+            const float time = i * 0.01f;
+            EXPECT_NEAR(animation.sampleScale(channel, time, cursor), interpolator.interpKey(time), 1e-4f) << time;
+        }
+    }
+
+    TEST(NifOsgPackedAnimationTest, should_use_nearest_key_for_constant_interpolation)
+    {
+        PackedAnimation animation;
+        const std::uint32_t channel
+            = animation.addScales(*makeKeys({ 0, 1 }, { 10, 20 }, Nif::InterpolationType_Constant));
+        std::uint32_t cursor = 0;
+        EXPECT_EQ(animation.sampleScale(channel, 0.25f, cursor), 10.f);
+        EXPECT_EQ(animation.sampleScale(channel, 0.75f, cursor), 20.f);
+    }
+
+    TEST(NifOsgPackedAnimationTest, should_not_pack_quadratic_or_empty_keys)
+    {
+        PackedAnimation animation;
+        EXPECT_EQ(animation.addTranslations(makeTranslationKeys({ 0, 1 }, Nif::InterpolationType_Quadratic)),
+            PackedAnimation::sNoChannel);
+        EXPECT_EQ(animation.addScales(*makeKeys({ 0, 1 }, { 1, 2 }, Nif::InterpolationType_Quadratic)),
+            PackedAnimation::sNoChannel);
+        EXPECT_EQ(animation.addRotations(makeRotationKeys({}, Nif::InterpolationType_Linear)),
+            PackedAnimation::sNoChannel);
+        EXPECT_EQ(animation.getNumChannels(), 0);
+    }
+
+    TEST(NifOsgPackedAnimationTest, sample_rotations_should_match_single_channel_sampling)
+    {
+        PackedAnimation animation;
+        const std::array<std::uint32_t, 2> channels{
+            animation.addRotations(makeRotationKeys({ 0, 1, 2 }, Nif::InterpolationType_Linear)),
+            animation.addRotations(makeRotationKeys({ 0, 0.25f, 0.5f, 3 }, Nif::InterpolationType_Constant)),
+        };
+        animation.shrinkToFit();
+        std::array<std::uint32_t, 2> cursors{};
+        std::array<osg::Quat, 2> result;
+        for (int i = 0; i < 40; ++i)
+        {
+            const float time = i * 0.1f;
+            animation.sampleRotations(channels, time, cursors, result);
+            for (std::size_t j = 0; j < channels.size(); ++j)
+            {
+                std::uint32_t cursor = 0;
+                const osg::Quat expected = animation.sampleRotation(channels[j], time, cursor);
+                EXPECT_EQ(result[j], expected) << time << " " << j;
+            }
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#include <components/misc/resourcehelpers.hpp>
+#include <components/nifosg/matrixtransform.hpp>
+#include <components/resource/binaryscenecache.hpp>
+#include <components/sceneutil/keyframe.hpp>
+#include <components/sceneutil/serialize.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <osg/Group>
+#include <osg/Image>
+#include <osg/Texture2D>
+#include <osgDB/Registry>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "../testing_util.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    const std::string fileHash = "0123456789abcdef";
+
+    struct BinarySceneCacheTest : Test
+    {
+        const std::filesystem::path mDirectory = TestingOpenMW::outputFilePath("binaryscenecache");
+        TestingOpenMW::VFSTestFile mTextureFile{ "" };
+        std::unique_ptr<VFS::Manager> mVFS = TestingOpenMW::createTestVFS({});
+
+        BinarySceneCacheTest() { std::filesystem::remove_all(mDirectory); }
+
+        void SetUp() override
+        {
+            if (osgDB::Registry::instance()->getReaderWriterForExtension("osgb") == nullptr)
+                GTEST_SKIP() << "osgb reader writer is not found";
+            // Registered by the tests comparing the scenes made by the NIF loader, the cache is disabled then
+            if (!SceneUtil::isGeometryDataSerialized())
+                GTEST_SKIP() << "debug serializers are registered";
+        }
+
+        BinarySceneCache makeCache(std::uint64_t maxSize = 1024 * 1024, std::string_view version = "version") const
+        {
+            return BinarySceneCache(mDirectory, maxSize, version, mVFS.get(), nullptr);
+        }
+
+        static osg::ref_ptr<osg::Group> makeScene()
+        {
+            Nif::Transformation transformation;
+            transformation.pos = osg::Vec3f(1, 2, 3);
+            transformation.scale = 2;
+            transformation.rotation.mValues[0][1] = 0.5f;
+            osg::ref_ptr<NifOsg::MatrixTransform> transform = new NifOsg::MatrixTransform(transformation);
+            transform->setName("Transform");
+            transform->setUserValue("recIndex", 42u);
+            osg::ref_ptr<osg::Group> scene = new osg::Group;
+            scene->addChild(transform);
+            return scene;
+        }
+    };
+
+    TEST_F(BinarySceneCacheTest, isStorableShouldAcceptOsgNodesAndNifOsgTransforms)
+    {
+        EXPECT_TRUE(BinarySceneCache::isStorable(*makeScene()));
+    }
+
+    TEST_F(BinarySceneCacheTest, isStorableShouldRejectNodesWithCallbacks)
+    {
+        osg::ref_ptr<osg::Group> scene = makeScene();
+        scene->getChild(0)->addUpdateCallback(new osg::NodeCallback);
+        EXPECT_FALSE(BinarySceneCache::isStorable(*scene));
+    }
+
+    TEST_F(BinarySceneCacheTest, isStorableShouldRejectUserObjectsOfOtherClasses)
+    {
+        osg::ref_ptr<osg::Group> scene = makeScene();
+        scene->getOrCreateUserDataContainer()->addUserObject(new SceneUtil::TextKeyMapHolder);
+        EXPECT_FALSE(BinarySceneCache::isStorable(*scene));
+    }
+
+    TEST_F(BinarySceneCacheTest, isStorableShouldRejectTexturesWithImagesNotFromFiles)
+    {
+        osg::ref_ptr<osg::Group> scene = makeScene();
+        osg::ref_ptr<osg::Texture2D> texture = new osg::Texture2D(new osg::Image);
+        scene->getOrCreateStateSet()->setTextureAttribute(0, texture);
+        EXPECT_FALSE(BinarySceneCache::isStorable(*scene));
+        texture->getImage()->setFileName("textures/image.dds");
+        EXPECT_TRUE(BinarySceneCache::isStorable(*scene));
+    }
+
+    TEST_F(BinarySceneCacheTest, readShouldReturnNullptrForMissingEntry)
+    {
+        BinarySceneCache cache = makeCache();
+        EXPECT_EQ(cache.read(fileHash), nullptr);
+    }
+
+    TEST_F(BinarySceneCacheTest, readShouldReturnWrittenScene)
+    {
+        {
+            BinarySceneCache cache = makeCache();
+            cache.write(fileHash, *makeScene(), {});
+        }
+        BinarySceneCache cache = makeCache();
+        const osg::ref_ptr<osg::Node> result = cache.read(fileHash);
+        ASSERT_NE(result, nullptr);
+        ASSERT_NE(result->asGroup(), nullptr);
+        ASSERT_EQ(result->asGroup()->getNumChildren(), 1u);
+        const auto* transform = dynamic_cast<const NifOsg::MatrixTransform*>(result->asGroup()->getChild(0));
+        ASSERT_NE(transform, nullptr);
+        const auto* expected = static_cast<const NifOsg::MatrixTransform*>(makeScene()->getChild(0));
+        EXPECT_EQ(transform->getName(), "Transform");
+        EXPECT_EQ(transform->getMatrix(), expected->getMatrix());
+        EXPECT_EQ(transform->mScale, 2);
+        EXPECT_EQ(transform->mRotationScale.mValues[0][1], 0.5f);
+        unsigned int recIndex = 0;
+        EXPECT_TRUE(transform->getUserValue("recIndex", recIndex));
+        EXPECT_EQ(recIndex, 42u);
+    }
+
+    TEST_F(BinarySceneCacheTest, readShouldIgnoreEntriesOfOtherVersion)
+    {
+        makeCache(1024 * 1024, "version").write(fileHash, *makeScene(), {});
+        EXPECT_EQ(makeCache(1024 * 1024, "other version").read(fileHash), nullptr);
+    }
+
+    TEST_F(BinarySceneCacheTest, readShouldReturnSceneWhenTexturesResolveToSamePaths)
+    {
+        mVFS = TestingOpenMW::createTestVFS({ { "textures/texture.tga", &mTextureFile } });
+        const std::string path = Misc::ResourceHelpers::correctTexturePath("texture.tga", mVFS.get());
+        makeCache().write(fileHash, *makeScene(), { { "texture.tga", path } });
+        EXPECT_NE(makeCache().read(fileHash), nullptr);
+    }
+
+    TEST_F(BinarySceneCacheTest, readShouldIgnoreEntriesWithTexturesResolvedToOtherPaths)
+    {
+        mVFS = TestingOpenMW::createTestVFS({ { "textures/texture.tga", &mTextureFile } });
+        const std::string path = Misc::ResourceHelpers::correctTexturePath("texture.tga", mVFS.get());
+        makeCache().write(fileHash, *makeScene(), { { "texture.tga", path } });
+        // A DDS version added by a mod replaces the texture
+        mVFS = TestingOpenMW::createTestVFS(
+            { { "textures/texture.tga", &mTextureFile }, { "textures/texture.dds", &mTextureFile } });
+        EXPECT_EQ(makeCache().read(fileHash), nullptr);
+    }
+
+    TEST_F(BinarySceneCacheTest, writeShouldRemoveLeastRecentlyUsedEntriesAboveMaxSize)
+    {
+        const std::string otherFileHash = "fedcba9876543210";
+        {
+            BinarySceneCache cache = makeCache();
+            cache.write(fileHash, *makeScene(), {});
+        }
+        const std::uint64_t entrySize = std::filesystem::file_size(*std::filesystem::directory_iterator(mDirectory));
+        BinarySceneCache cache = makeCache(entrySize * 3 / 2);
+        cache.write(otherFileHash, *makeScene(), {});
+        EXPECT_EQ(cache.read(fileHash), nullptr);
+        EXPECT_NE(cache.read(otherFileHash), nullptr);
+    }
+}
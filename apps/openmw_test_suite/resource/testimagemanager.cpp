@@ -0,0 +1,47 @@
+#include <components/resource/imagemanager.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/Stats>
+
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "../testing_util.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    struct ResourceImageManagerTest : Test
+    {
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue = new SceneUtil::WorkQueue(1);
+        std::unique_ptr<VFS::Manager> mVFS = TestingOpenMW::createTestVFS({});
+        ImageManager mImageManager{ mVFS.get() };
+    };
+
+    TEST_F(ResourceImageManagerTest, requestImageWithoutWorkQueueShouldLoadOnCallingThread)
+    {
+        const std::shared_future<osg::ref_ptr<osg::Image>> future = mImageManager.requestImage("missing.dds");
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        EXPECT_EQ(future.get().get(), mImageManager.getWarningImage());
+    }
+
+    TEST_F(ResourceImageManagerTest, requestImageShouldLoadOnWorkQueueAndCacheResult)
+    {
+        mImageManager.setWorkQueue(mWorkQueue);
+        const std::shared_future<osg::ref_ptr<osg::Image>> future = mImageManager.requestImage("missing.dds");
+        EXPECT_EQ(future.get().get(), mImageManager.getWarningImage());
+        EXPECT_EQ(mImageManager.getImage("missing.dds").get(), mImageManager.getWarningImage());
+        osg::ref_ptr<osg::Stats> stats = new osg::Stats("stats");
+        mImageManager.reportStats(0, stats);
+        double value = 0;
+        ASSERT_TRUE(stats->getAttribute(0, "Image Pending", value));
+        EXPECT_EQ(value, 0);
+        ASSERT_TRUE(stats->getAttribute(0, "Image", value));
+        EXPECT_EQ(value, 1);
+    }
+}
@@ -0,0 +1,78 @@
+#include <components/resource/objectcache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/Image>
+
+#include <cstddef>
+#include <limits>
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    struct ResourceObjectCacheTest : Test
+    {
+        osg::ref_ptr<ObjectCache> mCache = new ObjectCache;
+
+        static std::size_t getSize(const osg::Object& object)
+        {
+            return static_cast<std::size_t>(static_cast<const osg::Image&>(object).s());
+        }
+
+        static osg::ref_ptr<osg::Image> makeImage(int size)
+        {
+            osg::ref_ptr<osg::Image> image = new osg::Image;
+            image->allocateImage(size, 1, 1, GL_LUMINANCE, GL_UNSIGNED_BYTE);
+            return image;
+        }
+    };
+
+    TEST_F(ResourceObjectCacheTest, removeLeastRecentlyUsedObjectsInCacheShouldKeepObjectsFittingMaxSize)
+    {
+        mCache->addEntryToObjectCache("a", makeImage(1), 1);
+        mCache->addEntryToObjectCache("b", makeImage(2), 2);
+        EXPECT_EQ(mCache->removeLeastRecentlyUsedObjectsInCache(3, getSize), 3);
+        EXPECT_EQ(mCache->getCacheSize(), 2);
+    }
+
+    TEST_F(ResourceObjectCacheTest, removeLeastRecentlyUsedObjectsInCacheShouldRemoveOldestFirst)
+    {
+        mCache->addEntryToObjectCache("recent", makeImage(1), 3);
+        mCache->addEntryToObjectCache("oldest", makeImage(1), 1);
+        mCache->addEntryToObjectCache("old", makeImage(1), 2);
+        EXPECT_EQ(mCache->removeLeastRecentlyUsedObjectsInCache(2, getSize), 2);
+        EXPECT_EQ(mCache->getRefFromObjectCache("oldest").get(), nullptr);
+        EXPECT_NE(mCache->getRefFromObjectCache("old").get(), nullptr);
+        EXPECT_NE(mCache->getRefFromObjectCache("recent").get(), nullptr);
+    }
+
+    TEST_F(ResourceObjectCacheTest, removeLeastRecentlyUsedObjectsInCacheShouldRemoveOnlyAsManyAsNeeded)
+    {
+        mCache->addEntryToObjectCache("small", makeImage(1), 1);
+        mCache->addEntryToObjectCache("large", makeImage(4), 2);
+        mCache->addEntryToObjectCache("recent", makeImage(1), 3);
+        EXPECT_EQ(mCache->removeLeastRecentlyUsedObjectsInCache(5, getSize), 5);
+        EXPECT_EQ(mCache->getCacheSize(), 2);
+        EXPECT_EQ(mCache->getRefFromObjectCache("small").get(), nullptr);
+    }
+
+    TEST_F(ResourceObjectCacheTest, removeLeastRecentlyUsedObjectsInCacheShouldKeepReferencedObjects)
+    {
+        const osg::ref_ptr<osg::Image> referenced = makeImage(2);
+        mCache->addEntryToObjectCache("referenced", referenced, 1);
+        mCache->addEntryToObjectCache("unreferenced", makeImage(2), 2);
+        EXPECT_EQ(mCache->removeLeastRecentlyUsedObjectsInCache(1, getSize), 2);
+        EXPECT_EQ(mCache->getRefFromObjectCache("referenced").get(), referenced.get());
+        EXPECT_EQ(mCache->getRefFromObjectCache("unreferenced").get(), nullptr);
+    }
+
+    TEST_F(ResourceObjectCacheTest, removeLeastRecentlyUsedObjectsInCacheWithoutLimitShouldOnlyMeasureSize)
+    {
+        mCache->addEntryToObjectCache("a", makeImage(1), 1);
+        mCache->addEntryToObjectCache("b", makeImage(2), 2);
+        EXPECT_EQ(mCache->removeLeastRecentlyUsedObjectsInCache(std::numeric_limits<std::size_t>::max(), getSize), 3);
+        EXPECT_EQ(mCache->getCacheSize(), 2);
+    }
+}
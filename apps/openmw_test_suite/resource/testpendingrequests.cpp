@@ -0,0 +1,248 @@
+#include <components/resource/pendingrequests.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/Image>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    using PendingImages = PendingRequests<osg::Image>;
+
+    // Occupies the only thread of the work queue until released
+    struct BlockingWorkItem : SceneUtil::WorkItem
+    {
+        std::promise<void> mStarted;
+        std::shared_future<void> mRelease;
+
+        explicit BlockingWorkItem(std::shared_future<void> release)
+            : mRelease(std::move(release))
+        {
+        }
+
+        void doWork() override
+        {
+            mStarted.set_value();
+            mRelease.wait();
+        }
+    };
+
+    struct ResourcePendingRequestsTest : Test
+    {
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue = new SceneUtil::WorkQueue(1);
+        PendingImages mRequests;
+        osg::ref_ptr<osg::Image> mImage = new osg::Image;
+        std::atomic_int mNumLoads{ 0 };
+        std::promise<void> mRelease;
+        osg::ref_ptr<BlockingWorkItem> mBlocker = new BlockingWorkItem(mRelease.get_future().share());
+        bool mBlocked = false;
+
+        ~ResourcePendingRequestsTest()
+        {
+            releaseWorkQueue();
+            mRequests.cancel();
+        }
+
+        PendingImages::Load makeLoad()
+        {
+            return [this](const std::string&) {
+                ++mNumLoads;
+                return mImage;
+            };
+        }
+
+        void blockWorkQueue()
+        {
+            mWorkQueue->addWorkItem(mBlocker);
+            mBlocked = true;
+            // Requests go to the front of the queue, they would be done before a blocker not started yet
+            mBlocker->mStarted.get_future().wait();
+        }
+
+        void releaseWorkQueue()
+        {
+            if (!mBlocked)
+                return;
+            mBlocked = false;
+            mRelease.set_value();
+            mBlocker->waitTillDone();
+        }
+
+        // The work queue has a single thread, the items added before are done when this one is
+        void flushWorkQueue()
+        {
+            osg::ref_ptr<SceneUtil::WorkItem> item = new SceneUtil::WorkItem;
+            mWorkQueue->addWorkItem(item);
+            item->waitTillDone();
+        }
+    };
+
+    TEST_F(ResourcePendingRequestsTest, requestShouldReturnNoValueWithoutWorkQueue)
+    {
+        EXPECT_FALSE(mRequests.request("image.dds", makeLoad()).has_value());
+        EXPECT_EQ(mRequests.size(), 0);
+        EXPECT_EQ(mNumLoads, 0);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, requestShouldLoadOnWorkQueue)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        const std::optional<PendingImages::Future> future = mRequests.request("image.dds", makeLoad());
+        ASSERT_TRUE(future.has_value());
+        EXPECT_EQ(future->get(), mImage);
+        EXPECT_EQ(mNumLoads, 1);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, requestsForSameResourceShouldShareResult)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        blockWorkQueue();
+        const std::optional<PendingImages::Future> first = mRequests.request("image.dds", makeLoad());
+        const std::optional<PendingImages::Future> second = mRequests.request("image.dds", makeLoad());
+        EXPECT_EQ(mRequests.size(), 1);
+        releaseWorkQueue();
+        ASSERT_TRUE(first.has_value());
+        ASSERT_TRUE(second.has_value());
+        EXPECT_EQ(first->get(), mImage);
+        EXPECT_EQ(second->get(), mImage);
+        EXPECT_EQ(mNumLoads, 1);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, finishedRequestShouldBeRemoved)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        mRequests.request("image.dds", makeLoad())->wait();
+        EXPECT_EQ(mRequests.size(), 0);
+        EXPECT_FALSE(mRequests.get("image.dds", makeLoad()).has_value());
+        EXPECT_EQ(mNumLoads, 1);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, getShouldReturnNoValueForNotRequestedResource)
+    {
+        EXPECT_FALSE(mRequests.get("image.dds", makeLoad()).has_value());
+        EXPECT_EQ(mNumLoads, 0);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, getShouldLoadNotStartedRequestOnCallingThreadOnce)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        blockWorkQueue();
+        const std::optional<PendingImages::Future> future = mRequests.request("image.dds", makeLoad());
+        std::thread::id loadingThread;
+        const auto load = [&](const std::string&) {
+            ++mNumLoads;
+            loadingThread = std::this_thread::get_id();
+            return mImage;
+        };
+        const std::optional<osg::ref_ptr<osg::Image>> result = mRequests.get("image.dds", load);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(*result, mImage);
+        EXPECT_EQ(loadingThread, std::this_thread::get_id());
+        ASSERT_TRUE(future.has_value());
+        EXPECT_EQ(future->wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        EXPECT_EQ(future->get(), mImage);
+        releaseWorkQueue();
+        flushWorkQueue();
+        EXPECT_EQ(mNumLoads, 1);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, getShouldWaitForRequestBeingLoaded)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        std::promise<void> started;
+        std::promise<void> finish;
+        std::shared_future<void> finishFuture = finish.get_future().share();
+        const auto load = [&](const std::string&) {
+            ++mNumLoads;
+            started.set_value();
+            finishFuture.wait();
+            return mImage;
+        };
+        const std::optional<PendingImages::Future> future = mRequests.request("image.dds", load);
+        started.get_future().wait();
+        std::thread finishing([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            finish.set_value();
+        });
+        const std::optional<osg::ref_ptr<osg::Image>> result = mRequests.get("image.dds", makeLoad());
+        finishing.join();
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(*result, mImage);
+        EXPECT_EQ(mNumLoads, 1);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, failedLoadShouldFailRequest)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        const auto load = [](const std::string&) -> osg::ref_ptr<osg::Image> { throw std::runtime_error("error"); };
+        const std::optional<PendingImages::Future> future = mRequests.request("image.dds", load);
+        ASSERT_TRUE(future.has_value());
+        EXPECT_THROW(future->get(), std::runtime_error);
+        EXPECT_EQ(mRequests.size(), 0);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, cancelShouldFailNotStartedRequest)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        blockWorkQueue();
+        const std::optional<PendingImages::Future> future = mRequests.request("image.dds", makeLoad());
+        mRequests.cancel();
+        EXPECT_EQ(mRequests.size(), 0);
+        ASSERT_TRUE(future.has_value());
+        EXPECT_THROW(future->get(), std::runtime_error);
+        releaseWorkQueue();
+        flushWorkQueue();
+        EXPECT_EQ(mNumLoads, 0);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, cancelShouldWaitForRequestBeingLoaded)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        std::promise<void> started;
+        std::promise<void> finish;
+        std::shared_future<void> finishFuture = finish.get_future().share();
+        std::atomic_bool loaded{ false };
+        const auto load = [&](const std::string&) {
+            started.set_value();
+            finishFuture.wait();
+            loaded = true;
+            return mImage;
+        };
+        const std::optional<PendingImages::Future> future = mRequests.request("image.dds", load);
+        started.get_future().wait();
+        std::thread finishing([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            finish.set_value();
+        });
+        mRequests.cancel();
+        EXPECT_TRUE(loaded);
+        finishing.join();
+        ASSERT_TRUE(future.has_value());
+        EXPECT_EQ(future->get(), mImage);
+    }
+
+    TEST_F(ResourcePendingRequestsTest, requestAfterCancelShouldBeLoaded)
+    {
+        mRequests.setWorkQueue(mWorkQueue);
+        blockWorkQueue();
+        const std::optional<PendingImages::Future> cancelled = mRequests.request("image.dds", makeLoad());
+        mRequests.cancel();
+        const std::optional<PendingImages::Future> future = mRequests.request("image.dds", makeLoad());
+        releaseWorkQueue();
+        ASSERT_TRUE(cancelled.has_value());
+        EXPECT_THROW(cancelled->get(), std::runtime_error);
+        ASSERT_TRUE(future.has_value());
+        EXPECT_EQ(future->get(), mImage);
+        EXPECT_EQ(mNumLoads, 1);
+    }
+}
@@ -0,0 +1,199 @@
+#include <components/resource/errormarker.hpp>
+#include <components/resource/imagemanager.hpp>
+#include <components/resource/niffilemanager.hpp>
+#include <components/resource/scenemanager.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/Node>
+#include <osg/Stats>
+#include <osgDB/Registry>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "../testing_util.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace Resource;
+
+    // Counts the loads of the scene, each one opens the file once
+    class CountingVFSFile : public VFS::File
+    {
+    public:
+        std::atomic_int mNumOpened{ 0 };
+        std::promise<void> mOpened;
+        // Opening waits for it when valid
+        std::shared_future<void> mRelease;
+
+        Files::IStreamPtr open() override
+        {
+            if (mNumOpened++ == 0)
+                mOpened.set_value();
+            if (mRelease.valid())
+                mRelease.wait();
+            return std::make_unique<std::stringstream>(std::string(ErrorMarker::sValue), std::ios_base::in);
+        }
+
+        std::filesystem::path getPath() override { return "TestFile"; }
+    };
+
+    // Occupies the only thread of the work queue until released
+    struct BlockingWorkItem : SceneUtil::WorkItem
+    {
+        std::promise<void> mStarted;
+        std::shared_future<void> mRelease;
+
+        explicit BlockingWorkItem(std::shared_future<void> release)
+            : mRelease(std::move(release))
+        {
+        }
+
+        void doWork() override
+        {
+            mStarted.set_value();
+            mRelease.wait();
+        }
+    };
+
+    struct ResourceSceneManagerTest : Test
+    {
+        const std::string mName = "meshes/scene.osgt";
+        CountingVFSFile mFile;
+        CountingVFSFile mOtherFile;
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue = new SceneUtil::WorkQueue(1);
+        std::unique_ptr<VFS::Manager> mVFS
+            = TestingOpenMW::createTestVFS({ { mName, &mFile }, { "meshes/other.osgt", &mOtherFile } });
+        ImageManager mImageManager{ mVFS.get() };
+        NifFileManager mNifFileManager{ mVFS.get() };
+        SceneManager mSceneManager{ mVFS.get(), &mImageManager, &mNifFileManager };
+
+        void SetUp() override
+        {
+            if (osgDB::Registry::instance()->getReaderWriterForExtension("osgt") == nullptr)
+                GTEST_SKIP() << "osgt reader writer is not found";
+            mSceneManager.setWorkQueue(mWorkQueue);
+        }
+
+        void TearDown() override { mSceneManager.setWorkQueue(nullptr); }
+
+        void blockWorkQueue(std::shared_future<void> release)
+        {
+            osg::ref_ptr<BlockingWorkItem> item = new BlockingWorkItem(std::move(release));
+            mWorkQueue->addWorkItem(item);
+            // Requests go to the front of the queue, they would be done before a blocker not started yet
+            item->mStarted.get_future().wait();
+        }
+
+        // The work queue has a single thread, the items added before are done when this one is
+        void flushWorkQueue()
+        {
+            osg::ref_ptr<SceneUtil::WorkItem> item = new SceneUtil::WorkItem;
+            mWorkQueue->addWorkItem(item);
+            item->waitTillDone();
+        }
+
+        double getNumSyncLoads() const
+        {
+            osg::ref_ptr<osg::Stats> stats = new osg::Stats("stats");
+            mSceneManager.reportStats(0, stats);
+            double result = 0;
+            stats->getAttribute(0, "Node Sync Load", result);
+            return result;
+        }
+    };
+
+    TEST_F(ResourceSceneManagerTest, requestTemplateShouldLoadSceneOnWorkQueue)
+    {
+        const std::shared_future<osg::ref_ptr<const osg::Node>> future = mSceneManager.requestTemplate(mName);
+        ASSERT_NE(future.get().get(), nullptr);
+        EXPECT_EQ(mSceneManager.getTemplate(mName), future.get());
+        EXPECT_EQ(mFile.mNumOpened, 1);
+        EXPECT_EQ(getNumSyncLoads(), 0);
+    }
+
+    TEST_F(ResourceSceneManagerTest, getTemplateShouldLoadNotStartedRequestOnceOnCallingThread)
+    {
+        std::promise<void> release;
+        blockWorkQueue(release.get_future().share());
+        const std::shared_future<osg::ref_ptr<const osg::Node>> future = mSceneManager.requestTemplate(mName);
+        const osg::ref_ptr<const osg::Node> scene = mSceneManager.getTemplate(mName);
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        EXPECT_EQ(future.get(), scene);
+        release.set_value();
+        flushWorkQueue();
+        EXPECT_EQ(mFile.mNumOpened, 1);
+        EXPECT_EQ(getNumSyncLoads(), 1);
+    }
+
+    TEST_F(ResourceSceneManagerTest, getTemplateShouldWaitForRequestBeingLoaded)
+    {
+        std::promise<void> release;
+        mFile.mRelease = release.get_future().share();
+        const std::shared_future<osg::ref_ptr<const osg::Node>> future = mSceneManager.requestTemplate(mName);
+        mFile.mOpened.get_future().wait();
+        std::thread releasing([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            release.set_value();
+        });
+        const osg::ref_ptr<const osg::Node> scene = mSceneManager.getTemplate(mName);
+        releasing.join();
+        EXPECT_EQ(future.get(), scene);
+        EXPECT_EQ(mFile.mNumOpened, 1);
+        EXPECT_EQ(getNumSyncLoads(), 0);
+    }
+
+    TEST_F(ResourceSceneManagerTest, cancelShouldFailRequestNotStartedWithoutLoadingIt)
+    {
+        std::promise<void> release;
+        blockWorkQueue(release.get_future().share());
+        const std::shared_future<osg::ref_ptr<const osg::Node>> future = mSceneManager.requestTemplate(mName);
+        mSceneManager.setWorkQueue(nullptr);
+        EXPECT_THROW(future.get(), std::runtime_error);
+        release.set_value();
+        flushWorkQueue();
+        EXPECT_EQ(mFile.mNumOpened, 0);
+    }
+
+    TEST_F(ResourceSceneManagerTest, cancelShouldWaitForRequestBeingLoaded)
+    {
+        std::promise<void> release;
+        mFile.mRelease = release.get_future().share();
+        const std::shared_future<osg::ref_ptr<const osg::Node>> future = mSceneManager.requestTemplate(mName);
+        mFile.mOpened.get_future().wait();
+        std::thread releasing([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            release.set_value();
+        });
+        mSceneManager.setWorkQueue(nullptr);
+        EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        releasing.join();
+        EXPECT_NE(future.get().get(), nullptr);
+        EXPECT_EQ(mFile.mNumOpened, 1);
+    }
+
+    TEST_F(ResourceSceneManagerTest, numSyncLoadsShouldCountOnlyLoadsOnMainThread)
+    {
+        mSceneManager.requestTemplate(mName).wait();
+        mSceneManager.getTemplate(mName);
+        EXPECT_EQ(getNumSyncLoads(), 0);
+        std::thread([&] { mSceneManager.getTemplate("meshes/other.osgt"); }).join();
+        EXPECT_EQ(mOtherFile.mNumOpened, 1);
+        EXPECT_EQ(getNumSyncLoads(), 0);
+        mSceneManager.getTemplate("meshes/other.osgt");
+        EXPECT_EQ(getNumSyncLoads(), 0);
+        mSceneManager.clearCache();
+        mSceneManager.getTemplate("meshes/other.osgt");
+        EXPECT_EQ(mOtherFile.mNumOpened, 2);
+        EXPECT_EQ(getNumSyncLoads(), 1);
+    }
+}
@@ -0,0 +1,78 @@
+#include <components/sceneutil/optimizer.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct CountGeometriesVisitor : osg::NodeVisitor
+    {
+        unsigned int mNumGeometries = 0;
+        unsigned int mNumVertices = 0;
+
+        CountGeometriesVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+        {
+        }
+
+        void apply(osg::Geometry& geometry) override
+        {
+            ++mNumGeometries;
+            mNumVertices += geometry.getVertexArray()->getNumElements();
+        }
+    };
+
+    osg::ref_ptr<osg::Node> makeTriangle(const osg::Vec3f& position)
+    {
+        osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+        vertices->push_back(osg::Vec3f(0, 0, 0));
+        vertices->push_back(osg::Vec3f(1, 0, 0));
+        vertices->push_back(osg::Vec3f(0, 1, 0));
+        osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+        geometry->setVertexArray(vertices);
+        geometry->addPrimitiveSet(new osg::DrawArrays(GL_TRIANGLES, 0, 3));
+        osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(osg::Matrix::translate(position));
+        transform->addChild(geometry);
+        return transform;
+    }
+
+    struct SceneUtilOptimizerTest : Test
+    {
+        osg::ref_ptr<WorkQueue> mWorkQueue = new WorkQueue(1);
+        Optimizer mOptimizer;
+        osg::ref_ptr<osg::Group> mRoot = new osg::Group;
+
+        SceneUtilOptimizerTest()
+        {
+            mRoot->addChild(makeTriangle(osg::Vec3f(0, 0, 0)));
+            mRoot->addChild(makeTriangle(osg::Vec3f(10, 0, 0)));
+        }
+    };
+
+    TEST_F(SceneUtilOptimizerTest, optimizeShouldMergeIndependentChildrenWithSameState)
+    {
+        mOptimizer.optimize(mRoot,
+            Optimizer::FLATTEN_STATIC_TRANSFORMS | Optimizer::REMOVE_REDUNDANT_NODES | Optimizer::MERGE_GEOMETRY);
+        CountGeometriesVisitor visitor;
+        mRoot->accept(visitor);
+        EXPECT_EQ(visitor.mNumGeometries, 1);
+        EXPECT_EQ(visitor.mNumVertices, 6);
+    }
+
+    TEST_F(SceneUtilOptimizerTest, optimizeWithWorkQueueShouldMergeIndependentChildrenWithSameState)
+    {
+        mOptimizer.setWorkQueue(mWorkQueue);
+        mOptimizer.optimize(mRoot,
+            Optimizer::FLATTEN_STATIC_TRANSFORMS | Optimizer::REMOVE_REDUNDANT_NODES | Optimizer::MERGE_GEOMETRY);
+        CountGeometriesVisitor visitor;
+        mRoot->accept(visitor);
+        EXPECT_EQ(visitor.mNumGeometries, 1);
+        EXPECT_EQ(visitor.mNumVertices, 6);
+    }
+}
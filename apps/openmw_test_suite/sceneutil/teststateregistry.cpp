@@ -0,0 +1,98 @@
+#include <components/sceneutil/stateregistry.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/BlendFunc>
+#include <osg/Image>
+#include <osg/Material>
+#include <osg/Texture2D>
+
+#include <string>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    osg::ref_ptr<osg::Material> makeMaterial(const osg::Vec4f& diffuse)
+    {
+        osg::ref_ptr<osg::Material> material = new osg::Material;
+        material->setDiffuse(osg::Material::FRONT_AND_BACK, diffuse);
+        return material;
+    }
+
+    osg::ref_ptr<osg::Texture2D> makeTexture(osg::Image* image, const std::string& name)
+    {
+        osg::ref_ptr<osg::Texture2D> texture = new osg::Texture2D(image);
+        texture->setName(name);
+        texture->setWrap(osg::Texture::WRAP_S, osg::Texture::REPEAT);
+        return texture;
+    }
+
+    TEST(SceneUtilStateRegistryTest, shareShouldReturnRegisteredEqualAttribute)
+    {
+        StateRegistry registry;
+        const osg::ref_ptr<osg::Material> first = registry.share(makeMaterial(osg::Vec4f(1, 0, 0, 1)));
+        EXPECT_EQ(registry.share(makeMaterial(osg::Vec4f(1, 0, 0, 1))), first);
+    }
+
+    TEST(SceneUtilStateRegistryTest, shareShouldNotReplaceDifferentAttribute)
+    {
+        StateRegistry registry;
+        const osg::ref_ptr<osg::Material> first = registry.share(makeMaterial(osg::Vec4f(1, 0, 0, 1)));
+        const osg::ref_ptr<osg::Material> second = makeMaterial(osg::Vec4f(0, 1, 0, 1));
+        EXPECT_EQ(registry.share(second), second);
+        const osg::ref_ptr<osg::BlendFunc> blendFunc = new osg::BlendFunc;
+        EXPECT_EQ(registry.share(blendFunc), blendFunc);
+    }
+
+    TEST(SceneUtilStateRegistryTest, shareShouldReturnRegisteredTextureOfSameImageAndName)
+    {
+        StateRegistry registry;
+        const osg::ref_ptr<osg::Image> image = new osg::Image;
+        const osg::ref_ptr<osg::Texture2D> first = registry.share(makeTexture(image, "diffuseMap"));
+        EXPECT_EQ(registry.share(makeTexture(image, "diffuseMap")), first);
+        const osg::ref_ptr<osg::Texture2D> otherName = makeTexture(image, "emissiveMap");
+        EXPECT_EQ(registry.share(otherName), otherName);
+    }
+
+    TEST(SceneUtilStateRegistryTest, shareShouldNotRegisterTexturesWithoutImage)
+    {
+        StateRegistry registry;
+        registry.share(makeTexture(nullptr, "diffuseMap"));
+        const osg::ref_ptr<osg::Texture2D> texture = makeTexture(nullptr, "diffuseMap");
+        EXPECT_EQ(registry.share(texture), texture);
+    }
+
+    TEST(SceneUtilStateRegistryTest, shareShouldApplyFilterSettingsToTextures)
+    {
+        StateRegistry registry;
+        registry.setFilterSettings(osg::Texture::NEAREST, osg::Texture::NEAREST, 4);
+        const osg::ref_ptr<osg::Image> image = new osg::Image;
+        const osg::ref_ptr<osg::Texture2D> texture = registry.share(makeTexture(image, "diffuseMap"));
+        EXPECT_EQ(texture->getFilter(osg::Texture::MIN_FILTER), osg::Texture::NEAREST);
+        EXPECT_EQ(texture->getFilter(osg::Texture::MAG_FILTER), osg::Texture::NEAREST);
+        EXPECT_EQ(texture->getMaxAnisotropy(), 4);
+    }
+
+    TEST(SceneUtilStateRegistryTest, setFilterSettingsShouldKeepTexturesShared)
+    {
+        StateRegistry registry;
+        const osg::ref_ptr<osg::Image> image = new osg::Image;
+        const osg::ref_ptr<osg::Texture2D> first = registry.share(makeTexture(image, "diffuseMap"));
+        registry.setFilterSettings(osg::Texture::LINEAR_MIPMAP_NEAREST, osg::Texture::NEAREST, 8);
+        EXPECT_EQ(first->getFilter(osg::Texture::MIN_FILTER), osg::Texture::LINEAR_MIPMAP_NEAREST);
+        EXPECT_EQ(registry.share(makeTexture(image, "diffuseMap")), first);
+    }
+
+    TEST(SceneUtilStateRegistryTest, pruneShouldRemoveAttributesNotUsedAnymore)
+    {
+        StateRegistry registry;
+        const osg::ref_ptr<osg::Material> used = registry.share(makeMaterial(osg::Vec4f(1, 0, 0, 1)));
+        registry.share(makeMaterial(osg::Vec4f(0, 1, 0, 1)));
+        registry.prune();
+        EXPECT_EQ(registry.share(makeMaterial(osg::Vec4f(1, 0, 0, 1))), used);
+        const osg::ref_ptr<osg::Material> unused = makeMaterial(osg::Vec4f(0, 1, 0, 1));
+        EXPECT_EQ(registry.share(unused), unused);
+    }
+}
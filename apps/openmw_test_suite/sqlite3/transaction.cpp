@@ -64,4 +64,30 @@ namespace
         }
         EXPECT_THAT(getIds(), ElementsAre(std::tuple(42)));
     }
+
+    TEST_F(Sqlite3TransactionTest, savepointShouldRollbackOnlyItsChangesOnDestruction)
+    {
+        {
+            Transaction transaction(*mDb);
+            insertId();
+            {
+                const Savepoint savepoint(*mDb, "test");
+                insertId();
+            }
+            transaction.commit();
+        }
+        EXPECT_THAT(getIds(), ElementsAre(std::tuple(42)));
+    }
+
+    TEST_F(Sqlite3TransactionTest, releasedSavepointChangesShouldBeCommittedWithTransaction)
+    {
+        {
+            Transaction transaction(*mDb);
+            Savepoint savepoint(*mDb, "test");
+            insertId();
+            savepoint.release();
+            transaction.commit();
+        }
+        EXPECT_THAT(getIds(), ElementsAre(std::tuple(42)));
+    }
 }
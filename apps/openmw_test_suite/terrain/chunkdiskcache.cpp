@@ -0,0 +1,232 @@
+#include "../testing_util.hpp"
+
+#include <components/terrain/chunkdiskcache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <osg/Array>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace testing;
+    using namespace Terrain;
+
+    struct Chunk
+    {
+        osg::ref_ptr<osg::Vec3Array> mPositions = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec3Array> mNormals = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec4ubArray> mColours = new osg::Vec4ubArray;
+    };
+
+    Chunk makeChunk(std::size_t numVertices, float value)
+    {
+        Chunk result;
+        for (std::size_t i = 0; i < numVertices; ++i)
+        {
+            result.mPositions->push_back(osg::Vec3f(value, static_cast<float>(i), 1));
+            result.mNormals->push_back(osg::Vec3f(0, 0, value));
+            result.mColours->push_back(osg::Vec4ub(1, 2, static_cast<unsigned char>(i), 255));
+        }
+        return result;
+    }
+
+    struct TerrainChunkDiskCacheTest : Test
+    {
+        const std::filesystem::path mDirectory = TestingOpenMW::outputFilePath("chunkdiskcache");
+        const osg::Vec2f mCenter{ 0.5f, -1.5f };
+        const Chunk mChunk = makeChunk(4, 42);
+
+        TerrainChunkDiskCacheTest() { std::filesystem::remove_all(mDirectory); }
+
+        std::filesystem::path getSegmentPath(const std::string& digest, unsigned number) const
+        {
+            return mDirectory / ("terrain-" + digest + "-" + std::to_string(number) + ".bin");
+        }
+
+        static void write(ChunkDiskCache& cache, const osg::Vec2f& center, const Chunk& chunk)
+        {
+            cache.write(1, center, 0, *chunk.mPositions, *chunk.mNormals, *chunk.mColours);
+        }
+
+        static bool read(const ChunkDiskCache& cache, const osg::Vec2f& center, Chunk& chunk)
+        {
+            return cache.read(1, center, 0, *chunk.mPositions, *chunk.mNormals, *chunk.mColours);
+        }
+
+        void expectCached(const ChunkDiskCache& cache, const osg::Vec2f& center, const Chunk& expected) const
+        {
+            Chunk chunk;
+            ASSERT_TRUE(read(cache, center, chunk));
+            EXPECT_EQ(chunk.mPositions->asVector(), expected.mPositions->asVector());
+            EXPECT_EQ(chunk.mNormals->asVector(), expected.mNormals->asVector());
+            EXPECT_EQ(chunk.mColours->asVector(), expected.mColours->asVector());
+        }
+
+        void writeFile(const std::filesystem::path& path, const std::vector<char>& content) const
+        {
+            std::filesystem::create_directories(mDirectory);
+            std::ofstream(path, std::ios::binary).write(content.data(), static_cast<std::streamsize>(content.size()));
+        }
+
+        static std::vector<char> makeHeader(std::uint32_t version, std::uint32_t count)
+        {
+            std::vector<char> result = { 'O', 'M', 'W', 'T', 'C', 'H', 'N', 'K' };
+            result.insert(result.end(), reinterpret_cast<const char*>(&version),
+                reinterpret_cast<const char*>(&version) + sizeof(version));
+            result.insert(result.end(), reinterpret_cast<const char*>(&count),
+                reinterpret_cast<const char*>(&count) + sizeof(count));
+            return result;
+        }
+    };
+
+    TEST_F(TerrainChunkDiskCacheTest, readShouldReturnFalseForMissingChunk)
+    {
+        const ChunkDiskCache cache(mDirectory, "digest");
+        Chunk chunk;
+        EXPECT_FALSE(read(cache, mCenter, chunk));
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, readShouldReturnPendingChunk)
+    {
+        ChunkDiskCache cache(mDirectory, "digest");
+        write(cache, mCenter, mChunk);
+        EXPECT_EQ(cache.getNumEntries(), 1);
+        expectCached(cache, mCenter, mChunk);
+        EXPECT_FALSE(std::filesystem::exists(getSegmentPath("digest", 0)));
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, readShouldReturnFlushedChunkAfterReopening)
+    {
+        {
+            ChunkDiskCache cache(mDirectory, "digest");
+            write(cache, mCenter, mChunk);
+            cache.flush();
+            EXPECT_EQ(cache.getPendingDataSize(), 0);
+            expectCached(cache, mCenter, mChunk);
+        }
+        const ChunkDiskCache cache(mDirectory, "digest");
+        EXPECT_EQ(cache.getNumEntries(), 1);
+        expectCached(cache, mCenter, mChunk);
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, destructorShouldFlushPendingChunks)
+    {
+        {
+            ChunkDiskCache cache(mDirectory, "digest");
+            write(cache, mCenter, mChunk);
+        }
+        const ChunkDiskCache cache(mDirectory, "digest");
+        expectCached(cache, mCenter, mChunk);
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, writeShouldIgnoreAlreadyCachedChunk)
+    {
+        ChunkDiskCache cache(mDirectory, "digest");
+        write(cache, mCenter, mChunk);
+        cache.flush();
+        write(cache, mCenter, makeChunk(4, 13));
+        EXPECT_EQ(cache.getNumEntries(), 1);
+        EXPECT_EQ(cache.getPendingDataSize(), 0);
+        expectCached(cache, mCenter, mChunk);
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, writeShouldAddSegmentWhenPendingDataExceedsLimit)
+    {
+        ChunkDiskCache cache(mDirectory, "digest", 1);
+        write(cache, mCenter, mChunk);
+        EXPECT_EQ(cache.getPendingDataSize(), 0);
+        EXPECT_TRUE(std::filesystem::exists(getSegmentPath("digest", 0)));
+        expectCached(cache, mCenter, mChunk);
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, flushShouldNotRewriteExistingSegments)
+    {
+        const Chunk other = makeChunk(8, 13);
+        ChunkDiskCache cache(mDirectory, "digest");
+        write(cache, mCenter, mChunk);
+        cache.flush();
+        const auto firstSize = std::filesystem::file_size(getSegmentPath("digest", 0));
+        write(cache, osg::Vec2f(2.5f, 3.5f), other);
+        cache.flush();
+        EXPECT_EQ(std::filesystem::file_size(getSegmentPath("digest", 0)), firstSize);
+        EXPECT_TRUE(std::filesystem::exists(getSegmentPath("digest", 1)));
+        const ChunkDiskCache reopened(mDirectory, "digest");
+        EXPECT_EQ(reopened.getNumEntries(), 2);
+        expectCached(reopened, mCenter, mChunk);
+        expectCached(reopened, osg::Vec2f(2.5f, 3.5f), other);
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, shouldNotReadChunksOfOtherContentDigest)
+    {
+        {
+            ChunkDiskCache cache(mDirectory, "digest");
+            write(cache, mCenter, mChunk);
+        }
+        const ChunkDiskCache cache(mDirectory, "other");
+        Chunk chunk;
+        EXPECT_FALSE(read(cache, mCenter, chunk));
+        EXPECT_TRUE(std::filesystem::exists(getSegmentPath("digest", 0)));
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, shouldRemoveSegmentsOfLeastRecentlyUsedContentDigests)
+    {
+        for (const std::string digest : { "old", "recent" })
+        {
+            ChunkDiskCache cache(mDirectory, digest);
+            write(cache, mCenter, mChunk);
+        }
+        const auto now = std::filesystem::file_time_type::clock::now();
+        std::filesystem::last_write_time(getSegmentPath("old", 0), now - std::chrono::hours(2));
+        std::filesystem::last_write_time(getSegmentPath("recent", 0), now - std::chrono::hours(1));
+        const ChunkDiskCache cache(mDirectory, "digest", ChunkDiskCache::defaultMaxPendingDataSize, 2);
+        EXPECT_FALSE(std::filesystem::exists(getSegmentPath("old", 0)));
+        EXPECT_TRUE(std::filesystem::exists(getSegmentPath("recent", 0)));
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, shouldIgnoreAndRemoveCorruptSegment)
+    {
+        writeFile(getSegmentPath("digest", 0), { 'g', 'a', 'r', 'b', 'a', 'g', 'e' });
+        ChunkDiskCache cache(mDirectory, "digest");
+        EXPECT_EQ(cache.getNumEntries(), 0);
+        EXPECT_FALSE(std::filesystem::exists(getSegmentPath("digest", 0)));
+        write(cache, mCenter, mChunk);
+        cache.flush();
+        expectCached(ChunkDiskCache(mDirectory, "digest"), mCenter, mChunk);
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, shouldIgnoreSegmentWithTruncatedIndex)
+    {
+        writeFile(getSegmentPath("digest", 0), makeHeader(2, 10));
+        const ChunkDiskCache cache(mDirectory, "digest");
+        EXPECT_EQ(cache.getNumEntries(), 0);
+        EXPECT_FALSE(std::filesystem::exists(getSegmentPath("digest", 0)));
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, shouldIgnoreSegmentOfOtherVersion)
+    {
+        writeFile(getSegmentPath("digest", 0), makeHeader(1, 0));
+        const ChunkDiskCache cache(mDirectory, "digest");
+        EXPECT_EQ(cache.getNumEntries(), 0);
+        EXPECT_FALSE(std::filesystem::exists(getSegmentPath("digest", 0)));
+    }
+
+    TEST_F(TerrainChunkDiskCacheTest, shouldKeepValidSegmentsAfterInvalidOne)
+    {
+        {
+            ChunkDiskCache cache(mDirectory, "digest");
+            write(cache, mCenter, mChunk);
+        }
+        std::filesystem::rename(getSegmentPath("digest", 0), getSegmentPath("digest", 1));
+        writeFile(getSegmentPath("digest", 0), makeHeader(1, 0));
+        const ChunkDiskCache cache(mDirectory, "digest");
+        EXPECT_EQ(cache.getNumEntries(), 1);
+        expectCached(cache, mCenter, mChunk);
+    }
+}
@@ -0,0 +1,327 @@
+#include <components/debug/debugging.hpp>
+#include <components/debug/debuglog.hpp>
+#include <components/esm3/loadland.hpp>
+#include <components/esm3/readerscache.hpp>
+#include <components/esm3terrain/storage.hpp>
+#include <components/esmloader/esmdata.hpp>
+#include <components/esmloader/load.hpp>
+#include <components/files/collections.hpp>
+#include <components/files/configurationmanager.hpp>
+#include <components/files/multidircollection.hpp>
+#include <components/misc/mathutil.hpp>
+#include <components/platform/platform.hpp>
+#include <components/settings/settings.hpp>
+#include <components/terrain/chunkdiskcache.hpp>
+#include <components/terrain/quadtreeworld.hpp>
+#include <components/to_utf8/to_utf8.hpp>
+#include <components/version/version.hpp>
+#include <components/vfs/manager.hpp>
+#include <components/vfs/registerarchives.hpp>
+
+#include <osg/ref_ptr>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    namespace bpo = boost::program_options;
+
+    using StringsVector = std::vector<std::string>;
+
+    constexpr std::string_view applicationName = "TerrainCacheTool";
+
+    // Bounds the memory used to keep land data loaded while neighbouring chunks are generated.
+    constexpr std::size_t maxCachedLands = 1024;
+
+    // Bounds the memory used to keep generated chunks until they are written.
+    constexpr std::size_t maxPendingDataSize = 256 * 1024 * 1024;
+
+    bpo::options_description makeOptionsDescription()
+    {
+        bpo::options_description result;
+        auto addOption = result.add_options();
+        addOption("help", "print help message");
+
+        addOption("version", "print version information and quit");
+
+        addOption("data",
+            bpo::value<Files::MaybeQuotedPathContainer>()
+                ->default_value(Files::MaybeQuotedPathContainer(), "data")
+                ->multitoken()
+                ->composing(),
+            "set data directories (later directories have higher priority)");
+
+        addOption("data-local",
+            bpo::value<Files::MaybeQuotedPathContainer::value_type>()->default_value(
+                Files::MaybeQuotedPathContainer::value_type(), ""),
+            "set local data directory (highest priority)");
+
+        addOption("fallback-archive",
+            bpo::value<StringsVector>()->default_value(StringsVector(), "fallback-archive")->multitoken()->composing(),
+            "set fallback BSA archives (later archives have higher priority)");
+
+        addOption("resources",
+            bpo::value<Files::MaybeQuotedPath>()->default_value(Files::MaybeQuotedPath(), "resources"),
+            "set resources directory");
+
+        addOption("content", bpo::value<StringsVector>()->default_value(StringsVector(), "")->multitoken()->composing(),
+            "content file(s): esm/esp, or omwgame/omwaddon/omwscripts");
+
+        addOption("fs-strict", bpo::value<bool>()->implicit_value(true)->default_value(false),
+            "strict file system handling (no case folding)");
+
+        addOption("encoding", bpo::value<std::string>()->default_value("win1252"),
+            "Character encoding used in OpenMW game messages:\n"
+            "\n\twin1250 - Central and Eastern European such as Polish, Czech, Slovak, Hungarian, Slovene, Bosnian, "
+            "Croatian, Serbian (Latin script), Romanian and Albanian languages\n"
+            "\n\twin1251 - Cyrillic alphabet such as Russian, Bulgarian, Serbian Cyrillic and other languages\n"
+            "\n\twin1252 - Western European (Latin) alphabet, used by default");
+        ;
+        Files::ConfigurationManager::addCommonOptions(result);
+
+        return result;
+    }
+
+    class LandStorage final : public ESMTerrain::Storage
+    {
+    public:
+        LandStorage(const VFS::Manager* vfs, const std::vector<ESM::Land>& lands)
+            : ESMTerrain::Storage(vfs)
+        {
+            for (const ESM::Land& land : lands)
+                mLands.emplace(std::pair(land.mX, land.mY), &land);
+        }
+
+        osg::ref_ptr<const ESMTerrain::LandObject> getLand(int cellX, int cellY) override
+        {
+            const auto land = mLands.find(std::pair(cellX, cellY));
+            if (land == mLands.end())
+                return nullptr;
+
+            const auto cached = mLoaded.find(land->first);
+            if (cached != mLoaded.end())
+                return cached->second;
+
+            if (mLoaded.size() >= maxCachedLands)
+                mLoaded.clear();
+
+            osg::ref_ptr<const ESMTerrain::LandObject> result = new ESMTerrain::LandObject(
+                land->second, ESM::Land::DATA_VCLR | ESM::Land::DATA_VHGT | ESM::Land::DATA_VNML);
+            mLoaded.emplace(land->first, result);
+            return result;
+        }
+
+        // Land textures do not contribute to vertex data.
+        const ESM::LandTexture* getLandTexture(int index, short plugin) override { return nullptr; }
+
+        bool hasData(int cellX, int cellY) override { return mLands.find(std::pair(cellX, cellY)) != mLands.end(); }
+
+        void getBounds(float& minX, float& maxX, float& minY, float& maxY) override
+        {
+            minX = 0;
+            minY = 0;
+            maxX = 0;
+            maxY = 0;
+
+            for (const auto& [position, land] : mLands)
+            {
+                minX = std::min(minX, static_cast<float>(position.first));
+                maxX = std::max(maxX, static_cast<float>(position.first));
+                minY = std::min(minY, static_cast<float>(position.second));
+                maxY = std::max(maxY, static_cast<float>(position.second));
+            }
+
+            // since grid coords are at cell origin, we need to add 1 cell
+            maxX += 1;
+            maxY += 1;
+        }
+
+    private:
+        std::map<std::pair<int, int>, const ESM::Land*> mLands;
+        std::map<std::pair<int, int>, osg::ref_ptr<const ESMTerrain::LandObject>> mLoaded;
+    };
+
+    /// Visits every chunk the quad tree of Terrain::QuadTreeWorld may request from its chunk manager, reproducing the
+    /// node layout of its builder so that the cache keys match.
+    class ChunkGenerator
+    {
+    public:
+        ChunkGenerator(LandStorage& storage, Terrain::ChunkDiskCache& cache, int vertexLodMod)
+            : mStorage(storage)
+            , mCache(cache)
+            , mVertexLodMod(vertexLodMod)
+        {
+        }
+
+        void generate()
+        {
+            mStorage.getBounds(mMinX, mMaxX, mMinY, mMaxY);
+
+            const int origSizeX = static_cast<int>(mMaxX - mMinX);
+            const int origSizeY = static_cast<int>(mMaxY - mMinY);
+            const int size = Misc::nextPowerOfTwo(std::max(origSizeX, origSizeY));
+
+            const float centerX = (mMinX + mMaxX) / 2.f + (size - origSizeX) / 2.f;
+            const float centerY = (mMinY + mMaxY) / 2.f + (size - origSizeY) / 2.f;
+
+            generateChunk(static_cast<float>(size), osg::Vec2f(centerX, centerY));
+            visitChildren(static_cast<float>(size), osg::Vec2f(centerX, centerY));
+        }
+
+        std::size_t getNumGenerated() const { return mNumGenerated; }
+
+        std::size_t getNumSkipped() const { return mNumSkipped; }
+
+    private:
+        LandStorage& mStorage;
+        Terrain::ChunkDiskCache& mCache;
+        const int mVertexLodMod;
+        float mMinX = 0;
+        float mMaxX = 0;
+        float mMinY = 0;
+        float mMaxY = 0;
+        std::size_t mNumGenerated = 0;
+        std::size_t mNumSkipped = 0;
+
+        void visitChildren(float parentSize, const osg::Vec2f& parentCenter)
+        {
+            const float size = parentSize / 2.f;
+            const float halfSize = size / 2.f;
+            visit(size, parentCenter + osg::Vec2f(-halfSize, -halfSize));
+            visit(size, parentCenter + osg::Vec2f(halfSize, -halfSize));
+            visit(size, parentCenter + osg::Vec2f(-halfSize, halfSize));
+            visit(size, parentCenter + osg::Vec2f(halfSize, halfSize));
+        }
+
+        void visit(float size, const osg::Vec2f& center)
+        {
+            const float halfSize = size / 2.f;
+            if (center.x() - halfSize > mMaxX || center.x() + halfSize < mMinX || center.y() - halfSize > mMaxY
+                || center.y() + halfSize < mMinY)
+                return;
+
+            if (size == 1 && !mStorage.hasData(center.x() - 0.5, center.y() - 0.5))
+                return;
+
+            generateChunk(size, center);
+
+            if (size > Terrain::minQuadTreeNodeSize)
+                visitChildren(size, center);
+        }
+
+        void generateChunk(float size, const osg::Vec2f& center)
+        {
+            const auto lod = static_cast<unsigned char>(Terrain::getVertexLod(size, mVertexLodMod));
+
+            osg::ref_ptr<osg::Vec3Array> positions(new osg::Vec3Array);
+            osg::ref_ptr<osg::Vec3Array> normals(new osg::Vec3Array);
+            osg::ref_ptr<osg::Vec4ubArray> colours(new osg::Vec4ubArray);
+
+            if (mCache.read(size, center, lod, *positions, *normals, *colours))
+            {
+                ++mNumSkipped;
+                return;
+            }
+
+            mStorage.fillVertexBuffers(lod, size, center, positions, normals, colours);
+            mCache.write(size, center, lod, *positions, *normals, *colours);
+            ++mNumGenerated;
+
+            if (mCache.getPendingDataSize() >= maxPendingDataSize)
+            {
+                Log(Debug::Info) << "Generated " << mNumGenerated << " chunks";
+                mCache.flush();
+            }
+        }
+    };
+
+    int runTerrainCacheTool(int argc, char* argv[])
+    {
+        Platform::init();
+
+        bpo::options_description desc = makeOptionsDescription();
+
+        bpo::parsed_options options = bpo::command_line_parser(argc, argv).options(desc).allow_unregistered().run();
+        bpo::variables_map variables;
+
+        bpo::store(options, variables);
+        bpo::notify(variables);
+
+        if (variables.find("help") != variables.end())
+        {
+            getRawStdout() << desc << std::endl;
+            return 0;
+        }
+
+        Files::ConfigurationManager config;
+
+        bpo::variables_map composingVariables = Files::separateComposingVariables(variables, desc);
+        config.readConfiguration(variables, desc);
+        Files::mergeComposingVariables(variables, composingVariables, desc);
+
+        const std::string encoding(variables["encoding"].as<std::string>());
+        Log(Debug::Info) << ToUTF8::encodingUsingMessage(encoding);
+        ToUTF8::Utf8Encoder encoder(ToUTF8::calculateEncoding(encoding));
+
+        Files::PathContainer dataDirs(asPathContainer(variables["data"].as<Files::MaybeQuotedPathContainer>()));
+
+        auto local = variables["data-local"].as<Files::MaybeQuotedPathContainer::value_type>();
+        if (!local.empty())
+            dataDirs.push_back(std::move(local));
+
+        config.filterOutNonExistingPaths(dataDirs);
+
+        const auto fsStrict = variables["fs-strict"].as<bool>();
+        const auto resDir = variables["resources"].as<Files::MaybeQuotedPath>();
+        const auto v = Version::getOpenmwVersion(resDir);
+        Log(Debug::Info) << v.describe();
+        dataDirs.insert(dataDirs.begin(), resDir / "vfs");
+        const auto fileCollections = Files::Collections(dataDirs, !fsStrict);
+        const auto archives = variables["fallback-archive"].as<StringsVector>();
+        const auto contentFiles = variables["content"].as<StringsVector>();
+
+        VFS::Manager vfs(fsStrict);
+
+        VFS::registerArchives(&vfs, fileCollections, archives, true);
+
+        Settings::Manager::load(config);
+
+        setupLogging(config.getLogPath(), applicationName);
+
+        ESM::ReadersCache readers;
+        EsmLoader::Query query;
+        query.mLoadLands = true;
+        const EsmLoader::EsmData esmData
+            = EsmLoader::loadEsmData(query, contentFiles, fileCollections, readers, &encoder);
+
+        LandStorage storage(&vfs, esmData.mLands);
+        Terrain::ChunkDiskCache cache(
+            config.getUserDataPath() / "terrain", Terrain::makeContentDigest(fileCollections, contentFiles));
+
+        ChunkGenerator generator(storage, cache, Settings::Manager::getInt("vertex lod mod", "Terrain"));
+        generator.generate();
+
+        Log(Debug::Info) << "Generated " << generator.getNumGenerated() << " chunks, " << generator.getNumSkipped()
+                         << " chunks were already cached";
+
+        cache.flush();
+
+        Log(Debug::Info) << "Done";
+
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    return wrapApplication(runTerrainCacheTool, argc, argv, applicationName);
+}
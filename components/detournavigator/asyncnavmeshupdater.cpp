@@ -94,8 +94,24 @@ namespace DetourNavigator
         {
             if (db == nullptr)
                 return nullptr;
-            return std::make_unique<DbWorker>(updater, std::move(db), TileVersion(navMeshFormatVersion),
-                settings.mRecast, settings.mWriteToNavMeshDb);
+            std::vector<std::unique_ptr<NavMeshDb>> readers;
+            try
+            {
+                for (std::size_t i = 0; i < settings.mNavMeshDbReaderThreads; ++i)
+                {
+                    std::unique_ptr<NavMeshDb> reader = db->makeConnection();
+                    if (reader == nullptr)
+                        break;
+                    readers.push_back(std::move(reader));
+                }
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Warning) << "Failed to open navmeshdb reader connection: " << e.what();
+            }
+            return std::make_unique<DbWorker>(updater, std::move(db), std::move(readers),
+                TileVersion(navMeshFormatVersion), settings.mRecast, settings.mWriteToNavMeshDb,
+                settings.mNavMeshDbWriteBatchSize);
         }
 
         void updateJobs(std::deque<JobIt>& jobs, TilePosition playerTile, int maxTiles)
@@ -155,7 +171,7 @@ namespace DetourNavigator
         , mRecastMeshManager(recastMeshManager)
         , mOffMeshConnectionsManager(offMeshConnectionsManager)
         , mShouldStop()
-        , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize)
+        , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize, settings.mAsyncNavMeshUpdaterThreads)
         , mDbWorker(makeDbWorker(*this, std::move(db), mSettings))
     {
         for (std::size_t i = 0; i < mSettings.get().mAsyncNavMeshUpdaterThreads; ++i)
@@ -193,8 +209,11 @@ namespace DetourNavigator
         {
             if (mPushed.emplace(agentBounds, changedTile).second)
             {
+                // Updates are delayed by the coalescing window so a burst of changes to the same tile is processed
+                // once
                 const auto processTime = changeType == ChangeType::update
-                    ? mLastUpdates[std::tie(agentBounds, changedTile)] + mSettings.get().mMinUpdateInterval
+                    ? std::max(mLastUpdates[std::tie(agentBounds, changedTile)] + mSettings.get().mMinUpdateInterval,
+                        std::chrono::steady_clock::now() + mSettings.get().mUpdateCoalescingWindow)
                     : std::chrono::steady_clock::time_point();
 
                 const JobIt it = mJobs.emplace(mJobs.end(), agentBounds, navMeshCacheItem, worldspace, changedTile,
@@ -321,6 +340,8 @@ namespace DetourNavigator
             result.mDb = mDbWorker->getStats();
         result.mCache = mNavMeshTilesCache.getStats();
         result.mDbGetTileHits = mDbGetTileHits.load(std::memory_order_relaxed);
+        result.mSkippedRebuilds = mSkippedRebuilds.load(std::memory_order_relaxed);
+        result.mPerformedRebuilds = mPerformedRebuilds.load(std::memory_order_relaxed);
         return result;
     }
 
@@ -418,6 +439,16 @@ namespace DetourNavigator
 
         NavMeshTilesCache::Value cachedNavMeshData
             = mNavMeshTilesCache.get(job.mAgentBounds, job.mChangedTile, *recastMesh);
+
+        NavMeshTileInput input{ recastMesh->getDigest(), mOffMeshConnectionsManager.get().get(job.mChangedTile) };
+
+        if (navMeshCacheItem.lockConst()->isTileUpToDate(job.mChangedTile, input))
+        {
+            Log(Debug::Debug) << "Unchanged input for job " << job.mId;
+            ++mSkippedRebuilds;
+            return handleUpdateNavMeshStatus(UpdateNavMeshStatus::ignored, job, navMeshCacheItem, *recastMesh);
+        }
+
         std::unique_ptr<PreparedNavMeshData> preparedNavMeshData;
         const PreparedNavMeshData* preparedNavMeshDataPtr = nullptr;
 
@@ -455,12 +486,13 @@ namespace DetourNavigator
             }
         }
 
-        const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
+        NavMeshData navMeshData = makeNavMeshTileData(*preparedNavMeshDataPtr, input.mOffMeshConnections,
+            job.mAgentBounds, job.mChangedTile, mSettings.get().mRecast);
 
-        const UpdateNavMeshStatus status
-            = navMeshCacheItem.lock()->updateTile(job.mChangedTile, std::move(cachedNavMeshData),
-                makeNavMeshTileData(*preparedNavMeshDataPtr, offMeshConnections, job.mAgentBounds, job.mChangedTile,
-                    mSettings.get().mRecast));
+        ++mPerformedRebuilds;
+
+        const UpdateNavMeshStatus status = navMeshCacheItem.lock()->updateTile(
+            job.mChangedTile, std::move(cachedNavMeshData), std::move(navMeshData), std::move(input));
 
         return handleUpdateNavMeshStatus(status, job, navMeshCacheItem, *recastMesh);
     }
@@ -498,16 +530,20 @@ namespace DetourNavigator
         auto cachedNavMeshData = mNavMeshTilesCache.set(
             job.mAgentBounds, job.mChangedTile, *job.mRecastMesh, std::move(preparedNavMeshData));
 
-        const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
+        NavMeshTileInput input{ job.mRecastMesh->getDigest(),
+            mOffMeshConnectionsManager.get().get(job.mChangedTile) };
 
         const PreparedNavMeshData* preparedNavMeshDataPtr
             = cachedNavMeshData ? &cachedNavMeshData.get() : preparedNavMeshData.get();
         assert(preparedNavMeshDataPtr != nullptr);
 
-        const UpdateNavMeshStatus status
-            = navMeshCacheItem.lock()->updateTile(job.mChangedTile, std::move(cachedNavMeshData),
-                makeNavMeshTileData(*preparedNavMeshDataPtr, offMeshConnections, job.mAgentBounds, job.mChangedTile,
-                    mSettings.get().mRecast));
+        NavMeshData navMeshData = makeNavMeshTileData(*preparedNavMeshDataPtr, input.mOffMeshConnections,
+            job.mAgentBounds, job.mChangedTile, mSettings.get().mRecast);
+
+        ++mPerformedRebuilds;
+
+        const UpdateNavMeshStatus status = navMeshCacheItem.lock()->updateTile(
+            job.mChangedTile, std::move(cachedNavMeshData), std::move(navMeshData), std::move(input));
 
         const JobStatus result = handleUpdateNavMeshStatus(status, job, navMeshCacheItem, *job.mRecastMesh);
 
@@ -705,6 +741,17 @@ namespace DetourNavigator
         return job;
     }
 
+    void DbJobQueue::popWritingJobs(std::size_t maxJobs, std::vector<JobIt>& jobs)
+    {
+        const std::lock_guard lock(mMutex);
+        for (std::size_t i = 0; i < maxJobs && !mJobs.empty() && isWritingDbJob(*mJobs.front()); ++i)
+        {
+            jobs.push_back(mJobs.front());
+            mJobs.pop_front();
+            --mWritingJobs;
+        }
+    }
+
     void DbJobQueue::update(TilePosition playerTile, int maxTiles)
     {
         const std::lock_guard lock(mMutex);
@@ -726,17 +773,23 @@ namespace DetourNavigator
         return DbJobQueueStats{ .mWritingJobs = mWritingJobs, .mReadingJobs = mReadingJobs };
     }
 
-    DbWorker::DbWorker(AsyncNavMeshUpdater& updater, std::unique_ptr<NavMeshDb>&& db, TileVersion version,
-        const RecastSettings& recastSettings, bool writeToDb)
+    DbWorker::DbWorker(AsyncNavMeshUpdater& updater, std::unique_ptr<NavMeshDb>&& db,
+        std::vector<std::unique_ptr<NavMeshDb>>&& readers, TileVersion version, const RecastSettings& recastSettings,
+        bool writeToDb, std::size_t writeBatchSize)
         : mUpdater(updater)
         , mRecastSettings(recastSettings)
         , mDb(std::move(db))
+        , mReaders(std::move(readers))
         , mVersion(version)
+        , mWriteBatchSize(std::max<std::size_t>(writeBatchSize, 1))
         , mWriteToDb(writeToDb)
         , mNextTileId(mDb->getMaxTileId() + 1)
         , mNextShapeId(mDb->getMaxShapeId() + 1)
         , mThread([this] { run(); })
     {
+        mReaderThreads.reserve(mReaders.size());
+        for (const std::unique_ptr<NavMeshDb>& reader : mReaders)
+            mReaderThreads.emplace_back([this, db = reader.get()] { runReader(*db); });
     }
 
     DbWorker::~DbWorker()
@@ -747,31 +800,61 @@ namespace DetourNavigator
     void DbWorker::enqueueJob(JobIt job)
     {
         Log(Debug::Debug) << "Enqueueing db job " << job->mId << " by thread=" << std::this_thread::get_id();
-        mQueue.push(job);
+        if (!mReaders.empty() && !isWritingDbJob(*job))
+            mReadingQueue.push(job);
+        else
+            mQueue.push(job);
+    }
+
+    void DbWorker::updateJobs(TilePosition playerTile, int maxTiles)
+    {
+        mQueue.update(playerTile, maxTiles);
+        mReadingQueue.update(playerTile, maxTiles);
     }
 
     DbWorkerStats DbWorker::getStats() const
     {
-        return DbWorkerStats{ .mJobs = mQueue.getStats(),
-            .mGetTileCount = mGetTileCount.load(std::memory_order_relaxed) };
+        DbJobQueueStats jobs = mQueue.getStats();
+        const DbJobQueueStats readingJobs = mReadingQueue.getStats();
+        jobs.mWritingJobs += readingJobs.mWritingJobs;
+        jobs.mReadingJobs += readingJobs.mReadingJobs;
+        return DbWorkerStats{ .mJobs = jobs,
+            .mGetTileCount = mGetTileCount.load(std::memory_order_relaxed),
+            .mWrittenTiles = mWrittenTiles.load(std::memory_order_relaxed),
+            .mWriteTransactions = mWriteTransactions.load(std::memory_order_relaxed) };
     }
 
     void DbWorker::stop()
     {
         mShouldStop = true;
         mQueue.stop();
+        mReadingQueue.stop();
         if (mThread.joinable())
             mThread.join();
+        for (std::thread& thread : mReaderThreads)
+            if (thread.joinable())
+                thread.join();
     }
 
     void DbWorker::run() noexcept
     {
+        std::vector<JobIt> writingJobs;
         while (!mShouldStop)
         {
             try
             {
-                if (const auto job = mQueue.pop())
+                const auto job = mQueue.pop();
+                if (!job.has_value())
+                    continue;
+                if (!isWritingDbJob(**job))
+                {
                     processJob(*job);
+                    continue;
+                }
+                writingJobs.clear();
+                writingJobs.push_back(*job);
+                mQueue.popWritingJobs(mWriteBatchSize - 1, writingJobs);
+                processWritingJobs(writingJobs);
             }
             catch (const std::exception& e)
             {
@@ -780,82 +863,166 @@ namespace DetourNavigator
         }
     }
 
-    void DbWorker::processJob(JobIt job)
+    void DbWorker::runReader(NavMeshDb& db) noexcept
     {
-        const auto process = [&](auto f) {
+        while (!mShouldStop)
+        {
             try
             {
-                f(job);
+                if (const auto job = mReadingQueue.pop())
+                    processReaderJob(*job, db);
             }
             catch (const std::exception& e)
             {
-                Log(Debug::Error) << "DbWorker exception while processing job " << job->mId << ": " << e.what();
-                if (mWriteToDb)
-                {
-                    const std::string_view message(e.what());
-                    if (message.find("database or disk is full") != std::string_view::npos)
-                    {
-                        mWriteToDb = false;
-                        Log(Debug::Warning)
-                            << "Writes to navmeshdb are disabled because file size limit is reached or disk is full";
-                    }
-                    else if (message.find("database is locked") != std::string_view::npos)
-                    {
-                        mWriteToDb = false;
-                        Log(Debug::Warning)
-                            << "Writes to navmeshdb are disabled to avoid concurrent writes from multiple processes";
-                    }
-                }
+                Log(Debug::Error) << "DbWorker reader exception: " << e.what();
             }
-        };
+        }
+    }
 
-        if (isWritingDbJob(*job))
-        {
-            process([&](JobIt job) { processWritingJob(job); });
-            mUpdater.removeJob(job);
+    void DbWorker::handleException(const std::exception& e)
+    {
+        if (!mWriteToDb)
             return;
+        const std::string_view message(e.what());
+        if (message.find("database or disk is full") != std::string_view::npos)
+        {
+            mWriteToDb = false;
+            Log(Debug::Warning)
+                << "Writes to navmeshdb are disabled because file size limit is reached or disk is full";
+        }
+        else if (message.find("database is locked") != std::string_view::npos)
+        {
+            mWriteToDb = false;
+            Log(Debug::Warning)
+                << "Writes to navmeshdb are disabled to avoid concurrent writes from multiple processes";
+        }
+    }
+
+    void DbWorker::processJob(JobIt job)
+    {
+        try
+        {
+            processReadingJob(job, *mDb, mWriteToDb);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "DbWorker exception while processing job " << job->mId << ": " << e.what();
+            handleException(e);
         }
+        job->mState = JobState::WithDbResult;
+        mUpdater.enqueueJob(job);
+    }
 
-        process([&](JobIt job) { processReadingJob(job); });
+    void DbWorker::processReaderJob(JobIt job, NavMeshDb& db)
+    {
+        try
+        {
+            if (!processReadingJob(job, db, false))
+            {
+                Log(Debug::Debug) << "Forward db read job " << job->mId << " to writer to add new shapes";
+                mQueue.push(job);
+                return;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "DbWorker exception while processing job " << job->mId << ": " << e.what();
+        }
         job->mState = JobState::WithDbResult;
         mUpdater.enqueueJob(job);
     }
 
-    void DbWorker::processReadingJob(JobIt job)
+    bool DbWorker::processReadingJob(JobIt job, NavMeshDb& db, bool canAddShapes)
     {
         Log(Debug::Debug) << "Processing db read job " << job->mId;
 
         if (job->mInput.empty())
         {
             Log(Debug::Debug) << "Serializing input for job " << job->mId;
-            if (mWriteToDb)
+            if (canAddShapes)
             {
                 const auto objects = makeDbRefGeometryObjects(job->mRecastMesh->getMeshSources(),
-                    [&](const MeshSource& v) { return resolveMeshSource(*mDb, v, mNextShapeId); });
+                    [&](const MeshSource& v) { return resolveMeshSource(db, v, mNextShapeId); });
                 job->mInput = serialize(mRecastSettings, job->mAgentBounds, *job->mRecastMesh, objects);
             }
             else
             {
                 const auto objects = makeDbRefGeometryObjects(job->mRecastMesh->getMeshSources(),
-                    [&](const MeshSource& v) { return resolveMeshSource(*mDb, v); });
+                    [&](const MeshSource& v) { return resolveMeshSource(db, v); });
+                // A tile can't be stored for a missing shape. But the shape has to be added when the generated tile
+                // is going to be written.
                 if (!objects.has_value())
-                    return;
+                    return !mWriteToDb;
                 job->mInput = serialize(mRecastSettings, job->mAgentBounds, *job->mRecastMesh, *objects);
             }
         }
 
-        job->mCachedTileData = mDb->getTileData(job->mWorldspace, job->mChangedTile, job->mInput);
+        job->mCachedTileData = db.getTileData(job->mWorldspace, job->mChangedTile, job->mInput);
         ++mGetTileCount;
+        return true;
     }
 
-    void DbWorker::processWritingJob(JobIt job)
+    void DbWorker::processWritingJobs(const std::vector<JobIt>& jobs)
     {
         if (!mWriteToDb)
         {
-            Log(Debug::Debug) << "Ignored db write job " << job->mId;
+            for (JobIt job : jobs)
+            {
+                Log(Debug::Debug) << "Ignored db write job " << job->mId;
+                mUpdater.removeJob(job);
+            }
             return;
         }
 
+        Log(Debug::Debug) << "Processing " << jobs.size() << " db write jobs";
+
+        std::size_t writtenTiles = 0;
+
+        try
+        {
+            Sqlite3::Transaction transaction = mDb->startTransaction(Sqlite3::TransactionMode::Immediate);
+
+            for (JobIt job : jobs)
+            {
+                // A failed job is dropped with its partial changes, the other jobs of the batch are still written
+                try
+                {
+                    Sqlite3::Savepoint savepoint = mDb->startSavepoint("write_job");
+                    const bool written = processWritingJob(job);
+                    savepoint.release();
+                    if (written)
+                        ++writtenTiles;
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Error) << "DbWorker exception while processing job " << job->mId << ": " << e.what();
+                    handleException(e);
+                }
+            }
+
+            transaction.commit();
+
+            mWrittenTiles += writtenTiles;
+            ++mWriteTransactions;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "DbWorker exception while writing " << jobs.size() << " tiles: " << e.what();
+            handleException(e);
+        }
+
+        for (JobIt job : jobs)
+            mUpdater.removeJob(job);
+    }
+
+    bool DbWorker::processWritingJob(JobIt job)
+    {
+        if (!mWriteToDb)
+        {
+            Log(Debug::Debug) << "Ignored db write job " << job->mId;
+            return false;
+        }
+
         Log(Debug::Debug) << "Processing db write job " << job->mId;
 
         if (job->mInput.empty())
@@ -872,14 +1039,14 @@ namespace DetourNavigator
             Log(Debug::Debug) << "Update db tile by job " << job->mId;
             job->mGeneratedNavMeshData->mUserId = cachedTileData->mTileId;
             mDb->updateTile(cachedTileData->mTileId, mVersion, serialize(*job->mGeneratedNavMeshData));
-            return;
+            return true;
         }
 
         const auto cached = mDb->findTile(job->mWorldspace, job->mChangedTile, job->mInput);
         if (cached.has_value() && cached->mVersion == mVersion)
         {
             Log(Debug::Debug) << "Ignore existing db tile by job " << job->mId;
-            return;
+            return false;
         }
 
         job->mGeneratedNavMeshData->mUserId = mNextTileId;
@@ -887,5 +1054,6 @@ namespace DetourNavigator
         mDb->insertTile(mNextTileId, job->mWorldspace, job->mChangedTile, mVersion, job->mInput,
             serialize(*job->mGeneratedNavMeshData));
         ++mNextTileId;
+        return true;
     }
 }
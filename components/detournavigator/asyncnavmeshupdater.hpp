@@ -28,6 +28,7 @@
 #include <set>
 #include <thread>
 #include <tuple>
+#include <vector>
 
 class dtNavMesh;
 
@@ -85,6 +86,9 @@ namespace DetourNavigator
 
         std::optional<JobIt> pop();
 
+        // Appends up to maxJobs writing jobs from the front of the queue without waiting for new jobs
+        void popWritingJobs(std::size_t maxJobs, std::vector<JobIt>& jobs);
+
         void update(TilePosition playerTile, int maxTiles);
 
         void stop();
@@ -102,11 +106,15 @@ namespace DetourNavigator
 
     class AsyncNavMeshUpdater;
 
+    // Reading jobs are processed by reader threads each having own database connection when there are any. Writing
+    // jobs and reading jobs that need to add new shapes into the database are processed by a single writer thread
+    // that groups consecutive writing jobs into one transaction.
     class DbWorker
     {
     public:
-        DbWorker(AsyncNavMeshUpdater& updater, std::unique_ptr<NavMeshDb>&& db, TileVersion version,
-            const RecastSettings& recastSettings, bool writeToDb);
+        DbWorker(AsyncNavMeshUpdater& updater, std::unique_ptr<NavMeshDb>&& db,
+            std::vector<std::unique_ptr<NavMeshDb>>&& readers, TileVersion version,
+            const RecastSettings& recastSettings, bool writeToDb, std::size_t writeBatchSize);
 
         ~DbWorker();
 
@@ -114,7 +122,7 @@ namespace DetourNavigator
 
         void enqueueJob(JobIt job);
 
-        void updateJobs(TilePosition playerTile, int maxTiles) { mQueue.update(playerTile, maxTiles); }
+        void updateJobs(TilePosition playerTile, int maxTiles);
 
         void stop();
 
@@ -122,22 +130,36 @@ namespace DetourNavigator
         AsyncNavMeshUpdater& mUpdater;
         const RecastSettings& mRecastSettings;
         const std::unique_ptr<NavMeshDb> mDb;
+        const std::vector<std::unique_ptr<NavMeshDb>> mReaders;
         const TileVersion mVersion;
-        bool mWriteToDb;
+        const std::size_t mWriteBatchSize;
+        std::atomic_bool mWriteToDb;
         TileId mNextTileId;
         ShapeId mNextShapeId;
         DbJobQueue mQueue;
+        DbJobQueue mReadingQueue;
         std::atomic_bool mShouldStop{ false };
         std::atomic_size_t mGetTileCount{ 0 };
+        std::atomic_size_t mWrittenTiles{ 0 };
+        std::atomic_size_t mWriteTransactions{ 0 };
         std::thread mThread;
+        std::vector<std::thread> mReaderThreads;
 
         inline void run() noexcept;
 
+        inline void runReader(NavMeshDb& db) noexcept;
+
         inline void processJob(JobIt job);
 
-        inline void processReadingJob(JobIt job);
+        inline void processReaderJob(JobIt job, NavMeshDb& db);
+
+        inline bool processReadingJob(JobIt job, NavMeshDb& db, bool canAddShapes);
+
+        inline void processWritingJobs(const std::vector<JobIt>& jobs);
+
+        inline bool processWritingJob(JobIt job);
 
-        inline void processWritingJob(JobIt job);
+        inline void handleException(const std::exception& e);
     };
 
     class AsyncNavMeshUpdater
@@ -181,6 +203,8 @@ namespace DetourNavigator
         std::vector<std::thread> mThreads;
         std::unique_ptr<DbWorker> mDbWorker;
         std::atomic_size_t mDbGetTileHits{ 0 };
+        std::atomic_size_t mSkippedRebuilds{ 0 };
+        std::atomic_size_t mPerformedRebuilds{ 0 };
 
         void process() noexcept;
 
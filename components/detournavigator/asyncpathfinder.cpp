@@ -0,0 +1,218 @@
+#include "asyncpathfinder.hpp"
+#include "navigator.hpp"
+#include "navigatorutils.hpp"
+
+#include <components/debug/debuglog.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        constexpr std::size_t minJobsCleanupSize = 64;
+
+        std::size_t getLatencyBucket(std::chrono::steady_clock::duration latency)
+        {
+            const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(latency).count();
+            const auto it = std::upper_bound(pathQueryLatencyBuckets.begin(), pathQueryLatencyBuckets.end(),
+                static_cast<std::size_t>(std::max<decltype(milliseconds)>(0, milliseconds)));
+            return static_cast<std::size_t>(it - pathQueryLatencyBuckets.begin());
+        }
+    }
+
+    PathQueryJob::PathQueryJob(const PathQuery& query, std::weak_ptr<GuardedNavMeshCacheItem> navMesh,
+        std::chrono::steady_clock::time_point postTime)
+        : mQuery(query)
+        , mNavMesh(std::move(navMesh))
+        , mPostTime(postTime)
+    {
+    }
+
+    AsyncPathFinder::AsyncPathFinder(const Settings& settings)
+        : mSettings(settings)
+    {
+        for (std::size_t i = 0; i < mSettings.mAsyncPathFinderThreads; ++i)
+            mThreads.emplace_back([&] { process(); });
+    }
+
+    AsyncPathFinder::~AsyncPathFinder()
+    {
+        stop();
+    }
+
+    SharedPathQueryJob AsyncPathFinder::post(const Navigator& navigator, const PathQuery& query)
+    {
+        const SharedNavMeshCacheItem navMesh = navigator.getNavMesh(query.mAgentBounds);
+        if (navMesh == nullptr)
+            return nullptr;
+
+        const Key key = makeKey(navMesh.get(), query);
+
+        const std::lock_guard lock(mMutex);
+
+        ++mStats.mPosted;
+
+        const auto it = mJobs.find(key);
+        if (it != mJobs.end())
+        {
+            // Navmesh may be destroyed and a new one allocated at the same address
+            if (SharedPathQueryJob job = it->second.lock();
+                job != nullptr && job->mNavMesh.lock() == navMesh && job->mState == PathQueryState::Waiting)
+            {
+                ++mStats.mDeduplicated;
+                return job;
+            }
+        }
+
+        // Cancelled jobs are not removed when they are dropped from the queue because their keys are unknown
+        if (mJobs.size() >= mJobsCleanupSize)
+        {
+            std::erase_if(mJobs, [](const auto& v) { return v.second.expired(); });
+            mJobsCleanupSize = std::max<std::size_t>(minJobsCleanupSize, 2 * mJobs.size());
+        }
+
+        auto job = std::make_shared<PathQueryJob>(query, navMesh, std::chrono::steady_clock::now());
+        mJobs.insert_or_assign(key, job);
+
+        if (mThreads.empty())
+            return job;
+
+        mWaiting.push_back(job);
+        mHasJob.notify_one();
+
+        return job;
+    }
+
+    const PathQueryResult* AsyncPathFinder::getResult(PathQueryJob& job)
+    {
+        if (job.mState.load(std::memory_order_acquire) == PathQueryState::Done)
+            return &job.mResult;
+
+        if (std::chrono::steady_clock::now() - job.mPostTime < mSettings.mMaxPathQueryLatency && !mThreads.empty())
+            return nullptr;
+
+        {
+            const std::lock_guard lock(mMutex);
+            if (job.mState != PathQueryState::Waiting)
+                return nullptr;
+            job.mState = PathQueryState::Processing;
+            if (const SharedNavMeshCacheItem navMesh = job.mNavMesh.lock())
+                mJobs.erase(makeKey(navMesh.get(), job.mQuery));
+            ++mStats.mProcessedByCaller;
+        }
+
+        tryProcessJob(job);
+
+        return &job.mResult;
+    }
+
+    AsyncPathFinderStats AsyncPathFinder::takeStats()
+    {
+        const std::lock_guard lock(mMutex);
+        AsyncPathFinderStats result = mStats;
+        result.mWaiting = static_cast<std::size_t>(std::count_if(mWaiting.begin(), mWaiting.end(),
+            [](const std::weak_ptr<PathQueryJob>& v) { return !v.expired(); }));
+        mStats = AsyncPathFinderStats{};
+        return result;
+    }
+
+    AsyncPathFinder::Key AsyncPathFinder::makeKey(const GuardedNavMeshCacheItem* navMesh, const PathQuery& query)
+    {
+        return Key(navMesh, query.mAgentBounds, query.mStepSize, query.mStart, query.mEnd, query.mIncludeFlags,
+            query.mAreaCosts.mWater, query.mAreaCosts.mDoor, query.mAreaCosts.mPathgrid, query.mAreaCosts.mGround,
+            query.mEndTolerance);
+    }
+
+    void AsyncPathFinder::process() noexcept
+    {
+        Log(Debug::Debug) << "Start process path queries by thread=" << std::this_thread::get_id();
+        while (const SharedPathQueryJob job = getNextJob())
+            tryProcessJob(*job);
+        Log(Debug::Debug) << "Stop process path queries by thread=" << std::this_thread::get_id();
+    }
+
+    SharedPathQueryJob AsyncPathFinder::getNextJob()
+    {
+        std::unique_lock lock(mMutex);
+        while (true)
+        {
+            mHasJob.wait(lock, [&] { return mShouldStop || !mWaiting.empty(); });
+
+            if (mShouldStop)
+                return nullptr;
+
+            const SharedPathQueryJob job = mWaiting.front().lock();
+            mWaiting.pop_front();
+
+            // All requesters have released the job before it's processed
+            if (job == nullptr)
+            {
+                ++mStats.mCancelled;
+                continue;
+            }
+
+            // Processed by the requester because of too long waiting
+            if (job->mState != PathQueryState::Waiting)
+                continue;
+
+            job->mState = PathQueryState::Processing;
+            if (const SharedNavMeshCacheItem navMesh = job->mNavMesh.lock())
+                mJobs.erase(makeKey(navMesh.get(), job->mQuery));
+
+            return job;
+        }
+    }
+
+    void AsyncPathFinder::tryProcessJob(PathQueryJob& job) noexcept
+    {
+        try
+        {
+            processJob(job);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "AsyncPathFinder failed to process path query: " << e.what();
+            job.mResult.mStatus = Status::FindPathOverPolygonsFailed;
+            job.mResult.mPath.clear();
+            job.mState.store(PathQueryState::Done, std::memory_order_release);
+        }
+    }
+
+    void AsyncPathFinder::processJob(PathQueryJob& job)
+    {
+        PathQueryResult& result = job.mResult;
+        result.mPath.clear();
+
+        if (const SharedNavMeshCacheItem navMesh = job.mNavMesh.lock())
+        {
+            const PathQuery& query = job.mQuery;
+            result.mStatus = findPath(*navMesh, mSettings, query.mAgentBounds, query.mStepSize, query.mStart,
+                query.mEnd, query.mIncludeFlags, query.mAreaCosts, query.mEndTolerance,
+                std::back_inserter(result.mPath));
+        }
+        else
+            result.mStatus = Status::NavMeshNotFound;
+
+        {
+            const std::lock_guard lock(mMutex);
+            ++mStats.mProcessed;
+            ++mStats.mLatency[getLatencyBucket(std::chrono::steady_clock::now() - job.mPostTime)];
+        }
+
+        job.mState.store(PathQueryState::Done, std::memory_order_release);
+    }
+
+    void AsyncPathFinder::stop()
+    {
+        {
+            const std::lock_guard lock(mMutex);
+            mShouldStop = true;
+        }
+        mHasJob.notify_all();
+        for (std::thread& thread : mThreads)
+            if (thread.joinable())
+                thread.join();
+    }
+}
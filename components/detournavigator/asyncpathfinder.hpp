@@ -0,0 +1,123 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_ASYNCPATHFINDER_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_ASYNCPATHFINDER_H
+
+#include "agentbounds.hpp"
+#include "areatype.hpp"
+#include "flags.hpp"
+#include "guardednavmeshcacheitem.hpp"
+#include "settings.hpp"
+#include "stats.hpp"
+#include "status.hpp"
+
+#include <osg/Vec3f>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace DetourNavigator
+{
+    struct Navigator;
+
+    struct PathQuery
+    {
+        AgentBounds mAgentBounds;
+        float mStepSize = 0;
+        osg::Vec3f mStart;
+        osg::Vec3f mEnd;
+        Flags mIncludeFlags = Flag_none;
+        AreaCosts mAreaCosts;
+        float mEndTolerance = 0;
+    };
+
+    struct PathQueryResult
+    {
+        Status mStatus = Status::Success;
+        std::vector<osg::Vec3f> mPath;
+    };
+
+    enum class PathQueryState
+    {
+        Waiting,
+        Processing,
+        Done,
+    };
+
+    // Shared by all requesters of the same query. Query is cancelled when all of them release it before processing.
+    struct PathQueryJob
+    {
+        const PathQuery mQuery;
+        const std::weak_ptr<GuardedNavMeshCacheItem> mNavMesh;
+        const std::chrono::steady_clock::time_point mPostTime;
+        std::atomic<PathQueryState> mState{ PathQueryState::Waiting };
+        PathQueryResult mResult;
+
+        PathQueryJob(const PathQuery& query, std::weak_ptr<GuardedNavMeshCacheItem> navMesh,
+            std::chrono::steady_clock::time_point postTime);
+    };
+
+    using SharedPathQueryJob = std::shared_ptr<PathQueryJob>;
+
+    /**
+     * @brief Finds paths in background threads so a burst of requests doesn't stall the main thread. Identical
+     * queries posted before the first one is processed share the result. Query waiting for a background thread longer
+     * than max path query latency is processed by the thread asking for the result.
+     */
+    class AsyncPathFinder
+    {
+    public:
+        explicit AsyncPathFinder(const Settings& settings);
+
+        AsyncPathFinder(const AsyncPathFinder&) = delete;
+
+        AsyncPathFinder& operator=(const AsyncPathFinder&) = delete;
+
+        ~AsyncPathFinder();
+
+        // Has to be called from the thread modifying navigator agents. Returns nullptr when there is no navmesh for
+        // the agent.
+        SharedPathQueryJob post(const Navigator& navigator, const PathQuery& query);
+
+        // Returns nullptr while the result is not ready.
+        const PathQueryResult* getResult(PathQueryJob& job);
+
+        // Returns counters accumulated since the previous call, supposed to be called once per frame.
+        AsyncPathFinderStats takeStats();
+
+    private:
+        using Key = std::tuple<const GuardedNavMeshCacheItem*, AgentBounds, float, osg::Vec3f, osg::Vec3f, Flags, float,
+            float, float, float, float>;
+
+        const Settings mSettings;
+        mutable std::mutex mMutex;
+        std::condition_variable mHasJob;
+        bool mShouldStop = false;
+        std::deque<std::weak_ptr<PathQueryJob>> mWaiting;
+        std::map<Key, std::weak_ptr<PathQueryJob>> mJobs;
+        std::size_t mJobsCleanupSize = 64;
+        AsyncPathFinderStats mStats;
+        std::vector<std::thread> mThreads;
+
+        static Key makeKey(const GuardedNavMeshCacheItem* navMesh, const PathQuery& query);
+
+        void process() noexcept;
+
+        SharedPathQueryJob getNextJob();
+
+        /// Marks the job as failed when processing throws
+        void tryProcessJob(PathQueryJob& job) noexcept;
+
+        void processJob(PathQueryJob& job);
+
+        void stop();
+    };
+}
+
+#endif
@@ -1,9 +1,11 @@
 #include "findsmoothpath.hpp"
+#include "tilegraph.hpp"
 
 #include <components/misc/convert.hpp>
 
 #include <algorithm>
 #include <array>
+#include <cstdlib>
 
 namespace DetourNavigator
 {
@@ -142,4 +144,55 @@ namespace DetourNavigator
             return 0;
         return ref;
     }
+
+    std::optional<std::size_t> findHierarchicalPath(const dtNavMeshQuery& navMeshQuery, const TileGraph& tileGraph,
+        const Settings& settings, const dtPolyRef startRef, const dtPolyRef endRef, const osg::Vec3f& start,
+        const osg::Vec3f& end, const osg::Vec3f& polyHalfExtents, const dtQueryFilter& queryFilter, dtPolyRef* path,
+        const std::size_t maxSize)
+    {
+        const int minTileDistance = settings.mDetour.mHierarchicalPathTileDistance;
+        if (minTileDistance <= 0)
+            return std::nullopt;
+
+        const TilePosition startTile = getTilePosition(settings.mRecast, start);
+        const TilePosition endTile = getTilePosition(settings.mRecast, end);
+        if (std::max(std::abs(endTile.x() - startTile.x()), std::abs(endTile.y() - startTile.y())) < minTileDistance)
+            return std::nullopt;
+
+        const std::optional<std::vector<osg::Vec3f>> portals = tileGraph.findPath(startTile, endTile);
+        if (!portals.has_value())
+            return std::nullopt;
+
+        // Each polygon search crosses only a few tiles to keep it within the query nodes limit
+        constexpr std::size_t portalsPerSegment = 2;
+
+        std::size_t pathSize = 0;
+        dtPolyRef segmentStartRef = startRef;
+        osg::Vec3f segmentStart = start;
+
+        for (std::size_t i = portalsPerSegment - 1;; i += portalsPerSegment)
+        {
+            const bool last = i >= portals->size();
+            const osg::Vec3f segmentEnd = last ? end : (*portals)[i];
+            const dtPolyRef segmentEndRef
+                = last ? endRef : findNearestPoly(navMeshQuery, queryFilter, segmentEnd, polyHalfExtents);
+            if (segmentEndRef == 0)
+                return std::nullopt;
+
+            // Consecutive segments share the polygon where one ends and the next one starts
+            const std::size_t offset = pathSize == 0 ? 0 : pathSize - 1;
+            const std::optional<std::size_t> segmentSize = findPath(navMeshQuery, segmentStartRef, segmentEndRef,
+                segmentStart, segmentEnd, queryFilter, path + offset, maxSize - offset);
+            if (!segmentSize.has_value() || *segmentSize == 0 || path[offset + *segmentSize - 1] != segmentEndRef)
+                return std::nullopt;
+
+            pathSize = offset + *segmentSize;
+
+            if (last)
+                return pathSize;
+
+            segmentStartRef = segmentEndRef;
+            segmentStart = segmentEnd;
+        }
+    }
 }
@@ -22,6 +22,7 @@ class dtNavMesh;
 namespace DetourNavigator
 {
     struct Settings;
+    class TileGraph;
 
     inline bool inRange(const osg::Vec3f& v1, const osg::Vec3f& v2, const float r)
     {
@@ -136,6 +137,14 @@ namespace DetourNavigator
         return static_cast<std::size_t>(pathLen);
     }
 
+    // Finds a path over tiles first and then over polygons only between a few portals at once. Supposed to be used
+    // for long distance paths that a single polygon search can't find with limited number of nodes. Returns nullopt
+    // when the distance is too short or the end polygon is not reached to let the caller fall back to findPath.
+    std::optional<std::size_t> findHierarchicalPath(const dtNavMeshQuery& navMeshQuery, const TileGraph& tileGraph,
+        const Settings& settings, const dtPolyRef startRef, const dtPolyRef endRef, const osg::Vec3f& start,
+        const osg::Vec3f& end, const osg::Vec3f& polyHalfExtents, const dtQueryFilter& queryFilter, dtPolyRef* path,
+        const std::size_t maxSize);
+
     template <class OutputIterator>
     Status makeSmoothPath(const dtNavMesh& navMesh, const dtNavMeshQuery& navMeshQuery, const dtQueryFilter& filter,
         const osg::Vec3f& start, const osg::Vec3f& end, const float stepSize, std::vector<dtPolyRef>& polygonPath,
@@ -252,9 +261,10 @@ namespace DetourNavigator
     }
 
     template <class OutputIterator>
-    Status findSmoothPath(const dtNavMesh& navMesh, const dtNavMeshQuery& navMeshQuery, const osg::Vec3f& halfExtents,
-        const float stepSize, const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
-        const AreaCosts& areaCosts, const Settings& settings, float endTolerance, OutputIterator out)
+    Status findSmoothPath(const dtNavMesh& navMesh, const dtNavMeshQuery& navMeshQuery, const TileGraph* tileGraph,
+        const osg::Vec3f& halfExtents, const float stepSize, const osg::Vec3f& start, const osg::Vec3f& end,
+        const Flags includeFlags, const AreaCosts& areaCosts, const Settings& settings, float endTolerance,
+        OutputIterator out)
     {
         dtQueryFilter queryFilter;
         queryFilter.setIncludeFlags(includeFlags);
@@ -276,8 +286,15 @@ namespace DetourNavigator
             return Status::EndPolygonNotFound;
 
         std::vector<dtPolyRef> polygonPath(settings.mDetour.mMaxPolygonPathSize);
-        const auto polygonPathSize
-            = findPath(navMeshQuery, startRef, endRef, start, end, queryFilter, polygonPath.data(), polygonPath.size());
+        std::optional<std::size_t> polygonPathSize;
+
+        if (tileGraph != nullptr)
+            polygonPathSize = findHierarchicalPath(navMeshQuery, *tileGraph, settings, startRef, endRef, start, end,
+                polyHalfExtents, queryFilter, polygonPath.data(), polygonPath.size());
+
+        if (!polygonPathSize.has_value())
+            polygonPathSize = findPath(
+                navMeshQuery, startRef, endRef, start, end, queryFilter, polygonPath.data(), polygonPath.size());
 
         if (!polygonPathSize.has_value())
             return Status::FindPathOverPolygonsFailed;
@@ -8,6 +8,7 @@
 #include "offmeshconnection.hpp"
 #include "preparednavmeshdata.hpp"
 #include "recastcontext.hpp"
+#include "recastglobalallocator.hpp"
 #include "recastmesh.hpp"
 #include "recastmeshbuilder.hpp"
 #include "recastparams.hpp"
@@ -520,6 +521,10 @@ namespace DetourNavigator
     std::unique_ptr<PreparedNavMeshData> prepareNavMeshTileData(const RecastMesh& recastMesh,
         const TilePosition& tilePosition, const AgentBounds& agentBounds, const RecastSettings& settings)
     {
+        // Everything Recast allocates to build the tile is freed by the end of this function, so it is taken from
+        // the thread arena. Must be destroyed after all Recast objects below.
+        RecastArenaScope arenaScope;
+
         RecastContext context(tilePosition, agentBounds);
 
         const auto [minZ, maxZ] = getBoundsByZ(recastMesh, agentBounds.mHalfExtents.z(), settings);
@@ -539,15 +544,18 @@ namespace DetourNavigator
         rcFilterLedgeSpans(&context, params.mWalkableHeight, params.mWalkableClimb, solid);
         rcFilterWalkableLowHeightSpans(&context, params.mWalkableHeight, solid);
 
-        std::unique_ptr<PreparedNavMeshData> result = std::make_unique<PreparedNavMeshData>();
+        PreparedNavMeshData arenaData;
 
-        if (!fillPolyMesh(context, settings, params, solid, result->mPolyMesh, result->mPolyMeshDetail))
+        if (!fillPolyMesh(context, settings, params, solid, arenaData.mPolyMesh, arenaData.mPolyMeshDetail))
             return nullptr;
 
-        result->mCellSize = settings.mCellSize;
-        result->mCellHeight = settings.mCellHeight;
+        arenaData.mCellSize = settings.mCellSize;
+        arenaData.mCellHeight = settings.mCellHeight;
+
+        // The result outlives the arena and may be freed by another thread
+        arenaScope.deactivate();
 
-        return result;
+        return std::make_unique<PreparedNavMeshData>(arenaData);
     }
 
     NavMeshData makeNavMeshTileData(const PreparedNavMeshData& data,
@@ -13,6 +13,27 @@
 
 namespace DetourNavigator
 {
+    /**
+     * @brief findPath fills output iterator with points of scene surfaces to be used for actor to walk through.
+     * Unlike the overload taking a navigator, can be called from any thread while navMesh is kept alive.
+     * @param navMesh to find path over, has to be created for agentBounds.
+     * @return Status of the search, the same as for the overload taking a navigator.
+     */
+    template <class OutputIterator>
+    inline Status findPath(GuardedNavMeshCacheItem& navMesh, const Settings& settings, const AgentBounds& agentBounds,
+        const float stepSize, const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags,
+        const AreaCosts& areaCosts, float endTolerance, OutputIterator out)
+    {
+        static_assert(std::is_same<typename std::iterator_traits<OutputIterator>::iterator_category,
+                          std::output_iterator_tag>::value,
+            "out is not an OutputIterator");
+        const auto locked = navMesh.lock();
+        return findSmoothPath(locked->getImpl(), locked->getQuery(), &locked->getTileGraph(),
+            toNavMeshCoordinates(settings.mRecast, agentBounds.mHalfExtents),
+            toNavMeshCoordinates(settings.mRecast, stepSize), toNavMeshCoordinates(settings.mRecast, start),
+            toNavMeshCoordinates(settings.mRecast, end), includeFlags, areaCosts, settings, endTolerance, out);
+    }
+
     /**
      * @brief findPath fills output iterator with points of scene surfaces to be used for actor to walk through.
      * @param agentBounds allows to find navmesh for given actor.
@@ -29,18 +50,11 @@ namespace DetourNavigator
         const osg::Vec3f& start, const osg::Vec3f& end, const Flags includeFlags, const AreaCosts& areaCosts,
         float endTolerance, OutputIterator out)
     {
-        static_assert(std::is_same<typename std::iterator_traits<OutputIterator>::iterator_category,
-                          std::output_iterator_tag>::value,
-            "out is not an OutputIterator");
         const auto navMesh = navigator.getNavMesh(agentBounds);
         if (navMesh == nullptr)
             return Status::NavMeshNotFound;
-        const Settings& settings = navigator.getSettings();
-        const auto locked = navMesh->lock();
-        return findSmoothPath(locked->getImpl(), locked->getQuery(),
-            toNavMeshCoordinates(settings.mRecast, agentBounds.mHalfExtents),
-            toNavMeshCoordinates(settings.mRecast, stepSize), toNavMeshCoordinates(settings.mRecast, start),
-            toNavMeshCoordinates(settings.mRecast, end), includeFlags, areaCosts, settings, endTolerance, out);
+        return findPath(*navMesh, navigator.getSettings(), agentBounds, stepSize, start, end, includeFlags, areaCosts,
+            endTolerance, out);
     }
 
     /**
@@ -72,6 +72,7 @@ namespace DetourNavigator
 
     NavMeshCacheItem::NavMeshCacheItem(std::size_t generation, const Settings& settings)
         : mVersion{ generation, 0 }
+        , mUseTileGraph(settings.mDetour.mHierarchicalPathTileDistance > 0)
     {
         initEmptyNavMesh(settings, mImpl);
 
@@ -84,13 +85,15 @@ namespace DetourNavigator
         }
     }
 
-    UpdateNavMeshStatus NavMeshCacheItem::updateTile(
-        const TilePosition& position, NavMeshTilesCache::Value&& cached, NavMeshData&& navMeshData)
+    UpdateNavMeshStatus NavMeshCacheItem::updateTile(const TilePosition& position, NavMeshTilesCache::Value&& cached,
+        NavMeshData&& navMeshData, NavMeshTileInput&& input)
     {
         const dtMeshTile* currentTile = getTile(mImpl, position);
         if (currentTile != nullptr
             && asNavMeshTileConstView(*currentTile) == asNavMeshTileConstView(navMeshData.mValue.get()))
         {
+            if (const auto tile = mUsedTiles.find(position); tile != mUsedTiles.end())
+                tile->second.mInput = std::move(input);
             return UpdateNavMeshStatus::ignored;
         }
         bool removed = ::removeTile(mImpl, position);
@@ -102,15 +105,18 @@ namespace DetourNavigator
             if (tile == mUsedTiles.end())
             {
                 mUsedTiles.emplace_hint(tile, position,
-                    Tile{ Version{ mVersion.mRevision, 1 }, std::move(cached), std::move(navMeshData) });
+                    Tile{ Version{ mVersion.mRevision, 1 }, std::move(cached), std::move(navMeshData),
+                        std::move(input) });
             }
             else
             {
                 ++tile->second.mVersion.mRevision;
                 tile->second.mCached = std::move(cached);
                 tile->second.mData = std::move(navMeshData);
+                tile->second.mInput = std::move(input);
             }
             ++mVersion.mRevision;
+            updateTileGraph(position);
             return UpdateNavMeshStatusBuilder().added(true).removed(removed).getResult();
         }
         else
@@ -119,6 +125,7 @@ namespace DetourNavigator
             {
                 mUsedTiles.erase(position);
                 ++mVersion.mRevision;
+                updateTileGraph(position);
             }
             return UpdateNavMeshStatusBuilder()
                 .removed(removed)
@@ -127,6 +134,13 @@ namespace DetourNavigator
         }
     }
 
+    void NavMeshCacheItem::updateTileGraph(const TilePosition& position)
+    {
+        // Only hierarchical path finding uses the graph, it's not worth updating for every changed tile otherwise
+        if (mUseTileGraph)
+            mTileGraph.update(mImpl, position);
+    }
+
     UpdateNavMeshStatus NavMeshCacheItem::removeTile(const TilePosition& position)
     {
         bool removed = ::removeTile(mImpl, position);
@@ -135,6 +149,7 @@ namespace DetourNavigator
         {
             mUsedTiles.erase(position);
             ++mVersion.mRevision;
+            updateTileGraph(position);
         }
         return UpdateNavMeshStatusBuilder().removed(removed).getResult();
     }
@@ -147,6 +162,7 @@ namespace DetourNavigator
         {
             mUsedTiles.erase(position);
             ++mVersion.mRevision;
+            updateTileGraph(position);
         }
         return UpdateNavMeshStatusBuilder().removed(removed).getResult();
     }
@@ -155,4 +171,10 @@ namespace DetourNavigator
     {
         return mEmptyTiles.find(position) != mEmptyTiles.end();
     }
+
+    bool NavMeshCacheItem::isTileUpToDate(const TilePosition& position, const NavMeshTileInput& input) const
+    {
+        const auto tile = mUsedTiles.find(position);
+        return tile != mUsedTiles.end() && tile->second.mInput == input;
+    }
 }
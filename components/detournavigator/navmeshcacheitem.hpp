@@ -3,6 +3,9 @@
 
 #include "navmeshdata.hpp"
 #include "navmeshtilescache.hpp"
+#include "offmeshconnection.hpp"
+#include "recastmesh.hpp"
+#include "tilegraph.hpp"
 #include "tileposition.hpp"
 #include "version.hpp"
 
@@ -12,6 +15,7 @@
 #include <iosfwd>
 #include <map>
 #include <set>
+#include <vector>
 
 struct dtMeshTile;
 
@@ -103,6 +107,19 @@ namespace DetourNavigator
 
     const dtMeshTile* getTile(const dtNavMesh& navMesh, const TilePosition& position);
 
+    // Everything a navmesh tile is built from besides the settings and agent bounds, which are fixed for a
+    // NavMeshCacheItem. Equal inputs produce equal tiles.
+    struct NavMeshTileInput
+    {
+        RecastMeshDigest mRecastMeshDigest;
+        std::vector<OffMeshConnection> mOffMeshConnections;
+    };
+
+    inline bool operator==(const NavMeshTileInput& lhs, const NavMeshTileInput& rhs)
+    {
+        return lhs.mRecastMeshDigest == rhs.mRecastMeshDigest && lhs.mOffMeshConnections == rhs.mOffMeshConnections;
+    }
+
     class NavMeshCacheItem
     {
     public:
@@ -114,8 +131,11 @@ namespace DetourNavigator
 
         const Version& getVersion() const { return mVersion; }
 
-        UpdateNavMeshStatus updateTile(
-            const TilePosition& position, NavMeshTilesCache::Value&& cached, NavMeshData&& navMeshData);
+        // Empty when hierarchical path finding is disabled
+        const TileGraph& getTileGraph() const { return mTileGraph; }
+
+        UpdateNavMeshStatus updateTile(const TilePosition& position, NavMeshTilesCache::Value&& cached,
+            NavMeshData&& navMeshData, NavMeshTileInput&& input);
 
         UpdateNavMeshStatus removeTile(const TilePosition& position);
 
@@ -123,6 +143,9 @@ namespace DetourNavigator
 
         bool isEmptyTile(const TilePosition& position) const;
 
+        // Returns true when the present tile was built from the same input so rebuilding it would not change it.
+        bool isTileUpToDate(const TilePosition& position, const NavMeshTileInput& input) const;
+
         template <class Function>
         void forEachUsedTile(Function&& function) const
         {
@@ -137,13 +160,18 @@ namespace DetourNavigator
             Version mVersion;
             NavMeshTilesCache::Value mCached;
             NavMeshData mData;
+            NavMeshTileInput mInput;
         };
 
         Version mVersion;
+        const bool mUseTileGraph;
         dtNavMesh mImpl;
         dtNavMeshQuery mQuery;
         std::map<TilePosition, Tile> mUsedTiles;
         std::set<TilePosition> mEmptyTiles;
+        TileGraph mTileGraph;
+
+        void updateTileGraph(const TilePosition& position);
     };
 }
 
@@ -11,6 +11,10 @@
 #include <sqlite3.h>
 
 #include <cstddef>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <tuple>
 #include <string_view>
 #include <vector>
 
@@ -73,6 +77,14 @@ namespace DetourNavigator
                AND input = :input
         )";
 
+        constexpr std::string_view getTilesQuery = R"(
+            SELECT tile_id, worldspace, tile_position_x, tile_position_y, version, input, data
+              FROM tiles
+             WHERE tile_id > :tile_id
+             ORDER BY tile_id
+             LIMIT :count
+        )";
+
         constexpr std::string_view insertTileQuery = R"(
             INSERT INTO tiles ( tile_id,  worldspace,  version,  tile_position_x,  tile_position_y,  input,  data)
                    VALUES     (:tile_id, :worldspace, :version, :tile_position_x, :tile_position_y, :input, :data)
@@ -123,6 +135,10 @@ namespace DetourNavigator
                AND hash = :hash
         )";
 
+        constexpr std::string_view getShapesQuery = R"(
+            SELECT shape_id, name, type, hash FROM shapes ORDER BY shape_id
+        )";
+
         constexpr std::string_view insertShapeQuery = R"(
             INSERT INTO shapes ( shape_id,  name,  type,  hash)
                    VALUES      (:shape_id, :name, :type, :hash)
@@ -152,6 +168,15 @@ namespace DetourNavigator
             if (const int ec = sqlite3_exec(&db, query.c_str(), nullptr, nullptr, nullptr); ec != SQLITE_OK)
                 throw std::runtime_error("Failed set max page count: " + std::string(sqlite3_errmsg(&db)));
         }
+
+        // Write-ahead log allows readers on other connections to proceed while the tiles are written. Losing the last
+        // transactions on power loss is acceptable for a cache so there is no need to sync on every commit.
+        void enableWriteAheadLog(sqlite3& db)
+        {
+            const char* const query = "pragma journal_mode = wal; pragma synchronous = normal;";
+            if (const int ec = sqlite3_exec(&db, query, nullptr, nullptr, nullptr); ec != SQLITE_OK)
+                Log(Debug::Warning) << "Failed to enable navmeshdb write-ahead log: " << sqlite3_errmsg(&db);
+        }
     }
 
     std::ostream& operator<<(std::ostream& stream, ShapeType value)
@@ -167,10 +192,12 @@ namespace DetourNavigator
     }
 
     NavMeshDb::NavMeshDb(std::string_view path, std::uint64_t maxFileSize)
-        : mDb(Sqlite3::makeDb(path, schema))
+        : mMaxFileSize(maxFileSize)
+        , mDb(Sqlite3::makeDb(path, schema))
         , mGetMaxTileId(*mDb, DbQueries::GetMaxTileId{})
         , mFindTile(*mDb, DbQueries::FindTile{})
         , mGetTileData(*mDb, DbQueries::GetTileData{})
+        , mGetTiles(*mDb, DbQueries::GetTiles{})
         , mInsertTile(*mDb, DbQueries::InsertTile{})
         , mUpdateTile(*mDb, DbQueries::UpdateTile{})
         , mDeleteTilesAt(*mDb, DbQueries::DeleteTilesAt{})
@@ -178,6 +205,7 @@ namespace DetourNavigator
         , mDeleteTilesOutsideRange(*mDb, DbQueries::DeleteTilesOutsideRange{})
         , mGetMaxShapeId(*mDb, DbQueries::GetMaxShapeId{})
         , mFindShapeId(*mDb, DbQueries::FindShapeId{})
+        , mGetShapes(*mDb, DbQueries::GetShapes{})
         , mInsertShape(*mDb, DbQueries::InsertShape{})
         , mVacuum(*mDb, DbQueries::Vacuum{})
     {
@@ -185,6 +213,15 @@ namespace DetourNavigator
         if (dbPageSize == 0)
             throw std::runtime_error("NavMeshDb page size is zero");
         setMaxPageCount(*mDb, maxFileSize / dbPageSize + static_cast<std::uint64_t>((maxFileSize % dbPageSize) != 0));
+        enableWriteAheadLog(*mDb);
+    }
+
+    std::unique_ptr<NavMeshDb> NavMeshDb::makeConnection() const
+    {
+        const char* const path = sqlite3_db_filename(mDb.get(), "main");
+        if (path == nullptr || *path == '\0')
+            return nullptr;
+        return std::make_unique<NavMeshDb>(path, mMaxFileSize);
     }
 
     Sqlite3::Transaction NavMeshDb::startTransaction(Sqlite3::TransactionMode mode)
@@ -192,6 +229,11 @@ namespace DetourNavigator
         return Sqlite3::Transaction(*mDb, mode);
     }
 
+    Sqlite3::Savepoint NavMeshDb::startSavepoint(std::string name)
+    {
+        return Sqlite3::Savepoint(*mDb, std::move(name));
+    }
+
     TileId NavMeshDb::getMaxTileId()
     {
         TileId tileId{ 0 };
@@ -222,6 +264,20 @@ namespace DetourNavigator
         return result;
     }
 
+    std::vector<TileRecord> NavMeshDb::getTiles(TileId afterTileId, std::size_t maxTiles)
+    {
+        using Row = std::tuple<TileId, std::string, int, int, TileVersion, std::vector<std::byte>,
+            std::vector<std::byte>>;
+        std::vector<Row> rows;
+        request(*mDb, mGetTiles, std::back_inserter(rows), maxTiles, afterTileId, static_cast<std::int64_t>(maxTiles));
+        std::vector<TileRecord> result;
+        result.reserve(rows.size());
+        for (auto& [tileId, worldspace, x, y, version, input, data] : rows)
+            result.push_back(TileRecord{ tileId, std::move(worldspace), TilePosition(x, y), version,
+                Misc::decompress(input), Misc::decompress(data) });
+        return result;
+    }
+
     int NavMeshDb::insertTile(TileId tileId, std::string_view worldspace, const TilePosition& tilePosition,
         TileVersion version, const std::vector<std::byte>& input, const std::vector<std::byte>& data)
     {
@@ -267,6 +323,17 @@ namespace DetourNavigator
         return shapeId;
     }
 
+    std::vector<ShapeRecord> NavMeshDb::getShapes()
+    {
+        std::vector<std::tuple<ShapeId, std::string, ShapeType, std::vector<std::byte>>> rows;
+        request(*mDb, mGetShapes, std::back_inserter(rows), std::numeric_limits<std::size_t>::max());
+        std::vector<ShapeRecord> result;
+        result.reserve(rows.size());
+        for (auto& [shapeId, name, type, hash] : rows)
+            result.push_back(ShapeRecord{ shapeId, std::move(name), type, std::move(hash) });
+        return result;
+    }
+
     int NavMeshDb::insertShape(ShapeId shapeId, std::string_view name, ShapeType type, const Sqlite3::ConstBlob& hash)
     {
         return execute(*mDb, mInsertShape, shapeId, name, type, hash);
@@ -312,6 +379,17 @@ namespace DetourNavigator
             Sqlite3::bindParameter(db, statement, ":input", input);
         }
 
+        std::string_view GetTiles::text() noexcept
+        {
+            return getTilesQuery;
+        }
+
+        void GetTiles::bind(sqlite3& db, sqlite3_stmt& statement, TileId afterTileId, std::int64_t count)
+        {
+            Sqlite3::bindParameter(db, statement, ":tile_id", afterTileId);
+            Sqlite3::bindParameter(db, statement, ":count", count);
+        }
+
         std::string_view InsertTile::text() noexcept
         {
             return insertTileQuery;
@@ -403,6 +481,11 @@ namespace DetourNavigator
             Sqlite3::bindParameter(db, statement, ":hash", hash);
         }
 
+        std::string_view GetShapes::text() noexcept
+        {
+            return getShapesQuery;
+        }
+
         std::string_view InsertShape::text() noexcept
         {
             return insertShapeQuery;
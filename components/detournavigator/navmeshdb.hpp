@@ -17,6 +17,7 @@
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <utility>
@@ -45,12 +46,30 @@ namespace DetourNavigator
         std::vector<std::byte> mData;
     };
 
+    struct TileRecord
+    {
+        TileId mTileId;
+        std::string mWorldspace;
+        TilePosition mTilePosition;
+        TileVersion mVersion;
+        std::vector<std::byte> mInput;
+        std::vector<std::byte> mData;
+    };
+
     enum class ShapeType
     {
         Collision = 1,
         Avoid = 2,
     };
 
+    struct ShapeRecord
+    {
+        ShapeId mShapeId;
+        std::string mName;
+        ShapeType mType;
+        std::vector<std::byte> mHash;
+    };
+
     std::ostream& operator<<(std::ostream& stream, ShapeType value);
 
     namespace DbQueries
@@ -75,6 +94,12 @@ namespace DetourNavigator
                 const TilePosition& tilePosition, const std::vector<std::byte>& input);
         };
 
+        struct GetTiles
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3& db, sqlite3_stmt& statement, TileId afterTileId, std::int64_t count);
+        };
+
         struct InsertTile
         {
             static std::string_view text() noexcept;
@@ -124,6 +149,12 @@ namespace DetourNavigator
                 const Sqlite3::ConstBlob& hash);
         };
 
+        struct GetShapes
+        {
+            static std::string_view text() noexcept;
+            static void bind(sqlite3&, sqlite3_stmt&) {}
+        };
+
         struct InsertShape
         {
             static std::string_view text() noexcept;
@@ -143,8 +174,14 @@ namespace DetourNavigator
     public:
         explicit NavMeshDb(std::string_view path, std::uint64_t maxFileSize);
 
+        // Opens one more connection to the same database file to be used from another thread. Returns nullptr for in
+        // memory databases because they can't be shared between connections.
+        std::unique_ptr<NavMeshDb> makeConnection() const;
+
         Sqlite3::Transaction startTransaction(Sqlite3::TransactionMode mode = Sqlite3::TransactionMode::Default);
 
+        Sqlite3::Savepoint startSavepoint(std::string name);
+
         TileId getMaxTileId();
 
         std::optional<Tile> findTile(
@@ -153,6 +190,9 @@ namespace DetourNavigator
         std::optional<TileData> getTileData(
             std::string_view worldspace, const TilePosition& tilePosition, const std::vector<std::byte>& input);
 
+        // Returns up to maxTiles tiles ordered by id starting after given one, with decompressed input and data.
+        std::vector<TileRecord> getTiles(TileId afterTileId, std::size_t maxTiles);
+
         int insertTile(TileId tileId, std::string_view worldspace, const TilePosition& tilePosition,
             TileVersion version, const std::vector<std::byte>& input, const std::vector<std::byte>& data);
 
@@ -168,15 +208,19 @@ namespace DetourNavigator
 
         std::optional<ShapeId> findShapeId(std::string_view name, ShapeType type, const Sqlite3::ConstBlob& hash);
 
+        std::vector<ShapeRecord> getShapes();
+
         int insertShape(ShapeId shapeId, std::string_view name, ShapeType type, const Sqlite3::ConstBlob& hash);
 
         void vacuum();
 
     private:
+        std::uint64_t mMaxFileSize;
         Sqlite3::Db mDb;
         Sqlite3::Statement<DbQueries::GetMaxTileId> mGetMaxTileId;
         Sqlite3::Statement<DbQueries::FindTile> mFindTile;
         Sqlite3::Statement<DbQueries::GetTileData> mGetTileData;
+        Sqlite3::Statement<DbQueries::GetTiles> mGetTiles;
         Sqlite3::Statement<DbQueries::InsertTile> mInsertTile;
         Sqlite3::Statement<DbQueries::UpdateTile> mUpdateTile;
         Sqlite3::Statement<DbQueries::DeleteTilesAt> mDeleteTilesAt;
@@ -184,6 +228,7 @@ namespace DetourNavigator
         Sqlite3::Statement<DbQueries::DeleteTilesOutsideRange> mDeleteTilesOutsideRange;
         Sqlite3::Statement<DbQueries::GetMaxShapeId> mGetMaxShapeId;
         Sqlite3::Statement<DbQueries::FindShapeId> mFindShapeId;
+        Sqlite3::Statement<DbQueries::GetShapes> mGetShapes;
         Sqlite3::Statement<DbQueries::InsertShape> mInsertShape;
         Sqlite3::Statement<DbQueries::Vacuum> mVacuum;
     };
@@ -4,6 +4,7 @@
 #include "gettilespositions.hpp"
 #include "makenavmesh.hpp"
 #include "navmeshcacheitem.hpp"
+#include "recastglobalallocator.hpp"
 #include "settings.hpp"
 #include "settingsutils.hpp"
 #include "waitconditiontype.hpp"
@@ -218,7 +219,10 @@ namespace DetourNavigator
 
     Stats NavMeshManager::getStats() const
     {
-        return Stats{ .mUpdater = mAsyncNavMeshUpdater.getStats() };
+        return Stats{
+            .mUpdater = mAsyncNavMeshUpdater.getStats(),
+            .mRecastAllocator = RecastGlobalAllocator::getStats(),
+        };
     }
 
     RecastMeshTiles NavMeshManager::getRecastMeshTiles() const
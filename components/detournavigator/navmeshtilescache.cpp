@@ -1,27 +1,72 @@
 #include "navmeshtilescache.hpp"
 #include "stats.hpp"
 
+#include <components/misc/hash.hpp>
+
+#include <algorithm>
 #include <cstring>
 
 namespace DetourNavigator
 {
-    NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize)
-        : mMaxNavMeshDataSize(maxNavMeshDataSize)
-        , mUsedNavMeshDataSize(0)
-        , mFreeNavMeshDataSize(0)
-        , mHitCount(0)
-        , mGetCount(0)
+    std::size_t NavMeshTilesCache::KeyHash::operator()(const Key& key) const noexcept
+    {
+        // The digest is already well distributed
+        std::size_t result = static_cast<std::size_t>(key.mRecastMeshDigest[0]);
+        Misc::hashCombine(result, key.mChangedTile.x());
+        Misc::hashCombine(result, key.mChangedTile.y());
+        Misc::hashCombine(result, static_cast<int>(key.mAgentBounds.mShapeType));
+        Misc::hashCombine(result, key.mAgentBounds.mHalfExtents.x());
+        Misc::hashCombine(result, key.mAgentBounds.mHalfExtents.y());
+        Misc::hashCombine(result, key.mAgentBounds.mHalfExtents.z());
+        return result;
+    }
+
+    NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize, std::size_t shards)
+        : mShards(std::max<std::size_t>(shards, 1))
     {
+        for (Shard& shard : mShards)
+            shard.mMaxNavMeshDataSize = maxNavMeshDataSize / mShards.size();
     }
 
     NavMeshTilesCache::Value NavMeshTilesCache::get(
         const AgentBounds& agentBounds, const TilePosition& changedTile, const RecastMesh& recastMesh)
+    {
+        const Key key{ agentBounds, changedTile, recastMesh.getDigest() };
+        return getShard(key).get(key);
+    }
+
+    NavMeshTilesCache::Value NavMeshTilesCache::set(const AgentBounds& agentBounds, const TilePosition& changedTile,
+        const RecastMesh& recastMesh, std::unique_ptr<PreparedNavMeshData>&& value)
+    {
+        const auto itemSize = sizeof(RecastMesh) + getSize(recastMesh)
+            + (value == nullptr ? 0 : sizeof(PreparedNavMeshData) + getSize(*value));
+
+        const Key key{ agentBounds, changedTile, recastMesh.getDigest() };
+        return getShard(key).set(key, itemSize, std::move(value));
+    }
+
+    NavMeshTilesCacheStats NavMeshTilesCache::getStats() const
+    {
+        NavMeshTilesCacheStats result;
+        for (const Shard& shard : mShards)
+        {
+            const std::lock_guard<std::mutex> lock(shard.mMutex);
+            result.mNavMeshCacheSize += shard.mUsedNavMeshDataSize;
+            result.mUsedNavMeshTiles += shard.mBusyItems.size();
+            result.mCachedNavMeshTiles += shard.mFreeItems.size();
+            result.mHitCount += shard.mHitCount;
+            result.mGetCount += shard.mGetCount;
+        }
+        return result;
+    }
+
+    NavMeshTilesCache::Value NavMeshTilesCache::Shard::get(const Key& key)
     {
         const std::lock_guard<std::mutex> lock(mMutex);
 
         ++mGetCount;
 
-        const auto tile = mValues.find(std::tie(agentBounds, changedTile, recastMesh));
+        const auto tile = mValues.find(key);
         if (tile == mValues.end())
             return Value();
 
@@ -32,12 +77,9 @@ namespace DetourNavigator
         return Value(*this, tile->second);
     }
 
-    NavMeshTilesCache::Value NavMeshTilesCache::set(const AgentBounds& agentBounds, const TilePosition& changedTile,
-        const RecastMesh& recastMesh, std::unique_ptr<PreparedNavMeshData>&& value)
+    NavMeshTilesCache::Value NavMeshTilesCache::Shard::set(
+        const Key& key, std::size_t itemSize, std::unique_ptr<PreparedNavMeshData>&& value)
     {
-        const auto itemSize = sizeof(RecastMesh) + getSize(recastMesh)
-            + (value == nullptr ? 0 : sizeof(PreparedNavMeshData) + getSize(*value));
-
         const std::lock_guard<std::mutex> lock(mMutex);
 
         if (itemSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
@@ -46,12 +88,8 @@ namespace DetourNavigator
         while (!mFreeItems.empty() && mUsedNavMeshDataSize + itemSize > mMaxNavMeshDataSize)
             removeLeastRecentlyUsed();
 
-        RecastMeshData key{ recastMesh.getMesh(), recastMesh.getWater(), recastMesh.getHeightfields(),
-            recastMesh.getFlatHeightfields() };
-
-        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentBounds, changedTile, std::move(key), itemSize);
-        const auto emplaced = mValues.emplace(
-            std::make_tuple(agentBounds, changedTile, std::cref(iterator->mRecastMeshData)), iterator);
+        const auto iterator = mFreeItems.emplace(mFreeItems.end(), key, itemSize);
+        const auto emplaced = mValues.emplace(key, iterator);
 
         if (!emplaced.second)
         {
@@ -70,25 +108,11 @@ namespace DetourNavigator
         return Value(*this, iterator);
     }
 
-    NavMeshTilesCacheStats NavMeshTilesCache::getStats() const
-    {
-        NavMeshTilesCacheStats result;
-        {
-            const std::lock_guard<std::mutex> lock(mMutex);
-            result.mNavMeshCacheSize = mUsedNavMeshDataSize;
-            result.mUsedNavMeshTiles = mBusyItems.size();
-            result.mCachedNavMeshTiles = mFreeItems.size();
-            result.mHitCount = mHitCount;
-            result.mGetCount = mGetCount;
-        }
-        return result;
-    }
-
-    void NavMeshTilesCache::removeLeastRecentlyUsed()
+    void NavMeshTilesCache::Shard::removeLeastRecentlyUsed()
     {
         const auto& item = mFreeItems.back();
 
-        const auto value = mValues.find(std::tie(item.mAgentBounds, item.mChangedTile, item.mRecastMeshData));
+        const auto value = mValues.find(item.mKey);
         if (value == mValues.end())
             return;
 
@@ -99,7 +123,7 @@ namespace DetourNavigator
         mFreeItems.pop_back();
     }
 
-    void NavMeshTilesCache::acquireItemUnsafe(ItemIterator iterator)
+    void NavMeshTilesCache::Shard::acquireItemUnsafe(ItemIterator iterator)
     {
         if (++iterator->mUseCount > 1)
             return;
@@ -108,7 +132,7 @@ namespace DetourNavigator
         mFreeNavMeshDataSize -= iterator->mSize;
     }
 
-    void NavMeshTilesCache::releaseItem(ItemIterator iterator)
+    void NavMeshTilesCache::Shard::releaseItem(ItemIterator iterator)
     {
         if (--iterator->mUseCount > 0)
             return;
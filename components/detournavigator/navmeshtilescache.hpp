@@ -10,58 +10,36 @@
 #include <cassert>
 #include <cstring>
 #include <list>
-#include <map>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace DetourNavigator
 {
-    struct RecastMeshData
-    {
-        Mesh mMesh;
-        std::vector<CellWater> mWater;
-        std::vector<Heightfield> mHeightfields;
-        std::vector<FlatHeightfield> mFlatHeightfields;
-    };
-
-    inline bool operator<(const RecastMeshData& lhs, const RecastMeshData& rhs)
-    {
-        return std::tie(lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields)
-            < std::tie(rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields);
-    }
-
-    inline bool operator<(const RecastMeshData& lhs, const RecastMesh& rhs)
-    {
-        return std::tie(lhs.mMesh, lhs.mWater, lhs.mHeightfields, lhs.mFlatHeightfields)
-            < std::tie(rhs.getMesh(), rhs.getWater(), rhs.getHeightfields(), rhs.getFlatHeightfields());
-    }
-
-    inline bool operator<(const RecastMesh& lhs, const RecastMeshData& rhs)
-    {
-        return std::tie(lhs.getMesh(), lhs.getWater(), lhs.getHeightfields(), lhs.getFlatHeightfields())
-            < std::tie(rhs.mMesh, rhs.mWater, rhs.mHeightfields, rhs.mFlatHeightfields);
-    }
-
     struct NavMeshTilesCacheStats;
 
     class NavMeshTilesCache
     {
+        struct Shard;
+
     public:
-        struct Item
+        struct Key
         {
-            std::atomic<std::int64_t> mUseCount;
             AgentBounds mAgentBounds;
             TilePosition mChangedTile;
-            RecastMeshData mRecastMeshData;
+            RecastMeshDigest mRecastMeshDigest;
+        };
+
+        struct Item
+        {
+            std::atomic<std::int64_t> mUseCount;
+            Key mKey;
             std::unique_ptr<PreparedNavMeshData> mPreparedNavMeshData;
             std::size_t mSize;
 
-            Item(const AgentBounds& agentBounds, const TilePosition& changedTile, RecastMeshData&& recastMeshData,
-                std::size_t size)
+            Item(const Key& key, std::size_t size)
                 : mUseCount(0)
-                , mAgentBounds(agentBounds)
-                , mChangedTile(changedTile)
-                , mRecastMeshData(std::move(recastMeshData))
+                , mKey(key)
                 , mSize(size)
             {
             }
@@ -78,7 +56,7 @@ namespace DetourNavigator
             {
             }
 
-            Value(NavMeshTilesCache& owner, ItemIterator iterator)
+            Value(Shard& owner, ItemIterator iterator)
                 : mOwner(&owner)
                 , mIterator(iterator)
             {
@@ -119,11 +97,14 @@ namespace DetourNavigator
             operator bool() const { return mOwner; }
 
         private:
-            NavMeshTilesCache* mOwner;
+            Shard* mOwner;
             ItemIterator mIterator;
         };
 
-        NavMeshTilesCache(const std::size_t maxNavMeshDataSize);
+        /// @param shards Number of independently locked parts the cache is split into, each getting an equal part of
+        /// the size limit. Reduces contention between threads at the cost of a less precise least recently used
+        /// eviction.
+        explicit NavMeshTilesCache(const std::size_t maxNavMeshDataSize, std::size_t shards = 1);
 
         Value get(const AgentBounds& agentBounds, const TilePosition& changedTile, const RecastMesh& recastMesh);
 
@@ -133,23 +114,46 @@ namespace DetourNavigator
         NavMeshTilesCacheStats getStats() const;
 
     private:
-        mutable std::mutex mMutex;
-        std::size_t mMaxNavMeshDataSize;
-        std::size_t mUsedNavMeshDataSize;
-        std::size_t mFreeNavMeshDataSize;
-        std::size_t mHitCount;
-        std::size_t mGetCount;
-        std::list<Item> mBusyItems;
-        std::list<Item> mFreeItems;
-        std::map<std::tuple<AgentBounds, TilePosition, std::reference_wrapper<const RecastMeshData>>, ItemIterator,
-            std::less<>>
-            mValues;
-
-        void removeLeastRecentlyUsed();
-
-        void acquireItemUnsafe(ItemIterator iterator);
-
-        void releaseItem(ItemIterator iterator);
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& key) const noexcept;
+        };
+
+        struct KeyEqual
+        {
+            bool operator()(const Key& lhs, const Key& rhs) const noexcept
+            {
+                return lhs.mRecastMeshDigest == rhs.mRecastMeshDigest && lhs.mChangedTile == rhs.mChangedTile
+                    && lhs.mAgentBounds == rhs.mAgentBounds;
+            }
+        };
+
+        struct Shard
+        {
+            mutable std::mutex mMutex;
+            std::size_t mMaxNavMeshDataSize = 0;
+            std::size_t mUsedNavMeshDataSize = 0;
+            std::size_t mFreeNavMeshDataSize = 0;
+            std::size_t mHitCount = 0;
+            std::size_t mGetCount = 0;
+            std::list<Item> mBusyItems;
+            std::list<Item> mFreeItems;
+            std::unordered_map<Key, ItemIterator, KeyHash, KeyEqual> mValues;
+
+            Value get(const Key& key);
+
+            Value set(const Key& key, std::size_t itemSize, std::unique_ptr<PreparedNavMeshData>&& value);
+
+            void removeLeastRecentlyUsed();
+
+            void acquireItemUnsafe(ItemIterator iterator);
+
+            void releaseItem(ItemIterator iterator);
+        };
+
+        std::vector<Shard> mShards;
+
+        Shard& getShard(const Key& key) { return mShards[KeyHash()(key) % mShards.size()]; }
     };
 }
 
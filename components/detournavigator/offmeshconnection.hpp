@@ -21,6 +21,11 @@ namespace DetourNavigator
     {
         return std::tie(lhs.mStart, lhs.mEnd, lhs.mAreaType) < std::tie(rhs.mStart, rhs.mEnd, rhs.mAreaType);
     }
+
+    inline bool operator==(const OffMeshConnection& lhs, const OffMeshConnection& rhs)
+    {
+        return std::tie(lhs.mStart, lhs.mEnd, lhs.mAreaType) == std::tie(rhs.mStart, rhs.mEnd, rhs.mAreaType);
+    }
 }
 
 #endif
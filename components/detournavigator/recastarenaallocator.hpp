@@ -0,0 +1,121 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_RECASTARENAALLOCATOR_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_RECASTARENAALLOCATOR_H
+
+#include "recastallocutils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace DetourNavigator
+{
+    // Bump allocator for everything Recast allocates while building a single tile. Freeing an allocation does not
+    // release its memory, all of it is reclaimed at once by reset. Memory is taken from chunks allocated on demand,
+    // after a reset requiring more than one chunk they are replaced by a single chunk of the high-water mark size so
+    // building the next tiles of similar complexity does not use the heap.
+    class RecastArenaAllocator
+    {
+    public:
+        explicit RecastArenaAllocator(std::size_t minChunkSize)
+            : mMinChunkSize(minChunkSize)
+        {
+        }
+
+        bool isActive() const { return mActive; }
+
+        void setActive(bool value) { mActive = value; }
+
+        void* alloc(std::size_t size)
+        {
+            const std::size_t itemSize = getItemSize(size);
+            if (rcUnlikely(mChunks.empty() || mChunks.back().mSize - mChunkUsed < itemSize))
+            {
+                if (rcUnlikely(!addChunk(itemSize)))
+                    return nullptr;
+            }
+            char* const ptr = mChunks.back().mData.get() + mChunkUsed;
+            mChunkUsed += itemSize;
+            mUsed += itemSize;
+            ++mAllocations;
+            void* const dataPtr = ptr + headerSize;
+            setDataPtrBufferType(dataPtr, BufferType_arena);
+            return dataPtr;
+        }
+
+        void free(void* ptr)
+        {
+            assert(BufferType_arena == getDataPtrBufferType(ptr));
+            static_cast<void>(ptr);
+        }
+
+        // All memory allocated since the previous reset must not be used after this call.
+        void reset()
+        {
+            mActive = false;
+            mHighWaterMark = std::max(mHighWaterMark, mUsed);
+            if (mChunks.size() > 1)
+            {
+                mChunks.clear();
+                mCapacity = 0;
+                addChunk(mHighWaterMark);
+            }
+            mChunkUsed = 0;
+            mUsed = 0;
+        }
+
+        // Number of allocations served since construction.
+        std::size_t getAllocations() const { return mAllocations; }
+
+        // Number of chunks allocated from the heap since construction.
+        std::size_t getChunkAllocations() const { return mChunkAllocations; }
+
+        std::size_t getCapacity() const { return mCapacity; }
+
+        std::size_t getHighWaterMark() const { return std::max(mHighWaterMark, mUsed); }
+
+    private:
+        struct Chunk
+        {
+            std::unique_ptr<char[]> mData;
+            std::size_t mSize;
+        };
+
+        static constexpr std::size_t alignment = alignof(std::max_align_t);
+        static constexpr std::size_t headerSize = alignment;
+
+        static_assert(headerSize >= sizeof(BufferType));
+
+        const std::size_t mMinChunkSize;
+        bool mActive = false;
+        std::vector<Chunk> mChunks;
+        std::size_t mChunkUsed = 0;
+        std::size_t mUsed = 0;
+        std::size_t mCapacity = 0;
+        std::size_t mHighWaterMark = 0;
+        std::size_t mAllocations = 0;
+        std::size_t mChunkAllocations = 0;
+
+        static std::size_t getItemSize(std::size_t size)
+        {
+            return headerSize + (size + alignment - 1) / alignment * alignment;
+        }
+
+        bool addChunk(std::size_t minSize)
+        {
+            const std::size_t size = std::max({ minSize, mMinChunkSize, mCapacity });
+            std::unique_ptr<char[]> data(new (std::nothrow) char[size]);
+            if (rcUnlikely(data == nullptr))
+                return false;
+            mChunks.push_back(Chunk{ std::move(data), size });
+            mChunkUsed = 0;
+            mCapacity += size;
+            ++mChunkAllocations;
+            return true;
+        }
+    };
+}
+
+#endif
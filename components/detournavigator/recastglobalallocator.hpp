@@ -1,8 +1,11 @@
 #ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_RECASTGLOBALALLOCATOR_H
 #define OPENMW_COMPONENTS_DETOURNAVIGATOR_RECASTGLOBALALLOCATOR_H
 
+#include "recastarenaallocator.hpp"
 #include "recasttempallocator.hpp"
+#include "stats.hpp"
 
+#include <atomic>
 #include <cstdlib>
 
 namespace DetourNavigator
@@ -15,7 +18,9 @@ namespace DetourNavigator
         static void* alloc(size_t size, rcAllocHint hint)
         {
             void* result = nullptr;
-            if (rcLikely(hint == RC_ALLOC_TEMP))
+            if (threadArena().mAllocator.isActive())
+                result = threadArena().mAllocator.alloc(size);
+            else if (rcLikely(hint == RC_ALLOC_TEMP))
                 result = tempAllocator().alloc(size);
             if (rcUnlikely(!result))
                 result = allocPerm(size);
@@ -26,16 +31,84 @@ namespace DetourNavigator
         {
             if (rcUnlikely(!ptr))
                 return;
-            if (rcLikely(BufferType_temp == getDataPtrBufferType(ptr)))
-                tempAllocator().free(ptr);
-            else
+            switch (getDataPtrBufferType(ptr))
             {
-                assert(BufferType_perm == getDataPtrBufferType(ptr));
-                std::free(getPermDataPtrHeapPtr(ptr));
+                case BufferType_arena:
+                    // Memory is reclaimed by resetArena
+                    return;
+                case BufferType_temp:
+                    tempAllocator().free(ptr);
+                    return;
+                default:
+                    assert(BufferType_perm == getDataPtrBufferType(ptr));
+                    std::free(getPermDataPtrHeapPtr(ptr));
+                    return;
             }
         }
 
+        static void setArenaActive(bool value)
+        {
+            assert(!value || !threadArena().mAllocator.isActive());
+            threadArena().mAllocator.setActive(value);
+        }
+
+        static void resetArena()
+        {
+            ThreadArena& arena = threadArena();
+            arena.mAllocator.reset();
+            arena.publish();
+        }
+
+        static RecastAllocatorStats getStats()
+        {
+            const Counters& value = counters();
+            return RecastAllocatorStats{
+                .mArenaAllocations = value.mArenaAllocations.load(std::memory_order_relaxed),
+                .mHeapAllocations = value.mHeapAllocations.load(std::memory_order_relaxed),
+                .mArenaCapacity = value.mArenaCapacity.load(std::memory_order_relaxed),
+                .mArenaHighWaterMark = value.mArenaHighWaterMark.load(std::memory_order_relaxed),
+            };
+        }
+
     private:
+        struct Counters
+        {
+            std::atomic_size_t mArenaAllocations{ 0 };
+            std::atomic_size_t mHeapAllocations{ 0 };
+            std::atomic_size_t mArenaCapacity{ 0 };
+            std::atomic_size_t mArenaHighWaterMark{ 0 };
+        };
+
+        // Arena counters are published once per reset to avoid touching shared atomics on each allocation.
+        struct ThreadArena
+        {
+            RecastArenaAllocator mAllocator{ 1024ul * 1024ul };
+            std::size_t mPublishedAllocations = 0;
+            std::size_t mPublishedChunkAllocations = 0;
+            std::size_t mPublishedCapacity = 0;
+
+            ~ThreadArena() { counters().mArenaCapacity.fetch_sub(mPublishedCapacity, std::memory_order_relaxed); }
+
+            void publish()
+            {
+                Counters& value = counters();
+                value.mArenaAllocations.fetch_add(
+                    mAllocator.getAllocations() - mPublishedAllocations, std::memory_order_relaxed);
+                value.mHeapAllocations.fetch_add(
+                    mAllocator.getChunkAllocations() - mPublishedChunkAllocations, std::memory_order_relaxed);
+                value.mArenaCapacity.fetch_add(mAllocator.getCapacity() - mPublishedCapacity, std::memory_order_relaxed);
+                std::size_t highWaterMark = value.mArenaHighWaterMark.load(std::memory_order_relaxed);
+                while (highWaterMark < mAllocator.getHighWaterMark()
+                    && !value.mArenaHighWaterMark.compare_exchange_weak(
+                        highWaterMark, mAllocator.getHighWaterMark(), std::memory_order_relaxed))
+                {
+                }
+                mPublishedAllocations = mAllocator.getAllocations();
+                mPublishedChunkAllocations = mAllocator.getChunkAllocations();
+                mPublishedCapacity = mAllocator.getCapacity();
+            }
+        };
+
         RecastGlobalAllocator() { rcAllocSetCustom(&RecastGlobalAllocator::alloc, &RecastGlobalAllocator::free); }
 
         static RecastGlobalAllocator& instance()
@@ -44,14 +117,27 @@ namespace DetourNavigator
             return value;
         }
 
+        static Counters& counters()
+        {
+            static Counters value;
+            return value;
+        }
+
         static RecastTempAllocator& tempAllocator()
         {
             static thread_local RecastTempAllocator value(1024ul * 1024ul);
             return value;
         }
 
+        static ThreadArena& threadArena()
+        {
+            static thread_local ThreadArena value;
+            return value;
+        }
+
         static void* allocPerm(size_t size)
         {
+            counters().mHeapAllocations.fetch_add(1, std::memory_order_relaxed);
             const auto ptr = std::malloc(size + sizeof(std::size_t));
             if (rcUnlikely(!ptr))
                 return ptr;
@@ -59,6 +145,23 @@ namespace DetourNavigator
             return getPermPtrDataPtr(ptr);
         }
     };
+
+    // Makes Recast allocations of the current thread use its arena until deactivated. The arena is reset on
+    // destruction so everything allocated within the scope must be freed before.
+    class RecastArenaScope
+    {
+    public:
+        RecastArenaScope() { RecastGlobalAllocator::setArenaActive(true); }
+
+        RecastArenaScope(const RecastArenaScope&) = delete;
+
+        RecastArenaScope& operator=(const RecastArenaScope&) = delete;
+
+        ~RecastArenaScope() { RecastGlobalAllocator::resetArena(); }
+
+        // Following allocations use the heap, memory allocated from the arena stays valid until destruction.
+        void deactivate() { RecastGlobalAllocator::setArenaActive(false); }
+    };
 }
 
 #endif
@@ -3,8 +3,75 @@
 
 #include <Recast.h>
 
+#include <extern/smhasher/MurmurHash3.h>
+
+#include <type_traits>
+
 namespace DetourNavigator
 {
+    namespace
+    {
+        class DigestBuilder
+        {
+        public:
+            template <class T>
+            void add(const T* data, std::size_t count)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                RecastMeshDigest result{ 0, 0 };
+                MurmurHash3_x64_128(data, static_cast<int>(count * sizeof(T)), mDigest.data(), result.data());
+                mDigest = result;
+            }
+
+            template <class T>
+            void add(const T& value)
+            {
+                add(&value, 1);
+            }
+
+            template <class T>
+            void add(const std::vector<T>& values)
+            {
+                add(values.size());
+                add(values.data(), values.size());
+            }
+
+            const RecastMeshDigest& getDigest() const { return mDigest; }
+
+        private:
+            RecastMeshDigest mDigest{ 0, 0 };
+        };
+
+        // Hashed as raw memory, so must not have padding
+        static_assert(sizeof(CellWater) == sizeof(osg::Vec2i) + sizeof(int) + sizeof(float));
+        static_assert(sizeof(FlatHeightfield) == sizeof(osg::Vec2i) + sizeof(int) + sizeof(float));
+    }
+
+    RecastMeshDigest makeRecastMeshDigest(const Mesh& mesh, const std::vector<CellWater>& water,
+        const std::vector<Heightfield>& heightfields, const std::vector<FlatHeightfield>& flatHeightfields)
+    {
+        DigestBuilder builder;
+        builder.add(mesh.getIndices());
+        builder.add(mesh.getVertices());
+        builder.add(mesh.getAreaTypes());
+        builder.add(water);
+        builder.add(heightfields.size());
+        for (const Heightfield& heightfield : heightfields)
+        {
+            builder.add(heightfield.mCellPosition);
+            builder.add(heightfield.mCellSize);
+            builder.add(heightfield.mLength);
+            builder.add(heightfield.mMinHeight);
+            builder.add(heightfield.mMaxHeight);
+            builder.add(heightfield.mHeights);
+            builder.add(heightfield.mOriginalSize);
+            builder.add(heightfield.mMinX);
+            builder.add(heightfield.mMinY);
+        }
+        builder.add(flatHeightfields);
+        return builder.getDigest();
+    }
+
     Mesh::Mesh(std::vector<int>&& indices, std::vector<float>&& vertices, std::vector<AreaType>&& areaTypes)
     {
         if (indices.size() / 3 != areaTypes.size())
@@ -32,5 +99,6 @@ namespace DetourNavigator
         mHeightfields.shrink_to_fit();
         for (Heightfield& v : mHeightfields)
             v.mHeights.shrink_to_fit();
+        mDigest = makeRecastMeshDigest(mMesh, mWater, mHeightfields, mFlatHeightfields);
     }
 }
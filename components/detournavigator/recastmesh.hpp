@@ -10,6 +10,8 @@
 #include <osg/Vec2i>
 #include <osg/Vec3f>
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -118,6 +120,12 @@ namespace DetourNavigator
         return tie(lhs) < tie(rhs);
     }
 
+    /// 128-bit hash identifying the geometry a navmesh tile is generated from.
+    using RecastMeshDigest = std::array<std::uint64_t, 2>;
+
+    RecastMeshDigest makeRecastMeshDigest(const Mesh& mesh, const std::vector<CellWater>& water,
+        const std::vector<Heightfield>& heightfields, const std::vector<FlatHeightfield>& flatHeightfields);
+
     struct MeshSource
     {
         osg::ref_ptr<const Resource::BulletShape> mShape;
@@ -144,6 +152,9 @@ namespace DetourNavigator
 
         const std::vector<MeshSource>& getMeshSources() const noexcept { return mMeshSources; }
 
+        /// Digest of the mesh, water and heightfields, computed on construction. Version and sources are not included.
+        const RecastMeshDigest& getDigest() const noexcept { return mDigest; }
+
     private:
         Version mVersion;
         Mesh mMesh;
@@ -151,6 +162,7 @@ namespace DetourNavigator
         std::vector<Heightfield> mHeightfields;
         std::vector<FlatHeightfield> mFlatHeightfields;
         std::vector<MeshSource> mMeshSources;
+        RecastMeshDigest mDigest;
 
         friend inline std::size_t getSize(const RecastMesh& value) noexcept
         {
@@ -45,6 +45,8 @@ namespace DetourNavigator
             = std::clamp(::Settings::Manager::getInt("max polygons per tile", "Navigator"), 1, (1 << 22) - 1);
         result.mMaxPolygonPathSize = ::Settings::Manager::getSize("max polygon path size", "Navigator");
         result.mMaxSmoothPathSize = ::Settings::Manager::getSize("max smooth path size", "Navigator");
+        result.mHierarchicalPathTileDistance
+            = std::max(0, ::Settings::Manager::getInt("hierarchical path tile distance", "Navigator"));
 
         return result;
     }
@@ -72,9 +74,17 @@ namespace DetourNavigator
             = ::Settings::Manager::getBool("enable nav mesh file name revision", "Navigator");
         result.mMinUpdateInterval
             = std::chrono::milliseconds(::Settings::Manager::getInt("min update interval ms", "Navigator"));
+        result.mUpdateCoalescingWindow = std::chrono::milliseconds(
+            std::max(0, ::Settings::Manager::getInt("update coalescing window ms", "Navigator")));
         result.mEnableNavMeshDiskCache = ::Settings::Manager::getBool("enable nav mesh disk cache", "Navigator");
         result.mWriteToNavMeshDb = ::Settings::Manager::getBool("write to navmeshdb", "Navigator");
         result.mMaxDbFileSize = ::Settings::Manager::getUInt64("max navmeshdb file size", "Navigator");
+        result.mNavMeshDbReaderThreads = ::Settings::Manager::getSize("navmeshdb reader threads", "Navigator");
+        result.mNavMeshDbWriteBatchSize
+            = std::max<std::size_t>(1, ::Settings::Manager::getSize("navmeshdb write batch size", "Navigator"));
+        result.mAsyncPathFinderThreads = ::Settings::Manager::getSize("async path finder threads", "Navigator");
+        result.mMaxPathQueryLatency = std::chrono::milliseconds(
+            std::max(0, ::Settings::Manager::getInt("max path query latency ms", "Navigator")));
 
         return result;
     }
@@ -31,6 +31,7 @@ namespace DetourNavigator
         int mMaxNavMeshQueryNodes = 0;
         std::size_t mMaxPolygonPathSize = 0;
         std::size_t mMaxSmoothPathSize = 0;
+        int mHierarchicalPathTileDistance = 0;
     };
 
     struct Settings
@@ -50,7 +51,12 @@ namespace DetourNavigator
         std::string mRecastMeshPathPrefix;
         std::string mNavMeshPathPrefix;
         std::chrono::milliseconds mMinUpdateInterval;
+        std::chrono::milliseconds mUpdateCoalescingWindow{ 0 };
         std::uint64_t mMaxDbFileSize = 0;
+        std::size_t mNavMeshDbReaderThreads = 0;
+        std::size_t mNavMeshDbWriteBatchSize = 1;
+        std::size_t mAsyncPathFinderThreads = 0;
+        std::chrono::milliseconds mMaxPathQueryLatency{ 0 };
     };
 
     inline constexpr std::int64_t navMeshFormatVersion = 2;
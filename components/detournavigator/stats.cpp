@@ -2,6 +2,8 @@
 
 #include <osg/Stats>
 
+#include <string>
+
 namespace DetourNavigator
 {
     namespace
@@ -12,6 +14,8 @@ namespace DetourNavigator
             out.setAttribute(frameNumber, "NavMesh Waiting", static_cast<double>(stats.mWaiting));
             out.setAttribute(frameNumber, "NavMesh Pushed", static_cast<double>(stats.mPushed));
             out.setAttribute(frameNumber, "NavMesh Processing", static_cast<double>(stats.mProcessing));
+            out.setAttribute(frameNumber, "NavMesh SkippedRebuilds", static_cast<double>(stats.mSkippedRebuilds));
+            out.setAttribute(frameNumber, "NavMesh PerformedRebuilds", static_cast<double>(stats.mPerformedRebuilds));
 
             if (stats.mDb.has_value())
             {
@@ -19,6 +23,9 @@ namespace DetourNavigator
                     frameNumber, "NavMesh DbJobs Write", static_cast<double>(stats.mDb->mJobs.mWritingJobs));
                 out.setAttribute(
                     frameNumber, "NavMesh DbJobs Read", static_cast<double>(stats.mDb->mJobs.mReadingJobs));
+                out.setAttribute(frameNumber, "NavMesh DbTiles Written", static_cast<double>(stats.mDb->mWrittenTiles));
+                out.setAttribute(
+                    frameNumber, "NavMesh DbTransactions", static_cast<double>(stats.mDb->mWriteTransactions));
 
                 if (stats.mDb->mGetTileCount > 0)
                     out.setAttribute(frameNumber, "NavMesh DbCacheHitRate",
@@ -39,5 +46,32 @@ namespace DetourNavigator
     {
         if (stats.mUpdater.has_value())
             reportStats(*stats.mUpdater, frameNumber, out);
+
+        out.setAttribute(
+            frameNumber, "NavMesh ArenaAllocations", static_cast<double>(stats.mRecastAllocator.mArenaAllocations));
+        out.setAttribute(
+            frameNumber, "NavMesh HeapAllocations", static_cast<double>(stats.mRecastAllocator.mHeapAllocations));
+        out.setAttribute(
+            frameNumber, "NavMesh ArenaCapacity", static_cast<double>(stats.mRecastAllocator.mArenaCapacity));
+        out.setAttribute(frameNumber, "NavMesh ArenaHighWaterMark",
+            static_cast<double>(stats.mRecastAllocator.mArenaHighWaterMark));
+    }
+
+    void reportStats(const AsyncPathFinderStats& stats, unsigned int frameNumber, osg::Stats& out)
+    {
+        out.setAttribute(frameNumber, "PathQuery Waiting", static_cast<double>(stats.mWaiting));
+        out.setAttribute(frameNumber, "PathQuery Posted", static_cast<double>(stats.mPosted));
+        out.setAttribute(frameNumber, "PathQuery Deduplicated", static_cast<double>(stats.mDeduplicated));
+        out.setAttribute(frameNumber, "PathQuery Cancelled", static_cast<double>(stats.mCancelled));
+        out.setAttribute(frameNumber, "PathQuery Processed", static_cast<double>(stats.mProcessed));
+        out.setAttribute(frameNumber, "PathQuery ProcessedByCaller", static_cast<double>(stats.mProcessedByCaller));
+
+        for (std::size_t i = 0; i < stats.mLatency.size(); ++i)
+        {
+            const std::string name = i < pathQueryLatencyBuckets.size()
+                ? "PathQuery Latency <" + std::to_string(pathQueryLatencyBuckets[i]) + "ms"
+                : "PathQuery Latency >=" + std::to_string(pathQueryLatencyBuckets.back()) + "ms";
+            out.setAttribute(frameNumber, name, static_cast<double>(stats.mLatency[i]));
+        }
     }
 }
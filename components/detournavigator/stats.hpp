@@ -1,6 +1,7 @@
 #ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_STATS_H
 #define OPENMW_COMPONENTS_DETOURNAVIGATOR_STATS_H
 
+#include <array>
 #include <cstddef>
 #include <optional>
 
@@ -21,6 +22,8 @@ namespace DetourNavigator
     {
         DbJobQueueStats mJobs;
         std::size_t mGetTileCount = 0;
+        std::size_t mWrittenTiles = 0;
+        std::size_t mWriteTransactions = 0;
     };
 
     struct NavMeshTilesCacheStats
@@ -39,16 +42,43 @@ namespace DetourNavigator
         std::size_t mPushed = 0;
         std::size_t mProcessing = 0;
         std::size_t mDbGetTileHits = 0;
+        std::size_t mSkippedRebuilds = 0;
+        std::size_t mPerformedRebuilds = 0;
         std::optional<DbWorkerStats> mDb;
         NavMeshTilesCacheStats mCache;
     };
 
+    struct RecastAllocatorStats
+    {
+        std::size_t mArenaAllocations = 0;
+        std::size_t mHeapAllocations = 0;
+        std::size_t mArenaCapacity = 0;
+        std::size_t mArenaHighWaterMark = 0;
+    };
+
+    // Upper bounds of path query latency histogram buckets in milliseconds, the last bucket is unbounded
+    inline constexpr std::array<std::size_t, 7> pathQueryLatencyBuckets{ 1, 2, 4, 8, 16, 32, 64 };
+
+    struct AsyncPathFinderStats
+    {
+        std::size_t mWaiting = 0;
+        std::size_t mPosted = 0;
+        std::size_t mDeduplicated = 0;
+        std::size_t mCancelled = 0;
+        std::size_t mProcessed = 0;
+        std::size_t mProcessedByCaller = 0;
+        std::array<std::size_t, pathQueryLatencyBuckets.size() + 1> mLatency{};
+    };
+
     struct Stats
     {
         std::optional<AsyncNavMeshUpdaterStats> mUpdater;
+        RecastAllocatorStats mRecastAllocator;
     };
 
     void reportStats(const Stats& stats, unsigned int frameNumber, osg::Stats& out);
+
+    void reportStats(const AsyncPathFinderStats& stats, unsigned int frameNumber, osg::Stats& out);
 }
 
 #endif
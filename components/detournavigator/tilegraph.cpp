@@ -0,0 +1,166 @@
+#include "tilegraph.hpp"
+
+#include <components/misc/convert.hpp>
+
+#include <DetourNavMesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        float getDistance(const TilePosition& lhs, const TilePosition& rhs)
+        {
+            const TilePosition delta = lhs - rhs;
+            return std::sqrt(static_cast<float>(delta.x() * delta.x() + delta.y() * delta.y()));
+        }
+
+        std::optional<osg::Vec3f> getPortalPosition(const dtMeshTile& tile, const dtPoly& poly, const dtLink& link)
+        {
+            const auto getVertex
+                = [&](unsigned short index) { return Misc::Convert::makeOsgVec3f(&tile.verts[index * 3]); };
+
+            // Links of off mesh connections use edge 0 for the start and 1 for the end
+            if (poly.getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+            {
+                if (link.edge > 1)
+                    return std::nullopt;
+                return getVertex(poly.verts[link.edge]);
+            }
+
+            // Links to off mesh connections from their landing polygons have no edge
+            if (link.edge >= poly.vertCount)
+                return std::nullopt;
+
+            return (getVertex(poly.verts[link.edge]) + getVertex(poly.verts[(link.edge + 1) % poly.vertCount])) / 2;
+        }
+
+        struct Node
+        {
+            float mCost = 0;
+            TilePosition mPrev;
+            const TilePortal* mPortal = nullptr;
+            bool mClosed = false;
+        };
+    }
+
+    void TileGraph::update(const dtNavMesh& navMesh, const TilePosition& position)
+    {
+        for (int x = -1; x <= 1; ++x)
+            for (int y = -1; y <= 1; ++y)
+                updateTile(navMesh, position + TilePosition(x, y));
+    }
+
+    const std::vector<TilePortal>* TileGraph::getPortals(const TilePosition& position) const
+    {
+        const auto it = mPortals.find(position);
+        if (it == mPortals.end())
+            return nullptr;
+        return &it->second;
+    }
+
+    std::optional<std::vector<osg::Vec3f>> TileGraph::findPath(const TilePosition& start, const TilePosition& end) const
+    {
+        if (mPortals.find(start) == mPortals.end() || mPortals.find(end) == mPortals.end())
+            return std::nullopt;
+
+        using Item = std::pair<float, TilePosition>;
+
+        std::map<TilePosition, Node> nodes;
+        std::priority_queue<Item, std::vector<Item>, std::greater<>> open;
+
+        nodes.emplace(start, Node{});
+        open.emplace(getDistance(start, end), start);
+
+        while (!open.empty())
+        {
+            const TilePosition position = open.top().second;
+            open.pop();
+
+            Node& node = nodes[position];
+            if (node.mClosed)
+                continue;
+            node.mClosed = true;
+
+            if (position == end)
+            {
+                std::vector<osg::Vec3f> result;
+                for (const Node* current = &node; current->mPortal != nullptr; current = &nodes[current->mPrev])
+                    result.push_back(current->mPortal->mPosition);
+                std::reverse(result.begin(), result.end());
+                return result;
+            }
+
+            const auto portals = mPortals.find(position);
+            if (portals == mPortals.end())
+                continue;
+
+            const float cost = node.mCost;
+
+            for (const TilePortal& portal : portals->second)
+            {
+                if (mPortals.find(portal.mNeighbour) == mPortals.end())
+                    continue;
+                const float neighbourCost = cost + getDistance(position, portal.mNeighbour);
+                const auto [neighbour, inserted] = nodes.emplace(portal.mNeighbour, Node{});
+                if (neighbour->second.mClosed || (!inserted && neighbour->second.mCost <= neighbourCost))
+                    continue;
+                neighbour->second.mCost = neighbourCost;
+                neighbour->second.mPrev = position;
+                neighbour->second.mPortal = &portal;
+                open.emplace(neighbourCost + getDistance(portal.mNeighbour, end), portal.mNeighbour);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void TileGraph::updateTile(const dtNavMesh& navMesh, const TilePosition& position)
+    {
+        const int layer = 0;
+        const dtMeshTile* const tile = navMesh.getTileAt(position.x(), position.y(), layer);
+        if (tile == nullptr || tile->header == nullptr)
+        {
+            mPortals.erase(position);
+            return;
+        }
+
+        std::map<TilePosition, std::vector<osg::Vec3f>> points;
+
+        for (int i = 0; i < tile->header->polyCount; ++i)
+        {
+            const dtPoly& poly = tile->polys[i];
+            for (unsigned int k = poly.firstLink; k != DT_NULL_LINK; k = tile->links[k].next)
+            {
+                const dtLink& link = tile->links[k];
+                const dtMeshTile* neighbour = nullptr;
+                const dtPoly* neighbourPoly = nullptr;
+                if (dtStatusFailed(navMesh.getTileAndPolyByRef(link.ref, &neighbour, &neighbourPoly))
+                    || neighbour == tile)
+                    continue;
+                if (const std::optional<osg::Vec3f> point = getPortalPosition(*tile, poly, link))
+                    points[TilePosition(neighbour->header->x, neighbour->header->y)].push_back(*point);
+            }
+        }
+
+        std::vector<TilePortal>& portals = mPortals[position];
+        portals.clear();
+
+        // The average may be outside of the navmesh when tiles are connected in multiple places, so use the closest
+        // actual portal point.
+        for (const auto& [neighbour, values] : points)
+        {
+            const osg::Vec3f center = std::accumulate(values.begin(), values.end(), osg::Vec3f())
+                / static_cast<float>(values.size());
+            const auto nearest = std::min_element(values.begin(), values.end(),
+                [&](const osg::Vec3f& l, const osg::Vec3f& r) { return (l - center).length2() < (r - center).length2(); });
+            portals.push_back(TilePortal{ neighbour, *nearest });
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_TILEGRAPH_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_TILEGRAPH_H
+
+#include "tileposition.hpp"
+
+#include <osg/Vec3f>
+
+#include <map>
+#include <optional>
+#include <vector>
+
+class dtNavMesh;
+
+namespace DetourNavigator
+{
+    // Connection from a tile to a neighbour tile. Position is in navmesh coordinates and is located on one of the
+    // polygon edges or off mesh connections linking the tiles.
+    struct TilePortal
+    {
+        TilePosition mNeighbour;
+        osg::Vec3f mPosition;
+    };
+
+    // Coarse graph of navmesh tiles connected by portals. Used to find long distance paths over tiles first and then
+    // refine them over polygons only along the found tiles.
+    class TileGraph
+    {
+    public:
+        // Has to be called after the tile at given position is added, replaced or removed from the navmesh. Updates
+        // the tile and its neighbours because Detour links them with the changed tile.
+        void update(const dtNavMesh& navMesh, const TilePosition& position);
+
+        const std::vector<TilePortal>* getPortals(const TilePosition& position) const;
+
+        std::size_t getTilesCount() const { return mPortals.size(); }
+
+        // Returns portals to pass through to get from start to end tile, empty when start is end and nullopt when
+        // there is no path.
+        std::optional<std::vector<osg::Vec3f>> findPath(const TilePosition& start, const TilePosition& end) const;
+
+    private:
+        std::map<TilePosition, std::vector<TilePortal>> mPortals;
+
+        void updateTile(const dtNavMesh& navMesh, const TilePosition& position);
+    };
+}
+
+#endif
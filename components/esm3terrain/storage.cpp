@@ -1,6 +1,11 @@
 #include "storage.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <optional>
 #include <set>
+#include <vector>
 
 #include <osg/Image>
 #include <osg/Plane>
@@ -43,6 +48,155 @@ namespace ESMTerrain
 
     const float defaultHeight = ESM::Land::DEFAULT_HEIGHT;
 
+    namespace
+    {
+        int floorDiv(int value, int divisor)
+        {
+            const int result = value / divisor;
+            return (value % divisor != 0 && value < 0) ? result - 1 : result;
+        }
+
+        // Vertex position along one axis of a chunk. Vertices on a cell border are shared by two cells: the height is
+        // taken from the cell where the vertex is the last one (except the first chunk vertex), normals and colours
+        // are taken from the cell where it is the first one.
+        struct AxisVertex
+        {
+            int mVertex;
+            float mPosition;
+            int mHeightCell;
+            int mHeightIndex;
+            int mDataCell;
+            int mDataIndex;
+        };
+
+        std::vector<AxisVertex> makeAxisVertices(int startVertex, std::size_t numVerts, int increment, float size)
+        {
+            std::vector<AxisVertex> result;
+            result.reserve(numVerts);
+            for (std::size_t i = 0; i < numVerts; ++i)
+            {
+                AxisVertex& vertex = result.emplace_back();
+                vertex.mVertex = startVertex + static_cast<int>(i) * increment;
+                vertex.mPosition
+                    = (static_cast<float>(i) / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits;
+                vertex.mDataCell = floorDiv(vertex.mVertex, ESM::Land::LAND_SIZE - 1);
+                vertex.mDataIndex = vertex.mVertex - vertex.mDataCell * (ESM::Land::LAND_SIZE - 1);
+                vertex.mHeightCell = (i == 0 || vertex.mDataIndex != 0) ? vertex.mDataCell : vertex.mDataCell - 1;
+                vertex.mHeightIndex = vertex.mVertex - vertex.mHeightCell * (ESM::Land::LAND_SIZE - 1);
+                assert(vertex.mHeightIndex >= 0 && vertex.mHeightIndex < ESM::Land::LAND_SIZE);
+            }
+            return result;
+        }
+
+        struct CellData
+        {
+            const ESM::Land::LandData* mHeights = nullptr;
+            const ESM::Land::LandData* mNormals = nullptr;
+            const ESM::Land::LandData* mColours = nullptr;
+        };
+
+        // Land data of all cells covered by a chunk resolved once to avoid a map lookup per vertex. Includes adjacent
+        // cells for the corner normals but not the diagonal ones which are never used.
+        class CellDataGrid
+        {
+        public:
+            template <class GetLand>
+            explicit CellDataGrid(
+                const std::vector<AxisVertex>& axisX, const std::vector<AxisVertex>& axisY, GetLand&& getLand)
+                : mMinCellX(floorDiv(axisX.front().mVertex - 1, ESM::Land::LAND_SIZE - 1))
+                , mMinCellY(floorDiv(axisY.front().mVertex - 1, ESM::Land::LAND_SIZE - 1))
+                , mWidth(floorDiv(axisX.back().mVertex + 1, ESM::Land::LAND_SIZE - 1) - mMinCellX + 1)
+                , mCells(static_cast<std::size_t>(
+                      mWidth * (floorDiv(axisY.back().mVertex + 1, ESM::Land::LAND_SIZE - 1) - mMinCellY + 1)))
+            {
+                const int maxCellY = mMinCellY + static_cast<int>(mCells.size()) / mWidth - 1;
+                for (int cellY = mMinCellY; cellY <= maxCellY; ++cellY)
+                    for (int cellX = mMinCellX; cellX < mMinCellX + mWidth; ++cellX)
+                    {
+                        const bool coveredX = cellX >= axisX.front().mDataCell && cellX <= axisX.back().mDataCell;
+                        const bool coveredY = cellY >= axisY.front().mDataCell && cellY <= axisY.back().mDataCell;
+                        if (!coveredX && !coveredY)
+                            continue;
+                        const LandObject* const land = getLand(cellX, cellY);
+                        if (land == nullptr)
+                            continue;
+                        CellData& cell = mCells[getIndex(cellX, cellY)];
+                        cell.mHeights = land->getData(ESM::Land::DATA_VHGT);
+                        cell.mNormals = land->getData(ESM::Land::DATA_VNML);
+                        cell.mColours = land->getData(ESM::Land::DATA_VCLR);
+                    }
+            }
+
+            const CellData& get(int cellX, int cellY) const { return mCells[getIndex(cellX, cellY)]; }
+
+        private:
+            int mMinCellX;
+            int mMinCellY;
+            int mWidth;
+            std::vector<CellData> mCells;
+
+            std::size_t getIndex(int cellX, int cellY) const
+            {
+                assert(cellX >= mMinCellX && cellX < mMinCellX + mWidth);
+                assert(cellY >= mMinCellY);
+                return static_cast<std::size_t>((cellY - mMinCellY) * mWidth + (cellX - mMinCellX));
+            }
+        };
+
+        // Same as osg::Vec3f::normalize but without data dependent branches for all elements
+        void normalize(osg::Vec3Array& values)
+        {
+            if (values.empty())
+                return;
+            osg::Vec3f* const data = &values.front();
+            const std::size_t size = values.size();
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const float norm = std::sqrt(data[i].x() * data[i].x() + data[i].y() * data[i].y()
+                    + data[i].z() * data[i].z());
+                const float inv = norm > 0.0f ? 1.0f / norm : 1.0f;
+                data[i].x() *= inv;
+                data[i].y() *= inv;
+                data[i].z() *= inv;
+            }
+        }
+
+        osg::Vec3f getNormal(const CellDataGrid& grid, int vertexX, int vertexY)
+        {
+            const int cellX = floorDiv(vertexX, ESM::Land::LAND_SIZE - 1);
+            const int cellY = floorDiv(vertexY, ESM::Land::LAND_SIZE - 1);
+            const ESM::Land::LandData* const data = grid.get(cellX, cellY).mNormals;
+            if (data == nullptr)
+                return osg::Vec3f(0, 0, 1);
+            const int row = vertexX - cellX * (ESM::Land::LAND_SIZE - 1);
+            const int col = vertexY - cellY * (ESM::Land::LAND_SIZE - 1);
+            const int index = (col * ESM::Land::LAND_SIZE + row) * 3;
+            osg::Vec3f normal(data->mNormals[index], data->mNormals[index + 1], data->mNormals[index + 2]);
+            normal.normalize();
+            return normal;
+        }
+
+        // Land texture position of a blendmap texel along one axis
+        struct TexelAxis
+        {
+            int mCell;
+            int mIndex;
+        };
+
+        std::vector<TexelAxis> makeTexelAxis(int start, int size)
+        {
+            std::vector<TexelAxis> result;
+            result.reserve(static_cast<std::size_t>(size));
+            for (int i = 0; i < size; ++i)
+            {
+                const int texel = start + i;
+                const int cell = floorDiv(texel, ESM::Land::LAND_TEXTURE_SIZE);
+                result.push_back(TexelAxis{ cell, texel - cell * ESM::Land::LAND_TEXTURE_SIZE });
+            }
+            return result;
+        }
+    }
+
     Storage::Storage(const VFS::Manager* vfs, const std::string& normalMapPattern,
         const std::string& normalHeightMapPattern, bool autoUseNormalMaps, const std::string& specularMapPattern,
         bool autoUseSpecularMaps)
@@ -95,262 +249,107 @@ namespace ESMTerrain
         return false;
     }
 
-    void Storage::fixNormal(osg::Vec3f& normal, int cellX, int cellY, int col, int row, LandCache& cache)
-    {
-        while (col >= ESM::Land::LAND_SIZE - 1)
-        {
-            ++cellY;
-            col -= ESM::Land::LAND_SIZE - 1;
-        }
-        while (row >= ESM::Land::LAND_SIZE - 1)
-        {
-            ++cellX;
-            row -= ESM::Land::LAND_SIZE - 1;
-        }
-        while (col < 0)
-        {
-            --cellY;
-            col += ESM::Land::LAND_SIZE - 1;
-        }
-        while (row < 0)
-        {
-            --cellX;
-            row += ESM::Land::LAND_SIZE - 1;
-        }
-
-        const LandObject* land = getLand(cellX, cellY, cache);
-        const ESM::Land::LandData* data = land ? land->getData(ESM::Land::DATA_VNML) : nullptr;
-        if (data)
-        {
-            normal.x() = data->mNormals[col * ESM::Land::LAND_SIZE * 3 + row * 3];
-            normal.y() = data->mNormals[col * ESM::Land::LAND_SIZE * 3 + row * 3 + 1];
-            normal.z() = data->mNormals[col * ESM::Land::LAND_SIZE * 3 + row * 3 + 2];
-            normal.normalize();
-        }
-        else
-            normal = osg::Vec3f(0, 0, 1);
-    }
-
-    void Storage::averageNormal(osg::Vec3f& normal, int cellX, int cellY, int col, int row, LandCache& cache)
-    {
-        osg::Vec3f n1, n2, n3, n4;
-        fixNormal(n1, cellX, cellY, col + 1, row, cache);
-        fixNormal(n2, cellX, cellY, col - 1, row, cache);
-        fixNormal(n3, cellX, cellY, col, row + 1, cache);
-        fixNormal(n4, cellX, cellY, col, row - 1, cache);
-        normal = (n1 + n2 + n3 + n4);
-        normal.normalize();
-    }
-
-    void Storage::fixColour(osg::Vec4ub& color, int cellX, int cellY, int col, int row, LandCache& cache)
-    {
-        if (col == ESM::Land::LAND_SIZE - 1)
-        {
-            ++cellY;
-            col = 0;
-        }
-        if (row == ESM::Land::LAND_SIZE - 1)
-        {
-            ++cellX;
-            row = 0;
-        }
-
-        const LandObject* land = getLand(cellX, cellY, cache);
-        const ESM::Land::LandData* data = land ? land->getData(ESM::Land::DATA_VCLR) : nullptr;
-        if (data)
-        {
-            color.r() = data->mColours[col * ESM::Land::LAND_SIZE * 3 + row * 3];
-            color.g() = data->mColours[col * ESM::Land::LAND_SIZE * 3 + row * 3 + 1];
-            color.b() = data->mColours[col * ESM::Land::LAND_SIZE * 3 + row * 3 + 2];
-        }
-        else
-        {
-            color.r() = 255;
-            color.g() = 255;
-            color.b() = 255;
-        }
-    }
-
     void Storage::fillVertexBuffers(int lodLevel, float size, const osg::Vec2f& center,
         osg::ref_ptr<osg::Vec3Array> positions, osg::ref_ptr<osg::Vec3Array> normals,
         osg::ref_ptr<osg::Vec4ubArray> colours)
     {
         // LOD level n means every 2^n-th vertex is kept
-        size_t increment = static_cast<size_t>(1) << lodLevel;
+        const int increment = 1 << lodLevel;
 
-        osg::Vec2f origin = center - osg::Vec2f(size / 2.f, size / 2.f);
+        const osg::Vec2f origin = center - osg::Vec2f(size / 2.f, size / 2.f);
 
-        int startCellX = static_cast<int>(std::floor(origin.x()));
-        int startCellY = static_cast<int>(std::floor(origin.y()));
+        const int startCellX = static_cast<int>(std::floor(origin.x()));
+        const int startCellY = static_cast<int>(std::floor(origin.y()));
 
-        size_t numVerts = static_cast<size_t>(size * (ESM::Land::LAND_SIZE - 1) / increment + 1);
+        const std::size_t numVerts = static_cast<std::size_t>(size * (ESM::Land::LAND_SIZE - 1) / increment + 1);
 
-        positions->resize(numVerts * numVerts);
-        normals->resize(numVerts * numVerts);
-        colours->resize(numVerts * numVerts);
-
-        osg::Vec3f normal;
-        osg::Vec4ub color;
+        // Only relevant for chunks smaller than (contained in) one cell
+        const int startVertexX = startCellX * (ESM::Land::LAND_SIZE - 1)
+            + static_cast<int>((origin.x() - startCellX) * ESM::Land::LAND_SIZE);
+        const int startVertexY = startCellY * (ESM::Land::LAND_SIZE - 1)
+            + static_cast<int>((origin.y() - startCellY) * ESM::Land::LAND_SIZE);
 
-        float vertY = 0;
-        float vertX = 0;
+        const std::vector<AxisVertex> axisX = makeAxisVertices(startVertexX, numVerts, increment, size);
+        const std::vector<AxisVertex> axisY = makeAxisVertices(startVertexY, numVerts, increment, size);
 
         LandCache cache;
+        const CellDataGrid grid(axisX, axisY, [&](int cellX, int cellY) { return getLand(cellX, cellY, cache); });
+
+        positions->resize(numVerts * numVerts);
+        normals->resize(numVerts * numVerts);
+        colours->resize(numVerts * numVerts);
 
-        bool alteration = useAlteration();
+        const bool alteration = useAlteration();
 
-        float vertY_ = 0; // of current cell corner
-        for (int cellY = startCellY; cellY < startCellY + std::ceil(size); ++cellY)
+        for (std::size_t vertX = 0; vertX < numVerts; ++vertX)
         {
-            float vertX_ = 0; // of current cell corner
-            for (int cellX = startCellX; cellX < startCellX + std::ceil(size); ++cellX)
-            {
-                const LandObject* land = getLand(cellX, cellY, cache);
-                const ESM::Land::LandData* heightData = nullptr;
-                const ESM::Land::LandData* normalData = nullptr;
-                const ESM::Land::LandData* colourData = nullptr;
-                if (land)
-                {
-                    heightData = land->getData(ESM::Land::DATA_VHGT);
-                    normalData = land->getData(ESM::Land::DATA_VNML);
-                    colourData = land->getData(ESM::Land::DATA_VCLR);
-                }
+            const AxisVertex& x = axisX[vertX];
+            osg::Vec3f* const positionsColumn = &(*positions)[vertX * numVerts];
+            osg::Vec3f* const normalsColumn = &(*normals)[vertX * numVerts];
+            osg::Vec4ub* const coloursColumn = &(*colours)[vertX * numVerts];
 
-                int rowStart = 0;
-                int colStart = 0;
-                // Skip the first row / column unless we're at a chunk edge,
-                // since this row / column is already contained in a previous cell
-                // This is only relevant if we're creating a chunk spanning multiple cells
-                if (vertY_ != 0)
-                    colStart += increment;
-                if (vertX_ != 0)
-                    rowStart += increment;
-
-                // Only relevant for chunks smaller than (contained in) one cell
-                rowStart += (origin.x() - startCellX) * ESM::Land::LAND_SIZE;
-                colStart += (origin.y() - startCellY) * ESM::Land::LAND_SIZE;
-                int rowEnd = std::min(static_cast<int>(rowStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE - 1) + 1),
-                    static_cast<int>(ESM::Land::LAND_SIZE));
-                int colEnd = std::min(static_cast<int>(colStart + std::min(1.f, size) * (ESM::Land::LAND_SIZE - 1) + 1),
-                    static_cast<int>(ESM::Land::LAND_SIZE));
-
-                vertY = vertY_;
-                for (int col = colStart; col < colEnd; col += increment)
+            for (std::size_t vertY = 0; vertY < numVerts; ++vertY)
+            {
+                const AxisVertex& y = axisY[vertY];
+
+                const ESM::Land::LandData* const heightData = grid.get(x.mHeightCell, y.mHeightCell).mHeights;
+                float height = defaultHeight;
+                if (heightData)
+                    height = heightData->mHeights[y.mHeightIndex * ESM::Land::LAND_SIZE + x.mHeightIndex];
+                if (alteration)
+                    height += getAlteredHeight(y.mHeightIndex, x.mHeightIndex);
+                positionsColumn[vertY] = osg::Vec3f(x.mPosition, y.mPosition, height);
+
+                // Normals apparently don't connect seamlessly between cells, colors mostly do but not always, so both
+                // are taken from the next cell for the shared vertices
+                const CellData& data = grid.get(x.mDataCell, y.mDataCell);
+                const int srcArrayIndex = (y.mDataIndex * ESM::Land::LAND_SIZE + x.mDataIndex) * 3;
+
+                if (data.mNormals)
+                    normalsColumn[vertY] = osg::Vec3f(data.mNormals->mNormals[srcArrayIndex],
+                        data.mNormals->mNormals[srcArrayIndex + 1], data.mNormals->mNormals[srcArrayIndex + 2]);
+                else
+                    normalsColumn[vertY] = osg::Vec3f(0, 0, 1);
+
+                osg::Vec4ub& color = coloursColumn[vertY];
+                if (data.mColours)
+                    color = osg::Vec4ub(data.mColours->mColours[srcArrayIndex],
+                        data.mColours->mColours[srcArrayIndex + 1], data.mColours->mColours[srcArrayIndex + 2], 255);
+                else
+                    color = osg::Vec4ub(255, 255, 255, 255);
+
+                // Does nothing by default, override in OpenMW-CS. Shared vertices use the colour of the next cell.
+                if (alteration && x.mHeightIndex != ESM::Land::LAND_SIZE - 1
+                    && y.mHeightIndex != ESM::Land::LAND_SIZE - 1)
                 {
-                    vertX = vertX_;
-                    for (int row = rowStart; row < rowEnd; row += increment)
-                    {
-                        int srcArrayIndex = col * ESM::Land::LAND_SIZE * 3 + row * 3;
-
-                        assert(row >= 0 && row < ESM::Land::LAND_SIZE);
-                        assert(col >= 0 && col < ESM::Land::LAND_SIZE);
-
-                        assert(vertX < numVerts);
-                        assert(vertY < numVerts);
-
-                        float height = defaultHeight;
-                        if (heightData)
-                            height = heightData->mHeights[col * ESM::Land::LAND_SIZE + row];
-                        if (alteration)
-                            height += getAlteredHeight(col, row);
-                        (*positions)[static_cast<unsigned int>(vertX * numVerts + vertY)]
-                            = osg::Vec3f((vertX / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits,
-                                (vertY / float(numVerts - 1) - 0.5f) * size * Constants::CellSizeInUnits, height);
-
-                        if (normalData)
-                        {
-                            for (int i = 0; i < 3; ++i)
-                                normal[i] = normalData->mNormals[srcArrayIndex + i];
-
-                            normal.normalize();
-                        }
-                        else
-                            normal = osg::Vec3f(0, 0, 1);
-
-                        // Normals apparently don't connect seamlessly between cells
-                        if (col == ESM::Land::LAND_SIZE - 1 || row == ESM::Land::LAND_SIZE - 1)
-                            fixNormal(normal, cellX, cellY, col, row, cache);
-
-                        // some corner normals appear to be complete garbage (z < 0)
-                        if ((row == 0 || row == ESM::Land::LAND_SIZE - 1)
-                            && (col == 0 || col == ESM::Land::LAND_SIZE - 1))
-                            averageNormal(normal, cellX, cellY, col, row, cache);
-
-                        assert(normal.z() > 0);
-
-                        (*normals)[static_cast<unsigned int>(vertX * numVerts + vertY)] = normal;
-
-                        if (colourData)
-                        {
-                            for (int i = 0; i < 3; ++i)
-                                color[i] = colourData->mColours[srcArrayIndex + i];
-                        }
-                        else
-                        {
-                            color.r() = 255;
-                            color.g() = 255;
-                            color.b() = 255;
-                        }
-                        if (alteration)
-                            adjustColor(col, row, heightData, color); // Does nothing by default, override in OpenMW-CS
-
-                        // Unlike normals, colors mostly connect seamlessly between cells, but not always...
-                        if (col == ESM::Land::LAND_SIZE - 1 || row == ESM::Land::LAND_SIZE - 1)
-                            fixColour(color, cellX, cellY, col, row, cache);
-
-                        color.a() = 255;
-
-                        (*colours)[static_cast<unsigned int>(vertX * numVerts + vertY)] = color;
-
-                        ++vertX;
-                    }
-                    ++vertY;
+                    adjustColor(y.mHeightIndex, x.mHeightIndex, heightData, color);
+                    color.a() = 255;
                 }
-                vertX_ = vertX;
             }
-            vertY_ = vertY;
-
-            assert(vertX_ == numVerts); // Ensure we covered whole area
-        }
-        assert(vertY_ == numVerts); // Ensure we covered whole area
-    }
-
-    Storage::UniqueTextureId Storage::getVtexIndexAt(int cellX, int cellY, int x, int y, LandCache& cache)
-    {
-        // For the first/last row/column, we need to get the texture from the neighbour cell
-        // to get consistent blending at the borders
-        --x;
-        if (x < 0)
-        {
-            --cellX;
-            x += ESM::Land::LAND_TEXTURE_SIZE;
-        }
-        while (x >= ESM::Land::LAND_TEXTURE_SIZE)
-        {
-            ++cellX;
-            x -= ESM::Land::LAND_TEXTURE_SIZE;
-        }
-        while (
-            y >= ESM::Land::LAND_TEXTURE_SIZE) // Y appears to be wrapped from the other side because why the hell not?
-        {
-            ++cellY;
-            y -= ESM::Land::LAND_TEXTURE_SIZE;
         }
 
-        assert(x < ESM::Land::LAND_TEXTURE_SIZE);
-        assert(y < ESM::Land::LAND_TEXTURE_SIZE);
+        // Separate pass over a contiguous array allows the compiler to vectorize it
+        normalize(*normals);
 
-        const LandObject* land = getLand(cellX, cellY, cache);
-
-        const ESM::Land::LandData* data = land ? land->getData(ESM::Land::DATA_VTEX) : nullptr;
-        if (data)
+        // some corner normals appear to be complete garbage (z < 0)
+        for (std::size_t vertX = 0; vertX < numVerts; ++vertX)
         {
-            int tex = data->mTextures[y * ESM::Land::LAND_TEXTURE_SIZE + x];
-            if (tex == 0)
-                return std::make_pair(0, 0); // vtex 0 is always the base texture, regardless of plugin
-            return std::make_pair(tex, land->getPlugin());
+            if (axisX[vertX].mDataIndex != 0)
+                continue;
+            for (std::size_t vertY = 0; vertY < numVerts; ++vertY)
+            {
+                if (axisY[vertY].mDataIndex != 0)
+                    continue;
+                const int x = axisX[vertX].mVertex;
+                const int y = axisY[vertY].mVertex;
+                osg::Vec3f normal = getNormal(grid, x, y + 1) + getNormal(grid, x, y - 1) + getNormal(grid, x + 1, y)
+                    + getNormal(grid, x - 1, y);
+                normal.normalize();
+                (*normals)[vertX * numVerts + vertY] = normal;
+            }
         }
-        return std::make_pair(0, 0);
+
+        assert(std::all_of(normals->begin(), normals->end(), [](const osg::Vec3f& v) { return v.z() > 0; }));
     }
 
     std::string Storage::getTextureName(UniqueTextureId id)
@@ -391,55 +390,113 @@ namespace ESMTerrain
         const int imageScaleFactor = 2;
         const int blendmapImageSize = blendmapSize * imageScaleFactor;
 
+        // For the first column, we need to get the texture from the neighbour cell to get consistent blending at the
+        // borders. Y appears to be wrapped from the other side because why the hell not?
+        const std::vector<TexelAxis> axisX
+            = makeTexelAxis(cellX * ESM::Land::LAND_TEXTURE_SIZE + rowStart - 1, blendmapSize);
+        const std::vector<TexelAxis> axisY
+            = makeTexelAxis(cellY * ESM::Land::LAND_TEXTURE_SIZE + colStart, blendmapSize);
+
+        // Texture data of the covered cells is resolved once instead of for each texel
         LandCache cache;
+        const int minCellX = axisX.front().mCell;
+        const int minCellY = axisY.front().mCell;
+        const int numCellsX = axisX.back().mCell - minCellX + 1;
+        const int numCellsY = axisY.back().mCell - minCellY + 1;
+        std::vector<std::pair<const ESM::Land::LandData*, short>> cells(
+            static_cast<std::size_t>(numCellsX * numCellsY));
+        for (int y = 0; y < numCellsY; ++y)
+            for (int x = 0; x < numCellsX; ++x)
+                if (const LandObject* land = getLand(minCellX + x, minCellY + y, cache))
+                    cells[y * numCellsX + x] = std::pair(land->getData(ESM::Land::DATA_VTEX), land->getPlugin());
+
         std::map<UniqueTextureId, unsigned int> textureIndicesMap;
 
+        const auto getLayerIndex = [&](UniqueTextureId id) {
+            std::map<UniqueTextureId, unsigned int>::iterator found = textureIndicesMap.find(id);
+            if (found != textureIndicesMap.end())
+                return found->second;
+
+            unsigned int layerIndex = layerList.size();
+            Terrain::LayerInfo info = getLayerInfo(getTextureName(id));
+
+            // look for existing diffuse map, which may be present when several plugins use the same texture
+            for (unsigned int i = 0; i < layerList.size(); ++i)
+            {
+                if (layerList[i].mDiffuseMap == info.mDiffuseMap)
+                {
+                    layerIndex = i;
+                    break;
+                }
+            }
+
+            if (layerIndex >= layerList.size())
+                layerList.emplace_back(info);
+
+            textureIndicesMap.emplace(id, layerIndex);
+            return layerIndex;
+        };
+
+        // First pass assigns layers in the order of their first use, neighbouring texels mostly share the texture
+        std::vector<unsigned int> layers(static_cast<std::size_t>(blendmapSize * blendmapSize));
+        std::optional<UniqueTextureId> lastId;
+        unsigned int lastLayer = 0;
         for (int y = 0; y < blendmapSize; y++)
         {
+            const TexelAxis& texelY = axisY[y];
             for (int x = 0; x < blendmapSize; x++)
             {
-                UniqueTextureId id = getVtexIndexAt(cellX, cellY, x + rowStart, y + colStart, cache);
-                std::map<UniqueTextureId, unsigned int>::iterator found = textureIndicesMap.find(id);
-                if (found == textureIndicesMap.end())
+                const TexelAxis& texelX = axisX[x];
+                const auto& [data, plugin]
+                    = cells[(texelY.mCell - minCellY) * numCellsX + (texelX.mCell - minCellX)];
+                UniqueTextureId id(0, 0);
+                if (data)
+                {
+                    int tex = data->mTextures[texelY.mIndex * ESM::Land::LAND_TEXTURE_SIZE + texelX.mIndex];
+                    // vtex 0 is always the base texture, regardless of plugin
+                    if (tex != 0)
+                        id = UniqueTextureId(tex, plugin);
+                }
+                if (id != lastId)
                 {
-                    unsigned int layerIndex = layerList.size();
-                    Terrain::LayerInfo info = getLayerInfo(getTextureName(id));
+                    lastId = id;
+                    lastLayer = getLayerIndex(id);
+                }
+                layers[y * blendmapSize + x] = lastLayer;
+            }
+        }
 
-                    // look for existing diffuse map, which may be present when several plugins use the same texture
-                    for (unsigned int i = 0; i < layerList.size(); ++i)
-                    {
-                        if (layerList[i].mDiffuseMap == info.mDiffuseMap)
-                        {
-                            layerIndex = i;
-                            break;
-                        }
-                    }
+        if (layerList.size() == 1)
+            return; // If a single texture fills the whole terrain, there is no need to blend
 
-                    found = textureIndicesMap.emplace(id, layerIndex).first;
+        // Second pass writes blend values of 4 layers into each RGBA texel
+        const std::size_t firstImage = blendmaps.size();
+        for (std::size_t i = 0; i < (layerList.size() + 3) / 4; ++i)
+        {
+            osg::ref_ptr<osg::Image> image(new osg::Image);
+            image->allocateImage(blendmapImageSize, blendmapImageSize, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+            memset(image->data(), 0, image->getTotalDataSize());
+            blendmaps.emplace_back(image);
+        }
 
-                    if (layerIndex >= layerList.size())
-                    {
-                        osg::ref_ptr<osg::Image> image(new osg::Image);
-                        image->allocateImage(blendmapImageSize, blendmapImageSize, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
-                        unsigned char* pData = image->data();
-                        memset(pData, 0, image->getTotalDataSize());
-                        blendmaps.emplace_back(image);
-                        layerList.emplace_back(info);
-                    }
-                }
-                unsigned int layerIndex = found->second;
-                unsigned char* pData = blendmaps[layerIndex]->data();
-                int realY = (blendmapSize - y - 1) * imageScaleFactor;
-                int realX = x * imageScaleFactor;
-                pData[((realY + 0) * blendmapImageSize + realX + 0)] = 255;
-                pData[((realY + 1) * blendmapImageSize + realX + 0)] = 255;
-                pData[((realY + 0) * blendmapImageSize + realX + 1)] = 255;
-                pData[((realY + 1) * blendmapImageSize + realX + 1)] = 255;
+        const std::size_t rowSize = static_cast<std::size_t>(blendmapImageSize) * 4;
+        for (int y = 0; y < blendmapSize; y++)
+        {
+            const std::size_t realY = static_cast<std::size_t>(blendmapSize - y - 1) * imageScaleFactor;
+            for (int x = 0; x < blendmapSize; x++)
+            {
+                const unsigned int layerIndex = layers[y * blendmapSize + x];
+                unsigned char* texel = blendmaps[firstImage + layerIndex / 4]->data()
+                    + realY * rowSize + static_cast<std::size_t>(x) * imageScaleFactor * 4 + layerIndex % 4;
+                texel[0] = 255;
+                texel[4] = 255;
+            }
+            for (std::size_t i = firstImage; i < blendmaps.size(); ++i)
+            {
+                unsigned char* pData = blendmaps[i]->data();
+                std::memcpy(pData + (realY + 1) * rowSize, pData + realY * rowSize, rowSize);
             }
         }
-
-        if (blendmaps.size() == 1)
-            blendmaps.clear(); // If a single texture fills the whole terrain, there is no need to blend
     }
 
     float Storage::getHeightAt(const osg::Vec3f& worldPos)
@@ -91,7 +91,8 @@ namespace ESMTerrain
         /// @note May be called from background threads.
         /// @param chunkSize size of the terrain chunk in cell units
         /// @param chunkCenter center of the chunk in cell units
-        /// @param blendmaps created blendmaps will be written here
+        /// @param blendmaps created blendmaps will be written here, RGBA images holding blend values of 4 layers each:
+        ///        layer i is stored in the channel i % 4 of the image i / 4. Empty when there is only one layer.
         /// @param layerList names of the layer textures used will be written here
         void getBlendmaps(float chunkSize, const osg::Vec2f& chunkCenter, ImageVector& blendmaps,
             std::vector<Terrain::LayerInfo>& layerList) override;
@@ -116,10 +117,6 @@ namespace ESMTerrain
     private:
         const VFS::Manager* mVFS;
 
-        inline void fixNormal(osg::Vec3f& normal, int cellX, int cellY, int col, int row, LandCache& cache);
-        inline void fixColour(osg::Vec4ub& colour, int cellX, int cellY, int col, int row, LandCache& cache);
-        inline void averageNormal(osg::Vec3f& normal, int cellX, int cellY, int col, int row, LandCache& cache);
-
         inline const LandObject* getLand(int cellX, int cellY, LandCache& cache);
 
         virtual bool useAlteration() const { return false; }
@@ -131,7 +128,6 @@ namespace ESMTerrain
         // pair  <texture id, plugin id>
         typedef std::pair<short, short> UniqueTextureId;
 
-        inline UniqueTextureId getVtexIndexAt(int cellX, int cellY, int x, int y, LandCache&);
         std::string getTextureName(UniqueTextureId id);
 
         std::map<std::string, Terrain::LayerInfo> mLayerInfoMap;
@@ -3,6 +3,7 @@
 
 #include <extern/smhasher/MurmurHash3.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <istream>
@@ -10,6 +11,18 @@
 
 namespace Files
 {
+    namespace
+    {
+        constexpr std::size_t blockSize = 4096;
+
+        void hashBlock(const char* data, std::size_t size, std::array<std::uint64_t, 2>& hash)
+        {
+            std::array<std::uint64_t, 2> blockHash{ 0, 0 };
+            MurmurHash3_x64_128(data, static_cast<int>(size), hash.data(), blockHash.data());
+            hash = blockHash;
+        }
+    }
+
     std::array<std::uint64_t, 2> getHash(const std::filesystem::path& fileName, std::istream& stream)
     {
         std::array<std::uint64_t, 2> hash{ 0, 0 };
@@ -20,14 +33,12 @@ namespace Files
             stream.exceptions(std::ios_base::badbit);
             while (stream)
             {
-                std::array<char, 4096> value;
+                std::array<char, blockSize> value;
                 stream.read(value.data(), value.size());
                 const std::streamsize read = stream.gcount();
                 if (read == 0)
                     break;
-                std::array<std::uint64_t, 2> blockHash{ 0, 0 };
-                MurmurHash3_x64_128(value.data(), static_cast<int>(read), hash.data(), blockHash.data());
-                hash = blockHash;
+                hashBlock(value.data(), static_cast<std::size_t>(read), hash);
             }
             stream.clear();
             stream.exceptions(exceptions);
@@ -40,4 +51,12 @@ namespace Files
         }
         return hash;
     }
+
+    std::array<std::uint64_t, 2> getHash(std::string_view content)
+    {
+        std::array<std::uint64_t, 2> hash{ 0, 0 };
+        for (std::size_t offset = 0; offset < content.size(); offset += blockSize)
+            hashBlock(content.data() + offset, std::min(blockSize, content.size() - offset), hash);
+        return hash;
+    }
 }
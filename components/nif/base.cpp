@@ -22,11 +22,4 @@ namespace Nif
             readRecordList(nif, extralist);
         controller.read(nif);
     }
-
-    void Named::post(Reader& nif)
-    {
-        extra.post(nif);
-        postRecordList(nif, extralist);
-        controller.post(nif);
-    }
 }
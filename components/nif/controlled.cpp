@@ -42,12 +42,6 @@ namespace Nif
             /* bool mPersistRenderData = */ nif->getBoolean();
     }
 
-    void NiSourceTexture::post(Reader& nif)
-    {
-        Named::post(nif);
-        data.post(nif);
-    }
-
     void BSShaderTextureSet::read(NIFStream* nif)
     {
         nif->getSizedStrings(textures, nif->getUInt());
@@ -59,12 +53,6 @@ namespace Nif
         controller.read(nif);
     }
 
-    void NiParticleModifier::post(Reader& nif)
-    {
-        next.post(nif);
-        controller.post(nif);
-    }
-
     void NiParticleGrowFade::read(NIFStream* nif)
     {
         NiParticleModifier::read(nif);
@@ -78,12 +66,6 @@ namespace Nif
         data.read(nif);
     }
 
-    void NiParticleColorModifier::post(Reader& nif)
-    {
-        NiParticleModifier::post(nif);
-        data.post(nif);
-    }
-
     void NiGravity::read(NIFStream* nif)
     {
         NiParticleModifier::read(nif);
@@ -22,13 +22,6 @@ namespace Nif
         target.read(nif);
     }
 
-    void Controller::post(Reader& nif)
-    {
-        Record::post(nif);
-        next.post(nif);
-        target.post(nif);
-    }
-
     void ControlledBlock::read(NIFStream* nif)
     {
         if (nif->getVersion() <= NIFStream::generateVersion(10, 1, 0, 103))
@@ -69,15 +62,6 @@ namespace Nif
         }
     }
 
-    void ControlledBlock::post(Reader& nif)
-    {
-        mInterpolator.post(nif);
-        mController.post(nif);
-        mBlendInterpolator.post(nif);
-        mStringPalette.post(nif);
-        // TODO: probably should fill the strings with string palette contents here
-    }
-
     void NiSequence::read(NIFStream* nif)
     {
         mName = nif->getString();
@@ -94,13 +78,6 @@ namespace Nif
             block.read(nif);
     }
 
-    void NiSequence::post(Reader& nif)
-    {
-        mTextKeys.post(nif);
-        for (ControlledBlock& block : mControlledBlocks)
-            block.post(nif);
-    }
-
     void NiControllerSequence::read(NIFStream* nif)
     {
         NiSequence::read(nif);
@@ -131,13 +108,6 @@ namespace Nif
         }
     }
 
-    void NiControllerSequence::post(Reader& nif)
-    {
-        NiSequence::post(nif);
-        mManager.post(nif);
-        mStringPalette.post(nif);
-    }
-
     void NiInterpController::read(NIFStream* nif)
     {
         Controller::read(nif);
@@ -153,12 +123,6 @@ namespace Nif
             mInterpolator.read(nif);
     }
 
-    void NiSingleInterpController::post(Reader& nif)
-    {
-        NiInterpController::post(nif);
-        mInterpolator.post(nif);
-    }
-
     void NiParticleSystemController::read(NIFStream* nif)
     {
         Controller::read(nif);
@@ -213,14 +177,6 @@ namespace Nif
         nif->getChar();
     }
 
-    void NiParticleSystemController::post(Reader& nif)
-    {
-        Controller::post(nif);
-        emitter.post(nif);
-        affectors.post(nif);
-        colliders.post(nif);
-    }
-
     void NiMaterialColorController::read(NIFStream* nif)
     {
         NiPoint3InterpController::read(nif);
@@ -237,12 +193,6 @@ namespace Nif
             mData.read(nif);
     }
 
-    void NiMaterialColorController::post(Reader& nif)
-    {
-        NiPoint3InterpController::post(nif);
-        mData.post(nif);
-    }
-
     void NiLookAtController::read(NIFStream* nif)
     {
         Controller::read(nif);
@@ -251,12 +201,6 @@ namespace Nif
         target.read(nif);
     }
 
-    void NiLookAtController::post(Reader& nif)
-    {
-        Controller::post(nif);
-        target.post(nif);
-    }
-
     void NiPathController::read(NIFStream* nif)
     {
         Controller::read(nif);
@@ -269,14 +213,6 @@ namespace Nif
         floatData.read(nif);
     }
 
-    void NiPathController::post(Reader& nif)
-    {
-        Controller::post(nif);
-
-        posData.post(nif);
-        floatData.post(nif);
-    }
-
     void NiUVController::read(NIFStream* nif)
     {
         Controller::read(nif);
@@ -285,12 +221,6 @@ namespace Nif
         data.read(nif);
     }
 
-    void NiUVController::post(Reader& nif)
-    {
-        Controller::post(nif);
-        data.post(nif);
-    }
-
     void NiKeyframeController::read(NIFStream* nif)
     {
         NiSingleInterpController::read(nif);
@@ -298,27 +228,13 @@ namespace Nif
             mData.read(nif);
     }
 
-    void NiKeyframeController::post(Reader& nif)
-    {
-        NiSingleInterpController::post(nif);
-        mData.post(nif);
-    }
-
     void NiMultiTargetTransformController::read(NIFStream* nif)
     {
         NiInterpController::read(nif);
-        size_t numTargets = nif->getUShort();
-        std::vector<NodePtr> targets;
-        targets.resize(numTargets);
-        for (size_t i = 0; i < targets.size(); i++)
-            targets[i].read(nif);
-        mExtraTargets = targets;
-    }
-
-    void NiMultiTargetTransformController::post(Reader& nif)
-    {
-        NiInterpController::post(nif);
-        postRecordList(nif, mExtraTargets);
+        // Links are resolved into the list, it's read in place
+        mExtraTargets.resize(nif->getUShort());
+        for (NodePtr& target : mExtraTargets)
+            target.read(nif);
     }
 
     void NiAlphaController::read(NIFStream* nif)
@@ -328,12 +244,6 @@ namespace Nif
             mData.read(nif);
     }
 
-    void NiAlphaController::post(Reader& nif)
-    {
-        NiFloatInterpController::post(nif);
-        mData.post(nif);
-    }
-
     void NiRollController::read(NIFStream* nif)
     {
         NiSingleInterpController::read(nif);
@@ -341,12 +251,6 @@ namespace Nif
             mData.read(nif);
     }
 
-    void NiRollController::post(Reader& nif)
-    {
-        NiSingleInterpController::post(nif);
-        mData.post(nif);
-    }
-
     void NiGeomMorpherController::read(NIFStream* nif)
     {
         NiInterpController::read(nif);
@@ -369,28 +273,19 @@ namespace Nif
                 }
                 else
                 {
-                    std::vector<NiInterpolatorPtr> interpolators;
                     size_t numInterps = nif->getUInt();
-                    interpolators.resize(numInterps);
+                    mInterpolators.resize(numInterps);
                     mWeights.resize(numInterps);
                     for (size_t i = 0; i < numInterps; i++)
                     {
-                        interpolators[i].read(nif);
+                        mInterpolators[i].read(nif);
                         mWeights[i] = nif->getFloat();
                     }
-                    mInterpolators = interpolators;
                 }
             }
         }
     }
 
-    void NiGeomMorpherController::post(Reader& nif)
-    {
-        NiInterpController::post(nif);
-        mData.post(nif);
-        postRecordList(nif, mInterpolators);
-    }
-
     void NiVisController::read(NIFStream* nif)
     {
         NiBoolInterpController::read(nif);
@@ -398,12 +293,6 @@ namespace Nif
             mData.read(nif);
     }
 
-    void NiVisController::post(Reader& nif)
-    {
-        NiBoolInterpController::post(nif);
-        mData.post(nif);
-    }
-
     void NiFlipController::read(NIFStream* nif)
     {
         NiFloatInterpController::read(nif);
@@ -416,12 +305,6 @@ namespace Nif
         readRecordList(nif, mSources);
     }
 
-    void NiFlipController::post(Reader& nif)
-    {
-        NiFloatInterpController::post(nif);
-        postRecordList(nif, mSources);
-    }
-
     void bhkBlendController::read(NIFStream* nif)
     {
         Controller::read(nif);
@@ -436,46 +319,24 @@ namespace Nif
         mObjectPalette.read(nif);
     }
 
-    void NiControllerManager::post(Reader& nif)
-    {
-        Controller::post(nif);
-        postRecordList(nif, mSequences);
-        mObjectPalette.post(nif);
-    }
-
     void NiPoint3Interpolator::read(NIFStream* nif)
     {
         defaultVal = nif->getVector3();
         data.read(nif);
     }
 
-    void NiPoint3Interpolator::post(Reader& nif)
-    {
-        data.post(nif);
-    }
-
     void NiBoolInterpolator::read(NIFStream* nif)
     {
         defaultVal = nif->getBoolean();
         data.read(nif);
     }
 
-    void NiBoolInterpolator::post(Reader& nif)
-    {
-        data.post(nif);
-    }
-
     void NiFloatInterpolator::read(NIFStream* nif)
     {
         defaultVal = nif->getFloat();
         data.read(nif);
     }
 
-    void NiFloatInterpolator::post(Reader& nif)
-    {
-        data.post(nif);
-    }
-
     void NiTransformInterpolator::read(NIFStream* nif)
     {
         defaultPos = nif->getVector3();
@@ -493,22 +354,12 @@ namespace Nif
         data.read(nif);
     }
 
-    void NiTransformInterpolator::post(Reader& nif)
-    {
-        data.post(nif);
-    }
-
     void NiColorInterpolator::read(NIFStream* nif)
     {
         defaultVal = nif->getVector4();
         data.read(nif);
     }
 
-    void NiColorInterpolator::post(Reader& nif)
-    {
-        data.post(nif);
-    }
-
     void NiBlendInterpolator::read(NIFStream* nif)
     {
         if (nif->getVersion() >= NIFStream::generateVersion(10, 1, 0, 112))
@@ -579,13 +430,6 @@ namespace Nif
         }
     }
 
-    void NiBlendInterpolator::post(Reader& nif)
-    {
-        for (Item& item : mItems)
-            item.post(nif);
-        mSingleInterpolator.post(nif);
-    }
-
     void NiBlendInterpolator::Item::read(NIFStream* nif)
     {
         mInterpolator.read(nif);
@@ -598,11 +442,6 @@ namespace Nif
         mEaseSpinner = nif->getFloat();
     }
 
-    void NiBlendInterpolator::Item::post(Reader& nif)
-    {
-        mInterpolator.post(nif);
-    }
-
     void NiBlendBoolInterpolator::read(NIFStream* nif)
     {
         NiBlendInterpolator::read(nif);
@@ -50,7 +50,6 @@ namespace Nif
         std::string mInterpolatorId;
 
         void read(NIFStream* nif);
-        void post(Reader& nif);
     };
 
     // Gamebryo KF root node record type (pre-10.0)
@@ -63,7 +62,6 @@ namespace Nif
         std::vector<ControlledBlock> mControlledBlocks;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // Gamebryo KF root node record type (10.0+)
@@ -79,7 +77,6 @@ namespace Nif
         NiStringPalettePtr mStringPalette;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // Base class for controllers that use NiInterpolators to animate objects.
@@ -97,7 +94,6 @@ namespace Nif
         NiInterpolatorPtr mInterpolator;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // Base class for controllers that use a NiFloatInterpolator to animate their target.
@@ -169,7 +165,6 @@ namespace Nif
         NiParticleModifierPtr colliders;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
 
         bool noAutoAdjust() const { return emitFlags & EmitFlag_NoAutoAdjust; }
         bool emitAtVertex() const { return flags & BSPArrayController_AtVertex; }
@@ -182,7 +177,6 @@ namespace Nif
         unsigned int mTargetColor;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiPathController : public Controller
@@ -205,7 +199,6 @@ namespace Nif
         short followAxis;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiLookAtController : public Controller
@@ -214,7 +207,6 @@ namespace Nif
         unsigned short lookAtFlags{ 0 };
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiUVController : public Controller
@@ -223,7 +215,6 @@ namespace Nif
         unsigned int uvSet;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiKeyframeController : public NiSingleInterpController
@@ -231,7 +222,6 @@ namespace Nif
         NiKeyframeDataPtr mData;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiMultiTargetTransformController : public NiInterpController
@@ -239,7 +229,6 @@ namespace Nif
         NodeList mExtraTargets;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiAlphaController : public NiFloatInterpController
@@ -247,7 +236,6 @@ namespace Nif
         NiFloatDataPtr mData;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiRollController : public NiSingleInterpController
@@ -255,7 +243,6 @@ namespace Nif
         NiFloatDataPtr mData;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiGeomMorpherController : public NiInterpController
@@ -267,7 +254,6 @@ namespace Nif
         std::vector<float> mWeights;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiVisController : public NiBoolInterpController
@@ -275,7 +261,6 @@ namespace Nif
         NiVisDataPtr mData;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiFlipController : public NiFloatInterpController
@@ -285,7 +270,6 @@ namespace Nif
         NiSourceTextureList mSources;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct bhkBlendController : public Controller
@@ -299,7 +283,6 @@ namespace Nif
         NiControllerSequenceList mSequences;
         NiDefaultAVObjectPalettePtr mObjectPalette;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiInterpolator : public Record
@@ -311,7 +294,6 @@ namespace Nif
         osg::Vec3f defaultVal;
         NiPosDataPtr data;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiBoolInterpolator : public NiInterpolator
@@ -319,7 +301,6 @@ namespace Nif
         char defaultVal;
         NiBoolDataPtr data;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiFloatInterpolator : public NiInterpolator
@@ -327,7 +308,6 @@ namespace Nif
         float defaultVal;
         NiFloatDataPtr data;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiTransformInterpolator : public NiInterpolator
@@ -338,7 +318,6 @@ namespace Nif
         NiKeyframeDataPtr data;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiColorInterpolator : public NiInterpolator
@@ -346,7 +325,6 @@ namespace Nif
         osg::Vec4f defaultVal;
         NiColorDataPtr data;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // Abstract
@@ -360,7 +338,6 @@ namespace Nif
             float mEaseSpinner;
 
             void read(NIFStream* nif);
-            void post(Reader& nif);
         };
 
         bool mManagerControlled{ false };
@@ -377,7 +354,6 @@ namespace Nif
         NiInterpolatorPtr mSingleInterpolator;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiBlendBoolInterpolator : public NiBlendInterpolator
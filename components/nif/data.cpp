@@ -18,11 +18,6 @@ namespace Nif
 
     void NiSkinInstance::post(Reader& nif)
     {
-        data.post(nif);
-        partitions.post(nif);
-        root.post(nif);
-        postRecordList(nif, bones);
-
         if (data.empty() || root.empty())
             throw Nif::Exception("NiSkinInstance missing root or data", nif.getFilename());
 
@@ -305,11 +300,6 @@ namespace Nif
             nif->getUChars(data, numPixels * numFaces);
     }
 
-    void NiPixelData::post(Reader& nif)
-    {
-        palette.post(nif);
-    }
-
     void NiColorData::read(NIFStream* nif)
     {
         mKeyMap = std::make_shared<Vector4KeyMap>();
@@ -361,11 +351,6 @@ namespace Nif
         }
     }
 
-    void NiSkinData::post(Reader& nif)
-    {
-        partitions.post(nif);
-    }
-
     void NiSkinPartition::read(NIFStream* nif)
     {
         unsigned int num = nif->getUInt();
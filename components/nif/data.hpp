@@ -147,7 +147,6 @@ namespace Nif
         std::vector<unsigned char> data;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiColorData : public Record
@@ -206,7 +205,6 @@ namespace Nif
         NiSkinPartitionPtr partitions;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiSkinPartition : public Record
@@ -60,12 +60,6 @@ namespace Nif
             nif->skip(2); // Unknown short
     }
 
-    void NiTextureEffect::post(Reader& nif)
-    {
-        NiDynamicEffect::post(nif);
-        texture.post(nif);
-    }
-
     void NiPointLight::read(NIFStream* nif)
     {
         NiLight::read(nif);
@@ -5,10 +5,12 @@
 
 #include <algorithm>
 #include <array>
+#include <istream>
 #include <limits>
 #include <map>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 
 #include "controlled.hpp"
 #include "controller.hpp"
@@ -28,6 +30,7 @@ namespace Nif
         , bethVer(file.mBethVersion)
         , filename(file.mPath)
         , hash(file.mHash)
+        , arena(file.mArena)
         , records(file.mRecords)
         , roots(file.mRoots)
         , mUseSkinning(file.mUseSkinning)
@@ -35,14 +38,14 @@ namespace Nif
     }
 
     template <typename NodeType, RecordType recordType>
-    static std::unique_ptr<Record> construct()
+    static Record* construct(RecordArena& arena)
     {
-        auto result = std::make_unique<NodeType>();
+        NodeType* const result = arena.create<NodeType>();
         result->recType = recordType;
         return result;
     }
 
-    using CreateRecord = std::unique_ptr<Record> (*)();
+    using CreateRecord = Record* (*)(RecordArena&);
 
     /// These are all the record types we know how to read.
     static std::map<std::string, CreateRecord> makeFactory()
@@ -191,6 +194,39 @@ namespace Nif
     /// Make the factory map used for parsing the file
     static const std::map<std::string, CreateRecord> factories = makeFactory();
 
+    std::string Reader::readContent(std::istream& stream)
+    {
+        std::string content;
+        try
+        {
+            // Reserve the whole size if the stream knows it, but don't rely on it
+            const auto start = stream.tellg();
+            if (start != std::istream::pos_type(-1))
+            {
+                stream.seekg(0, std::ios_base::end);
+                const auto end = stream.tellg();
+                if (end > start)
+                    content.reserve(static_cast<std::size_t>(end - start));
+                stream.clear();
+                stream.seekg(start);
+            }
+
+            std::array<char, 64 * 1024> buffer;
+            while (stream)
+            {
+                stream.read(buffer.data(), buffer.size());
+                content.append(buffer.data(), static_cast<std::size_t>(stream.gcount()));
+            }
+            if (stream.bad())
+                throw std::runtime_error("stream is bad");
+        }
+        catch (const std::exception& e)
+        {
+            throw Nif::Exception(std::string("Failed to read file: ") + e.what(), filename);
+        }
+        return content;
+    }
+
     std::string Reader::printVersion(unsigned int version)
     {
         int major = (version >> 24) & 0xFF;
@@ -205,10 +241,15 @@ namespace Nif
 
     void Reader::parse(Files::IStreamPtr&& stream)
     {
-        const std::array<std::uint64_t, 2> fileHash = Files::getHash(filename, *stream);
+        // The whole file is read at once, records are parsed from memory
+        const std::string content = readContent(*stream);
+        stream.reset();
+        mSize = content.size();
+
+        const std::array<std::uint64_t, 2> fileHash = Files::getHash(content);
         hash.append(reinterpret_cast<const char*>(fileHash.data()), fileHash.size() * sizeof(std::uint64_t));
 
-        NIFStream nif(*this, std::move(stream));
+        NIFStream nif(*this, content);
 
         // Check the header string
         std::string head = nif.getVersionString();
@@ -310,8 +351,6 @@ namespace Nif
             = ver >= NIFStream::generateVersion(10, 0, 0, 0) && ver < NIFStream::generateVersion(10, 2, 0, 0);
         for (std::size_t i = 0; i < recNum; i++)
         {
-            std::unique_ptr<Record> r;
-
             std::string rec = hasRecTypeListings ? recTypes[recTypeIndices[i]] : nif.getString();
             if (rec.empty())
             {
@@ -331,7 +370,7 @@ namespace Nif
             if (entry == factories.end())
                 throw Nif::Exception("Unknown record type " + rec, filename);
 
-            r = entry->second();
+            Record* const r = entry->second(arena);
 
             if (!supportedVersion && writeDebugLog)
                 Log(Debug::Verbose) << "NIF Debug: Reading record of type " << rec << ", index " << i << " ("
@@ -341,10 +380,22 @@ namespace Nif
             assert(r->recType != RC_MISSING);
             r->recName = rec;
             r->recIndex = i;
-            r->read(&nif);
-            records[i] = std::move(r);
+            // Links to the record itself and the previous ones are resolved while reading
+            records[i] = r;
+            if (mRecordTypeStats == nullptr)
+                r->read(&nif);
+            else
+            {
+                const auto start = std::chrono::steady_clock::now();
+                r->read(&nif);
+                RecordTypeStats& recordTypeStats = (*mRecordTypeStats)[rec];
+                ++recordTypeStats.mCount;
+                recordTypeStats.mTime += std::chrono::steady_clock::now() - start;
+            }
         }
 
+        nif.resolveLinks();
+
         const std::size_t rootNum = nif.getUInt();
         roots.resize(rootNum);
 
@@ -354,7 +405,7 @@ namespace Nif
             int idx = nif.getInt();
             if (idx >= 0 && static_cast<std::size_t>(idx) < records.size())
             {
-                roots[i] = records[idx].get();
+                roots[i] = records[idx];
             }
             else
             {
@@ -364,8 +415,8 @@ namespace Nif
             }
         }
 
-        // Once parsing is done, do post-processing.
-        for (const auto& record : records)
+        // Once every record is linked, do post-processing.
+        for (Record* record : records)
             record->post(*this);
     }
 
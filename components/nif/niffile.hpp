@@ -4,12 +4,17 @@
 #define OPENMW_COMPONENTS_NIF_NIFFILE_HPP
 
 #include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
 #include <vector>
 
 #include <components/files/istreamptr.hpp>
 
 #include "record.hpp"
+#include "recordarena.hpp"
 
 namespace Nif
 {
@@ -39,8 +44,11 @@ namespace Nif
         std::filesystem::path mPath;
         std::string mHash;
 
+        /// Storage of the records
+        RecordArena mArena;
+
         /// Record list
-        std::vector<std::unique_ptr<Record>> mRecords;
+        std::vector<Record*> mRecords;
 
         /// Root list.  This is a select portion of the pointers from records
         std::vector<Record*> mRoots;
@@ -87,6 +95,15 @@ namespace Nif
         const NIFFile* mFile;
     };
 
+    /// Number and total read time of the records of a type
+    struct RecordTypeStats
+    {
+        std::size_t mCount = 0;
+        std::chrono::steady_clock::duration mTime{};
+    };
+
+    using RecordTypeStatsMap = std::map<std::string, RecordTypeStats, std::less<>>;
+
     class Reader
     {
         /// File version, user version, Bethesda version
@@ -98,8 +115,11 @@ namespace Nif
         std::filesystem::path& filename;
         std::string& hash;
 
+        /// Storage of the records
+        RecordArena& arena;
+
         /// Record list
-        std::vector<std::unique_ptr<Record>>& records;
+        std::vector<Record*>& records;
 
         /// Root list.  This is a select portion of the pointers from records
         std::vector<Record*>& roots;
@@ -109,6 +129,11 @@ namespace Nif
 
         bool& mUseSkinning;
 
+        /// Size of the parsed file in bytes
+        std::size_t mSize = 0;
+
+        RecordTypeStatsMap* mRecordTypeStats = nullptr;
+
         static std::atomic_bool sLoadUnsupportedFiles;
         static std::atomic_bool sWriteNifDebugLog;
 
@@ -116,6 +141,9 @@ namespace Nif
         ///\returns A string containing a human readable NIF version number
         std::string printVersion(unsigned int version);
 
+        /// Read the rest of the stream into memory
+        std::string readContent(std::istream& stream);
+
     public:
         /// Open a NIF stream. The name is used for error messages.
         explicit Reader(NIFFile& file);
@@ -124,7 +152,10 @@ namespace Nif
         void parse(Files::IStreamPtr&& stream);
 
         /// Get a given record
-        Record* getRecord(size_t index) const { return records.at(index).get(); }
+        Record* getRecord(size_t index) const { return records.at(index); }
+
+        /// Get a given record if it is already created
+        Record* findRecord(size_t index) const { return index < records.size() ? records[index] : nullptr; }
 
         /// Get a given string from the file's string table
         std::string getString(uint32_t index) const;
@@ -136,6 +167,12 @@ namespace Nif
         /// Get the name of the file
         std::filesystem::path getFilename() const { return filename; }
 
+        /// Get the size of the parsed file in bytes
+        std::size_t getSize() const { return mSize; }
+
+        /// Measure the read time of each record type into the given map, if any
+        void setRecordTypeStats(RecordTypeStatsMap* value) { mRecordTypeStats = value; }
+
         /// Get the version of the NIF format used
         unsigned int getVersion() const { return ver; }
 
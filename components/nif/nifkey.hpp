@@ -3,7 +3,10 @@
 #ifndef OPENMW_COMPONENTS_NIF_NIFKEY_HPP
 #define OPENMW_COMPONENTS_NIF_NIFKEY_HPP
 
-#include <map>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
 
 #include "exception.hpp"
 #include "niffile.hpp"
@@ -44,13 +47,13 @@ namespace Nif
     template <typename T, T (NIFStream::*getValue)()>
     struct KeyMapT
     {
-        using MapType = std::map<float, KeyT<T>>;
-
         using ValueType = T;
         using KeyType = KeyT<T>;
 
         unsigned int mInterpolationType = InterpolationType_Unknown;
-        MapType mKeys;
+        // Sorted by time without duplicates, mTimes[i] is the time of mKeys[i]
+        std::vector<float> mTimes;
+        std::vector<KeyType> mKeys;
 
         // Read in a KeyGroup (see http://niftools.sourceforge.net/doc/nif/NiKeyframeData.html)
         void read(NIFStream* nif, bool morph = false)
@@ -77,30 +80,36 @@ namespace Nif
 
             if (mInterpolationType == InterpolationType_Linear || mInterpolationType == InterpolationType_Constant)
             {
+                reserve(count);
                 for (size_t i = 0; i < count; i++)
                 {
-                    float time = nif->getFloat();
+                    mTimes.push_back(nif->getFloat());
                     readValue(*nif, key);
-                    mKeys[time] = key;
+                    mKeys.push_back(key);
                 }
+                sortKeys();
             }
             else if (mInterpolationType == InterpolationType_Quadratic)
             {
+                reserve(count);
                 for (size_t i = 0; i < count; i++)
                 {
-                    float time = nif->getFloat();
+                    mTimes.push_back(nif->getFloat());
                     readQuadratic(*nif, key);
-                    mKeys[time] = key;
+                    mKeys.push_back(key);
                 }
+                sortKeys();
             }
             else if (mInterpolationType == InterpolationType_TBC)
             {
+                reserve(count);
                 for (size_t i = 0; i < count; i++)
                 {
-                    float time = nif->getFloat();
+                    mTimes.push_back(nif->getFloat());
                     readTBC(*nif, key);
-                    mKeys[time] = key;
+                    mKeys.push_back(key);
                 }
+                sortKeys();
             }
             else if (mInterpolationType == InterpolationType_XYZ)
             {
@@ -119,6 +128,43 @@ namespace Nif
         }
 
     private:
+        void reserve(size_t count)
+        {
+            mTimes.reserve(mTimes.size() + count);
+            mKeys.reserve(mKeys.size() + count);
+        }
+
+        // Keys are almost always stored in order. Otherwise sort them, and a later key replaces an earlier one with
+        // the same time.
+        void sortKeys()
+        {
+            if (std::adjacent_find(mTimes.begin(), mTimes.end(), std::greater_equal<float>()) == mTimes.end())
+                return;
+
+            std::vector<size_t> order(mTimes.size());
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::stable_sort(
+                order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return mTimes[lhs] < mTimes[rhs]; });
+
+            std::vector<float> times;
+            std::vector<KeyType> keys;
+            times.reserve(order.size());
+            keys.reserve(order.size());
+            for (size_t i : order)
+            {
+                if (!times.empty() && times.back() == mTimes[i])
+                    keys.back() = mKeys[i];
+                else
+                {
+                    times.push_back(mTimes[i]);
+                    keys.push_back(mKeys[i]);
+                }
+            }
+
+            mTimes = std::move(times);
+            mKeys = std::move(keys);
+        }
+
         static void readValue(NIFStream& nif, KeyT<T>& key) { key.mValue = (nif.*getValue)(); }
 
         template <typename U>
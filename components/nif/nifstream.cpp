@@ -1,5 +1,6 @@
 #include "nifstream.hpp"
 // For error reporting
+#include "exception.hpp"
 #include "niffile.hpp"
 
 namespace Nif
@@ -7,7 +8,7 @@ namespace Nif
     osg::Quat NIFStream::getQuaternion()
     {
         float f[4];
-        readLittleEndianBufferOfType<4, float>(inp, f);
+        readLittleEndianBufferOfType<4, float>(f);
         osg::Quat quat;
         quat.w() = f[0];
         quat.x() = f[1];
@@ -37,6 +38,26 @@ namespace Nif
         return getVersion() < generateVersion(20, 1, 0, 1) ? getSizedString() : file.getString(getUInt());
     }
 
+    void NIFStream::link(std::size_t index, void* slot, LinkResolver resolve)
+    {
+        if (Record* const record = file.findRecord(index))
+            resolve(slot, record);
+        else
+            mPendingLinks.push_back(PendingLink{ index, slot, resolve });
+    }
+
+    void NIFStream::resolveLinks()
+    {
+        for (const PendingLink& link : mPendingLinks)
+        {
+            Record* const record = file.findRecord(link.mIndex);
+            if (record == nullptr)
+                throw Nif::Exception("Link to a missing record " + std::to_string(link.mIndex), file.getFilename());
+            link.mResolve(link.mSlot, record);
+        }
+        mPendingLinks.clear();
+    }
+
     // Convenience utility functions: get the versions of the currently read file
     unsigned int NIFStream::getVersion() const
     {
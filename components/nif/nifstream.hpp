@@ -3,14 +3,16 @@
 #ifndef OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 #define OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 
+#include <algorithm>
 #include <cassert>
-#include <istream>
+#include <cstring>
 #include <stdexcept>
 #include <stdint.h>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
-#include <components/files/istreamptr.hpp>
 #include <components/misc/endianness.hpp>
 
 #include <osg/Quat>
@@ -23,95 +25,120 @@ namespace Nif
 {
 
     class Reader;
+    struct Record;
 
-    template <std::size_t numInstances, typename T>
-    inline void readLittleEndianBufferOfType(Files::IStreamPtr& pIStream, T* dest)
-    {
-        static_assert(std::is_arithmetic_v<T>, "Buffer element type is not arithmetic");
-        pIStream->read((char*)dest, numInstances * sizeof(T));
-        if (pIStream->bad())
-            throw std::runtime_error("Failed to read little endian typed (" + std::string(typeid(T).name())
-                + ") buffer of " + std::to_string(numInstances) + " instances");
-        if constexpr (Misc::IS_BIG_ENDIAN)
-            for (std::size_t i = 0; i < numInstances; i++)
-                Misc::swapEndiannessInplace(dest[i]);
-    }
-
-    template <typename T>
-    inline void readLittleEndianDynamicBufferOfType(Files::IStreamPtr& pIStream, T* dest, std::size_t numInstances)
-    {
-        static_assert(std::is_arithmetic_v<T>, "Buffer element type is not arithmetic");
-        pIStream->read((char*)dest, numInstances * sizeof(T));
-        if (pIStream->bad())
-            throw std::runtime_error(
-                "Failed to read little endian dynamic buffer of " + std::to_string(numInstances) + " instances");
-        if constexpr (Misc::IS_BIG_ENDIAN)
-            for (std::size_t i = 0; i < numInstances; i++)
-                Misc::swapEndiannessInplace(dest[i]);
-    }
-    template <typename type>
-    type inline readLittleEndianType(Files::IStreamPtr& pIStream)
-    {
-        type val;
-        readLittleEndianBufferOfType<1, type>(pIStream, &val);
-        return val;
-    }
+    /// Stores a resolved record into a link slot
+    using LinkResolver = void (*)(void* slot, Record* record);
 
     class NIFStream
     {
         const Reader& file;
 
-        /// Input stream
-        Files::IStreamPtr inp;
+        /// Unread part of the file contents
+        const char* mCurrent;
+        const char* mEnd;
+
+        struct PendingLink
+        {
+            std::size_t mIndex;
+            void* mSlot;
+            LinkResolver mResolve;
+        };
+
+        /// Links to the records that were not created yet
+        std::vector<PendingLink> mPendingLinks;
+
+        void checkAvailable(std::size_t size, const char* what) const
+        {
+            if (size > static_cast<std::size_t>(mEnd - mCurrent))
+                throw std::runtime_error(std::string("Failed to read ") + what + ": " + std::to_string(size)
+                    + " bytes requested, " + std::to_string(mEnd - mCurrent) + " bytes left");
+        }
+
+        template <typename T>
+        void readLittleEndianDynamicBufferOfType(T* dest, std::size_t numInstances)
+        {
+            static_assert(std::is_arithmetic_v<T>, "Buffer element type is not arithmetic");
+            const std::size_t size = numInstances * sizeof(T);
+            checkAvailable(size, "little endian buffer");
+            std::memcpy(dest, mCurrent, size);
+            mCurrent += size;
+            if constexpr (Misc::IS_BIG_ENDIAN)
+                for (std::size_t i = 0; i < numInstances; i++)
+                    Misc::swapEndiannessInplace(dest[i]);
+        }
+
+        template <std::size_t numInstances, typename T>
+        void readLittleEndianBufferOfType(T* dest)
+        {
+            readLittleEndianDynamicBufferOfType(dest, numInstances);
+        }
+
+        template <typename T>
+        T readLittleEndianType()
+        {
+            T val;
+            readLittleEndianBufferOfType<1, T>(&val);
+            return val;
+        }
 
     public:
-        explicit NIFStream(const Reader& file, Files::IStreamPtr&& inp)
+        /// The data is not copied and has to outlive the stream
+        explicit NIFStream(const Reader& file, std::string_view data)
             : file(file)
-            , inp(std::move(inp))
+            , mCurrent(data.data())
+            , mEnd(data.data() + data.size())
         {
         }
 
         const Reader& getFile() const { return file; }
 
-        void skip(size_t size) { inp->ignore(size); }
+        void skip(size_t size)
+        {
+            checkAvailable(size, "skipped data");
+            mCurrent += size;
+        }
+
+        /// Number of bytes that were not read yet
+        std::size_t getRemaining() const { return static_cast<std::size_t>(mEnd - mCurrent); }
 
-        char getChar() { return readLittleEndianType<char>(inp); }
+        char getChar() { return readLittleEndianType<char>(); }
 
-        short getShort() { return readLittleEndianType<short>(inp); }
+        short getShort() { return readLittleEndianType<short>(); }
 
-        unsigned short getUShort() { return readLittleEndianType<unsigned short>(inp); }
+        unsigned short getUShort() { return readLittleEndianType<unsigned short>(); }
 
-        int getInt() { return readLittleEndianType<int>(inp); }
+        int getInt() { return readLittleEndianType<int>(); }
 
-        unsigned int getUInt() { return readLittleEndianType<unsigned int>(inp); }
+        unsigned int getUInt() { return readLittleEndianType<unsigned int>(); }
 
-        float getFloat() { return readLittleEndianType<float>(inp); }
+        float getFloat() { return readLittleEndianType<float>(); }
 
         osg::Vec2f getVector2()
         {
             osg::Vec2f vec;
-            readLittleEndianBufferOfType<2, float>(inp, vec._v);
+            readLittleEndianBufferOfType<2, float>(vec._v);
             return vec;
         }
 
         osg::Vec3f getVector3()
         {
             osg::Vec3f vec;
-            readLittleEndianBufferOfType<3, float>(inp, vec._v);
+            readLittleEndianBufferOfType<3, float>(vec._v);
             return vec;
         }
 
         osg::Vec4f getVector4()
         {
             osg::Vec4f vec;
-            readLittleEndianBufferOfType<4, float>(inp, vec._v);
+            readLittleEndianBufferOfType<4, float>(vec._v);
             return vec;
         }
 
         Matrix3 getMatrix3()
         {
             Matrix3 mat;
-            readLittleEndianBufferOfType<9, float>(inp, (float*)&mat.mValues);
+            readLittleEndianBufferOfType<9, float>((float*)&mat.mValues);
             return mat;
         }
 
@@ -123,6 +150,13 @@ namespace Nif
 
         std::string getString();
 
+        /// Fill the slot with the record of the given index. Links to the records that were already created are
+        /// resolved immediately, the others are kept until resolveLinks is called.
+        void link(std::size_t index, void* slot, LinkResolver resolve);
+
+        /// Resolve the kept links once every record is created
+        void resolveLinks();
+
         unsigned int getVersion() const;
         unsigned int getUserVersion() const;
         unsigned int getBethVersion() const;
@@ -136,105 +170,99 @@ namespace Nif
         /// Read in a string of the given length
         std::string getSizedString(size_t length)
         {
-            std::string str(length, '\0');
-            inp->read(str.data(), length);
-            if (inp->bad())
-                throw std::runtime_error("Failed to read sized string of " + std::to_string(length) + " chars");
-            size_t end = str.find('\0');
-            if (end != std::string::npos)
-                str.erase(end);
-            return str;
+            checkAvailable(length, "sized string");
+            const std::string_view str(mCurrent, length);
+            mCurrent += length;
+            return std::string(str.substr(0, str.find('\0')));
         }
         /// Read in a string of the length specified in the file
         std::string getSizedString()
         {
-            size_t size = readLittleEndianType<uint32_t>(inp);
+            size_t size = readLittleEndianType<uint32_t>();
             return getSizedString(size);
         }
 
         /// Specific to Bethesda headers, uses a byte for length
         std::string getExportString()
         {
-            size_t size = static_cast<size_t>(readLittleEndianType<uint8_t>(inp));
+            size_t size = static_cast<size_t>(readLittleEndianType<uint8_t>());
             return getSizedString(size);
         }
 
         /// This is special since the version string doesn't start with a number, and ends with "\n"
         std::string getVersionString()
         {
-            std::string result;
-            std::getline(*inp, result);
-            if (inp->bad())
-                throw std::runtime_error("Failed to read version string");
+            const char* const end = std::find(mCurrent, mEnd, '\n');
+            std::string result(mCurrent, end);
+            mCurrent = end == mEnd ? end : end + 1;
             return result;
         }
 
         /// Read a sequence of null-terminated strings
         std::string getStringPalette()
         {
-            size_t size = readLittleEndianType<uint32_t>(inp);
-            std::string str(size, '\0');
-            inp->read(str.data(), size);
-            if (inp->bad())
-                throw std::runtime_error("Failed to read string palette of " + std::to_string(size) + " chars");
+            size_t size = readLittleEndianType<uint32_t>();
+            checkAvailable(size, "string palette");
+            std::string str(mCurrent, size);
+            mCurrent += size;
             return str;
         }
 
         void getChars(std::vector<char>& vec, size_t size)
         {
             vec.resize(size);
-            readLittleEndianDynamicBufferOfType<char>(inp, vec.data(), size);
+            readLittleEndianDynamicBufferOfType<char>(vec.data(), size);
         }
 
         void getUChars(std::vector<unsigned char>& vec, size_t size)
         {
             vec.resize(size);
-            readLittleEndianDynamicBufferOfType<unsigned char>(inp, vec.data(), size);
+            readLittleEndianDynamicBufferOfType<unsigned char>(vec.data(), size);
         }
 
         void getUShorts(std::vector<unsigned short>& vec, size_t size)
         {
             vec.resize(size);
-            readLittleEndianDynamicBufferOfType<unsigned short>(inp, vec.data(), size);
+            readLittleEndianDynamicBufferOfType<unsigned short>(vec.data(), size);
         }
 
         void getFloats(std::vector<float>& vec, size_t size)
         {
             vec.resize(size);
-            readLittleEndianDynamicBufferOfType<float>(inp, vec.data(), size);
+            readLittleEndianDynamicBufferOfType<float>(vec.data(), size);
         }
 
         void getInts(std::vector<int>& vec, size_t size)
         {
             vec.resize(size);
-            readLittleEndianDynamicBufferOfType<int>(inp, vec.data(), size);
+            readLittleEndianDynamicBufferOfType<int>(vec.data(), size);
         }
 
         void getUInts(std::vector<unsigned int>& vec, size_t size)
         {
             vec.resize(size);
-            readLittleEndianDynamicBufferOfType<unsigned int>(inp, vec.data(), size);
+            readLittleEndianDynamicBufferOfType<unsigned int>(vec.data(), size);
         }
 
         void getVector2s(std::vector<osg::Vec2f>& vec, size_t size)
         {
             vec.resize(size);
             /* The packed storage of each Vec2f is 2 floats exactly */
-            readLittleEndianDynamicBufferOfType<float>(inp, (float*)vec.data(), size * 2);
+            readLittleEndianDynamicBufferOfType<float>((float*)vec.data(), size * 2);
         }
 
         void getVector3s(std::vector<osg::Vec3f>& vec, size_t size)
         {
             vec.resize(size);
             /* The packed storage of each Vec3f is 3 floats exactly */
-            readLittleEndianDynamicBufferOfType<float>(inp, (float*)vec.data(), size * 3);
+            readLittleEndianDynamicBufferOfType<float>((float*)vec.data(), size * 3);
         }
 
         void getVector4s(std::vector<osg::Vec4f>& vec, size_t size)
         {
             vec.resize(size);
             /* The packed storage of each Vec4f is 4 floats exactly */
-            readLittleEndianDynamicBufferOfType<float>(inp, (float*)vec.data(), size * 4);
+            readLittleEndianDynamicBufferOfType<float>((float*)vec.data(), size * 4);
         }
 
         void getQuaternions(std::vector<osg::Quat>& quat, size_t size)
@@ -99,13 +99,6 @@ namespace Nif
         isBone = false;
     }
 
-    void Node::post(Reader& nif)
-    {
-        Named::post(nif);
-        postRecordList(nif, props);
-        collision.post(nif);
-    }
-
     void Node::setBone()
     {
         isBone = true;
@@ -136,10 +129,6 @@ namespace Nif
 
     void NiNode::post(Reader& nif)
     {
-        Node::post(nif);
-        postRecordList(nif, children);
-        postRecordList(nif, effects);
-
         for (auto& child : children)
         {
             // Why would a unique list of children contain empty refs?
@@ -184,11 +173,6 @@ namespace Nif
 
     void NiGeometry::post(Reader& nif)
     {
-        Node::post(nif);
-        data.post(nif);
-        skin.post(nif);
-        shaderprop.post(nif);
-        alphaprop.post(nif);
         if (recType != RC_NiParticles && !skin.empty())
             nif.setUseSkinning(true);
     }
@@ -277,12 +261,6 @@ namespace Nif
             mSubSorter.read(nif);
     }
 
-    void NiSortAdjustNode::post(Reader& nif)
-    {
-        NiNode::post(nif);
-        mSubSorter.post(nif);
-    }
-
     void NiBillboardNode::read(NIFStream* nif)
     {
         NiNode::read(nif);
@@ -299,11 +277,4 @@ namespace Nif
         for (size_t i = 0; i < numObjects; i++)
             mObjects[nif->getSizedString()].read(nif);
     }
-
-    void NiDefaultAVObjectPalette::post(Reader& nif)
-    {
-        mScene.post(nif);
-        for (auto& object : mObjects)
-            object.second.post(nif);
-    }
 }
@@ -96,7 +96,6 @@ namespace Nif
         NiCollisionObjectPtr collision;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
 
         // Parent node, or nullptr for the root node. As far as I'm aware, only
         // NiNodes (or types derived from NiNodes) can be parents.
@@ -265,7 +264,6 @@ namespace Nif
         NiAccumulatorPtr mSubSorter;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiBillboardNode : NiNode
@@ -281,7 +279,6 @@ namespace Nif
         std::unordered_map<std::string, NodePtr> mObjects;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
 } // Namespace
@@ -205,11 +205,6 @@ namespace Nif
         mWorldObjectInfo.read(nif);
     }
 
-    void bhkWorldObject::post(Reader& nif)
-    {
-        mShape.post(nif);
-    }
-
     void bhkEntity::read(NIFStream* nif)
     {
         bhkWorldObject::read(nif);
@@ -221,11 +216,6 @@ namespace Nif
         mShape.read(nif);
     }
 
-    void bhkBvTreeShape::post(Reader& nif)
-    {
-        mShape.post(nif);
-    }
-
     void bhkMoppBvTreeShape::read(NIFStream* nif)
     {
         bhkBvTreeShape::read(nif);
@@ -247,11 +237,6 @@ namespace Nif
         nif->getUInts(mFilters, numFilters);
     }
 
-    void bhkNiTriStripsShape::post(Reader& nif)
-    {
-        postRecordList(nif, mData);
-    }
-
     void bhkPackedNiTriStripsShape::read(NIFStream* nif)
     {
         if (nif->getVersion() <= NIFFile::NIFVersion::VER_OB)
@@ -269,11 +254,6 @@ namespace Nif
         mData.read(nif);
     }
 
-    void bhkPackedNiTriStripsShape::post(Reader& nif)
-    {
-        mData.post(nif);
-    }
-
     void hkPackedNiTriStripsData::read(NIFStream* nif)
     {
         unsigned int numTriangles = nif->getUInt();
@@ -332,11 +312,6 @@ namespace Nif
         mTransform.set(mat.data());
     }
 
-    void bhkConvexTransformShape::post(Reader& nif)
-    {
-        mShape.post(nif);
-    }
-
     void bhkBoxShape::read(NIFStream* nif)
     {
         bhkConvexShape::read(nif);
@@ -379,12 +354,6 @@ namespace Nif
         mData.read(nif);
     }
 
-    void bhkCompressedMeshShape::post(Reader& nif)
-    {
-        mTarget.post(nif);
-        mData.post(nif);
-    }
-
     void bhkCompressedMeshShapeData::read(NIFStream* nif)
     {
         mBitsPerIndex = nif->getUInt();
@@ -239,7 +239,6 @@ namespace Nif
         NodePtr mTarget;
 
         void read(NIFStream* nif) override { mTarget.read(nif); }
-        void post(Reader& nif) override { mTarget.post(nif); }
     };
 
     // Bethesda Havok-specific collision object
@@ -249,11 +248,6 @@ namespace Nif
         bhkWorldObjectPtr mBody;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override
-        {
-            NiCollisionObject::post(nif);
-            mBody.post(nif);
-        }
     };
 
     // Abstract Havok shape info record
@@ -263,7 +257,6 @@ namespace Nif
         HavokFilter mHavokFilter;
         bhkWorldObjectCInfo mWorldObjectInfo;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // Abstract
@@ -279,7 +272,6 @@ namespace Nif
     {
         bhkShapePtr mShape;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // bhkBvTreeShape with Havok MOPP code
@@ -300,7 +292,6 @@ namespace Nif
         NiTriStripsDataList mData;
         std::vector<unsigned int> mFilters;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // Bethesda packed triangle strip-based Havok shape collection
@@ -313,7 +304,6 @@ namespace Nif
         hkPackedNiTriStripsDataPtr mData;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // bhkPackedNiTriStripsShape data block
@@ -356,7 +346,6 @@ namespace Nif
         float mRadius;
         osg::Matrixf mTransform;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     // A box
@@ -397,7 +386,6 @@ namespace Nif
         osg::Vec4f mScale;
         bhkCompressedMeshShapeDataPtr mData;
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct bhkCompressedMeshShapeData : public bhkRefObject
@@ -47,11 +47,6 @@ namespace Nif
         }
     }
 
-    void NiTexturingProperty::Texture::post(Reader& nif)
-    {
-        texture.post(nif);
-    }
-
     void NiTexturingProperty::read(NIFStream* nif)
     {
         Property::read(nif);
@@ -92,15 +87,6 @@ namespace Nif
         }
     }
 
-    void NiTexturingProperty::post(Reader& nif)
-    {
-        Property::post(nif);
-        for (size_t i = 0; i < textures.size(); i++)
-            textures[i].post(nif);
-        for (size_t i = 0; i < shaderTextures.size(); i++)
-            shaderTextures[i].post(nif);
-    }
-
     void BSShaderProperty::read(NIFStream* nif)
     {
         NiShadeProperty::read(nif);
@@ -134,12 +120,6 @@ namespace Nif
         parallax.scale = nif->getFloat();
     }
 
-    void BSShaderPPLightingProperty::post(Reader& nif)
-    {
-        BSShaderLightingProperty::post(nif);
-        textureSet.post(nif);
-    }
-
     void BSShaderNoLightingProperty::read(NIFStream* nif)
     {
         BSShaderLightingProperty::read(nif);
@@ -198,12 +178,6 @@ namespace Nif
         }
     }
 
-    void BSLightingShaderProperty::post(Reader& nif)
-    {
-        BSShaderProperty::post(nif);
-        mTextureSet.post(nif);
-    }
-
     void BSEffectShaderProperty::read(NIFStream* nif)
     {
         BSShaderProperty::read(nif);
@@ -53,7 +53,6 @@ namespace Nif
             unsigned int clamp, uvSet;
 
             void read(NIFStream* nif);
-            void post(Reader& nif);
 
             bool wrapT() const { return clamp & 1; }
             bool wrapS() const { return (clamp >> 1) & 1; }
@@ -97,7 +96,6 @@ namespace Nif
         osg::Vec4f bumpMapMatrix;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct NiFogProperty : public Property
@@ -166,7 +164,6 @@ namespace Nif
         ParallaxSettings parallax;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct BSShaderNoLightingProperty : public BSShaderLightingProperty
@@ -212,7 +209,6 @@ namespace Nif
         float mEmissiveMult, mSpecStrength;
 
         void read(NIFStream* nif) override;
-        void post(Reader& nif) override;
     };
 
     struct BSEffectShaderProperty : public BSShaderProperty
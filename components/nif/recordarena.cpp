@@ -0,0 +1,38 @@
+#include "recordarena.hpp"
+
+#include "record.hpp"
+
+#include <algorithm>
+#include <memory>
+
+namespace Nif
+{
+    namespace
+    {
+        constexpr std::size_t minBlockSize = 4 * 1024;
+        constexpr std::size_t maxBlockSize = 256 * 1024;
+    }
+
+    RecordArena::~RecordArena()
+    {
+        for (auto it = mRecords.rbegin(); it != mRecords.rend(); ++it)
+            (*it)->~Record();
+    }
+
+    void* RecordArena::allocate(std::size_t size, std::size_t alignment)
+    {
+        void* memory = mCurrent;
+        if (mCurrent == nullptr || std::align(alignment, size, memory, mAvailable) == nullptr)
+        {
+            // Small files fit into a single small block, bigger ones double the block size up to the limit
+            const std::size_t blockSize = std::max(size, std::clamp(mCapacity, minBlockSize, maxBlockSize));
+            mBlocks.emplace_back(new std::byte[blockSize]);
+            mCapacity += blockSize;
+            memory = mBlocks.back().get();
+            mAvailable = blockSize;
+        }
+        mCurrent = static_cast<std::byte*>(memory) + size;
+        mAvailable -= size;
+        return memory;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef OPENMW_COMPONENTS_NIF_RECORDARENA_HPP
+#define OPENMW_COMPONENTS_NIF_RECORDARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Nif
+{
+    struct Record;
+
+    /// Monotonic storage for the records of a single file. Records are placed one after another into growing blocks
+    /// and are only destroyed together with the arena, in the reverse order of creation.
+    class RecordArena
+    {
+    public:
+        RecordArena() = default;
+
+        RecordArena(const RecordArena&) = delete;
+
+        RecordArena& operator=(const RecordArena&) = delete;
+
+        ~RecordArena();
+
+        template <class T, class... Args>
+        T* create(Args&&... args)
+        {
+            static_assert(std::is_base_of_v<Record, T>);
+            static_assert(alignof(T) <= alignof(std::max_align_t));
+            void* const memory = allocate(sizeof(T), alignof(T));
+            mRecords.reserve(mRecords.size() + 1);
+            T* const result = new (memory) T(std::forward<Args>(args)...);
+            mRecords.push_back(result);
+            return result;
+        }
+
+        /// Total size of the allocated blocks in bytes
+        std::size_t getCapacity() const { return mCapacity; }
+
+    private:
+        std::vector<std::unique_ptr<std::byte[]>> mBlocks;
+        std::vector<Record*> mRecords;
+        std::byte* mCurrent = nullptr;
+        std::size_t mAvailable = 0;
+        std::size_t mCapacity = 0;
+
+        void* allocate(std::size_t size, std::size_t alignment);
+    };
+}
+
+#endif
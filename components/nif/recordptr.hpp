@@ -9,52 +9,40 @@ namespace Nif
 {
 
     /** A reference to another record. It is read as an index from the
-        NIF, and later looked up in the index table to get an actual
-        pointer.
+        NIF and linked by the stream to the record with that index, either
+        right away or once the record is created.
     */
     template <class X>
     class RecordPtrT
     {
-        union
-        {
-            intptr_t index;
-            X* ptr;
-        };
+        X* ptr = nullptr;
 
-    public:
-        RecordPtrT()
-            : index(-2)
+        static void resolve(void* slot, Record* record)
         {
+            X* const value = dynamic_cast<X*>(record);
+            assert(value != nullptr);
+            *static_cast<X**>(slot) = value;
         }
 
+    public:
+        RecordPtrT() = default;
+
         RecordPtrT(X* ptr)
             : ptr(ptr)
         {
         }
 
-        /// Read the index from the nif
+        /// Read the index from the nif and link it. The pointer must stay at the same address until the stream
+        /// resolves its links.
         void read(NIFStream* nif)
         {
             // Can only read the index once
-            assert(index == -2);
+            assert(ptr == nullptr);
 
-            // Store the index for later
-            index = nif->getInt();
+            const int index = nif->getInt();
             assert(index >= -1);
-        }
-
-        /// Resolve index to pointer
-        void post(Reader& nif)
-        {
-            if (index < 0)
-                ptr = nullptr;
-            else
-            {
-                Record* r = nif.getRecord(index);
-                // And cast it
-                ptr = dynamic_cast<X*>(r);
-                assert(ptr != nullptr);
-            }
+            if (index >= 0)
+                nif->link(static_cast<std::size_t>(index), &ptr, &resolve);
         }
 
         /// Look up the actual object from the index
@@ -81,7 +69,7 @@ namespace Nif
     };
 
     /** A list of references to other records. These are read as a list,
-        and later converted to pointers as needed. Not an optimized
+        and linked as the single references are. Not an optimized
         implementation.
      */
     template <class X>
@@ -101,13 +89,6 @@ namespace Nif
             value.read(nif);
     }
 
-    template <class T>
-    void postRecordList(Reader& nif, RecordListT<T>& list)
-    {
-        for (auto& value : list)
-            value.post(nif);
-    }
-
     struct Node;
     struct Extra;
     struct Property;
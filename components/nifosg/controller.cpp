@@ -9,6 +9,7 @@
 
 #include <components/nif/data.hpp>
 #include <components/sceneutil/morphgeometry.hpp>
+#include <components/sceneutil/skeleton.hpp>
 
 #include "matrixtransform.hpp"
 
@@ -79,6 +80,9 @@ namespace NifOsg
         , mTranslations(copy.mTranslations)
         , mScales(copy.mScales)
         , mAxisOrder(copy.mAxisOrder)
+        , mPackedAnimation(copy.mPackedAnimation)
+        , mPackedTrack(copy.mPackedTrack)
+        , mPackedCursor(copy.mPackedCursor)
     {
     }
 
@@ -121,6 +125,41 @@ namespace NifOsg
         }
     }
 
+    KeyframeController::KeyframeController(
+        const Nif::NiKeyframeController* keyctrl, const std::shared_ptr<PackedAnimation>& packedAnimation)
+        : KeyframeController(keyctrl)
+    {
+        const Nif::NiKeyframeData* keydata = nullptr;
+        if (!keyctrl->mInterpolator.empty())
+        {
+            if (keyctrl->mInterpolator->recType == Nif::RC_NiTransformInterpolator)
+                keydata = static_cast<const Nif::NiTransformInterpolator*>(keyctrl->mInterpolator.getPtr())
+                              ->data.getPtr();
+        }
+        else
+            keydata = keyctrl->mData.getPtr();
+
+        if (keydata == nullptr)
+            return;
+
+        if (keydata->mRotations)
+            mPackedTrack.mRotation = packedAnimation->addRotations(*keydata->mRotations);
+        if (keydata->mTranslations)
+            mPackedTrack.mTranslation = packedAnimation->addTranslations(*keydata->mTranslations);
+        if (keydata->mScales)
+            mPackedTrack.mScale = packedAnimation->addScales(*keydata->mScales);
+
+        // The packed channels replace the interpolators, keys that can't be packed are sampled as usual
+        if (mPackedTrack.mRotation != PackedAnimation::sNoChannel)
+            mRotations = QuaternionInterpolator();
+        if (mPackedTrack.mTranslation != PackedAnimation::sNoChannel)
+            mTranslations = Vec3Interpolator();
+        if (mPackedTrack.mScale != PackedAnimation::sNoChannel)
+            mScales = FloatInterpolator();
+
+        mPackedAnimation = packedAnimation;
+    }
+
     osg::Quat KeyframeController::getXYZRotation(float time) const
     {
         float xrot = 0, yrot = 0, zrot = 0;
@@ -159,6 +198,8 @@ namespace NifOsg
 
     osg::Vec3f KeyframeController::getTranslation(float time) const
     {
+        if (mPackedTrack.mTranslation != PackedAnimation::sNoChannel)
+            return mPackedAnimation->sampleTranslation(mPackedTrack.mTranslation, time, mPackedCursor.mTranslation);
         if (!mTranslations.empty())
             return mTranslations.interpKey(time);
         return osg::Vec3f();
@@ -166,21 +207,29 @@ namespace NifOsg
 
     void KeyframeController::operator()(NifOsg::MatrixTransform* node, osg::NodeVisitor* nv)
     {
-        if (hasInput())
+        if (hasInput() && !SceneUtil::Skeleton::isBoneUpdateSkipped())
         {
             float time = getInputValue(nv);
 
-            if (!mRotations.empty())
+            if (mPackedTrack.mRotation != PackedAnimation::sNoChannel)
+                node->setRotation(
+                    mPackedAnimation->sampleRotation(mPackedTrack.mRotation, time, mPackedCursor.mRotation));
+            else if (!mRotations.empty())
                 node->setRotation(mRotations.interpKey(time));
             else if (!mXRotations.empty() || !mYRotations.empty() || !mZRotations.empty())
                 node->setRotation(getXYZRotation(time));
             else
                 node->setRotation(node->mRotationScale);
 
-            if (!mScales.empty())
+            if (mPackedTrack.mScale != PackedAnimation::sNoChannel)
+                node->setScale(mPackedAnimation->sampleScale(mPackedTrack.mScale, time, mPackedCursor.mScale));
+            else if (!mScales.empty())
                 node->setScale(mScales.interpKey(time));
 
-            if (!mTranslations.empty())
+            if (mPackedTrack.mTranslation != PackedAnimation::sNoChannel)
+                node->setTranslation(
+                    mPackedAnimation->sampleTranslation(mPackedTrack.mTranslation, time, mPackedCursor.mTranslation));
+            else if (!mTranslations.empty())
                 node->setTranslation(mTranslations.interpKey(time));
         }
 
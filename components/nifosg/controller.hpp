@@ -9,8 +9,14 @@
 #include <components/sceneutil/nodecallback.hpp>
 #include <components/sceneutil/statesetupdater.hpp>
 
+#include "keysearch.hpp"
+#include "packedanimation.hpp"
+
+#include <algorithm>
+#include <memory>
 #include <set>
 #include <type_traits>
+#include <vector>
 
 #include <osg/Texture2D>
 
@@ -39,25 +45,6 @@ namespace NifOsg
     template <typename MapT>
     class ValueInterpolator
     {
-        typename MapT::MapType::const_iterator retrieveKey(float time) const
-        {
-            // retrieve the current position in the map, optimized for the most common case
-            // where time moves linearly along the keyframe track
-            if (mLastHighKey != mKeys->mKeys.end())
-            {
-                if (time > mLastHighKey->first)
-                {
-                    // try if we're there by incrementing one
-                    ++mLastLowKey;
-                    ++mLastHighKey;
-                }
-                if (mLastHighKey != mKeys->mKeys.end() && time >= mLastLowKey->first && time <= mLastHighKey->first)
-                    return mLastHighKey;
-            }
-
-            return mKeys->mKeys.lower_bound(time);
-        }
-
     public:
         using ValueT = typename MapT::ValueType;
 
@@ -76,22 +63,12 @@ namespace NifOsg
             if (interpolator->data.empty())
                 return;
             mKeys = interpolator->data->mKeyList;
-            if (mKeys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
         }
 
         ValueInterpolator(std::shared_ptr<const MapT> keys, ValueT defaultVal = ValueT())
             : mKeys(keys)
             , mDefaultVal(defaultVal)
         {
-            if (keys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
         }
 
         ValueT interpKey(float time) const
@@ -99,26 +76,22 @@ namespace NifOsg
             if (empty())
                 return mDefaultVal;
 
-            const typename MapT::MapType& keys = mKeys->mKeys;
+            const std::vector<float>& times = mKeys->mTimes;
+            const auto& keys = mKeys->mKeys;
 
-            if (time <= keys.begin()->first)
-                return keys.begin()->second.mValue;
+            if (time <= times.front())
+                return keys.front().mValue;
 
-            typename MapT::MapType::const_iterator it = retrieveKey(time);
+            if (time > times.back())
+                return keys.back().mValue;
 
-            // now do the actual interpolation
-            if (it != keys.end())
-            {
-                // cache for next time
-                mLastHighKey = it;
-                mLastLowKey = --it;
-
-                float a = (time - mLastLowKey->first) / (mLastHighKey->first - mLastLowKey->first);
+            // cache for next time
+            mLastHighKey = findKey(times, time, mLastHighKey);
+            const std::size_t low = mLastHighKey - 1;
 
-                return interpolate(mLastLowKey->second, mLastHighKey->second, a, mKeys->mInterpolationType);
-            }
+            float a = (time - times[low]) / (times[mLastHighKey] - times[low]);
 
-            return keys.rbegin()->second.mValue;
+            return interpolate(keys[low], keys[mLastHighKey], a, mKeys->mInterpolationType);
         }
 
         bool empty() const { return !mKeys || mKeys->mKeys.empty(); }
@@ -171,8 +144,8 @@ namespace NifOsg
             }
         }
 
-        mutable typename MapT::MapType::const_iterator mLastLowKey;
-        mutable typename MapT::MapType::const_iterator mLastHighKey;
+        // Index of the key after the time of the previous interpolation, 0 if there is none
+        mutable std::size_t mLastHighKey = 0;
 
         std::shared_ptr<const MapT> mKeys;
 
@@ -234,6 +207,9 @@ namespace NifOsg
         KeyframeController();
         KeyframeController(const KeyframeController& copy, const osg::CopyOp& copyop);
         KeyframeController(const Nif::NiKeyframeController* keyctrl);
+        /// Add the keys of supported channels to the packed animation and sample them from there
+        KeyframeController(
+            const Nif::NiKeyframeController* keyctrl, const std::shared_ptr<PackedAnimation>& packedAnimation);
 
         META_Object(NifOsg, KeyframeController)
 
@@ -254,6 +230,10 @@ namespace NifOsg
 
         Nif::NiKeyframeData::AxisOrder mAxisOrder{ Nif::NiKeyframeData::AxisOrder::Order_XYZ };
 
+        std::shared_ptr<const PackedAnimation> mPackedAnimation;
+        PackedAnimation::Track mPackedTrack;
+        mutable PackedAnimation::Cursor mPackedCursor;
+
         osg::Quat getXYZRotation(float time) const;
     };
 #ifdef _MSC_VER
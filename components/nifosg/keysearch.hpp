@@ -0,0 +1,43 @@
+#ifndef OPENMW_COMPONENTS_NIFOSG_KEYSEARCH_H
+#define OPENMW_COMPONENTS_NIFOSG_KEYSEARCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+namespace NifOsg
+{
+    // Number of keys to step over from the previous position before falling back to a binary search
+    constexpr std::size_t maxKeyCursorSteps = 4;
+
+    // Branchless lower bound, it doesn't stall on mispredicted branches when seeking to a random time
+    inline std::size_t lowerBoundKey(std::span<const float> times, float time)
+    {
+        const float* first = times.data();
+        std::size_t size = times.size();
+        while (size > 1)
+        {
+            const std::size_t half = size / 2;
+            first = first[half] < time ? first + half : first;
+            size -= half;
+        }
+        return static_cast<std::size_t>(first - times.data()) + (*first < time ? 1 : 0);
+    }
+
+    // Index of the first key at or after the given time, which has to be within the keyframe track. The cursor is
+    // the result of the previous search on the same track, 0 if there is none.
+    inline std::size_t findKey(std::span<const float> times, float time, std::size_t cursor)
+    {
+        // optimized for the most common case where time moves linearly along the keyframe track
+        if (cursor > 0 && cursor < times.size() && time > times[cursor - 1])
+        {
+            for (const std::size_t end = std::min(cursor + maxKeyCursorSteps, times.size()); cursor < end; ++cursor)
+                if (time <= times[cursor])
+                    return cursor;
+        }
+
+        return lowerBoundKey(times, time);
+    }
+}
+
+#endif
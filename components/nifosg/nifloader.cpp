@@ -1,6 +1,5 @@
 #include "nifloader.hpp"
 
-#include <mutex>
 #include <string_view>
 
 #include <osg/Array>
@@ -50,6 +49,7 @@
 #include <components/sceneutil/morphgeometry.hpp>
 #include <components/sceneutil/riggeometry.hpp>
 #include <components/sceneutil/skeleton.hpp>
+#include <components/sceneutil/stateregistry.hpp>
 
 #include "matrixtransform.hpp"
 #include "particle.hpp"
@@ -250,6 +250,20 @@ namespace NifOsg
         // This is used to queue emitters that weren't attached to their node yet.
         std::vector<std::pair<size_t, osg::ref_ptr<Emitter>>> mEmitterQueue;
 
+        // Shares equal state attributes, within the file unless a registry used for other files is given
+        SceneUtil::StateRegistry mFileStateRegistry;
+        SceneUtil::StateRegistry* mStateRegistry = &mFileStateRegistry;
+
+        Loader::TexturePaths* mTexturePaths = nullptr;
+
+        std::string correctTexturePath(const std::string& name, const VFS::Manager* vfs) const
+        {
+            std::string path = Misc::ResourceHelpers::correctTexturePath(name, vfs);
+            if (mTexturePaths != nullptr)
+                mTexturePaths->emplace_back(name, path);
+            return path;
+        }
+
         void loadKf(Nif::FileView nif, SceneUtil::KeyframeHolder& target) const
         {
             const Nif::NiSequenceStreamHelper* seq = nullptr;
@@ -282,6 +296,9 @@ namespace NifOsg
 
             extractTextKeys(static_cast<const Nif::NiTextKeyExtraData*>(extra.getPtr()), target.mTextKeys);
 
+            // All the controllers of the file keep their keys in one packed animation shared between their copies
+            const auto packedAnimation = std::make_shared<NifOsg::PackedAnimation>();
+
             extra = extra->next;
             Nif::ControllerPtr ctrl = seq->controller;
             for (; !extra.empty() && !ctrl.empty(); (extra = extra->next), (ctrl = ctrl->next))
@@ -309,13 +326,21 @@ namespace NifOsg
                     continue;
                 }
 
-                osg::ref_ptr<SceneUtil::KeyframeController> callback = new NifOsg::KeyframeController(key);
-                setupController(key, callback, /*animflags*/ 0);
-
-                if (!target.mKeyframeControllers.emplace(strdata->string, callback).second)
+                if (target.mKeyframeControllers.contains(strdata->string))
+                {
                     Log(Debug::Verbose) << "Controller " << strdata->string << " present more than once in "
                                         << nif.getFilename() << ", ignoring later version";
+                    continue;
+                }
+
+                osg::ref_ptr<SceneUtil::KeyframeController> callback
+                    = new NifOsg::KeyframeController(key, packedAnimation);
+                setupController(key, callback, /*animflags*/ 0);
+
+                target.mKeyframeControllers.emplace(strdata->string, callback);
             }
+
+            packedAnimation->shrinkToFit();
         }
 
         osg::ref_ptr<osg::Node> load(Nif::FileView nif, Resource::ImageManager* imageManager)
@@ -497,7 +522,7 @@ namespace NifOsg
             }
             else
             {
-                std::string filename = Misc::ResourceHelpers::correctTexturePath(st->filename, imageManager->getVFS());
+                std::string filename = correctTexturePath(st->filename, imageManager->getVFS());
                 image = imageManager->getImage(filename);
             }
             return image;
@@ -555,6 +580,7 @@ namespace NifOsg
                 texture2d->setTextureSize(image->s(), image->t());
             texture2d->setName("envMap");
             handleTextureWrapping(texture2d, textureEffect->wrapS(), textureEffect->wrapT());
+            texture2d = mStateRegistry->share(texture2d);
 
             int texUnit = 3; // FIXME
 
@@ -1789,7 +1815,7 @@ namespace NifOsg
                     }
 
                     unsigned int uvSet = 0;
-                    // create a new texture, will later attempt to share using the SharedStateManager
+                    // create a new texture, shared with the equal ones once it's complete
                     osg::ref_ptr<osg::Texture2D> texture2d;
                     if (texprop->textures[i].inUse)
                     {
@@ -1825,6 +1851,35 @@ namespace NifOsg
                         uvSet = 0;
                     }
 
+                    switch (i)
+                    {
+                        case Nif::NiTexturingProperty::BaseTexture:
+                            texture2d->setName("diffuseMap");
+                            break;
+                        case Nif::NiTexturingProperty::BumpTexture:
+                            texture2d->setName("bumpMap");
+                            break;
+                        case Nif::NiTexturingProperty::GlowTexture:
+                            texture2d->setName("emissiveMap");
+                            break;
+                        case Nif::NiTexturingProperty::DarkTexture:
+                            texture2d->setName("darkMap");
+                            break;
+                        case Nif::NiTexturingProperty::DetailTexture:
+                            texture2d->setName("detailMap");
+                            break;
+                        case Nif::NiTexturingProperty::DecalTexture:
+                            texture2d->setName("decalMap");
+                            break;
+                        case Nif::NiTexturingProperty::GlossTexture:
+                            texture2d->setName("glossMap");
+                            break;
+                        default:
+                            break;
+                    }
+
+                    texture2d = mStateRegistry->share(texture2d);
+
                     unsigned int texUnit = boundTextures.size();
 
                     stateset->setTextureAttributeAndModes(texUnit, texture2d, osg::StateAttribute::ON);
@@ -1897,33 +1952,6 @@ namespace NifOsg
                         stateset->setTextureAttributeAndModes(texUnit, texEnv, osg::StateAttribute::ON);
                     }
 
-                    switch (i)
-                    {
-                        case Nif::NiTexturingProperty::BaseTexture:
-                            texture2d->setName("diffuseMap");
-                            break;
-                        case Nif::NiTexturingProperty::BumpTexture:
-                            texture2d->setName("bumpMap");
-                            break;
-                        case Nif::NiTexturingProperty::GlowTexture:
-                            texture2d->setName("emissiveMap");
-                            break;
-                        case Nif::NiTexturingProperty::DarkTexture:
-                            texture2d->setName("darkMap");
-                            break;
-                        case Nif::NiTexturingProperty::DetailTexture:
-                            texture2d->setName("detailMap");
-                            break;
-                        case Nif::NiTexturingProperty::DecalTexture:
-                            texture2d->setName("decalMap");
-                            break;
-                        case Nif::NiTexturingProperty::GlossTexture:
-                            texture2d->setName("glossMap");
-                            break;
-                        default:
-                            break;
-                    }
-
                     boundTextures.push_back(uvSet);
                 }
             }
@@ -1960,15 +1988,12 @@ namespace NifOsg
                         continue;
                     }
                 }
-                std::string filename
-                    = Misc::ResourceHelpers::correctTexturePath(textureSet->textures[i], imageManager->getVFS());
+                std::string filename = correctTexturePath(textureSet->textures[i], imageManager->getVFS());
                 osg::ref_ptr<osg::Image> image = imageManager->getImage(filename);
                 osg::ref_ptr<osg::Texture2D> texture2d = new osg::Texture2D(image);
                 if (image)
                     texture2d->setTextureSize(image->s(), image->t());
                 handleTextureWrapping(texture2d, (clamp >> 1) & 0x1, clamp & 0x1);
-                unsigned int texUnit = boundTextures.size();
-                stateset->setTextureAttributeAndModes(texUnit, texture2d, osg::StateAttribute::ON);
                 // BSShaderTextureSet presence means there's no need for FFP support for the affected node
                 switch (i)
                 {
@@ -1982,6 +2007,9 @@ namespace NifOsg
                         texture2d->setName("emissiveMap");
                         break;
                 }
+                texture2d = mStateRegistry->share(texture2d);
+                unsigned int texUnit = boundTextures.size();
+                stateset->setTextureAttributeAndModes(texUnit, texture2d, osg::StateAttribute::ON);
                 boundTextures.emplace_back(uvSet);
             }
         }
@@ -2061,7 +2089,7 @@ namespace NifOsg
                             frontFace->setMode(osg::FrontFace::COUNTER_CLOCKWISE);
                             break;
                     }
-                    frontFace = shareAttribute(frontFace);
+                    frontFace = mStateRegistry->share(frontFace);
 
                     osg::StateSet* stateset = node->getOrCreateStateSet();
                     stateset->setAttribute(frontFace, osg::StateAttribute::ON);
@@ -2079,7 +2107,7 @@ namespace NifOsg
                             getStencilOperation(stencilprop->data.zFailAction));
                         stencil->setStencilPassAndDepthPassOperation(
                             getStencilOperation(stencilprop->data.zPassAction));
-                        stencil = shareAttribute(stencil);
+                        stencil = mStateRegistry->share(stencil);
 
                         stateset->setAttributeAndModes(stencil, osg::StateAttribute::ON);
                     }
@@ -2091,7 +2119,7 @@ namespace NifOsg
                     osg::ref_ptr<osg::PolygonMode> mode = new osg::PolygonMode;
                     mode->setMode(osg::PolygonMode::FRONT_AND_BACK,
                         wireprop->isEnabled() ? osg::PolygonMode::LINE : osg::PolygonMode::FILL);
-                    mode = shareAttribute(mode);
+                    mode = mStateRegistry->share(mode);
                     node->getOrCreateStateSet()->setAttributeAndModes(mode, osg::StateAttribute::ON);
                     break;
                 }
@@ -2107,7 +2135,7 @@ namespace NifOsg
                     // uses a fixed depth function of GL_ALWAYS.
                     if (hasStencilProperty)
                         depth->setFunction(osg::Depth::ALWAYS);
-                    depth = shareAttribute(depth);
+                    depth = mStateRegistry->share(depth);
                     stateset->setAttributeAndModes(depth, osg::StateAttribute::ON);
                     break;
                 }
@@ -2164,14 +2192,14 @@ namespace NifOsg
                                 stateset->setTextureMode(i, GL_TEXTURE_2D, osg::StateAttribute::OFF);
                             boundTextures.clear();
                         }
-                        std::string filename
-                            = Misc::ResourceHelpers::correctTexturePath(texprop->filename, imageManager->getVFS());
+                        std::string filename = correctTexturePath(texprop->filename, imageManager->getVFS());
                         osg::ref_ptr<osg::Image> image = imageManager->getImage(filename);
                         osg::ref_ptr<osg::Texture2D> texture2d = new osg::Texture2D(image);
                         texture2d->setName("diffuseMap");
                         if (image)
                             texture2d->setTextureSize(image->s(), image->t());
                         handleTextureWrapping(texture2d, texprop->wrapS(), texprop->wrapT());
+                        texture2d = mStateRegistry->share(texture2d);
                         const unsigned int texUnit = 0;
                         const unsigned int uvSet = 0;
                         stateset->setTextureAttributeAndModes(texUnit, texture2d, osg::StateAttribute::ON);
@@ -2217,14 +2245,14 @@ namespace NifOsg
                                 stateset->setTextureMode(i, GL_TEXTURE_2D, osg::StateAttribute::OFF);
                             boundTextures.clear();
                         }
-                        std::string filename = Misc::ResourceHelpers::correctTexturePath(
-                            texprop->mSourceTexture, imageManager->getVFS());
+                        std::string filename = correctTexturePath(texprop->mSourceTexture, imageManager->getVFS());
                         osg::ref_ptr<osg::Image> image = imageManager->getImage(filename);
                         osg::ref_ptr<osg::Texture2D> texture2d = new osg::Texture2D(image);
                         texture2d->setName("diffuseMap");
                         if (image)
                             texture2d->setTextureSize(image->s(), image->t());
                         handleTextureWrapping(texture2d, (texprop->mClamp >> 1) & 0x1, texprop->mClamp & 0x1);
+                        texture2d = mStateRegistry->share(texture2d);
                         const unsigned int texUnit = 0;
                         const unsigned int uvSet = 0;
                         stateset->setTextureAttributeAndModes(texUnit, texture2d, osg::StateAttribute::ON);
@@ -2265,30 +2293,6 @@ namespace NifOsg
             }
         }
 
-        struct CompareStateAttribute
-        {
-            bool operator()(
-                const osg::ref_ptr<osg::StateAttribute>& left, const osg::ref_ptr<osg::StateAttribute>& right) const
-            {
-                return left->compare(*right) < 0;
-            }
-        };
-
-        // global sharing of State Attributes will reduce the number of GL calls as the osg::State will check by pointer
-        // to see if state is the same
-        template <class Attribute>
-        Attribute* shareAttribute(const osg::ref_ptr<Attribute>& attr)
-        {
-            typedef std::set<osg::ref_ptr<Attribute>, CompareStateAttribute> Cache;
-            static Cache sCache;
-            static std::mutex sMutex;
-            std::lock_guard<std::mutex> lock(sMutex);
-            typename Cache::iterator found = sCache.find(attr);
-            if (found == sCache.end())
-                found = sCache.insert(attr).first;
-            return *found;
-        }
-
         void applyDrawableProperties(osg::Node* node, const std::vector<const Nif::Property*>& properties,
             SceneUtil::CompositeStateSetUpdater* composite, bool hasVertexColors, int animflags)
         {
@@ -2399,7 +2403,7 @@ namespace NifOsg
                             // Either way, D3D8.1 doesn't do that, so adapt the destination factor.
                             if (blendFunc->getDestination() == GL_DST_ALPHA)
                                 blendFunc->setDestination(GL_ONE);
-                            blendFunc = shareAttribute(blendFunc);
+                            blendFunc = mStateRegistry->share(blendFunc);
                             node->getOrCreateStateSet()->setAttributeAndModes(blendFunc, osg::StateAttribute::ON);
 
                             if (!alphaprop->noSorter())
@@ -2427,7 +2431,7 @@ namespace NifOsg
                         {
                             osg::ref_ptr<osg::AlphaFunc> alphaFunc(new osg::AlphaFunc(
                                 getTestMode(alphaprop->alphaTestMode()), alphaprop->data.threshold / 255.f));
-                            alphaFunc = shareAttribute(alphaFunc);
+                            alphaFunc = mStateRegistry->share(alphaFunc);
                             node->getOrCreateStateSet()->setAttributeAndModes(alphaFunc, osg::StateAttribute::ON);
                         }
                         else if (osg::StateSet* stateset = node->getStateSet())
@@ -2512,7 +2516,7 @@ namespace NifOsg
                 return;
             }
 
-            mat = shareAttribute(mat);
+            mat = mStateRegistry->share(mat);
 
             osg::StateSet* stateset = node->getOrCreateStateSet();
             stateset->setAttributeAndModes(mat, osg::StateAttribute::ON);
@@ -2568,9 +2572,13 @@ namespace NifOsg
         }
     };
 
-    osg::ref_ptr<osg::Node> Loader::load(Nif::FileView file, Resource::ImageManager* imageManager)
+    osg::ref_ptr<osg::Node> Loader::load(Nif::FileView file, Resource::ImageManager* imageManager,
+        SceneUtil::StateRegistry* stateRegistry, TexturePaths* texturePaths)
     {
         LoaderImpl impl(file.getFilename(), file.getVersion(), file.getUserVersion(), file.getBethVersion());
+        if (stateRegistry != nullptr)
+            impl.mStateRegistry = stateRegistry;
+        impl.mTexturePaths = texturePaths;
         return impl.load(file, imageManager);
     }
 
@@ -5,9 +5,14 @@
 
 #include <osg/ref_ptr>
 
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace SceneUtil
 {
     class KeyframeHolder;
+    class StateRegistry;
 }
 
 namespace osg
@@ -28,9 +33,16 @@ namespace NifOsg
     class Loader
     {
     public:
+        /// Texture names used by a file and the VFS paths they were resolved to
+        using TexturePaths = std::vector<std::pair<std::string, std::string>>;
+
         /// Create a scene graph for the given NIF. Auto-detects when skinning is used and wraps the graph in a Skeleton
         /// if so.
-        static osg::ref_ptr<osg::Node> load(Nif::FileView file, Resource::ImageManager* imageManager);
+        /// @param stateRegistry shares the state attributes with the other files loaded with it, without it they are
+        /// only shared within the file.
+        /// @param texturePaths receives the texture paths resolved while loading the file, if given.
+        static osg::ref_ptr<osg::Node> load(Nif::FileView file, Resource::ImageManager* imageManager,
+            SceneUtil::StateRegistry* stateRegistry = nullptr, TexturePaths* texturePaths = nullptr);
 
         /// Load keyframe controllers from the given kf file.
         static void loadKf(Nif::FileView kf, SceneUtil::KeyframeHolder& target);
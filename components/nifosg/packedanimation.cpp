@@ -0,0 +1,223 @@
+#include "packedanimation.hpp"
+
+#include "keysearch.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace NifOsg
+{
+    namespace
+    {
+        constexpr int rotationComponentBits = 20;
+        constexpr std::uint64_t rotationComponentMask = (std::uint64_t(1) << rotationComponentBits) - 1;
+        // No component but the largest can have a greater absolute value in a unit quaternion
+        constexpr double rotationComponentLimit = 0.70710678118654752440;
+        constexpr float valueMax = std::numeric_limits<std::uint16_t>::max();
+
+        // Index of the largest component in the lowest 2 bits followed by the other three components
+        std::uint64_t packRotation(const osg::Quat& value)
+        {
+            const double length = value.length();
+            const osg::Quat normalized = length > 0 ? value / length : osg::Quat();
+            int largest = 0;
+            for (int i = 1; i < 4; ++i)
+                if (std::abs(normalized[i]) > std::abs(normalized[largest]))
+                    largest = i;
+            // q and -q are the same rotation, the largest component is stored as positive
+            const double sign = normalized[largest] < 0 ? -1 : 1;
+            std::uint64_t result = static_cast<std::uint64_t>(largest);
+            int shift = 2;
+            for (int i = 0; i < 4; ++i)
+            {
+                if (i == largest)
+                    continue;
+                const double component = std::clamp(sign * normalized[i] / rotationComponentLimit, -1.0, 1.0);
+                const auto quantized
+                    = static_cast<std::uint64_t>(std::lround((component + 1) / 2 * rotationComponentMask));
+                result |= quantized << shift;
+                shift += rotationComponentBits;
+            }
+            return result;
+        }
+
+        osg::Quat unpackRotation(std::uint64_t value)
+        {
+            const int largest = static_cast<int>(value & 3);
+            osg::Quat result;
+            double sum = 0;
+            int shift = 2;
+            for (int i = 0; i < 4; ++i)
+            {
+                if (i == largest)
+                    continue;
+                const double quantized = static_cast<double>((value >> shift) & rotationComponentMask);
+                const double component = (quantized / rotationComponentMask * 2 - 1) * rotationComponentLimit;
+                result[i] = component;
+                sum += component * component;
+                shift += rotationComponentBits;
+            }
+            result[largest] = std::sqrt(std::max(0.0, 1 - sum));
+            return result;
+        }
+
+        std::uint16_t quantize(float value, float offset, float scale)
+        {
+            if (scale <= 0)
+                return 0;
+            return static_cast<std::uint16_t>(std::clamp(std::round((value - offset) / scale), 0.f, valueMax));
+        }
+
+        bool isPackable(unsigned int interpolationType)
+        {
+            // Quadratic interpolation needs tangents, everything else but constant is linear
+            return interpolationType != Nif::InterpolationType_Quadratic;
+        }
+    }
+
+    template <class MapT>
+    PackedAnimation::Channel& PackedAnimation::addChannel(const MapT& keys)
+    {
+        Channel& channel = mChannels.emplace_back();
+        channel.mFirstKey = static_cast<std::uint32_t>(mTimes.size());
+        channel.mNumKeys = static_cast<std::uint32_t>(keys.mTimes.size());
+        channel.mFirstValue = 0;
+        channel.mConstant = keys.mInterpolationType == Nif::InterpolationType_Constant;
+        mTimes.insert(mTimes.end(), keys.mTimes.begin(), keys.mTimes.end());
+        return channel;
+    }
+
+    std::uint32_t PackedAnimation::addRotations(const Nif::QuaternionKeyMap& keys)
+    {
+        // There is no quadratic interpolation of rotations, such keys are interpolated linearly
+        if (keys.mKeys.empty())
+            return sNoChannel;
+        Channel& channel = addChannel(keys);
+        channel.mFirstValue = static_cast<std::uint32_t>(mRotations.size());
+        for (const Nif::QuaternionKey& key : keys.mKeys)
+            mRotations.push_back(packRotation(key.mValue));
+        return static_cast<std::uint32_t>(mChannels.size() - 1);
+    }
+
+    std::uint32_t PackedAnimation::addTranslations(const Nif::Vector3KeyMap& keys)
+    {
+        if (keys.mKeys.empty() || !isPackable(keys.mInterpolationType))
+            return sNoChannel;
+        osg::Vec3f min = keys.mKeys.front().mValue;
+        osg::Vec3f max = min;
+        for (const Nif::Vector3Key& key : keys.mKeys)
+            for (int i = 0; i < 3; ++i)
+            {
+                min[i] = std::min(min[i], key.mValue[i]);
+                max[i] = std::max(max[i], key.mValue[i]);
+            }
+        Channel& channel = addChannel(keys);
+        channel.mFirstValue = static_cast<std::uint32_t>(mValues.size());
+        channel.mOffset = min;
+        channel.mScale = (max - min) / valueMax;
+        for (const Nif::Vector3Key& key : keys.mKeys)
+            for (int i = 0; i < 3; ++i)
+                mValues.push_back(quantize(key.mValue[i], min[i], channel.mScale[i]));
+        return static_cast<std::uint32_t>(mChannels.size() - 1);
+    }
+
+    std::uint32_t PackedAnimation::addScales(const Nif::FloatKeyMap& keys)
+    {
+        if (keys.mKeys.empty() || !isPackable(keys.mInterpolationType))
+            return sNoChannel;
+        const auto [min, max] = std::minmax_element(keys.mKeys.begin(), keys.mKeys.end(),
+            [](const Nif::FloatKey& lhs, const Nif::FloatKey& rhs) { return lhs.mValue < rhs.mValue; });
+        Channel& channel = addChannel(keys);
+        channel.mFirstValue = static_cast<std::uint32_t>(mValues.size());
+        channel.mOffset = osg::Vec3f(min->mValue, 0, 0);
+        channel.mScale = osg::Vec3f((max->mValue - min->mValue) / valueMax, 0, 0);
+        for (const Nif::FloatKey& key : keys.mKeys)
+            mValues.push_back(quantize(key.mValue, channel.mOffset.x(), channel.mScale.x()));
+        return static_cast<std::uint32_t>(mChannels.size() - 1);
+    }
+
+    void PackedAnimation::shrinkToFit()
+    {
+        mChannels.shrink_to_fit();
+        mTimes.shrink_to_fit();
+        mRotations.shrink_to_fit();
+        mValues.shrink_to_fit();
+    }
+
+    osg::Vec3f PackedAnimation::getVector(const Channel& channel, std::size_t key) const
+    {
+        const std::uint16_t* const values = mValues.data() + channel.mFirstValue + key * 3;
+        return osg::Vec3f(channel.mOffset.x() + values[0] * channel.mScale.x(),
+            channel.mOffset.y() + values[1] * channel.mScale.y(), channel.mOffset.z() + values[2] * channel.mScale.z());
+    }
+
+    template <class Decode, class Interpolate>
+    auto PackedAnimation::sample(const Channel& channel, float time, std::uint32_t& cursor, Decode&& decode,
+        Interpolate&& interpolate) const
+    {
+        const std::span<const float> times(mTimes.data() + channel.mFirstKey, channel.mNumKeys);
+
+        if (time <= times.front())
+            return decode(0);
+
+        if (time > times.back())
+            return decode(times.size() - 1);
+
+        // cache for next time
+        const std::size_t high = findKey(times, time, cursor);
+        cursor = static_cast<std::uint32_t>(high);
+        const std::size_t low = high - 1;
+
+        const float a = (time - times[low]) / (times[high] - times[low]);
+
+        if (channel.mConstant)
+            return decode(a > 0.5f ? high : low);
+
+        return interpolate(decode(low), decode(high), a);
+    }
+
+    osg::Quat PackedAnimation::sampleRotation(std::uint32_t channel, float time, std::uint32_t& cursor) const
+    {
+        const Channel& value = mChannels[channel];
+        return sample(
+            value, time, cursor, [&](std::size_t key) { return unpackRotation(mRotations[value.mFirstValue + key]); },
+            [](const osg::Quat& a, const osg::Quat& b, float fraction) {
+                osg::Quat result;
+                result.slerp(fraction, a, b);
+                return result;
+            });
+    }
+
+    osg::Vec3f PackedAnimation::sampleTranslation(std::uint32_t channel, float time, std::uint32_t& cursor) const
+    {
+        const Channel& value = mChannels[channel];
+        return sample(
+            value, time, cursor, [&](std::size_t key) { return getVector(value, key); },
+            [](const osg::Vec3f& a, const osg::Vec3f& b, float fraction) { return a + (b - a) * fraction; });
+    }
+
+    float PackedAnimation::sampleScale(std::uint32_t channel, float time, std::uint32_t& cursor) const
+    {
+        const Channel& value = mChannels[channel];
+        return sample(
+            value, time, cursor,
+            [&](std::size_t key) { return value.mOffset.x() + mValues[value.mFirstValue + key] * value.mScale.x(); },
+            [](float a, float b, float fraction) { return a + (b - a) * fraction; });
+    }
+
+    void PackedAnimation::sampleRotations(std::span<const std::uint32_t> channels, float time,
+        std::span<std::uint32_t> cursors, std::span<osg::Quat> result) const
+    {
+        assert(channels.size() == cursors.size() && channels.size() == result.size());
+        for (std::size_t i = 0; i < channels.size(); ++i)
+            result[i] = sampleRotation(channels[i], time, cursors[i]);
+    }
+
+    std::size_t PackedAnimation::getMemoryUsage() const
+    {
+        return mChannels.capacity() * sizeof(Channel) + mTimes.capacity() * sizeof(float)
+            + mRotations.capacity() * sizeof(std::uint64_t) + mValues.capacity() * sizeof(std::uint16_t);
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef OPENMW_COMPONENTS_NIFOSG_PACKEDANIMATION_H
+#define OPENMW_COMPONENTS_NIFOSG_PACKEDANIMATION_H
+
+#include <components/nif/nifkey.hpp>
+
+#include <osg/Quat>
+#include <osg/Vec3f>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace NifOsg
+{
+    /// Keyframes of all the nodes animated by a KF file, in flat arrays shared by every copy of its controllers.
+    /// Rotations keep the three smallest components of the quaternion in 20 bits each, translations and scales are
+    /// quantized to 16 bits within the range of their channel. Key times stay floats since a KF file puts all its
+    /// animation groups on a single timeline. Channels using quadratic interpolation are not packed.
+    class PackedAnimation
+    {
+    public:
+        static constexpr std::uint32_t sNoChannel = ~0u;
+
+        /// Packed channels of an animated node
+        struct Track
+        {
+            std::uint32_t mRotation = sNoChannel;
+            std::uint32_t mTranslation = sNoChannel;
+            std::uint32_t mScale = sNoChannel;
+        };
+
+        /// Keys found by the previous sampling of a track, each copy of a controller has its own
+        struct Cursor
+        {
+            std::uint32_t mRotation = 0;
+            std::uint32_t mTranslation = 0;
+            std::uint32_t mScale = 0;
+        };
+
+        /// Pack the keys if the interpolation type is supported.
+        /// @return the channel index or sNoChannel
+        std::uint32_t addRotations(const Nif::QuaternionKeyMap& keys);
+        std::uint32_t addTranslations(const Nif::Vector3KeyMap& keys);
+        std::uint32_t addScales(const Nif::FloatKeyMap& keys);
+
+        /// Free the memory reserved while adding channels
+        void shrinkToFit();
+
+        osg::Quat sampleRotation(std::uint32_t channel, float time, std::uint32_t& cursor) const;
+        osg::Vec3f sampleTranslation(std::uint32_t channel, float time, std::uint32_t& cursor) const;
+        float sampleScale(std::uint32_t channel, float time, std::uint32_t& cursor) const;
+
+        /// Sample the rotation channels at the same time, all spans have the same size
+        void sampleRotations(std::span<const std::uint32_t> channels, float time, std::span<std::uint32_t> cursors,
+            std::span<osg::Quat> result) const;
+
+        std::size_t getNumChannels() const { return mChannels.size(); }
+
+        /// Size of the keys and the channel descriptions in bytes
+        std::size_t getMemoryUsage() const;
+
+    private:
+        struct Channel
+        {
+            // Index of the first key time, also of the first key value within the array of the channel type
+            std::uint32_t mFirstKey;
+            std::uint32_t mNumKeys;
+            std::uint32_t mFirstValue;
+            bool mConstant;
+            // Maps 16 bit values back to the range of the channel
+            osg::Vec3f mOffset;
+            osg::Vec3f mScale;
+        };
+
+        std::vector<Channel> mChannels;
+        std::vector<float> mTimes;
+        std::vector<std::uint64_t> mRotations;
+        std::vector<std::uint16_t> mValues;
+
+        template <class MapT>
+        Channel& addChannel(const MapT& keys);
+
+        osg::Vec3f getVector(const Channel& channel, std::size_t key) const;
+
+        template <class Decode, class Interpolate>
+        auto sample(const Channel& channel, float time, std::uint32_t& cursor, Decode&& decode,
+            Interpolate&& interpolate) const;
+    };
+}
+
+#endif
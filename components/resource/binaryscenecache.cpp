@@ -0,0 +1,413 @@
+#include "binaryscenecache.hpp"
+
+#include <osg/Geometry>
+#include <osg/Node>
+#include <osg/NodeVisitor>
+#include <osg/Stats>
+#include <osg/Texture>
+#include <osg/UserDataContainer>
+#include <osg/Version>
+#include <osgDB/Options>
+#include <osgDB/ReaderWriter>
+#include <osgDB/Registry>
+
+#include <components/debug/debuglog.hpp>
+#include <components/files/conversion.hpp>
+#include <components/files/hash.hpp>
+#include <components/misc/resourcehelpers.hpp>
+#include <components/nifosg/nifloader.hpp>
+#include <components/sceneutil/serialize.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Resource
+{
+    namespace
+    {
+        constexpr std::string_view entryExtension = ".osgb";
+        constexpr std::string_view tmpExtension = ".tmp";
+        // Increase when the NIF loader converts files differently or the entry layout changes
+        constexpr int formatVersion = 2;
+
+        bool isStorableClass(const osg::Object& object)
+        {
+            const std::string_view library = object.libraryName();
+            if (library == "osg")
+                return true;
+            return library == "NifOsg" && std::string_view(object.className()) == "MatrixTransform";
+        }
+
+        bool isStorableUserData(const osg::Object& object)
+        {
+            const osg::UserDataContainer* container = object.getUserDataContainer();
+            if (container == nullptr)
+                return true;
+            if (!isStorableClass(*container) || container->getUserData() != nullptr)
+                return false;
+            for (unsigned int i = 0; i < container->getNumUserObjects(); ++i)
+            {
+                const osg::Object* userObject = container->getUserObject(i);
+                if (userObject != nullptr && (!isStorableClass(*userObject) || !isStorableUserData(*userObject)))
+                    return false;
+            }
+            return true;
+        }
+
+        bool isStorableObject(const osg::Object& object)
+        {
+            return isStorableClass(object) && isStorableUserData(object);
+        }
+
+        bool isStorableAttribute(const osg::StateAttribute& attribute)
+        {
+            if (!isStorableObject(attribute) || attribute.getUpdateCallback() != nullptr
+                || attribute.getEventCallback() != nullptr)
+                return false;
+            if (const osg::Texture* texture = attribute.asTexture())
+            {
+                // Images are written as file names and read again with the image manager
+                for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                {
+                    const osg::Image* image = texture->getImage(i);
+                    if (image == nullptr || image->getFileName().empty())
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        bool isStorableStateSet(const osg::StateSet& stateSet)
+        {
+            if (!isStorableObject(stateSet) || stateSet.getUpdateCallback() != nullptr
+                || stateSet.getEventCallback() != nullptr)
+                return false;
+            for (const auto& [type, attribute] : stateSet.getAttributeList())
+                if (!isStorableAttribute(*attribute.first))
+                    return false;
+            for (const osg::StateSet::AttributeList& attributes : stateSet.getTextureAttributeList())
+                for (const auto& [type, attribute] : attributes)
+                    if (!isStorableAttribute(*attribute.first))
+                        return false;
+            for (const auto& [name, uniform] : stateSet.getUniformList())
+                if (!isStorableObject(*uniform.first) || uniform.first->getUpdateCallback() != nullptr
+                    || uniform.first->getEventCallback() != nullptr)
+                    return false;
+            return true;
+        }
+
+        class IsStorableVisitor : public osg::NodeVisitor
+        {
+        public:
+            IsStorableVisitor()
+                : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            {
+            }
+
+            void apply(osg::Node& node) override
+            {
+                if (!mStorable)
+                    return;
+                if (!isStorableObject(node) || node.getUpdateCallback() != nullptr
+                    || node.getEventCallback() != nullptr || node.getCullCallback() != nullptr
+                    || (node.getStateSet() != nullptr && !isStorableStateSet(*node.getStateSet())))
+                {
+                    mStorable = false;
+                    return;
+                }
+                traverse(node);
+            }
+
+            void apply(osg::Drawable& drawable) override
+            {
+                if (drawable.getDrawCallback() != nullptr || drawable.getComputeBoundingBoxCallback() != nullptr
+                    || drawable.getShape() != nullptr)
+                    mStorable = false;
+                // The vertex data is lost once the debug serializers are registered
+                else if (drawable.asGeometry() != nullptr && !SceneUtil::isGeometryDataSerialized())
+                    mStorable = false;
+                else
+                    apply(static_cast<osg::Node&>(drawable));
+            }
+
+            bool mStorable = true;
+        };
+
+        std::string getHex(const std::array<std::uint64_t, 2>& hash)
+        {
+            std::ostringstream result;
+            result << std::hex << std::setfill('0') << std::setw(16) << hash[0] << std::setw(16) << hash[1];
+            return result.str();
+        }
+
+        // Entries start with the texture paths, followed by the osgb stream
+        void writeString(std::ostream& stream, const std::string& value)
+        {
+            const auto size = static_cast<std::uint32_t>(value.size());
+            stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            stream.write(value.data(), value.size());
+        }
+
+        bool readString(std::istream& stream, std::string& value)
+        {
+            std::uint32_t size = 0;
+            if (!stream.read(reinterpret_cast<char*>(&size), sizeof(size)))
+                return false;
+            value.resize(size);
+            return static_cast<bool>(stream.read(value.data(), size));
+        }
+
+        void writeTexturePaths(std::ostream& stream, BinarySceneCache::TexturePaths texturePaths)
+        {
+            std::sort(texturePaths.begin(), texturePaths.end());
+            texturePaths.erase(std::unique(texturePaths.begin(), texturePaths.end()), texturePaths.end());
+            const auto count = static_cast<std::uint32_t>(texturePaths.size());
+            stream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (const auto& [name, path] : texturePaths)
+            {
+                writeString(stream, name);
+                writeString(stream, path);
+            }
+        }
+
+        bool readTexturePaths(std::istream& stream, BinarySceneCache::TexturePaths& texturePaths)
+        {
+            std::uint32_t count = 0;
+            if (!stream.read(reinterpret_cast<char*>(&count), sizeof(count)))
+                return false;
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                auto& [name, path] = texturePaths.emplace_back();
+                if (!readString(stream, name) || !readString(stream, path))
+                    return false;
+            }
+            return true;
+        }
+
+        std::string getTmpFileName(const std::string& fileName)
+        {
+            // Several threads may write the same entry
+            return fileName + '.' + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()))
+                + std::string(tmpExtension);
+        }
+    }
+
+    BinarySceneCache::BinarySceneCache(const std::filesystem::path& directory, std::uint64_t maxSize,
+        std::string_view version, const VFS::Manager* vfs, osg::ref_ptr<osgDB::ReadFileCallback> readImage)
+        : mDirectory(directory)
+        , mMaxSize(maxSize)
+        , mVersion(std::to_string(formatVersion) + ' ' + osgGetVersion() + ' ' + std::string(version))
+        , mVFS(vfs)
+        , mReaderWriter(osgDB::Registry::instance()->getReaderWriterForExtension("osgb"))
+        , mReadOptions(new osgDB::Options)
+        , mWriteOptions(new osgDB::Options)
+    {
+        SceneUtil::registerStorableSerializers();
+
+        mReadOptions->setReadFileCallback(readImage);
+        mWriteOptions->setPluginStringData("fileType", "Binary");
+        mWriteOptions->setPluginStringData("WriteImageHint", "UseExternal");
+
+        if (mReaderWriter == nullptr)
+        {
+            Log(Debug::Warning) << "Binary scene cache is disabled: osgb reader writer is not found";
+            return;
+        }
+
+        std::vector<std::pair<std::filesystem::file_time_type, std::string>> entries;
+        std::error_code ec;
+        std::filesystem::create_directories(mDirectory, ec);
+        for (const auto& file : std::filesystem::directory_iterator(mDirectory, ec))
+        {
+            const std::string name = Files::pathToUnicodeString(file.path().filename());
+            if (name.ends_with(tmpExtension))
+            {
+                // Left by an interrupted write
+                std::filesystem::remove(file.path(), ec);
+                continue;
+            }
+            if (!name.ends_with(entryExtension))
+                continue;
+            const std::uint64_t size = file.file_size(ec);
+            if (ec)
+                continue;
+            entries.emplace_back(file.last_write_time(ec), name);
+            mEntries.emplace(name, Entry{ size, 0 });
+            mSize += size;
+        }
+
+        // Files are touched when read, so the order of the last use survives between runs
+        std::sort(entries.begin(), entries.end());
+        for (const auto& [time, name] : entries)
+            mEntries[name].mLastUse = ++mLastUse;
+
+        trim();
+
+        Log(Debug::Verbose) << "Opened binary scene cache " << mDirectory << " with " << mEntries.size()
+                            << " entries, " << mSize << " bytes";
+    }
+
+    BinarySceneCache::~BinarySceneCache() = default;
+
+    std::string BinarySceneCache::getFileName(std::string_view fileHash) const
+    {
+        // Markers and node masks are decided when converting the scene
+        std::string key(fileHash);
+        key += mVersion;
+        key += ' ';
+        key += NifOsg::Loader::getShowMarkers() ? '1' : '0';
+        key += ' ';
+        key += std::to_string(NifOsg::Loader::getHiddenNodeMask());
+        key += ' ';
+        key += std::to_string(NifOsg::Loader::getIntersectionDisabledNodeMask());
+        return getHex(Files::getHash(key)) + std::string(entryExtension);
+    }
+
+    osg::ref_ptr<osg::Node> BinarySceneCache::read(std::string_view fileHash)
+    {
+        if (mReaderWriter == nullptr || !SceneUtil::isGeometryDataSerialized())
+            return nullptr;
+
+        const std::string fileName = getFileName(fileHash);
+
+        {
+            const std::lock_guard lock(mMutex);
+            const auto it = mEntries.find(fileName);
+            if (it == mEntries.end())
+            {
+                ++mNumMisses;
+                return nullptr;
+            }
+            it->second.mLastUse = ++mLastUse;
+        }
+
+        const std::filesystem::path path = mDirectory / Files::pathFromUnicodeString(fileName);
+        std::ifstream stream(path, std::ios::binary);
+        TexturePaths texturePaths;
+        if (!stream || !readTexturePaths(stream, texturePaths))
+        {
+            Log(Debug::Warning) << "Failed to read binary scene cache entry " << path << ": invalid texture paths";
+            stream.close();
+            const std::lock_guard lock(mMutex);
+            remove(fileName);
+            ++mNumMisses;
+            return nullptr;
+        }
+
+        // Textures added or removed since the entry was written are resolved to other paths, the entry is replaced
+        for (const auto& [name, texturePath] : texturePaths)
+        {
+            if (Misc::ResourceHelpers::correctTexturePath(name, mVFS) != texturePath)
+            {
+                Log(Debug::Verbose) << "Binary scene cache entry " << path << " is outdated: texture " << name
+                                    << " is not " << texturePath << " anymore";
+                stream.close();
+                const std::lock_guard lock(mMutex);
+                remove(fileName);
+                ++mNumMisses;
+                return nullptr;
+            }
+        }
+
+        osgDB::ReaderWriter::ReadResult result = mReaderWriter->readNode(stream, mReadOptions);
+        if (!result.success() || result.getNode() == nullptr)
+        {
+            Log(Debug::Warning) << "Failed to read binary scene cache entry " << path << ": " << result.message();
+            stream.close();
+            const std::lock_guard lock(mMutex);
+            remove(fileName);
+            ++mNumMisses;
+            return nullptr;
+        }
+
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+        ++mNumHits;
+        return result.getNode();
+    }
+
+    void BinarySceneCache::write(std::string_view fileHash, const osg::Node& node, const TexturePaths& texturePaths)
+    {
+        if (mReaderWriter == nullptr || !isStorable(node))
+            return;
+
+        const std::string fileName = getFileName(fileHash);
+        const std::filesystem::path path = mDirectory / Files::pathFromUnicodeString(fileName);
+        const std::filesystem::path tmpPath = mDirectory / Files::pathFromUnicodeString(getTmpFileName(fileName));
+
+        {
+            std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+            if (stream)
+                writeTexturePaths(stream, texturePaths);
+            const bool written = stream && mReaderWriter->writeNode(node, stream, mWriteOptions).success();
+            stream.close();
+            if (!written || !stream)
+            {
+                Log(Debug::Warning) << "Failed to write binary scene cache entry " << path;
+                std::error_code ec;
+                std::filesystem::remove(tmpPath, ec);
+                return;
+            }
+        }
+
+        std::error_code ec;
+        const std::uint64_t size = std::filesystem::file_size(tmpPath, ec);
+        if (!ec)
+            std::filesystem::rename(tmpPath, path, ec);
+        if (ec)
+        {
+            Log(Debug::Warning) << "Failed to write binary scene cache entry " << path << ": " << ec.message();
+            std::filesystem::remove(tmpPath, ec);
+            return;
+        }
+
+        const std::lock_guard lock(mMutex);
+        Entry& entry = mEntries[fileName];
+        mSize = mSize - entry.mSize + size;
+        entry.mSize = size;
+        entry.mLastUse = ++mLastUse;
+        trim();
+    }
+
+    bool BinarySceneCache::isStorable(const osg::Node& node)
+    {
+        IsStorableVisitor visitor;
+        const_cast<osg::Node&>(node).accept(visitor);
+        return visitor.mStorable;
+    }
+
+    void BinarySceneCache::remove(const std::string& fileName)
+    {
+        const auto it = mEntries.find(fileName);
+        if (it == mEntries.end())
+            return;
+        std::error_code ec;
+        std::filesystem::remove(mDirectory / Files::pathFromUnicodeString(fileName), ec);
+        mSize -= it->second.mSize;
+        mEntries.erase(it);
+    }
+
+    void BinarySceneCache::trim()
+    {
+        while (mSize > mMaxSize && !mEntries.empty())
+        {
+            const auto leastRecentlyUsed = std::min_element(mEntries.begin(), mEntries.end(),
+                [](const auto& l, const auto& r) { return l.second.mLastUse < r.second.mLastUse; });
+            remove(leastRecentlyUsed->first);
+        }
+    }
+
+    void BinarySceneCache::reportStats(unsigned int frameNumber, osg::Stats* stats) const
+    {
+        stats->setAttribute(frameNumber, "Node Cache Hit", mNumHits.load());
+        stats->setAttribute(frameNumber, "Node Cache Miss", mNumMisses.load());
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_BINARYSCENECACHE_H
+#define OPENMW_COMPONENTS_RESOURCE_BINARYSCENECACHE_H
+
+#include <osg/ref_ptr>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace osg
+{
+    class Node;
+    class Stats;
+}
+
+namespace VFS
+{
+    class Manager;
+}
+
+namespace osgDB
+{
+    class Options;
+    class ReadFileCallback;
+    class ReaderWriter;
+}
+
+namespace Resource
+{
+    /// Stores scenes converted from NIF files in the osg binary format, so the next runs read them back instead of
+    /// parsing and converting the NIF files again. Entries are keyed by the hash of the NIF file content, the build
+    /// and the loader settings, a changed file or setting is a different entry. The least recently used entries are
+    /// removed once the total size of the files exceeds the limit.
+    /// @par Entries keep the texture names of the NIF file with the paths they were resolved to, an entry is not read
+    /// when a texture name resolves to another path with the current VFS.
+    /// @par Only scenes that the osg serializers write in full are stored, see isStorable.
+    /// @par Thread safe.
+    class BinarySceneCache
+    {
+    public:
+        /// Texture names and the VFS paths they were resolved to, as in NifOsg::Loader::TexturePaths
+        using TexturePaths = std::vector<std::pair<std::string, std::string>>;
+
+        /// @param version identifies the build, entries written by another build are never read
+        /// @param vfs resolves the texture names of the stored entries again
+        /// @param readImage loads the images referenced by the stored textures
+        BinarySceneCache(const std::filesystem::path& directory, std::uint64_t maxSize, std::string_view version,
+            const VFS::Manager* vfs, osg::ref_ptr<osgDB::ReadFileCallback> readImage);
+
+        ~BinarySceneCache();
+
+        /// @param fileHash hash of the NIF file content as in Nif::NIFFile::getHash
+        /// @return the stored scene or nullptr
+        osg::ref_ptr<osg::Node> read(std::string_view fileHash);
+
+        /// Store the scene converted from the NIF file with the given hash, if it is storable
+        /// @param texturePaths the texture paths resolved while converting the file
+        void write(std::string_view fileHash, const osg::Node& node, const TexturePaths& texturePaths);
+
+        /// A scene is storable if it has no callbacks, its objects are instances of osg classes or of OpenMW
+        /// classes serialized in full, and all its texture images are files
+        static bool isStorable(const osg::Node& node);
+
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
+    private:
+        struct Entry
+        {
+            std::uint64_t mSize;
+            std::uint64_t mLastUse;
+        };
+
+        const std::filesystem::path mDirectory;
+        const std::uint64_t mMaxSize;
+        const std::string mVersion;
+        const VFS::Manager* mVFS;
+        osgDB::ReaderWriter* mReaderWriter;
+        osg::ref_ptr<osgDB::Options> mReadOptions;
+        osg::ref_ptr<osgDB::Options> mWriteOptions;
+        mutable std::mutex mMutex;
+        std::map<std::string, Entry, std::less<>> mEntries;
+        std::uint64_t mSize = 0;
+        std::uint64_t mLastUse = 0;
+        std::atomic<std::size_t> mNumHits{ 0 };
+        std::atomic<std::size_t> mNumMisses{ 0 };
+
+        std::string getFileName(std::string_view fileHash) const;
+
+        void remove(const std::string& fileName);
+
+        void trim();
+    };
+}
+
+#endif
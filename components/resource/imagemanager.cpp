@@ -1,10 +1,16 @@
 #include "imagemanager.hpp"
 
 #include <cassert>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include <osg/Stats>
 #include <osgDB/Registry>
 
 #include <components/debug/debuglog.hpp>
 #include <components/misc/pathhelpers.hpp>
+#include <components/sceneutil/workqueue.hpp>
 #include <components/vfs/manager.hpp>
 
 #include "objectcache.hpp"
@@ -53,7 +59,10 @@ namespace Resource
     {
     }
 
-    ImageManager::~ImageManager() {}
+    ImageManager::~ImageManager()
+    {
+        mPendingImages.cancel();
+    }
 
     bool checkSupported(osg::Image* image, const std::string& filename)
     {
@@ -90,106 +99,142 @@ namespace Resource
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
             return osg::ref_ptr<osg::Image>(static_cast<osg::Image*>(obj.get()));
-        else
+
+        const auto load = [&](const std::string& name) { return loadCachedImage(name, disableFlip); };
+        if (std::optional<osg::ref_ptr<osg::Image>> requested = mPendingImages.get(normalized, load))
+            return *requested;
+
+        return loadImage(normalized, disableFlip);
+    }
+
+    std::shared_future<osg::ref_ptr<osg::Image>> ImageManager::requestImage(
+        const std::string& filename, bool disableFlip)
+    {
+        const std::string normalized = mVFS->normalizeFilename(filename);
+
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
+            return PendingImages::makeReadyFuture(static_cast<osg::Image*>(obj.get()));
+
+        const auto load = [this, disableFlip](const std::string& name) { return loadCachedImage(name, disableFlip); };
+        if (std::optional<PendingImages::Future> requested = mPendingImages.request(normalized, load))
+            return *requested;
+
+        return PendingImages::makeReadyFuture(loadImage(normalized, disableFlip));
+    }
+
+    void ImageManager::setWorkQueue(osg::ref_ptr<SceneUtil::WorkQueue> workQueue)
+    {
+        mPendingImages.setWorkQueue(std::move(workQueue));
+    }
+
+    osg::ref_ptr<osg::Image> ImageManager::loadCachedImage(const std::string& normalized, bool disableFlip)
+    {
+        // Another request for the same image may have finished since this one was made
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
+            return static_cast<osg::Image*>(obj.get());
+        return loadImage(normalized, disableFlip);
+    }
+
+    osg::ref_ptr<osg::Image> ImageManager::loadImage(const std::string& normalized, bool disableFlip)
+    {
+        Files::IStreamPtr stream;
+        try
         {
-            Files::IStreamPtr stream;
-            try
-            {
-                stream = mVFS->get(normalized);
-            }
-            catch (std::exception& e)
-            {
-                Log(Debug::Error) << "Failed to open image: " << e.what();
-                mCache->addEntryToObjectCache(normalized, mWarningImage);
-                return mWarningImage;
-            }
+            stream = mVFS->get(normalized);
+        }
+        catch (std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to open image: " << e.what();
+            mCache->addEntryToObjectCache(normalized, mWarningImage);
+            return mWarningImage;
+        }
 
-            const std::string ext(Misc::getFileExtension(normalized));
-            osgDB::ReaderWriter* reader = osgDB::Registry::instance()->getReaderWriterForExtension(ext);
-            if (!reader)
+        const std::string ext(Misc::getFileExtension(normalized));
+        osgDB::ReaderWriter* reader = osgDB::Registry::instance()->getReaderWriterForExtension(ext);
+        if (!reader)
+        {
+            Log(Debug::Error) << "Error loading " << normalized << ": no readerwriter for '" << ext << "' found";
+            mCache->addEntryToObjectCache(normalized, mWarningImage);
+            return mWarningImage;
+        }
+
+        bool killAlpha = false;
+        if (reader->supportedExtensions().count("tga"))
+        {
+            // Morrowind ignores the alpha channel of 16bpp TGA files even when the header says not to
+            unsigned char header[18];
+            stream->read((char*)header, 18);
+            if (stream->gcount() != 18)
             {
-                Log(Debug::Error) << "Error loading " << filename << ": no readerwriter for '" << ext << "' found";
+                Log(Debug::Error) << "Error loading " << normalized << ": couldn't read TGA header";
                 mCache->addEntryToObjectCache(normalized, mWarningImage);
                 return mWarningImage;
             }
+            int type = header[2];
+            int depth;
+            if (type == 1 || type == 9)
+                depth = header[7];
+            else
+                depth = header[16];
+            int alphaBPP = header[17] & 0x0F;
+            killAlpha = depth == 16 && alphaBPP == 1;
+            stream->seekg(0);
+        }
 
-            bool killAlpha = false;
-            if (reader->supportedExtensions().count("tga"))
-            {
-                // Morrowind ignores the alpha channel of 16bpp TGA files even when the header says not to
-                unsigned char header[18];
-                stream->read((char*)header, 18);
-                if (stream->gcount() != 18)
-                {
-                    Log(Debug::Error) << "Error loading " << filename << ": couldn't read TGA header";
-                    mCache->addEntryToObjectCache(normalized, mWarningImage);
-                    return mWarningImage;
-                }
-                int type = header[2];
-                int depth;
-                if (type == 1 || type == 9)
-                    depth = header[7];
-                else
-                    depth = header[16];
-                int alphaBPP = header[17] & 0x0F;
-                killAlpha = depth == 16 && alphaBPP == 1;
-                stream->seekg(0);
-            }
+        osgDB::ReaderWriter::ReadResult result = reader->readImage(*stream, disableFlip ? mOptionsNoFlip : mOptions);
+        if (!result.success())
+        {
+            Log(Debug::Error) << "Error loading " << normalized << ": " << result.message() << " code "
+                              << result.status();
+            mCache->addEntryToObjectCache(normalized, mWarningImage);
+            return mWarningImage;
+        }
 
-            osgDB::ReaderWriter::ReadResult result
-                = reader->readImage(*stream, disableFlip ? mOptionsNoFlip : mOptions);
-            if (!result.success())
+        osg::ref_ptr<osg::Image> image = result.getImage();
+
+        image->setFileName(normalized);
+        if (!checkSupported(image, normalized))
+        {
+            static bool uncompress = (getenv("OPENMW_DECOMPRESS_TEXTURES") != nullptr);
+            if (!uncompress)
             {
-                Log(Debug::Error) << "Error loading " << filename << ": " << result.message() << " code "
-                                  << result.status();
+                Log(Debug::Error) << "Error loading " << normalized
+                                  << ": no S3TC texture compression support installed";
                 mCache->addEntryToObjectCache(normalized, mWarningImage);
                 return mWarningImage;
             }
-
-            osg::ref_ptr<osg::Image> image = result.getImage();
-
-            image->setFileName(normalized);
-            if (!checkSupported(image, filename))
-            {
-                static bool uncompress = (getenv("OPENMW_DECOMPRESS_TEXTURES") != nullptr);
-                if (!uncompress)
-                {
-                    Log(Debug::Error) << "Error loading " << filename
-                                      << ": no S3TC texture compression support installed";
-                    mCache->addEntryToObjectCache(normalized, mWarningImage);
-                    return mWarningImage;
-                }
-                else
-                {
-                    // decompress texture in software if not supported by GPU
-                    // requires update to getColor() to be released with OSG 3.6
-                    osg::ref_ptr<osg::Image> newImage = new osg::Image;
-                    newImage->setFileName(image->getFileName());
-                    newImage->allocateImage(image->s(), image->t(), image->r(),
-                        image->isImageTranslucent() ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE);
-                    for (int s = 0; s < image->s(); ++s)
-                        for (int t = 0; t < image->t(); ++t)
-                            for (int r = 0; r < image->r(); ++r)
-                                newImage->setColor(image->getColor(s, t, r), s, t, r);
-                    image = newImage;
-                }
-            }
-            else if (killAlpha)
+            else
             {
+                // decompress texture in software if not supported by GPU
+                // requires update to getColor() to be released with OSG 3.6
                 osg::ref_ptr<osg::Image> newImage = new osg::Image;
                 newImage->setFileName(image->getFileName());
-                newImage->allocateImage(image->s(), image->t(), image->r(), GL_RGB, GL_UNSIGNED_BYTE);
-                // OSG just won't write the alpha as there's nowhere to put it.
+                newImage->allocateImage(image->s(), image->t(), image->r(),
+                    image->isImageTranslucent() ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE);
                 for (int s = 0; s < image->s(); ++s)
                     for (int t = 0; t < image->t(); ++t)
                         for (int r = 0; r < image->r(); ++r)
                             newImage->setColor(image->getColor(s, t, r), s, t, r);
                 image = newImage;
             }
-
-            mCache->addEntryToObjectCache(normalized, image);
-            return image;
         }
+        else if (killAlpha)
+        {
+            osg::ref_ptr<osg::Image> newImage = new osg::Image;
+            newImage->setFileName(image->getFileName());
+            newImage->allocateImage(image->s(), image->t(), image->r(), GL_RGB, GL_UNSIGNED_BYTE);
+            // OSG just won't write the alpha as there's nowhere to put it.
+            for (int s = 0; s < image->s(); ++s)
+                for (int t = 0; t < image->t(); ++t)
+                    for (int r = 0; r < image->r(); ++r)
+                        newImage->setColor(image->getColor(s, t, r), s, t, r);
+            image = newImage;
+        }
+
+        mCache->addEntryToObjectCache(normalized, image);
+        return image;
     }
 
     osg::Image* ImageManager::getWarningImage()
@@ -197,9 +242,32 @@ namespace Resource
         return mWarningImage;
     }
 
+    void ImageManager::updateCache(double referenceTime)
+    {
+        const auto getSize = [](const osg::Object& object) {
+            return static_cast<const osg::Image&>(object).getTotalSizeInBytesIncludingMipmaps();
+        };
+        const std::size_t maxCacheSize = mMaxCacheSize;
+        if (maxCacheSize == 0)
+        {
+            ResourceManager::updateCache(referenceTime);
+            // Nothing is removed without a limit, only the size is measured
+            mCacheMemoryUsage
+                = mCache->removeLeastRecentlyUsedObjectsInCache(std::numeric_limits<std::size_t>::max(), getSize);
+        }
+        else
+        {
+            mCache->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
+            mCacheMemoryUsage = mCache->removeLeastRecentlyUsedObjectsInCache(maxCacheSize, getSize);
+        }
+    }
+
     void ImageManager::reportStats(unsigned int frameNumber, osg::Stats* stats) const
     {
         stats->setAttribute(frameNumber, "Image", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Image Memory", mCacheMemoryUsage.load());
+
+        stats->setAttribute(frameNumber, "Image Pending", mPendingImages.size());
     }
 
 }
@@ -1,13 +1,16 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_IMAGEMANAGER_H
 #define OPENMW_COMPONENTS_RESOURCE_IMAGEMANAGER_H
 
-#include <map>
+#include <atomic>
+#include <cstddef>
+#include <future>
 #include <string>
 
 #include <osg/Image>
 #include <osg/Texture2D>
 #include <osg/ref_ptr>
 
+#include "pendingrequests.hpp"
 #include "resourcemanager.hpp"
 
 namespace osgDB
@@ -28,17 +31,44 @@ namespace Resource
 
         /// Create or retrieve an Image
         /// Returns the dummy image if the given image is not found.
+        /// @note Waits for the image if it's being loaded by a request, or loads it if the request hasn't started yet.
         osg::ref_ptr<osg::Image> getImage(const std::string& filename, bool disableFlip = false);
 
+        /// Start loading an image on the work queue without waiting for it, or load it on the calling thread if
+        /// there is no work queue. Requests for an image already being loaded share the same result.
+        std::shared_future<osg::ref_ptr<osg::Image>> requestImage(
+            const std::string& filename, bool disableFlip = false);
+
+        /// Set the work queue to load requested images on, nullptr to load them on the requesting thread.
+        /// @note Waits for the requests already started on the previous work queue.
+        void setWorkQueue(osg::ref_ptr<SceneUtil::WorkQueue> workQueue);
+
+        /// Keep images no longer referenced outside of the cache as long as all the images in the cache take less
+        /// than maxSize bytes, removing the least recently used first, instead of removing them after the expiry
+        /// delay. 0 to use the expiry delay.
+        void setMaxCacheSize(std::size_t maxSize) { mMaxCacheSize = maxSize; }
+
         osg::Image* getWarningImage();
 
+        void updateCache(double referenceTime) override;
+
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
     private:
+        using PendingImages = PendingRequests<osg::Image>;
+
         osg::ref_ptr<osg::Image> mWarningImage;
         osg::ref_ptr<osgDB::Options> mOptions;
         osg::ref_ptr<osgDB::Options> mOptionsNoFlip;
 
+        PendingImages mPendingImages;
+
+        std::atomic<std::size_t> mMaxCacheSize{ 0 };
+        std::atomic<std::size_t> mCacheMemoryUsage{ 0 };
+
+        osg::ref_ptr<osg::Image> loadImage(const std::string& normalized, bool disableFlip);
+        osg::ref_ptr<osg::Image> loadCachedImage(const std::string& normalized, bool disableFlip);
+
         ImageManager(const ImageManager&);
         void operator=(const ImageManager&);
     };
@@ -24,9 +24,12 @@
 #include <osg/Referenced>
 #include <osg/ref_ptr>
 
+#include <algorithm>
+#include <cstddef>
 #include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace osg
 {
@@ -93,6 +96,45 @@ namespace Resource
             objectsToRemove.clear();
         }
 
+        /** Remove the objects without external references, least recently used first, while the total size of the
+         * objects in the cache is greater than maxSize. The time stamps of the objects with external references have
+         * to be updated first, like for removeExpiredObjectsInCache.
+         * @return the total size of the objects left in the cache */
+        template <class GetSize>
+        std::size_t removeLeastRecentlyUsedObjectsInCache(std::size_t maxSize, GetSize&& getSize)
+        {
+            std::vector<osg::ref_ptr<osg::Object>> objectsToRemove;
+            std::size_t size = 0;
+            {
+                std::lock_guard<std::mutex> lock(_objectCacheMutex);
+                std::vector<typename ObjectCacheMap::iterator> unreferenced;
+                for (typename ObjectCacheMap::iterator itr = _objectCache.begin(); itr != _objectCache.end(); ++itr)
+                {
+                    if (itr->second.first == nullptr)
+                        continue;
+                    size += getSize(*itr->second.first);
+                    if (itr->second.first->referenceCount() == 1)
+                        unreferenced.push_back(itr);
+                }
+                if (size > maxSize)
+                {
+                    std::sort(unreferenced.begin(), unreferenced.end(),
+                        [](const auto& l, const auto& r) { return l->second.second < r->second.second; });
+                    for (const typename ObjectCacheMap::iterator& itr : unreferenced)
+                    {
+                        if (size <= maxSize)
+                            break;
+                        size -= getSize(*itr->second.first);
+                        objectsToRemove.push_back(itr->second.first);
+                        _objectCache.erase(itr);
+                    }
+                }
+            }
+            // note, actual unref happens outside of the lock
+            objectsToRemove.clear();
+            return size;
+        }
+
         /** Remove all objects in the cache regardless of having external references or expiry times.*/
         void clear()
         {
@@ -0,0 +1,201 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_PENDINGREQUESTS_H
+#define OPENMW_COMPONENTS_RESOURCE_PENDINGREQUESTS_H
+
+#include <components/debug/debuglog.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <osg/ref_ptr>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Resource
+{
+    /// @brief Resources requested to be loaded on a work queue, by normalized name. All the requests for a resource
+    /// share the same result until it is loaded. Each request is loaded once, by the work queue or by a thread
+    /// needing the resource before the work queue gets to it.
+    /// @note Thread safe. The owner has to cancel the requests before destroying what the load functions use.
+    template <class T>
+    class PendingRequests
+    {
+    public:
+        using Result = osg::ref_ptr<T>;
+        using Future = std::shared_future<Result>;
+        /// Called with the normalized name on the thread loading the request, may throw.
+        using Load = std::function<Result(const std::string& normalized)>;
+
+        static Future makeReadyFuture(Result value)
+        {
+            std::promise<Result> promise;
+            promise.set_value(std::move(value));
+            return promise.get_future().share();
+        }
+
+        /// Set the work queue to load the requests on, nullptr to not accept requests anymore.
+        /// @note Cancels the requests made on the previous work queue, see cancel.
+        void setWorkQueue(osg::ref_ptr<SceneUtil::WorkQueue> workQueue)
+        {
+            {
+                const std::lock_guard lock(mMutex);
+                mWorkQueue = std::move(workQueue);
+            }
+            cancel();
+        }
+
+        /// @return the future of the request for the resource, a new one loaded with the given function unless
+        /// there already is one. No value without a work queue, the caller has to load the resource itself.
+        std::optional<Future> request(const std::string& normalized, Load load)
+        {
+            std::shared_ptr<Request> request;
+            osg::ref_ptr<SceneUtil::WorkQueue> workQueue;
+            {
+                const std::lock_guard lock(mMutex);
+                const auto it = mRequests.find(normalized);
+                if (it != mRequests.end())
+                    return it->second->mFuture;
+                if (mWorkQueue == nullptr)
+                    return std::nullopt;
+                request = std::make_shared<Request>();
+                mRequests.emplace(normalized, request);
+                workQueue = mWorkQueue;
+            }
+
+            // Requested resources are usually needed soon, they go before preloading
+            workQueue->addWorkItem(new LoadWorkItem(*this, normalized, request, std::move(load)), true);
+            return request->mFuture;
+        }
+
+        /// @return the resource of the request for it, loaded with the given function on this thread unless the
+        /// work queue has started it, then waits for it. No value if the resource is not requested.
+        std::optional<Result> get(const std::string& normalized, const Load& load)
+        {
+            std::shared_ptr<Request> request;
+            {
+                const std::lock_guard lock(mMutex);
+                const auto it = mRequests.find(normalized);
+                if (it == mRequests.end())
+                    return std::nullopt;
+                request = it->second;
+            }
+
+            if (!request->claim())
+                return request->mFuture.get();
+
+            return loadRequest(normalized, *request, load);
+        }
+
+        /// Make the requests not started yet fail and wait for the ones being loaded, as they may still use what the
+        /// load function refers to.
+        void cancel()
+        {
+            std::map<std::string, std::shared_ptr<Request>, std::less<>> requests;
+            {
+                const std::lock_guard lock(mMutex);
+                requests.swap(mRequests);
+            }
+            for (const auto& [normalized, request] : requests)
+            {
+                // The work items of the cancelled requests do nothing
+                if (request->claim())
+                    request->mPromise.set_exception(
+                        std::make_exception_ptr(std::runtime_error("Request for '" + normalized + "' is cancelled")));
+                else
+                    request->mFuture.wait();
+            }
+        }
+
+        std::size_t size() const
+        {
+            const std::lock_guard lock(mMutex);
+            return mRequests.size();
+        }
+
+    private:
+        struct Request
+        {
+            std::promise<Result> mPromise;
+            Future mFuture = mPromise.get_future().share();
+            std::atomic_bool mClaimed{ false };
+
+            // Only the thread claiming the request loads the resource, the others wait for it
+            bool claim() { return !mClaimed.exchange(true); }
+        };
+
+        class LoadWorkItem : public SceneUtil::WorkItem
+        {
+        public:
+            LoadWorkItem(
+                PendingRequests& requests, const std::string& normalized, std::shared_ptr<Request> request, Load load)
+                : mRequests(requests)
+                , mNormalized(normalized)
+                , mRequest(std::move(request))
+                , mLoad(std::move(load))
+            {
+            }
+
+            void doWork() override
+            {
+                // The request may have been loaded by a thread that couldn't wait for it or cancelled meanwhile
+                if (!mRequest->claim())
+                    return;
+                try
+                {
+                    mRequests.loadRequest(mNormalized, *mRequest, mLoad);
+                }
+                catch (const std::exception& e)
+                {
+                    Log(Debug::Error) << "Failed to load requested '" << mNormalized << "': " << e.what();
+                }
+            }
+
+        private:
+            PendingRequests& mRequests;
+            const std::string mNormalized;
+            const std::shared_ptr<Request> mRequest;
+            const Load mLoad;
+        };
+
+        mutable std::mutex mMutex;
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        std::map<std::string, std::shared_ptr<Request>, std::less<>> mRequests;
+
+        Result loadRequest(const std::string& normalized, Request& request, const Load& load)
+        {
+            Result loaded;
+            try
+            {
+                loaded = load(normalized);
+            }
+            catch (...)
+            {
+                finish(normalized, request);
+                request.mPromise.set_exception(std::current_exception());
+                throw;
+            }
+            finish(normalized, request);
+            request.mPromise.set_value(loaded);
+            return loaded;
+        }
+
+        void finish(const std::string& normalized, const Request& request)
+        {
+            const std::lock_guard lock(mMutex);
+            // A cancelled request may have been replaced by a new one
+            const auto it = mRequests.find(normalized);
+            if (it != mRequests.end() && it->second.get() == &request)
+                mRequests.erase(it);
+        }
+    };
+}
+
+#endif
@@ -2,6 +2,8 @@
 
 #include <cstdlib>
 #include <filesystem>
+#include <optional>
+#include <stdexcept>
 
 #include <osg/AlphaFunc>
 #include <osg/Group>
@@ -40,8 +42,10 @@
 #include <components/sceneutil/lightmanager.hpp>
 #include <components/sceneutil/optimizer.hpp>
 #include <components/sceneutil/riggeometryosgaextension.hpp>
+#include <components/sceneutil/stateregistry.hpp>
 #include <components/sceneutil/util.hpp>
 #include <components/sceneutil/visitor.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 #include <components/shader/shadermanager.hpp>
 #include <components/shader/shadervisitor.hpp>
@@ -50,6 +54,7 @@
 #include <components/files/hash.hpp>
 #include <components/files/memorystream.hpp>
 
+#include "binaryscenecache.hpp"
 #include "errormarker.hpp"
 #include "imagemanager.hpp"
 #include "niffilemanager.hpp"
@@ -219,9 +224,13 @@ namespace Resource
             osg::Texture* tex = attr->asTexture();
             if (tex)
             {
-                tex->setFilter(osg::Texture::MIN_FILTER, mMinFilter);
-                tex->setFilter(osg::Texture::MAG_FILTER, mMagFilter);
-                tex->setMaxAnisotropy(mMaxAnisotropy);
+                // Textures are shared with the scenes loaded before, don't dirty them when nothing changes
+                if (tex->getFilter(osg::Texture::MIN_FILTER) != mMinFilter)
+                    tex->setFilter(osg::Texture::MIN_FILTER, mMinFilter);
+                if (tex->getFilter(osg::Texture::MAG_FILTER) != mMagFilter)
+                    tex->setFilter(osg::Texture::MAG_FILTER, mMagFilter);
+                if (tex->getMaxAnisotropy() != mMaxAnisotropy)
+                    tex->setMaxAnisotropy(mMaxAnisotropy);
             }
         }
 
@@ -231,6 +240,51 @@ namespace Resource
         int mMaxAnisotropy;
     };
 
+    /// Replace the state attributes of a scene not made by the NIF loader with the registered ones.
+    class ShareStateAttributesVisitor : public osg::NodeVisitor
+    {
+    public:
+        explicit ShareStateAttributesVisitor(SceneUtil::StateRegistry& registry)
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mRegistry(registry)
+        {
+        }
+
+        void apply(osg::Node& node) override
+        {
+            if (osg::StateSet* stateset = node.getStateSet())
+                applyStateSet(*stateset);
+
+            traverse(node);
+        }
+
+        void applyStateSet(osg::StateSet& stateset)
+        {
+            // Copies, setting an attribute replaces the list entry
+            const osg::StateSet::AttributeList attributes = stateset.getAttributeList();
+            for (const auto& [type, attribute] : attributes)
+            {
+                const osg::ref_ptr<osg::StateAttribute> shared = mRegistry.share(attribute.first);
+                if (shared != attribute.first)
+                    stateset.setAttribute(shared, attribute.second);
+            }
+
+            const osg::StateSet::TextureAttributeList textureAttributes = stateset.getTextureAttributeList();
+            for (unsigned int unit = 0; unit < textureAttributes.size(); ++unit)
+            {
+                for (const auto& [type, attribute] : textureAttributes[unit])
+                {
+                    const osg::ref_ptr<osg::StateAttribute> shared = mRegistry.share(attribute.first);
+                    if (shared != attribute.first)
+                        stateset.setTextureAttribute(unit, shared, attribute.second);
+                }
+            }
+        }
+
+    private:
+        SceneUtil::StateRegistry& mRegistry;
+    };
+
     // Check Collada extra descriptions
     class ColladaDescriptionVisitor : public osg::NodeVisitor
     {
@@ -365,12 +419,14 @@ namespace Resource
         , mAdjustCoverageForAlphaTest(false)
         , mSupportsNormalsRT(false)
         , mSharedStateManager(new SharedStateManager)
+        , mStateRegistry(std::make_unique<SceneUtil::StateRegistry>())
         , mImageManager(imageManager)
         , mNifFileManager(nifFileManager)
         , mMinFilter(osg::Texture::LINEAR_MIPMAP_LINEAR)
         , mMagFilter(osg::Texture::LINEAR)
         , mMaxAnisotropy(1)
         , mUnRefImageDataAfterApply(false)
+        , mMainThreadId(std::this_thread::get_id())
         , mParticleSystemMask(~0u)
     {
     }
@@ -438,6 +494,13 @@ namespace Resource
         mSpecularMapPattern = pattern;
     }
 
+    void SceneManager::setOptimizerThreads(unsigned int numThreads)
+    {
+        if (mOptimizerWorkQueue)
+            mOptimizerWorkQueue->stop();
+        mOptimizerWorkQueue = numThreads > 0 ? new SceneUtil::WorkQueue(numThreads) : nullptr;
+    }
+
     void SceneManager::setApplyLightingToEnvMaps(bool apply)
     {
         mApplyLightingToEnvMaps = apply;
@@ -493,6 +556,7 @@ namespace Resource
     SceneManager::~SceneManager()
     {
         // this has to be defined in the .cpp file as we can't delete incomplete types
+        mPendingTemplates.cancel();
     }
 
     Shader::ShaderManager& SceneManager::getShaderManager()
@@ -720,11 +784,12 @@ namespace Resource
     }
 
     osg::ref_ptr<osg::Node> load(const std::string& normalizedFilename, const VFS::Manager* vfs,
-        Resource::ImageManager* imageManager, Resource::NifFileManager* nifFileManager)
+        Resource::ImageManager* imageManager, Resource::NifFileManager* nifFileManager,
+        SceneUtil::StateRegistry* stateRegistry)
     {
         auto ext = Misc::getFileExtension(normalizedFilename);
         if (ext == "nif")
-            return NifOsg::Loader::load(*nifFileManager->get(normalizedFilename), imageManager);
+            return NifOsg::Loader::load(*nifFileManager->get(normalizedFilename), imageManager, stateRegistry);
         else
             return loadNonNif(normalizedFilename, *vfs->get(normalizedFilename), imageManager);
     }
@@ -840,7 +905,7 @@ namespace Resource
             {
                 const std::string normalized = "meshes/marker_error." + std::string(meshType);
                 if (mVFS->exists(normalized))
-                    return load(normalized, mVFS, mImageManager, mNifFileManager);
+                    return load(normalized, mVFS, mImageManager, mNifFileManager, mStateRegistry.get());
             }
         }
         catch (const std::exception& e)
@@ -867,57 +932,136 @@ namespace Resource
         osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
         if (obj)
             return osg::ref_ptr<const osg::Node>(static_cast<osg::Node*>(obj.get()));
-        else
-        {
-            osg::ref_ptr<osg::Node> loaded;
-            try
-            {
-                loaded = load(normalized, mVFS, mImageManager, mNifFileManager);
 
-                SceneUtil::ProcessExtraDataVisitor extraDataVisitor(this);
-                loaded->accept(extraDataVisitor);
-            }
-            catch (const std::exception& e)
-            {
-                Log(Debug::Error) << "Failed to load '" << name << "': " << e.what() << ", using marker_error instead";
-                loaded = cloneErrorMarker();
-            }
+        // Waiting for a request started on the work queue is not counted, only the loads on this thread
+        const auto load = [&](const std::string& path) {
+            if (std::this_thread::get_id() == mMainThreadId)
+                ++mNumSyncLoads;
+            return loadCachedTemplate(path, compile);
+        };
+        if (std::optional<osg::ref_ptr<const osg::Node>> requested = mPendingTemplates.get(normalized, load))
+            return *requested;
 
-            // set filtering settings
-            SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsVisitor);
-            SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(
-                mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsControllerVisitor);
+        return load(normalized);
+    }
 
-            SceneUtil::ReplaceDepthVisitor replaceDepthVisitor;
-            loaded->accept(replaceDepthVisitor);
+    std::shared_future<osg::ref_ptr<const osg::Node>> SceneManager::requestTemplate(const std::string& name)
+    {
+        const std::string normalized = mVFS->normalizeFilename(name);
 
-            osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor(createShaderVisitor());
-            loaded->accept(*shaderVisitor);
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
+            return PendingTemplates::makeReadyFuture(static_cast<osg::Node*>(obj.get()));
 
-            if (canOptimize(normalized))
-            {
-                SceneUtil::Optimizer optimizer;
-                optimizer.setSharedStateManager(mSharedStateManager, &mSharedStateMutex);
-                optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+        const auto load = [this](const std::string& path) { return loadCachedTemplate(path, true); };
+        if (std::optional<PendingTemplates::Future> requested = mPendingTemplates.request(normalized, load))
+            return *requested;
 
-                static const unsigned int options
-                    = getOptimizationOptions() | SceneUtil::Optimizer::SHARE_DUPLICATE_STATE;
+        std::promise<osg::ref_ptr<const osg::Node>> loaded;
+        try
+        {
+            loaded.set_value(getTemplate(normalized));
+        }
+        catch (...)
+        {
+            loaded.set_exception(std::current_exception());
+        }
+        return loaded.get_future().share();
+    }
 
-                optimizer.optimize(loaded, options);
-            }
-            else
-                shareState(loaded);
+    void SceneManager::setWorkQueue(osg::ref_ptr<SceneUtil::WorkQueue> workQueue)
+    {
+        mPendingTemplates.setWorkQueue(std::move(workQueue));
+    }
 
-            if (compile && mIncrementalCompileOperation)
-                mIncrementalCompileOperation->add(loaded);
+    osg::ref_ptr<const osg::Node> SceneManager::loadCachedTemplate(const std::string& normalized, bool compile)
+    {
+        // Another request for the same scene may have finished since this one was made
+        osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(normalized);
+        if (obj)
+            return static_cast<osg::Node*>(obj.get());
+        return loadTemplate(normalized, compile);
+    }
+
+    osg::ref_ptr<const osg::Node> SceneManager::loadTemplate(const std::string& normalized, bool compile)
+    {
+        osg::ref_ptr<osg::Node> loaded;
+        try
+        {
+            if (mBinarySceneCache != nullptr && Misc::getFileExtension(normalized) == "nif")
+                loaded = loadCachedNif(normalized);
             else
-                loaded->getBound();
+                loaded = load(normalized, mVFS, mImageManager, mNifFileManager, mStateRegistry.get());
 
-            mCache->addEntryToObjectCache(normalized, loaded);
-            return loaded;
+            SceneUtil::ProcessExtraDataVisitor extraDataVisitor(this);
+            loaded->accept(extraDataVisitor);
         }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to load '" << normalized << "': " << e.what()
+                              << ", using marker_error instead";
+            loaded = cloneErrorMarker();
+        }
+
+        // set filtering settings
+        SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsVisitor);
+        SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsControllerVisitor);
+
+        SceneUtil::ReplaceDepthVisitor replaceDepthVisitor;
+        loaded->accept(replaceDepthVisitor);
+
+        osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor(createShaderVisitor());
+        loaded->accept(*shaderVisitor);
+
+        if (canOptimize(normalized))
+        {
+            SceneUtil::Optimizer optimizer;
+            optimizer.setSharedStateManager(mSharedStateManager, &mSharedStateMutex);
+            optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+            optimizer.setWorkQueue(mOptimizerWorkQueue.get());
+
+            static const unsigned int options = getOptimizationOptions() | SceneUtil::Optimizer::SHARE_DUPLICATE_STATE;
+
+            optimizer.optimize(loaded, options);
+        }
+        else
+            shareState(loaded);
+
+        if (compile && mIncrementalCompileOperation)
+            mIncrementalCompileOperation->add(loaded);
+        else
+            loaded->getBound();
+
+        mCache->addEntryToObjectCache(normalized, loaded);
+        return loaded;
+    }
+
+    osg::ref_ptr<osg::Node> SceneManager::loadCachedNif(const std::string& normalized)
+    {
+        // Hashing the file is much cheaper than parsing it, the hash is the same as the one of the parsed file
+        const std::array<std::uint64_t, 2> fileHash = Files::getHash(normalized, *mVFS->get(normalized));
+        const std::string_view hash(reinterpret_cast<const char*>(fileHash.data()), sizeof(fileHash));
+        if (osg::ref_ptr<osg::Node> cached = mBinarySceneCache->read(hash))
+        {
+            ShareStateAttributesVisitor shareStateAttributesVisitor(*mStateRegistry);
+            cached->accept(shareStateAttributesVisitor);
+            return cached;
+        }
+        const Nif::NIFFilePtr file = mNifFileManager->get(normalized);
+        NifOsg::Loader::TexturePaths texturePaths;
+        osg::ref_ptr<osg::Node> loaded
+            = NifOsg::Loader::load(*file, mImageManager, mStateRegistry.get(), &texturePaths);
+        mBinarySceneCache->write(file->mHash, *loaded, texturePaths);
+        return loaded;
+    }
+
+    void SceneManager::setBinarySceneCache(
+        const std::filesystem::path& directory, std::uint64_t maxSize, std::string_view version)
+    {
+        mBinarySceneCache = std::make_unique<BinarySceneCache>(
+            directory, maxSize, version, mVFS, new ImageReadCallback(mImageManager));
     }
 
     osg::ref_ptr<osg::Node> SceneManager::getInstance(const std::string& name)
@@ -1040,6 +1184,8 @@ namespace Resource
         mMagFilter = mag;
         mMaxAnisotropy = std::max(1, maxAnisotropy);
 
+        mStateRegistry->setFilterSettings(mMinFilter, mMagFilter, mMaxAnisotropy);
+
         SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
         SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
 
@@ -1067,6 +1213,8 @@ namespace Resource
         mSharedStateManager->prune();
         mSharedStateMutex.unlock();
 
+        mStateRegistry->prune();
+
         if (mIncrementalCompileOperation)
         {
             std::lock_guard<OpenThreads::Mutex> lock(*mIncrementalCompileOperation->getToCompiledMutex());
@@ -1093,6 +1241,7 @@ namespace Resource
 
         std::lock_guard<std::mutex> lock(mSharedStateMutex);
         mSharedStateManager->clearCache();
+        mStateRegistry->clear();
     }
 
     void SceneManager::reportStats(unsigned int frameNumber, osg::Stats* stats) const
@@ -1109,7 +1258,14 @@ namespace Resource
             stats->setAttribute(frameNumber, "StateSet", mSharedStateManager->getNumSharedStateSets());
         }
 
+        mStateRegistry->reportStats(frameNumber, stats);
+
         stats->setAttribute(frameNumber, "Node", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Node Sync Load", mNumSyncLoads.load());
+        if (mBinarySceneCache != nullptr)
+            mBinarySceneCache->reportStats(frameNumber, stats);
+
+        stats->setAttribute(frameNumber, "Node Pending", mPendingTemplates.size());
     }
 
     Shader::ShaderVisitor* SceneManager::createShaderVisitor(const std::string& shaderPrefix)
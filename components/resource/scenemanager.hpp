@@ -1,13 +1,19 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_SCENEMANAGER_H
 #define OPENMW_COMPONENTS_RESOURCE_SCENEMANAGER_H
 
+#include <atomic>
+#include <cstdint>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 
 #include <osg/Texture>
 #include <osg/ref_ptr>
 
+#include "pendingrequests.hpp"
 #include "resourcemanager.hpp"
 
 #include <components/sceneutil/lightmanager.hpp>
@@ -29,6 +35,7 @@ namespace osg
 
 namespace Resource
 {
+    class BinarySceneCache;
     class ImageManager;
     class NifFileManager;
     class SharedStateManager;
@@ -45,6 +52,12 @@ namespace Shader
     class ShaderVisitor;
 }
 
+namespace SceneUtil
+{
+    class StateRegistry;
+    class WorkQueue;
+}
+
 namespace Resource
 {
     class TemplateRef : public osg::Object
@@ -158,6 +171,18 @@ namespace Resource
         /// @note Thread safe.
         osg::ref_ptr<const osg::Node> getTemplate(const std::string& name, bool compile = true);
 
+        /// Start loading a scene "template" on the work queue without waiting for it
+        /// @return the future template, already available if the scene is loaded. Without a work queue the scene is
+        ///  loaded right away.
+        /// @note getTemplate for a requested scene waits for the request, or loads the scene itself if no work
+        ///  thread has picked it up yet.
+        /// @note Thread safe.
+        std::shared_future<osg::ref_ptr<const osg::Node>> requestTemplate(const std::string& name);
+
+        /// Set the work queue to load requested templates on, nullptr to load them on the requesting thread.
+        /// @note Waits for the requests already started on the previous work queue.
+        void setWorkQueue(osg::ref_ptr<SceneUtil::WorkQueue> workQueue);
+
         /// Clone osg::Node safely.
         /// @note Thread safe.
         static osg::ref_ptr<osg::Node> cloneNode(const osg::Node* base);
@@ -226,7 +251,27 @@ namespace Resource
         void setSoftParticles(bool enabled) { mSoftParticles = enabled; }
         bool getSoftParticles() const { return mSoftParticles; }
 
+        /// Set the number of threads helping to optimize loaded scenes, 0 to optimize them on the loading thread only.
+        void setOptimizerThreads(unsigned int numThreads);
+
+        /// @return the work queue used to optimize scenes in parallel, or nullptr if disabled
+        /// @par May be used to optimize other scene graphs than the ones loaded by this scene manager.
+        SceneUtil::WorkQueue* getOptimizerWorkQueue() const { return mOptimizerWorkQueue.get(); }
+
+        /// Store the scenes converted from NIF files in the given directory and read them back from there instead of
+        /// converting the files again. The oldest entries are removed when the directory grows over maxSize bytes.
+        /// @param version identifies the build, entries written by another build are never read
+        /// @note Must be called before any template is loaded.
+        void setBinarySceneCache(
+            const std::filesystem::path& directory, std::uint64_t maxSize, std::string_view version);
+
     private:
+        using PendingTemplates = PendingRequests<const osg::Node>;
+
+        osg::ref_ptr<const osg::Node> loadTemplate(const std::string& normalized, bool compile);
+        osg::ref_ptr<const osg::Node> loadCachedTemplate(const std::string& normalized, bool compile);
+        osg::ref_ptr<osg::Node> loadCachedNif(const std::string& normalized);
+
         Shader::ShaderVisitor* createShaderVisitor(const std::string& shaderPrefix = "objects");
         osg::ref_ptr<osg::Node> loadErrorMarker();
         osg::ref_ptr<osg::Node> cloneErrorMarker();
@@ -250,6 +295,8 @@ namespace Resource
 
         osg::ref_ptr<Resource::SharedStateManager> mSharedStateManager;
         mutable std::mutex mSharedStateMutex;
+        // State attributes are shared when the NIF loader makes them, the state sets once the scenes are processed
+        std::unique_ptr<SceneUtil::StateRegistry> mStateRegistry;
 
         Resource::ImageManager* mImageManager;
         Resource::NifFileManager* mNifFileManager;
@@ -261,6 +308,15 @@ namespace Resource
 
         osg::ref_ptr<osgUtil::IncrementalCompileOperation> mIncrementalCompileOperation;
 
+        osg::ref_ptr<SceneUtil::WorkQueue> mOptimizerWorkQueue;
+
+        std::unique_ptr<BinarySceneCache> mBinarySceneCache;
+
+        PendingTemplates mPendingTemplates;
+        // Loads on this thread stall the frame, it's the one creating the scene manager and rendering
+        const std::thread::id mMainThreadId;
+        std::atomic<std::size_t> mNumSyncLoads{ 0 };
+
         unsigned int mParticleSystemMask;
         mutable osg::ref_ptr<osg::Node> mErrorMarker;
 
@@ -428,31 +428,71 @@ namespace Resource
                 "",
                 "Texture",
                 "StateSet",
+                "State Attribute",
+                "State Attribute Created",
+                "State Attribute Shared",
                 "Node",
+                "Node Sync Load",
+                "Node Pending",
+                "Node Cache Hit",
+                "Node Cache Miss",
                 "Shape",
                 "Shape Instance",
                 "Image",
+                "Image Memory",
+                "Image Pending",
                 "Nif",
                 "Keyframe",
                 "",
                 "Groundcover Chunk",
                 "Object Chunk",
+                "Object Chunk Rebuild",
+                "Object Chunk Patch",
+                "Object Chunk Churn",
                 "Terrain Chunk",
+                "Terrain Chunk Disk Hit",
+                "Terrain Blendmap",
                 "Terrain Texture",
                 "Land",
                 "Composite",
+                "Composite Pending",
+                "Composite Prepare us",
+                "Composite Compile us",
                 "",
                 "NavMesh Jobs",
                 "NavMesh Waiting",
                 "NavMesh Pushed",
                 "NavMesh Processing",
+                "NavMesh SkippedRebuilds",
+                "NavMesh PerformedRebuilds",
                 "NavMesh DbJobs Write",
                 "NavMesh DbJobs Read",
+                "NavMesh DbTiles Written",
+                "NavMesh DbTransactions",
                 "NavMesh DbCacheHitRate",
                 "NavMesh CacheSize",
                 "NavMesh UsedTiles",
                 "NavMesh CachedTiles",
                 "NavMesh CacheHitRate",
+                "NavMesh ArenaAllocations",
+                "NavMesh HeapAllocations",
+                "NavMesh ArenaCapacity",
+                "NavMesh ArenaHighWaterMark",
+                "",
+                "PathQuery Waiting",
+                "PathQuery Posted",
+                "PathQuery Deduplicated",
+                "PathQuery Cancelled",
+                "PathQuery Processed",
+                "PathQuery ProcessedByCaller",
+                "PathQuery Latency <1ms",
+                "PathQuery Latency <2ms",
+                "PathQuery Latency <4ms",
+                "PathQuery Latency <8ms",
+                "PathQuery Latency <16ms",
+                "PathQuery Latency <32ms",
+                "PathQuery Latency <64ms",
+                "PathQuery Latency >=64ms",
                 "",
                 "Mechanics Actors",
                 "Mechanics Objects",
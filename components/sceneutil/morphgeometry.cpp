@@ -172,9 +172,12 @@ namespace SceneUtil
 
     void MorphGeometry::cull(osg::NodeVisitor* nv)
     {
+        // The shadow map splits may be culled on several threads at once, the first one morphs the geometry
+        std::unique_lock lock(mMutex);
         if (mLastFrameNumber == nv->getTraversalNumber() || !mDirty || mMorphTargets.size() == 0)
         {
             osg::Geometry& geom = *getGeometry(mLastFrameNumber);
+            lock.unlock();
             nv->pushOntoNodePath(&geom);
             nv->apply(geom);
             nv->popFromNodePath();
@@ -204,6 +207,7 @@ namespace SceneUtil
         positionDst->dirty();
 
         geom.osg::Drawable::dirtyGLObjects();
+        lock.unlock();
 
         nv->pushOntoNodePath(&geom);
         nv->apply(geom);
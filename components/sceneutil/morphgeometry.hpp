@@ -3,6 +3,8 @@
 
 #include <osg/Geometry>
 
+#include <mutex>
+
 namespace SceneUtil
 {
 
@@ -85,6 +87,8 @@ namespace SceneUtil
 
         unsigned int mLastFrameNumber;
         bool mDirty; // Have any morph targets changed?
+        // Guards the morphing, culls of the shadow map splits may run in parallel
+        std::mutex mMutex;
 
         mutable bool mMorphedBoundingBox;
     };
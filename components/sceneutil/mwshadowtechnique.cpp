@@ -232,6 +232,33 @@ public:
     }
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// SplitCullWorkItem
+//
+class SplitCullWorkItem : public SceneUtil::WorkItem
+{
+    public:
+
+        SplitCullWorkItem(const MWShadowTechnique* vdsm, osgUtil::CullVisitor* cv, osg::Camera* camera):
+            _vdsm(vdsm),
+            _cv(cv),
+            _camera(camera)
+        {
+        }
+
+        void doWork() override
+        {
+            _vdsm->cullShadowCastingScene(_cv, _camera);
+        }
+
+    protected:
+
+        const MWShadowTechnique*                _vdsm;
+        osgUtil::CullVisitor*                   _cv;
+        osg::Camera*                            _camera;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////
 //
 // VDSMCameraCullCallback
@@ -935,6 +962,17 @@ void SceneUtil::MWShadowTechnique::setupCastingShader(Shader::ShaderManager & sh
     }
 }
 
+void SceneUtil::MWShadowTechnique::setParallelCull(unsigned int numWorkerThreads)
+{
+    if (numWorkerThreads == 0)
+    {
+        _cullWorkQueue = nullptr;
+        return;
+    }
+
+    _cullWorkQueue = new WorkQueue(numWorkerThreads);
+}
+
 MWShadowTechnique::ViewDependentData* MWShadowTechnique::createViewDependentData(osgUtil::CullVisitor* /*cv*/)
 {
     return new ViewDependentData(this);
@@ -1190,6 +1228,7 @@ void MWShadowTechnique::cull(osgUtil::CullVisitor& cv)
     previous_sdl.swap(sdl);
 
     unsigned int numShadowMapsPerLight = settings->getNumShadowMapsPerLight();
+    std::size_t numSplits = 0;
 
     LightDataList& pll = vdd->getLightDataList();
     for(LightDataList::iterator itr = pll.begin();
@@ -1334,6 +1373,16 @@ void MWShadowTechnique::cull(osgUtil::CullVisitor& cv)
         }
 #endif
 
+        struct SplitData
+        {
+            osg::ref_ptr<ShadowData> sd;
+            osg::ref_ptr<VDSMCameraCullCallback> vdsmCallback;
+            double cascaseNear;
+            double cascadeFar;
+        };
+        std::vector<SplitData> splits;
+        splits.reserve(numShadowMapsPerLight);
+
         // 4. For each light/shadow map
         for (unsigned int sm_i=0; sm_i<numShadowMapsPerLight; ++sm_i)
         {
@@ -1492,14 +1541,28 @@ void MWShadowTechnique::cull(osgUtil::CullVisitor& cv)
             osg::ref_ptr<VDSMCameraCullCallback> vdsmCallback = new VDSMCameraCullCallback(this, local_polytope);
             camera->setCullCallback(vdsmCallback.get());
 
-            // 4.3 traverse RTT camera
-            //
+            splits.push_back({ sd, vdsmCallback, cascaseNear, cascadeFar });
+        }
 
-            cv.pushStateSet(_shadowCastingStateSet.get());
+        // 4.3 traverse RTT cameras
+        //
+        {
+            std::vector<osg::Camera*> cameras;
+            cameras.reserve(splits.size());
+            for (const SplitData& split : splits)
+                cameras.push_back(split.sd->_camera.get());
 
-            cullShadowCastingScene(&cv, camera.get());
+            cullShadowCastingScenes(cv, *vdd, cameras, numSplits);
+            numSplits += cameras.size();
+        }
 
-            cv.popStateSet();
+        for (unsigned int sm_i=0; sm_i<splits.size(); ++sm_i)
+        {
+            osg::ref_ptr<ShadowData> sd = splits[sm_i].sd;
+            osg::ref_ptr<osg::Camera> camera = sd->_camera;
+            osg::ref_ptr<VDSMCameraCullCallback> vdsmCallback = splits[sm_i].vdsmCallback;
+            double cascaseNear = splits[sm_i].cascaseNear;
+            double cascadeFar = splits[sm_i].cascadeFar;
 
             if (!orthographicViewFrustum && settings->getShadowMapProjectionHint()==ShadowSettings::PERSPECTIVE_SHADOW_MAP)
             {
@@ -3123,6 +3186,113 @@ void MWShadowTechnique::cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Ca
     return;
 }
 
+void MWShadowTechnique::cullShadowCastingScenes(osgUtil::CullVisitor& cv, ViewDependentData& vdd, const std::vector<osg::Camera*>& cameras, std::size_t firstSplit)
+{
+    OSG_INFO<<"cullShadowCastingScenes()"<<std::endl;
+
+    if (!_cullWorkQueue || cameras.size() < 2)
+    {
+        for (osg::Camera* camera : cameras)
+        {
+            cv.pushStateSet(_shadowCastingStateSet.get());
+
+            cullShadowCastingScene(&cv, camera);
+
+            cv.popStateSet();
+        }
+        return;
+    }
+
+    // make sure lazily created state shared by all splits exists before the worker threads can race to create it
+    getOrCreateShadowsBinStateSet();
+
+    SplitCullDataList& splitCullDataList = vdd._splitCullDataList;
+    if (splitCullDataList.size() < firstSplit + cameras.size())
+        splitCullDataList.resize(firstSplit + cameras.size());
+
+    std::vector<osgUtil::CullVisitor*> splitCullVisitors;
+    splitCullVisitors.reserve(cameras.size());
+    for (std::size_t i = 0; i < cameras.size(); ++i)
+    {
+        osgUtil::CullVisitor* splitCv = prepareSplitCullVisitor(cv, splitCullDataList[firstSplit + i]);
+        splitCv->pushStateSet(_shadowCastingStateSet.get());
+        splitCullVisitors.push_back(splitCv);
+    }
+
+    // the first split is culled on this thread while the workers handle the rest
+    std::vector<osg::ref_ptr<SplitCullWorkItem>> workItems;
+    workItems.reserve(cameras.size() - 1);
+    for (std::size_t i = 1; i < cameras.size(); ++i)
+    {
+        workItems.push_back(new SplitCullWorkItem(this, splitCullVisitors[i], cameras[i]));
+        _cullWorkQueue->addWorkItem(workItems.back());
+    }
+
+    cullShadowCastingScene(splitCullVisitors[0], cameras[0]);
+
+    for (const auto& workItem : workItems)
+        workItem->waitTillDone();
+
+    // hand the RTT stages over to the main view in split order, matching what a serial traversal would produce
+    osgUtil::RenderStage* renderStage = cv.getCurrentRenderBin()->getStage();
+    for (std::size_t i = 0; i < cameras.size(); ++i)
+    {
+        SplitCullData& splitCullData = splitCullDataList[firstSplit + i];
+        splitCullVisitors[i]->popStateSet();
+
+        osgUtil::RenderStage::RenderStageList& preRenderList = splitCullData._renderStage->getPreRenderList();
+        for (const auto& [order, stage] : preRenderList)
+            renderStage->addPreRenderStage(stage.get(), order);
+        preRenderList.clear();
+
+        splitCullData._stateGraph->prune();
+    }
+}
+
+osgUtil::CullVisitor* MWShadowTechnique::prepareSplitCullVisitor(osgUtil::CullVisitor& cv, SplitCullData& splitCullData) const
+{
+    // The SplitCullData lives in the ViewDependentData of the main CullVisitor, so it is double buffered the same way
+    // and the RenderLeafs and StateGraph of the previous frame stay valid until the draw thread is done with them.
+    if (!splitCullData._cullVisitor)
+    {
+        splitCullData._cullVisitor = cv.clone();
+        splitCullData._stateGraph = new osgUtil::StateGraph;
+        splitCullData._renderStage = new osgUtil::RenderStage;
+    }
+
+    osgUtil::CullVisitor* splitCv = splitCullData._cullVisitor.get();
+    splitCv->reset();
+    splitCullData._stateGraph->clean();
+    splitCullData._renderStage->reset();
+    splitCullData._renderStage->setCamera(cv.getCurrentCamera());
+
+    splitCv->setFrameStamp(const_cast<osg::FrameStamp*>(cv.getFrameStamp()));
+    splitCv->setTraversalNumber(cv.getTraversalNumber());
+    splitCv->setTraversalMask(cv.getTraversalMask());
+    splitCv->setNodeMaskOverride(cv.getNodeMaskOverride());
+    splitCv->setUserData(cv.getUserData());
+    splitCv->inheritCullSettings(cv);
+    splitCv->setRenderInfo(cv.getRenderInfo());
+    splitCv->setStateGraph(splitCullData._stateGraph.get());
+    splitCv->setRenderStage(splitCullData._renderStage.get());
+
+    splitCv->pushViewport(cv.getViewport());
+    splitCv->pushProjectionMatrix(cv.getProjectionMatrix());
+    splitCv->pushModelViewMatrix(cv.getModelViewMatrix(), osg::Transform::ABSOLUTE_RF);
+
+    // replay the state that is currently pushed on the main CullVisitor
+    std::vector<const osg::StateSet*> stateSets;
+    for (osgUtil::StateGraph* stateGraph = cv.getCurrentStateGraph(); stateGraph; stateGraph = stateGraph->_parent)
+    {
+        if (stateGraph->getStateSet())
+            stateSets.push_back(stateGraph->getStateSet());
+    }
+    for (auto itr = stateSets.rbegin(); itr != stateSets.rend(); ++itr)
+        splitCv->pushStateSet(*itr);
+
+    return splitCv;
+}
+
 osg::StateSet* MWShadowTechnique::prepareStateSetForRenderingShadow(ViewDependentData& vdd, unsigned int traversalNumber) const
 {
     OSG_INFO<<"   prepareStateSetForRenderingShadow() "<<vdd.getStateSet(traversalNumber)<<std::endl;
@@ -32,8 +32,13 @@
 
 #include <osgShadow/ShadowTechnique>
 
+#include <osgUtil/RenderStage>
+#include <osgUtil/StateGraph>
+
 #include <components/shader/shadermanager.hpp>
 
+#include "workqueue.hpp"
+
 namespace SceneUtil {
 
     /** ViewDependentShadowMap provides an base implementation of view dependent shadow mapping techniques.*/
@@ -88,6 +93,10 @@ namespace SceneUtil {
 
         virtual void setupCastingShader(Shader::ShaderManager &shaderManager);
 
+        /** Cull the shadow casting scene of each shadow map split concurrently on the given number of worker threads,
+         * in addition to the cull thread. Zero worker threads culls all splits on the cull thread. */
+        virtual void setParallelCull(unsigned int numWorkerThreads);
+
         class ComputeLightSpaceBounds : public osg::NodeVisitor, public osg::CullStack
         {
         public:
@@ -198,6 +207,16 @@ namespace SceneUtil {
 
         typedef std::list< osg::ref_ptr<ShadowData> > ShadowDataList;
 
+        /** Thread-local cull state used to traverse the casting scene of one shadow map split off the cull thread.
+         * The RenderStages created for the split's camera are moved into the main CullVisitor's RenderStage afterwards. */
+        struct SplitCullData
+        {
+            osg::ref_ptr<osgUtil::CullVisitor>  _cullVisitor;
+            osg::ref_ptr<osgUtil::StateGraph>   _stateGraph;
+            osg::ref_ptr<osgUtil::RenderStage>  _renderStage;
+        };
+
+        typedef std::vector<SplitCullData> SplitCullDataList;
 
         class ViewDependentData : public osg::Referenced
         {
@@ -228,6 +247,7 @@ namespace SceneUtil {
 
             LightDataList               _lightDataList;
             ShadowDataList              _shadowDataList;
+            SplitCullDataList           _splitCullDataList;
 
             unsigned int _numValidShadows;
         };
@@ -256,6 +276,13 @@ namespace SceneUtil {
 
         virtual void cullShadowCastingScene(osgUtil::CullVisitor* cv, osg::Camera* camera) const;
 
+        /** Cull the casting scene of every given shadow camera, on worker threads if parallel cull is enabled.
+         * firstSplit is the index of the first camera among all splits of this view, used to pick its thread-local cull state. */
+        virtual void cullShadowCastingScenes(osgUtil::CullVisitor& cv, ViewDependentData& vdd, const std::vector<osg::Camera*>& cameras, std::size_t firstSplit);
+
+        /** Set up a split's CullVisitor so it continues from the current state of the main CullVisitor. */
+        osgUtil::CullVisitor* prepareSplitCullVisitor(osgUtil::CullVisitor& cv, SplitCullData& splitCullData) const;
+
         virtual osg::StateSet* prepareStateSetForRenderingShadow(ViewDependentData& vdd, unsigned int traversalNumber) const;
 
         void setWorldMask(unsigned int worldMask) { _worldMask = worldMask; }
@@ -299,6 +326,8 @@ namespace SceneUtil {
 
         unsigned int                            _worldMask = ~0u;
 
+        osg::ref_ptr<WorkQueue>                 _cullWorkQueue;
+
         class DebugHUD final : public osg::Referenced
         {
         public:
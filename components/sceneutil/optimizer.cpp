@@ -35,11 +35,16 @@
 #include <osgUtil/MeshOptimizers>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 #include <numeric>
+#include <typeinfo>
 
 #include <iterator>
 
 #include <components/sceneutil/depth.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 using namespace osgUtil;
 
@@ -50,7 +55,195 @@ void Optimizer::reset()
 {
 }
 
+namespace
+{
+
+bool canSplitChildren(const osg::Group& group)
+{
+    // Node types that keep per child data, e.g. LOD ranges, would lose it when their children are detached.
+    return std::strcmp(group.className(), "Group") == 0 || std::strcmp(group.className(), "MatrixTransform") == 0;
+}
+
+class IsTreeVisitor : public osg::NodeVisitor
+{
+    public:
+
+        IsTreeVisitor() : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN), _isTree(true)
+        {
+            setNodeMaskOverride(0xffffffff);
+        }
+
+        void apply(osg::Node& node) override
+        {
+            // Shared state sets have their parent lists changed when the nodes using them are replaced.
+            if (node.getNumParents() > 1 || (node.getStateSet() && node.getStateSet()->getNumParents() > 1))
+                _isTree = false;
+            else if (_isTree)
+                traverse(node);
+        }
+
+        void apply(osg::Geometry& geometry) override
+        {
+            // Flattening transforms and merging change the arrays and primitive sets in place.
+            osg::Geometry::ArrayList arrays;
+            geometry.getArrayList(arrays);
+            for (const osg::ref_ptr<osg::Array>& array : arrays) // Referenced by the geometry and the list
+                if (array->referenceCount() > 2)
+                    _isTree = false;
+            for (const osg::ref_ptr<osg::PrimitiveSet>& primitiveSet : geometry.getPrimitiveSetList())
+                if (primitiveSet->referenceCount() > 1)
+                    _isTree = false;
+            apply(static_cast<osg::Node&>(geometry));
+        }
+
+        bool _isTree;
+};
+
+class OptimizeSubgraphsWorkItem : public WorkItem
+{
+    public:
+
+        OptimizeSubgraphsWorkItem(Optimizer& optimizer, unsigned int options, const Optimizer::StateSetList& stateSets) :
+            _optimizer(optimizer), _options(options), _stateSets(stateSets), _claimed(false) {}
+
+        void addSubgraph(osg::Group* holder) { _holders.push_back(holder); }
+
+        /// Ensures the work is done only once, by whichever of the caller and the worker thread gets to it first.
+        bool claim() { return !_claimed.exchange(true); }
+
+        void doWork() override
+        {
+            if (claim())
+                run();
+        }
+
+        void run()
+        {
+            for (const osg::ref_ptr<osg::Group>& holder : _holders)
+                _optimizer.optimizeSubgraph(holder, _options, _stateSets);
+            _holders.clear();
+        }
+
+    private:
+
+        Optimizer& _optimizer;
+        const unsigned int _options;
+        const Optimizer::StateSetList _stateSets;
+        std::vector<osg::ref_ptr<osg::Group>> _holders;
+        std::atomic_bool _claimed;
+};
+
+}
+
 void Optimizer::optimize(osg::Node* node, unsigned int options)
+{
+    // Passes whose result is complete once done on every child in parallel are not repeated over the whole graph.
+    if (_workQueue)
+        options &= ~optimizeChildrenInParallel(node, options);
+
+    optimizeSubgraph(node, options, StateSetList());
+}
+
+unsigned int Optimizer::optimizeChildrenInParallel(osg::Node* node, unsigned int options)
+{
+    options &= FLATTEN_STATIC_TRANSFORMS | SHARE_DUPLICATE_STATE | REMOVE_REDUNDANT_NODES | MERGE_GEOMETRY;
+    const std::size_t numThreads = _workQueue->getNumThreads();
+    if (options == 0 || numThreads == 0)
+        return 0;
+
+    // Find the first node that branches, collecting the state sets above its children.
+    StateSetList stateSets;
+    bool transformAbove = false;
+    osg::Group* group = node->asGroup();
+    while (group && group->getNumChildren() == 1 && canSplitChildren(*group))
+    {
+        transformAbove = transformAbove || group->asTransform() != nullptr;
+        if (group->getStateSet())
+            stateSets.push_back(group->getStateSet());
+        osg::Node* child = group->getChild(0);
+        if (child->getNumParents() > 1)
+            return 0;
+        group = child->asGroup();
+    }
+    if (!group || group->getNumChildren() < 2 || !canSplitChildren(*group))
+        return 0;
+    transformAbove = transformAbove || group->asTransform() != nullptr;
+    if (group->getStateSet())
+        stateSets.push_back(group->getStateSet());
+
+    // Only children not sharing any node or data with the rest of the graph can be optimized independently.
+    std::vector<osg::ref_ptr<osg::Node>> children(group->getNumChildren());
+    std::vector<bool> independent(children.size());
+    std::size_t numIndependent = 0;
+    for (unsigned int i = 0; i < group->getNumChildren(); ++i)
+    {
+        children[i] = group->getChild(i);
+        IsTreeVisitor isTreeVisitor;
+        children[i]->accept(isTreeVisitor);
+        independent[i] = isTreeVisitor._isTree;
+        numIndependent += isTreeVisitor._isTree;
+    }
+    if (numIndependent < 2)
+        return 0;
+
+    // Detached subgraphs do not propagate bound and traversal count updates to the shared parent while they are
+    // modified concurrently. Each one gets a holder group so that its root can be replaced like any other node.
+    group->removeChildren(0, group->getNumChildren());
+
+    std::vector<osg::ref_ptr<OptimizeSubgraphsWorkItem>> items(std::min(numIndependent, numThreads + 1));
+    for (osg::ref_ptr<OptimizeSubgraphsWorkItem>& item : items)
+        item = new OptimizeSubgraphsWorkItem(*this, options, stateSets);
+
+    // The other children may share data with each other, they are optimized together on this thread, placed where
+    // the first of them was.
+    std::vector<osg::ref_ptr<osg::Group>> holders(children.size());
+    osg::ref_ptr<osg::Group> sharedHolder;
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < children.size(); ++i)
+    {
+        if (!independent[i])
+        {
+            if (!sharedHolder)
+                holders[i] = sharedHolder = new osg::Group;
+            sharedHolder->addChild(children[i]);
+            continue;
+        }
+        holders[i] = new osg::Group;
+        holders[i]->addChild(children[i]);
+        items[next++ % items.size()]->addSubgraph(holders[i]);
+    }
+
+    for (std::size_t i = 1; i < items.size(); ++i)
+        _workQueue->addWorkItem(items[i]);
+
+    if (sharedHolder)
+        optimizeSubgraph(sharedHolder, options, stateSets);
+
+    // Items no worker has picked up yet are done on this thread, so waiting never depends on the queue making progress.
+    for (const osg::ref_ptr<OptimizeSubgraphsWorkItem>& item : items)
+    {
+        if (item->claim())
+            item->run();
+        else
+            item->waitTillDone();
+    }
+
+    for (std::size_t i = 0; i < children.size(); ++i)
+    {
+        if (!holders[i])
+            continue;
+        const osg::Group::NodeList optimized = holders[i]->getChildren();
+        holders[i]->removeChildren(0, holders[i]->getNumChildren());
+        for (const osg::ref_ptr<osg::Node>& child : optimized)
+            group->addChild(child);
+    }
+
+    // Sharing state, merging geometries and removing nodes work across the children, so they still need the whole
+    // graph. Static transforms are all flattened unless one is above the children.
+    return transformAbove ? 0 : (options & FLATTEN_STATIC_TRANSFORMS);
+}
+
+void Optimizer::optimizeSubgraph(osg::Node* node, unsigned int options, const StateSetList& parentStateSets)
 {
     StatsVisitor stats;
 
@@ -116,6 +309,8 @@ void Optimizer::optimize(osg::Node* node, unsigned int options)
         mgv.setTargetMaximumNumberOfVertices(1000000);
         mgv.setMergeAlphaBlending(_mergeAlphaBlending);
         mgv.setViewPoint(_viewPoint);
+        for (osg::StateSet* stateSet : parentStateSets)
+            mgv.pushStateSet(stateSet);
         node->accept(mgv);
 
         osg::Timer_t endTick = osg::Timer::instance()->tick();
@@ -369,6 +564,77 @@ class CollectLowestTransformsVisitor : public BaseOptimizerVisitor
 };
 
 
+namespace
+{
+
+bool isAffine(const osg::Matrix& matrix)
+{
+    return matrix(0,3) == 0.0 && matrix(1,3) == 0.0 && matrix(2,3) == 0.0 && matrix(3,3) == 1.0;
+}
+
+// The loops below are kept free of calls and branches so that they can be vectorized by the compiler.
+
+void transformPositions(osg::Vec3Array& array, const osg::Matrix& matrix)
+{
+    if (array.empty())
+        return;
+    const float m00 = matrix(0,0), m01 = matrix(0,1), m02 = matrix(0,2);
+    const float m10 = matrix(1,0), m11 = matrix(1,1), m12 = matrix(1,2);
+    const float m20 = matrix(2,0), m21 = matrix(2,1), m22 = matrix(2,2);
+    const float m30 = matrix(3,0), m31 = matrix(3,1), m32 = matrix(3,2);
+    float* const data = &array.front().x();
+    const std::size_t size = array.size() * 3;
+    for (std::size_t i = 0; i < size; i += 3)
+    {
+        const float x = data[i], y = data[i+1], z = data[i+2];
+        data[i]   = x * m00 + y * m10 + z * m20 + m30;
+        data[i+1] = x * m01 + y * m11 + z * m21 + m31;
+        data[i+2] = x * m02 + y * m12 + z * m22 + m32;
+    }
+}
+
+/// Same as osg::Matrix::transform3x3(inverse, v) followed by normalization, for elements with the given number of
+/// components of which the first three are a direction.
+template <std::size_t stride>
+void transformDirections(float* data, std::size_t numElements, const osg::Matrix& inverse)
+{
+    const float m00 = inverse(0,0), m01 = inverse(0,1), m02 = inverse(0,2);
+    const float m10 = inverse(1,0), m11 = inverse(1,1), m12 = inverse(1,2);
+    const float m20 = inverse(2,0), m21 = inverse(2,1), m22 = inverse(2,2);
+    const std::size_t size = numElements * stride;
+    for (std::size_t i = 0; i < size; i += stride)
+    {
+        const float x = data[i], y = data[i+1], z = data[i+2];
+        const float tx = m00 * x + m01 * y + m02 * z;
+        const float ty = m10 * x + m11 * y + m12 * z;
+        const float tz = m20 * x + m21 * y + m22 * z;
+        const float length = std::sqrt(tx * tx + ty * ty + tz * tz);
+        const float scale = length > 0.f ? 1.f / length : 1.f;
+        data[i]   = tx * scale;
+        data[i+1] = ty * scale;
+        data[i+2] = tz * scale;
+    }
+}
+
+/// @return false if the geometry has arrays of a layout that must be handled by osgUtil::TransformAttributeFunctor
+bool transformGeometry(osg::Geometry& geometry, const osg::Matrix& matrix, const osg::Matrix& inverse)
+{
+    // Subclasses may expose different arrays through osg::Drawable::accept(AttributeFunctor&).
+    if (typeid(geometry) != typeid(osg::Geometry) || !isAffine(matrix))
+        return false;
+    osg::Vec3Array* vertices = dynamic_cast<osg::Vec3Array*>(geometry.getVertexArray());
+    osg::Vec3Array* normals = dynamic_cast<osg::Vec3Array*>(geometry.getNormalArray());
+    if (!vertices || (!normals && geometry.getNormalArray()))
+        return false;
+
+    transformPositions(*vertices, matrix);
+    if (normals && !normals->empty())
+        transformDirections<3>(&normals->front().x(), normals->size(), inverse);
+    return true;
+}
+
+}
+
 void CollectLowestTransformsVisitor::doTransform(osg::Object* obj,osg::Matrix& matrix)
 {
     osg::Node* node = obj->asNode();
@@ -377,23 +643,19 @@ void CollectLowestTransformsVisitor::doTransform(osg::Object* obj,osg::Matrix& m
     osg::Drawable* drawable = node->asDrawable();
     if (drawable)
     {
-        osgUtil::TransformAttributeFunctor tf(matrix);
-        drawable->accept(tf);
+        const osg::Matrix inverse = osg::Matrix::inverse(matrix);
 
         osg::Geometry *geom = drawable->asGeometry();
-        osg::Vec4Array* tangents = geom ? dynamic_cast<osg::Vec4Array*>(geom->getTexCoordArray(7)) : nullptr;
-        if (tangents)
+        if (!geom || !transformGeometry(*geom, matrix, inverse))
         {
-            for (unsigned int i=0; i<tangents->size(); ++i)
-            {
-                osg::Vec4f& itr = (*tangents)[i];
-                osg::Vec3f vec3 (itr.x(), itr.y(), itr.z());
-                vec3 = osg::Matrix::transform3x3(tf._im, vec3);
-                vec3.normalize();
-                itr = osg::Vec4f(vec3.x(), vec3.y(), vec3.z(), itr.w());
-            }
+            osgUtil::TransformAttributeFunctor tf(matrix);
+            drawable->accept(tf);
         }
 
+        osg::Vec4Array* tangents = geom ? dynamic_cast<osg::Vec4Array*>(geom->getTexCoordArray(7)) : nullptr;
+        if (tangents && !tangents->empty())
+            transformDirections<4>(&tangents->front().x(), tangents->size(), inverse);
+
         drawable->dirtyBound();
         drawable->dirtyDisplayList();
 
@@ -1197,6 +1459,41 @@ bool containsSharedPrimitives(const osg::Geometry* geom)
     return false;
 }
 
+namespace
+{
+
+/// Avoid repeated reallocations of the arrays the rest of the list will be appended to.
+void reserveMergedArrays(osg::Geometry& lhs, const std::vector<osg::ref_ptr<osg::Geometry>>& duplicateList)
+{
+    const osg::Array* vertices = lhs.getVertexArray();
+    if (!vertices)
+        return;
+    const unsigned int numLhsVertices = vertices->getNumElements();
+    unsigned int numVertices = 0;
+    for (const osg::ref_ptr<osg::Geometry>& geometry : duplicateList)
+        numVertices += geometry->getVertexArray() ? geometry->getVertexArray()->getNumElements() : 0;
+
+    auto reserve = [&] (osg::Array* array)
+    {
+        // Shared arrays are copied on merge, and must not be reallocated while others may read them.
+        if (array && array->referenceCount() == 1 && array->getBinding() == osg::Array::BIND_PER_VERTEX
+            && array->getNumElements() == numLhsVertices)
+            array->reserveArray(numVertices);
+    };
+
+    reserve(lhs.getVertexArray());
+    reserve(lhs.getNormalArray());
+    reserve(lhs.getColorArray());
+    reserve(lhs.getSecondaryColorArray());
+    reserve(lhs.getFogCoordArray());
+    for (unsigned int i = 0; i < lhs.getNumTexCoordArrays(); ++i)
+        reserve(lhs.getTexCoordArray(i));
+    for (unsigned int i = 0; i < lhs.getNumVertexAttribArrays(); ++i)
+        reserve(lhs.getVertexAttribArray(i));
+}
+
+}
+
 bool Optimizer::MergeGeometryVisitor::mergeGroup(osg::Group& group)
 {
     if (!isOperationPermissibleForObject(&group)) return false;
@@ -1363,6 +1660,7 @@ bool Optimizer::MergeGeometryVisitor::mergeGroup(osg::Group& group)
                     DuplicateList::iterator ditr = duplicateList.begin();
                     osg::ref_ptr<osg::Geometry> lhs = *ditr++;
                     group.addChild(lhs.get());
+                    reserveMergedArrays(*lhs, duplicateList);
                     for(;
                         ditr != duplicateList.end();
                         ++ditr)
@@ -1780,20 +2078,16 @@ bool Optimizer::MergeGeometryVisitor::mergeGeometry(osg::Geometry& lhs,osg::Geom
         case(osg::PrimitiveSet::DrawElementsUBytePrimitiveType):
             {
                 osg::DrawElementsUByte* primitiveUByte = static_cast<osg::DrawElementsUByte*>(primitive);
-                unsigned int currentMaximum = 0;
-                for(osg::DrawElementsUByte::iterator eitr=primitiveUByte->begin();
-                    eitr!=primitiveUByte->end();
-                    ++eitr)
-                {
-                    currentMaximum = osg::maximum(currentMaximum,(unsigned int)*eitr);
-                }
+                const unsigned int currentMaximum = primitiveUByte->empty() ? 0u
+                    : static_cast<unsigned int>(*std::max_element(primitiveUByte->begin(), primitiveUByte->end()));
                 if ((base+currentMaximum)>=65536)
                 {
                     // must promote to a DrawElementsUInt
                     osg::DrawElementsUInt* new_primitive = new osg::DrawElementsUInt(primitive->getMode());
                     if (!ebo) ebo = new osg::ElementBufferObject;
                     new_primitive->setElementBufferObject(ebo);
-                    std::copy(primitiveUByte->begin(),primitiveUByte->end(),std::back_inserter(*new_primitive));
+                    new_primitive->reserve(primitiveUByte->size());
+                    new_primitive->insert(new_primitive->end(), primitiveUByte->begin(), primitiveUByte->end());
                     new_primitive->offsetIndices(base);
                     (*primItr) = new_primitive;
                 } else if ((base+currentMaximum)>=256)
@@ -1802,7 +2096,8 @@ bool Optimizer::MergeGeometryVisitor::mergeGeometry(osg::Geometry& lhs,osg::Geom
                     osg::DrawElementsUShort* new_primitive = new osg::DrawElementsUShort(primitive->getMode());
                     if (!ebo) ebo = new osg::ElementBufferObject;
                     new_primitive->setElementBufferObject(ebo);
-                    std::copy(primitiveUByte->begin(),primitiveUByte->end(),std::back_inserter(*new_primitive));
+                    new_primitive->reserve(primitiveUByte->size());
+                    new_primitive->insert(new_primitive->end(), primitiveUByte->begin(), primitiveUByte->end());
                     new_primitive->offsetIndices(base);
                     (*primItr) = new_primitive;
                 }
@@ -1817,20 +2112,16 @@ bool Optimizer::MergeGeometryVisitor::mergeGeometry(osg::Geometry& lhs,osg::Geom
         case(osg::PrimitiveSet::DrawElementsUShortPrimitiveType):
             {
                 osg::DrawElementsUShort* primitiveUShort = static_cast<osg::DrawElementsUShort*>(primitive);
-                unsigned int currentMaximum = 0;
-                for(osg::DrawElementsUShort::iterator eitr=primitiveUShort->begin();
-                    eitr!=primitiveUShort->end();
-                    ++eitr)
-                {
-                    currentMaximum = osg::maximum(currentMaximum,(unsigned int)*eitr);
-                }
+                const unsigned int currentMaximum = primitiveUShort->empty() ? 0u
+                    : static_cast<unsigned int>(*std::max_element(primitiveUShort->begin(), primitiveUShort->end()));
                 if ((base+currentMaximum)>=65536)
                 {
                     // must promote to a DrawElementsUInt
                     osg::DrawElementsUInt* new_primitive = new osg::DrawElementsUInt(primitive->getMode());
                     if (!ebo) ebo = new osg::ElementBufferObject;
                     new_primitive->setElementBufferObject(ebo);
-                    std::copy(primitiveUShort->begin(),primitiveUShort->end(),std::back_inserter(*new_primitive));
+                    new_primitive->reserve(primitiveUShort->size());
+                    new_primitive->insert(new_primitive->end(), primitiveUShort->begin(), primitiveUShort->end());
                     new_primitive->offsetIndices(base);
                     (*primItr) = new_primitive;
                 }
@@ -27,6 +27,7 @@
 
 #include <set>
 #include <mutex>
+#include <vector>
 
 namespace osgDB
 {
@@ -38,6 +39,7 @@ namespace SceneUtil {
 
 // forward declare
 class Optimizer;
+class WorkQueue;
 
 /** Helper base class for implementing Optimizer techniques.*/
 class BaseOptimizerVisitor : public osg::NodeVisitor
@@ -72,7 +74,7 @@ class Optimizer
 
     public:
 
-        Optimizer() : _mergeAlphaBlending(false), _sharedStateManager(nullptr), _sharedStateMutex(nullptr) {}
+        Optimizer() : _mergeAlphaBlending(false), _sharedStateManager(nullptr), _sharedStateMutex(nullptr), _workQueue(nullptr) {}
         virtual ~Optimizer() {}
 
         enum OptimizationOptions
@@ -130,6 +132,12 @@ class Optimizer
 
         void setSharedStateManager(osgDB::SharedStateManager* sharedStateManager, std::mutex* sharedStateMutex) { _sharedStateMutex = sharedStateMutex; _sharedStateManager = sharedStateManager; }
 
+        /** Optimize independent subgraphs in parallel on the given work queue before the passes over the whole graph.
+          * The work queue must not be the one optimize() is called from, as its threads would wait on each other.*/
+        void setWorkQueue(WorkQueue* workQueue) { _workQueue = workQueue; }
+
+        typedef std::vector<osg::StateSet*> StateSetList;
+
         /** Reset internal data to initial state - the getPermissibleOptionsMap is cleared.*/
         void reset();
 
@@ -137,6 +145,10 @@ class Optimizer
           * visitors, specified by the OptimizationOptions.*/
         virtual void optimize(osg::Node* node, unsigned int options);
 
+        /** Same as optimize(), but never splits the work and assumes the node is attached below the given state sets,
+          * which matters for the MERGE_GEOMETRY pass.*/
+        void optimizeSubgraph(osg::Node* node, unsigned int options, const StateSetList& parentStateSets);
+
 
         /** Callback for customizing what operations are permitted on objects in the scene graph.*/
         struct IsOperationPermissibleForObjectCallback : public osg::Referenced
@@ -270,6 +282,13 @@ class Optimizer
         osgDB::SharedStateManager* _sharedStateManager;
         mutable std::mutex* _sharedStateMutex;
 
+        WorkQueue* _workQueue;
+
+        /** Optimize the children of the first branching node in parallel, each as an independent graph. Children
+          * sharing nodes or data with other parts of the graph are optimized together on the calling thread.
+          * @return the passes that don't need to be repeated over the whole graph.*/
+        unsigned int optimizeChildrenInParallel(osg::Node* node, unsigned int options);
+
     public:
 
         /** Flatten Static Transform nodes by applying their transform to the
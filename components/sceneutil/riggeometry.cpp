@@ -157,19 +157,15 @@ namespace SceneUtil
             return false;
         }
 
-        mBoneNodesVector.clear();
+        mBoneIndices.clear();
         for (auto& bonePair : mBoneSphereVector->mData)
         {
             const std::string& boneName = bonePair.first;
-            Bone* bone = mSkeleton->getBone(boneName);
-            if (!bone)
-            {
-                mBoneNodesVector.push_back(nullptr);
+            const std::size_t bone = mSkeleton->getBone(boneName);
+            if (bone == Skeleton::sNoBone)
                 Log(Debug::Error) << "Error: RigGeometry did not find bone " << boneName;
-                continue;
-            }
 
-            mBoneNodesVector.push_back(bone);
+            mBoneIndices.push_back(bone);
         }
 
         for (auto& pair : mBone2VertexVector->mData)
@@ -177,15 +173,11 @@ namespace SceneUtil
             for (auto& weight : pair.first)
             {
                 const std::string& boneName = weight.first.first;
-                Bone* bone = mSkeleton->getBone(boneName);
-                if (!bone)
-                {
-                    mBoneNodesVector.push_back(nullptr);
+                const std::size_t bone = mSkeleton->getBone(boneName);
+                if (bone == Skeleton::sNoBone)
                     Log(Debug::Error) << "Error: RigGeometry did not find bone " << boneName;
-                    continue;
-                }
 
-                mBoneNodesVector.push_back(bone);
+                mBoneIndices.push_back(bone);
             }
         }
 
@@ -194,24 +186,37 @@ namespace SceneUtil
 
     void RigGeometry::cull(osg::NodeVisitor* nv)
     {
-        if (!mSkeleton)
+        unsigned int frameNumber = 0;
         {
-            Log(Debug::Error)
-                << "Error: RigGeometry rendering with no skeleton, should have been initialized by UpdateVisitor";
-            // try to recover anyway, though rendering is likely to be incorrect.
-            if (!initFromParentSkeleton(nv))
-                return;
-        }
+            // The shadow map splits may be culled on several threads at once, the first one skins the geometry
+            const std::lock_guard lock(mMutex);
 
-        unsigned int traversalNumber = nv->getTraversalNumber();
-        if (mLastFrameNumber == traversalNumber || (mLastFrameNumber != 0 && !mSkeleton->getActive()))
-        {
-            osg::Geometry& geom = *getGeometry(mLastFrameNumber);
-            nv->pushOntoNodePath(&geom);
-            nv->apply(geom);
-            nv->popFromNodePath();
-            return;
+            if (!mSkeleton)
+            {
+                Log(Debug::Error)
+                    << "Error: RigGeometry rendering with no skeleton, should have been initialized by UpdateVisitor";
+                // try to recover anyway, though rendering is likely to be incorrect.
+                if (!initFromParentSkeleton(nv))
+                    return;
+            }
+
+            frameNumber = skin(nv->getTraversalNumber());
         }
+
+        osg::Geometry& geom = *getGeometry(frameNumber);
+        nv->pushOntoNodePath(&geom);
+        nv->apply(geom);
+        nv->popFromNodePath();
+    }
+
+    unsigned int RigGeometry::skin(unsigned int traversalNumber)
+    {
+        // bones of a skeleton with a reduced update rate keep their pose until its next update
+        const bool skeletonUpdated = mSkeleton->getUpdateInterval() == 1
+            || mSkeleton->getLastUpdateFrameNumber() > mLastFrameNumber;
+        if (mLastFrameNumber == traversalNumber
+            || (mLastFrameNumber != 0 && (!mSkeleton->getActive() || !skeletonUpdated)))
+            return mLastFrameNumber;
         mLastFrameNumber = traversalNumber;
         osg::Geometry& geom = *getGeometry(mLastFrameNumber);
 
@@ -226,19 +231,21 @@ namespace SceneUtil
         osg::Vec3Array* normalDst = static_cast<osg::Vec3Array*>(geom.getNormalArray());
         osg::Vec4Array* tangentDst = static_cast<osg::Vec4Array*>(geom.getTexCoordArray(7));
 
-        int index = mBoneSphereVector->mData.size();
+        // the array is reallocated when bones are added, the matrices are read through it after the update
+        const std::lock_guard skeletonLock(mSkeleton->getMutex());
+        const std::vector<osg::Matrixf>& boneMatrices = mSkeleton->getBoneMatrices();
+        std::size_t index = mBoneSphereVector->mData.size();
         for (auto& pair : mBone2VertexVector->mData)
         {
             osg::Matrixf resultMat(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1);
 
             for (auto& weight : pair.first)
             {
-                Bone* bone = mBoneNodesVector[index];
-                if (bone == nullptr)
+                const std::size_t bone = mBoneIndices[index++];
+                if (bone == Skeleton::sNoBone)
                     continue;
 
-                accumulateMatrix(weight.first.second, bone->mMatrixInSkeletonSpace, weight.second, resultMat);
-                index++;
+                accumulateMatrix(weight.first.second, boneMatrices[bone], weight.second, resultMat);
             }
 
             if (mGeomToSkelMatrix)
@@ -268,9 +275,7 @@ namespace SceneUtil
 
         geom.osg::Drawable::dirtyGLObjects();
 
-        nv->pushOntoNodePath(&geom);
-        nv->apply(geom);
-        nv->popFromNodePath();
+        return mLastFrameNumber;
     }
 
     void RigGeometry::updateBounds(osg::NodeVisitor* nv)
@@ -291,19 +296,20 @@ namespace SceneUtil
 
         osg::BoundingBox box;
 
-        int index = 0;
+        const std::lock_guard skeletonLock(mSkeleton->getMutex());
+        const std::vector<osg::Matrixf>& boneMatrices = mSkeleton->getBoneMatrices();
+        std::size_t index = 0;
         for (auto& boundPair : mBoneSphereVector->mData)
         {
-            Bone* bone = mBoneNodesVector[index];
-            if (bone == nullptr)
+            const std::size_t bone = mBoneIndices[index++];
+            if (bone == Skeleton::sNoBone)
                 continue;
 
-            index++;
             osg::BoundingSpheref bs = boundPair.second;
             if (mGeomToSkelMatrix)
-                transformBoundingSphere(bone->mMatrixInSkeletonSpace * (*mGeomToSkelMatrix), bs);
+                transformBoundingSphere(boneMatrices[bone] * (*mGeomToSkelMatrix), bs);
             else
-                transformBoundingSphere(bone->mMatrixInSkeletonSpace, bs);
+                transformBoundingSphere(boneMatrices[bone], bs);
             box.expandBy(bs);
         }
 
@@ -4,10 +4,11 @@
 #include <osg/Geometry>
 #include <osg/Matrixf>
 
+#include <mutex>
+
 namespace SceneUtil
 {
     class Skeleton;
-    class Bone;
 
     // TODO: This class has a lot of issues.
     // - We require too many workarounds to ensure safety.
@@ -79,6 +80,10 @@ namespace SceneUtil
         void cull(osg::NodeVisitor* nv);
         void updateBounds(osg::NodeVisitor* nv);
 
+        /// Skin the geometry of the traversal unless it's already done, call with mMutex locked
+        /// @return frame number of the geometry to draw
+        unsigned int skin(unsigned int traversalNumber);
+
         osg::ref_ptr<osg::Geometry> mGeometry[2];
         osg::Geometry* getGeometry(unsigned int frame) const;
 
@@ -109,10 +114,13 @@ namespace SceneUtil
             std::vector<std::pair<std::string, osg::BoundingSpheref>> mData;
         };
         osg::ref_ptr<BoneSphereVector> mBoneSphereVector;
-        std::vector<Bone*> mBoneNodesVector;
+        // Indices into the bone matrices of the skeleton, first for mBoneSphereVector then for mBone2VertexVector
+        std::vector<std::size_t> mBoneIndices;
 
         unsigned int mLastFrameNumber;
         bool mBoundsFirstFrame;
+        // Guards the skinning, culls of the shadow map splits may run in parallel
+        std::mutex mMutex;
 
         bool initFromParentSkeleton(osg::NodeVisitor* nv);
 
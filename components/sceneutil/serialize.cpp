@@ -1,6 +1,8 @@
 #include "serialize.hpp"
 
+#include <osgDB/InputStream>
 #include <osgDB/ObjectWrapper>
+#include <osgDB/OutputStream>
 #include <osgDB/Registry>
 
 #include <components/nifosg/matrixtransform.hpp>
@@ -11,8 +13,41 @@
 #include <components/sceneutil/riggeometryosgaextension.hpp>
 #include <components/sceneutil/skeleton.hpp>
 
+#include <atomic>
+#include <mutex>
+
 namespace SceneUtil
 {
+    namespace
+    {
+        std::atomic<bool> sGeometryDataSerialized{ true };
+
+        bool checkDecomposedTransform(const NifOsg::MatrixTransform&)
+        {
+            return true;
+        }
+
+        // The matrix is serialized by the osg::MatrixTransform wrapper, the components are read as they are to not
+        // depend on the order of the properties
+        bool readDecomposedTransform(osgDB::InputStream& is, NifOsg::MatrixTransform& node)
+        {
+            is >> node.mScale;
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    is >> node.mRotationScale.mValues[i][j];
+            return true;
+        }
+
+        bool writeDecomposedTransform(osgDB::OutputStream& os, const NifOsg::MatrixTransform& node)
+        {
+            os << node.mScale;
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 3; ++j)
+                    os << node.mRotationScale.mValues[i][j];
+            os << std::endl;
+            return true;
+        }
+    }
 
     template <class Cls>
     static osg::Object* createInstanceFunc()
@@ -120,6 +155,9 @@ namespace SceneUtil
             : osgDB::ObjectWrapper(createInstanceFunc<NifOsg::MatrixTransform>, "NifOsg::MatrixTransform",
                 "osg::Object osg::Node osg::Group osg::Transform osg::MatrixTransform NifOsg::MatrixTransform")
         {
+            addSerializer(new osgDB::UserSerializer<NifOsg::MatrixTransform>("DecomposedTransform",
+                              &checkDecomposedTransform, &readDecomposedTransform, &writeDecomposedTransform),
+                osgDB::BaseSerializer::RW_USER);
         }
     };
 
@@ -138,11 +176,26 @@ namespace SceneUtil
         }
     };
 
+    void registerStorableSerializers()
+    {
+        static std::once_flag done;
+        std::call_once(done, [] {
+            osgDB::Registry::instance()->getObjectWrapperManager()->addWrapper(new MatrixTransformSerializer);
+        });
+    }
+
+    bool isGeometryDataSerialized()
+    {
+        return sGeometryDataSerialized;
+    }
+
     void registerSerializers()
     {
         static bool done = false;
         if (!done)
         {
+            registerStorableSerializers();
+
             osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
             mgr->addWrapper(new PositionAttitudeTransformSerializer);
             mgr->addWrapper(new SkeletonSerializer);
@@ -152,12 +205,12 @@ namespace SceneUtil
             mgr->addWrapper(new MorphGeometrySerializer);
             mgr->addWrapper(new LightManagerSerializer);
             mgr->addWrapper(new CameraRelativeTransformSerializer);
-            mgr->addWrapper(new MatrixTransformSerializer);
 
             // Don't serialize Geometry data as we are more interested in the overall structure rather than tons of
             // vertex data that would make the file large and hard to read.
             mgr->removeWrapper(mgr->findWrapper("osg::Geometry"));
             mgr->addWrapper(new GeometrySerializer);
+            sGeometryDataSerialized = false;
 
             // ignore the below for now to avoid warning spam
             const char* ignore[] = { "MWRender::PtrHolder", "Resource::TemplateRef", "Resource::TemplateMultiRef",
@@ -7,6 +7,14 @@ namespace SceneUtil
     /// Register osg node serializers for certain SceneUtil classes if not already done so
     void registerSerializers();
 
+    /// Register osg node serializers for the OpenMW classes that are written without losing any data, like the
+    /// scenes stored in the binary scene cache. Also done by registerSerializers.
+    void registerStorableSerializers();
+
+    /// registerSerializers replaces the osg::Geometry serializer with one ignoring the vertex data, so the scenes
+    /// written afterwards can't be read back
+    bool isGeometryDataSerialized();
+
 }
 
 #endif
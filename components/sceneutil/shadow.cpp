@@ -68,6 +68,11 @@ namespace SceneUtil
         else
             mShadowTechnique->disableFrontFaceCulling();
 
+        if (Settings::Manager::getBool("parallel cull", "Shadows"))
+            mShadowTechnique->setParallelCull(numberOfShadowMapsPerLight - 1);
+        else
+            mShadowTechnique->setParallelCull(0);
+
         if (Settings::Manager::getBool("allow shadow map overlap", "Shadows"))
             mShadowSettings->setMultipleShadowMapHint(osgShadow::ShadowSettings::CASCADED);
         else
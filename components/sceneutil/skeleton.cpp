@@ -2,11 +2,35 @@
 
 #include <osg/MatrixTransform>
 
-#include <components/debug/debuglog.hpp>
 #include <components/misc/strings/lower.hpp>
 
 #include <algorithm>
 
+namespace
+{
+    // Set while an update traversal is below a skeleton not updating its bones this frame
+    thread_local bool sBoneUpdateSkipped = false;
+
+    // Same as osg::Matrixf::mult but row by row on whole rows of the parent matrix, which compilers vectorize
+    void multiplyBoneMatrix(const osg::Matrixf& local, const osg::Matrixf& parent, osg::Matrixf& result)
+    {
+        const float* const lhs = local.ptr();
+        const float* const rhs = parent.ptr();
+        float* const out = result.ptr();
+        for (int row = 0; row < 4; ++row)
+        {
+            float sum[4];
+            for (int column = 0; column < 4; ++column)
+                sum[column] = lhs[row * 4] * rhs[column];
+            for (int k = 1; k < 4; ++k)
+                for (int column = 0; column < 4; ++column)
+                    sum[column] += lhs[row * 4 + k] * rhs[k * 4 + column];
+            for (int column = 0; column < 4; ++column)
+                out[row * 4 + column] = sum[column];
+        }
+    }
+}
+
 namespace SceneUtil
 {
 
@@ -39,6 +63,8 @@ namespace SceneUtil
         , mActive(Active)
         , mLastFrameNumber(0)
         , mLastCullFrameNumber(0)
+        , mUpdateInterval(1)
+        , mLastUpdateFrameNumber(0)
     {
     }
 
@@ -49,11 +75,15 @@ namespace SceneUtil
         , mActive(copy.mActive)
         , mLastFrameNumber(0)
         , mLastCullFrameNumber(0)
+        , mUpdateInterval(copy.mUpdateInterval)
+        , mLastUpdateFrameNumber(0)
     {
     }
 
-    Bone* Skeleton::getBone(const std::string& name)
+    std::size_t Skeleton::getBone(const std::string& name)
     {
+        const std::lock_guard lock(mMutex);
+
         if (!mBoneCacheInit)
         {
             InitBoneCacheVisitor visitor(mBoneCache);
@@ -63,30 +93,26 @@ namespace SceneUtil
 
         BoneCache::iterator found = mBoneCache.find(Misc::StringUtils::lowerCase(name));
         if (found == mBoneCache.end())
-            return nullptr;
-
-        // find or insert in the bone hierarchy
+            return sNoBone;
 
-        if (!mRootBone.get())
-        {
-            mRootBone = std::make_unique<Bone>();
-        }
+        // find or insert in the bone hierarchy, appending a bone after its parent keeps the topological order
 
-        Bone* bone = mRootBone.get();
+        std::size_t bone = sNoBone;
         for (osg::MatrixTransform* matrixTransform : found->second)
         {
-            const auto it = std::find_if(bone->mChildren.begin(), bone->mChildren.end(),
-                [&](const auto& v) { return v->mNode == matrixTransform; });
+            std::size_t child = bone == sNoBone ? 0 : bone + 1;
+            while (child < mBoneNodes.size() && (mBoneNodes[child] != matrixTransform || mBoneParents[child] != bone))
+                ++child;
 
-            if (it == bone->mChildren.end())
+            if (child == mBoneNodes.size())
             {
-                bone = bone->mChildren.emplace_back(std::make_unique<Bone>()).get();
+                mBoneNodes.push_back(matrixTransform);
+                mBoneParents.push_back(bone);
+                mBoneMatrices.emplace_back();
                 mNeedToUpdateBoneMatrices = true;
             }
-            else
-                bone = it->get();
 
-            bone->mNode = matrixTransform;
+            bone = child;
         }
 
         return bone;
@@ -94,6 +120,8 @@ namespace SceneUtil
 
     void Skeleton::updateBoneMatrices(unsigned int traversalNumber)
     {
+        const std::lock_guard lock(mMutex);
+
         if (traversalNumber != mLastFrameNumber)
             mNeedToUpdateBoneMatrices = true;
 
@@ -101,10 +129,13 @@ namespace SceneUtil
 
         if (mNeedToUpdateBoneMatrices)
         {
-            if (mRootBone.get())
+            for (std::size_t i = 0, n = mBoneNodes.size(); i < n; ++i)
             {
-                for (const auto& child : mRootBone->mChildren)
-                    child->update(nullptr);
+                const osg::Matrixf local(mBoneNodes[i]->getMatrix());
+                if (mBoneParents[i] == sNoBone)
+                    mBoneMatrices[i] = local;
+                else
+                    multiplyBoneMatrix(local, mBoneMatrices[mBoneParents[i]], mBoneMatrices[i]);
             }
 
             mNeedToUpdateBoneMatrices = false;
@@ -121,8 +152,19 @@ namespace SceneUtil
         return mActive != Inactive;
     }
 
+    void Skeleton::setUpdateInterval(unsigned int interval)
+    {
+        mUpdateInterval = std::max(interval, 1u);
+    }
+
+    bool Skeleton::isBoneUpdateSkipped()
+    {
+        return sBoneUpdateSkipped;
+    }
+
     void Skeleton::markDirty()
     {
+        const std::lock_guard lock(mMutex);
         mLastFrameNumber = 0;
         mBoneCache.clear();
         mBoneCacheInit = false;
@@ -136,6 +178,17 @@ namespace SceneUtil
                 return;
             if (mActive == SemiActive && mLastFrameNumber != 0 && mLastCullFrameNumber + 3 <= nv.getTraversalNumber())
                 return;
+
+            const bool skipBones
+                = mLastUpdateFrameNumber != 0 && nv.getTraversalNumber() - mLastUpdateFrameNumber < mUpdateInterval;
+            if (!skipBones)
+                mLastUpdateFrameNumber = nv.getTraversalNumber();
+
+            const bool parentBoneUpdateSkipped = sBoneUpdateSkipped;
+            sBoneUpdateSkipped = skipBones;
+            osg::Group::traverse(nv);
+            sBoneUpdateSkipped = parentBoneUpdateSkipped;
+            return;
         }
         else if (nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR)
             mLastCullFrameNumber = nv.getTraversalNumber();
@@ -153,25 +206,4 @@ namespace SceneUtil
         markDirty();
     }
 
-    Bone::Bone()
-        : mNode(nullptr)
-    {
-    }
-
-    void Bone::update(const osg::Matrixf* parentMatrixInSkeletonSpace)
-    {
-        if (!mNode)
-        {
-            Log(Debug::Error) << "Error: Bone without node";
-            return;
-        }
-        if (parentMatrixInSkeletonSpace)
-            mMatrixInSkeletonSpace = mNode->getMatrix() * (*parentMatrixInSkeletonSpace);
-        else
-            mMatrixInSkeletonSpace = mNode->getMatrix();
-
-        for (const auto& child : mChildren)
-            child->update(&mMatrixInSkeletonSpace);
-    }
-
 }
@@ -2,30 +2,19 @@
 #define OPENMW_COMPONENTS_NIFOSG_SKELETON_H
 
 #include <osg/Group>
+#include <osg/Matrixf>
 
-#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace SceneUtil
 {
 
-    /// @brief Defines a Bone hierarchy, used for updating of skeleton-space bone matrices.
-    /// @note To prevent unnecessary updates, only bones that are used for skinning will be added to this hierarchy.
-    class Bone
-    {
-    public:
-        Bone();
-
-        osg::Matrixf mMatrixInSkeletonSpace;
-
-        osg::MatrixTransform* mNode;
-
-        std::vector<std::unique_ptr<Bone>> mChildren;
-
-        /// Update the skeleton-space matrix of this bone and all its children.
-        void update(const osg::Matrixf* parentMatrixInSkeletonSpace);
-    };
-
     /// @brief Handles the bone matrices for any number of child RigGeometries.
     /// @par Bones should be created as osg::MatrixTransform children of the skeleton.
     /// To be a referenced by a RigGeometry, a bone needs to have a unique name.
@@ -37,12 +26,22 @@ namespace SceneUtil
 
         META_Node(SceneUtil, Skeleton)
 
-        /// Retrieve a bone by name.
-        Bone* getBone(const std::string& name);
+        static constexpr std::size_t sNoBone = std::numeric_limits<std::size_t>::max();
+
+        /// Retrieve the index of a bone by name, adding it and its parent bones to the hierarchy if necessary.
+        /// @return the index into getBoneMatrices or sNoBone if there is no such bone
+        std::size_t getBone(const std::string& name);
 
         /// Request an update of bone matrices. May be a no-op if already updated in this frame.
         void updateBoneMatrices(unsigned int traversalNumber);
 
+        /// Skeleton-space matrices of the bones, valid after updateBoneMatrices. Read them with getMutex locked when
+        /// bones may be added concurrently, as in parallel culls.
+        const std::vector<osg::Matrixf>& getBoneMatrices() const { return mBoneMatrices; }
+
+        /// Locked while bones are added or their matrices are updated
+        std::mutex& getMutex() const { return mMutex; }
+
         enum ActiveType
         {
             Inactive = 0,
@@ -56,6 +55,20 @@ namespace SceneUtil
 
         bool getActive() const;
 
+        /// Update the bones only every given number of frames, which saves animating and skinning of distant actors.
+        /// Bones are animated to the current time whenever they're updated, so changing the interval doesn't cause
+        /// the animation to drift. The other controllers below the skeleton still run every frame.
+        void setUpdateInterval(unsigned int interval);
+
+        /// Whether the controllers animating bones are to skip the current update traversal, because the skeleton
+        /// being traversed doesn't update its bones this frame.
+        static bool isBoneUpdateSkipped();
+
+        unsigned int getUpdateInterval() const { return mUpdateInterval; }
+
+        /// Traversal number of the last update traversal that animated the bones
+        unsigned int getLastUpdateFrameNumber() const { return mLastUpdateFrameNumber; }
+
         void traverse(osg::NodeVisitor& nv) override;
 
         void markDirty();
@@ -64,9 +77,12 @@ namespace SceneUtil
         void childRemoved(unsigned int, unsigned int) override;
 
     private:
-        // The root bone is not a "real" bone, it has no corresponding node in the scene graph.
-        // As far as the scene graph goes we support multiple root bones.
-        std::unique_ptr<Bone> mRootBone;
+        // Bone hierarchy in flat arrays, parents always come before their children so the matrices are updated in a
+        // single pass. Root bones have sNoBone as parent, as far as the scene graph goes we support multiple of them.
+        // To prevent unnecessary updates, only bones that are used for skinning are added to this hierarchy.
+        std::vector<osg::MatrixTransform*> mBoneNodes;
+        std::vector<std::size_t> mBoneParents;
+        std::vector<osg::Matrixf> mBoneMatrices;
 
         typedef std::unordered_map<std::string, std::vector<osg::MatrixTransform*>> BoneCache;
         BoneCache mBoneCache;
@@ -74,10 +90,16 @@ namespace SceneUtil
 
         bool mNeedToUpdateBoneMatrices;
 
+        mutable std::mutex mMutex;
+
         ActiveType mActive;
 
         unsigned int mLastFrameNumber;
-        unsigned int mLastCullFrameNumber;
+        // Written by the culls of every view, which may run in parallel
+        std::atomic<unsigned int> mLastCullFrameNumber;
+
+        unsigned int mUpdateInterval;
+        unsigned int mLastUpdateFrameNumber;
     };
 
 }
@@ -0,0 +1,139 @@
+#include "stateregistry.hpp"
+
+#include <osg/Material>
+#include <osg/Stats>
+#include <osg/Texture>
+
+#include <components/misc/hash.hpp>
+
+#include <typeinfo>
+
+namespace SceneUtil
+{
+    namespace
+    {
+        void hashVec4f(std::size_t& seed, const osg::Vec4f& value)
+        {
+            for (int i = 0; i < 4; ++i)
+                Misc::hashCombine(seed, value[i]);
+        }
+
+        bool isShareable(const osg::StateAttribute& attribute)
+        {
+            if (attribute.getUpdateCallback() != nullptr || attribute.getEventCallback() != nullptr
+                || attribute.getUserDataContainer() != nullptr)
+                return false;
+            if (const osg::Texture* texture = attribute.asTexture())
+            {
+                // Textures without images are placeholders filled by controllers
+                if (texture->getNumImages() == 0)
+                    return false;
+                for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                    if (texture->getImage(i) == nullptr)
+                        return false;
+            }
+            return true;
+        }
+    }
+
+    std::size_t StateRegistry::Hash::operator()(const osg::ref_ptr<osg::StateAttribute>& attribute) const
+    {
+        std::size_t seed = typeid(*attribute).hash_code();
+        Misc::hashCombine(seed, attribute->getMember());
+        Misc::hashCombine(seed, attribute->getName());
+
+        // Only the most distinctive fields, equality is decided by osg::StateAttribute::compare
+        if (const osg::Texture* texture = attribute->asTexture())
+        {
+            for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                Misc::hashCombine(seed, texture->getImage(i));
+            Misc::hashCombine(seed, static_cast<int>(texture->getWrap(osg::Texture::WRAP_S)));
+            Misc::hashCombine(seed, static_cast<int>(texture->getWrap(osg::Texture::WRAP_T)));
+        }
+        else if (const auto* material = dynamic_cast<const osg::Material*>(attribute.get()))
+        {
+            Misc::hashCombine(seed, static_cast<int>(material->getColorMode()));
+            hashVec4f(seed, material->getDiffuse(osg::Material::FRONT));
+            hashVec4f(seed, material->getAmbient(osg::Material::FRONT));
+            hashVec4f(seed, material->getEmission(osg::Material::FRONT));
+            hashVec4f(seed, material->getSpecular(osg::Material::FRONT));
+            Misc::hashCombine(seed, material->getShininess(osg::Material::FRONT));
+        }
+
+        return seed;
+    }
+
+    bool StateRegistry::Equal::operator()(
+        const osg::ref_ptr<osg::StateAttribute>& l, const osg::ref_ptr<osg::StateAttribute>& r) const
+    {
+        // The shader visitor finds textures by name
+        return l->getName() == r->getName() && l->compare(*r) == 0;
+    }
+
+    osg::ref_ptr<osg::StateAttribute> StateRegistry::shareAttribute(const osg::ref_ptr<osg::StateAttribute>& attribute)
+    {
+        if (attribute == nullptr || !isShareable(*attribute))
+            return attribute;
+
+        const std::lock_guard lock(mMutex);
+        // The attribute is not shared yet, so it can be changed to compare equal to the registered textures
+        if (osg::Texture* texture = attribute->asTexture())
+            applyFilterSettings(*texture);
+        const auto [it, inserted] = mAttributes.insert(attribute);
+        if (inserted)
+            ++mNumCreated;
+        else
+            ++mNumShared;
+        return *it;
+    }
+
+    void StateRegistry::setFilterSettings(
+        osg::Texture::FilterMode minFilter, osg::Texture::FilterMode magFilter, int maxAnisotropy)
+    {
+        const std::lock_guard lock(mMutex);
+        mMinFilter = minFilter;
+        mMagFilter = magFilter;
+        mMaxAnisotropy = maxAnisotropy;
+        // The filter settings are not hashed, so the registered textures don't need to be reinserted
+        for (const osg::ref_ptr<osg::StateAttribute>& attribute : mAttributes)
+            if (osg::Texture* texture = attribute->asTexture())
+                applyFilterSettings(*texture);
+    }
+
+    void StateRegistry::applyFilterSettings(osg::Texture& texture) const
+    {
+        // Don't dirty the texture parameters when nothing changes
+        if (texture.getFilter(osg::Texture::MIN_FILTER) != mMinFilter)
+            texture.setFilter(osg::Texture::MIN_FILTER, mMinFilter);
+        if (texture.getFilter(osg::Texture::MAG_FILTER) != mMagFilter)
+            texture.setFilter(osg::Texture::MAG_FILTER, mMagFilter);
+        if (texture.getMaxAnisotropy() != mMaxAnisotropy)
+            texture.setMaxAnisotropy(mMaxAnisotropy);
+    }
+
+    void StateRegistry::prune()
+    {
+        const std::lock_guard lock(mMutex);
+        for (auto it = mAttributes.begin(); it != mAttributes.end();)
+        {
+            if ((*it)->referenceCount() <= 1)
+                it = mAttributes.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void StateRegistry::clear()
+    {
+        const std::lock_guard lock(mMutex);
+        mAttributes.clear();
+    }
+
+    void StateRegistry::reportStats(unsigned int frameNumber, osg::Stats* stats) const
+    {
+        const std::lock_guard lock(mMutex);
+        stats->setAttribute(frameNumber, "State Attribute", mAttributes.size());
+        stats->setAttribute(frameNumber, "State Attribute Created", mNumCreated);
+        stats->setAttribute(frameNumber, "State Attribute Shared", mNumShared);
+    }
+}
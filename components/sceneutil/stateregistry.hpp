@@ -0,0 +1,74 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_STATEREGISTRY_H
+#define OPENMW_COMPONENTS_SCENEUTIL_STATEREGISTRY_H
+
+#include <osg/StateAttribute>
+#include <osg/Texture>
+#include <osg/ref_ptr>
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_set>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace SceneUtil
+{
+    /// Hash-consing of the state attributes made by the loaders: an attribute equal to a registered one is replaced by
+    /// the registered instance when it is made, instead of finding the duplicates in every loaded scene afterwards.
+    /// The osg::State compares attributes by pointer, so shared attributes also save state changes when drawing.
+    /// @par Registered attributes are shared by unrelated scenes and must not be changed anymore. Texture filtering is
+    /// the exception: the registry applies it to the textures before comparing them, and to all the registered textures
+    /// when it changes.
+    /// @par Thread safe.
+    class StateRegistry
+    {
+    public:
+        /// @return the registered attribute equal to the given one, or the given one once it is registered. Attributes
+        /// with callbacks, user data or textures of missing images are not shared and are returned as they are.
+        template <class T>
+        osg::ref_ptr<T> share(const osg::ref_ptr<T>& attribute)
+        {
+            return static_cast<T*>(shareAttribute(attribute).get());
+        }
+
+        /// Set the filtering of the shared textures, see the class description
+        void setFilterSettings(
+            osg::Texture::FilterMode minFilter, osg::Texture::FilterMode magFilter, int maxAnisotropy);
+
+        /// Unregister the attributes that are not referenced anywhere else
+        void prune();
+
+        void clear();
+
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
+    private:
+        struct Hash
+        {
+            std::size_t operator()(const osg::ref_ptr<osg::StateAttribute>& attribute) const;
+        };
+
+        struct Equal
+        {
+            bool operator()(
+                const osg::ref_ptr<osg::StateAttribute>& l, const osg::ref_ptr<osg::StateAttribute>& r) const;
+        };
+
+        mutable std::mutex mMutex;
+        std::unordered_set<osg::ref_ptr<osg::StateAttribute>, Hash, Equal> mAttributes;
+        std::size_t mNumCreated = 0;
+        std::size_t mNumShared = 0;
+        osg::Texture::FilterMode mMinFilter = osg::Texture::LINEAR_MIPMAP_LINEAR;
+        osg::Texture::FilterMode mMagFilter = osg::Texture::LINEAR;
+        int mMaxAnisotropy = 1;
+
+        void applyFilterSettings(osg::Texture& texture) const;
+
+        osg::ref_ptr<osg::StateAttribute> shareAttribute(const osg::ref_ptr<osg::StateAttribute>& attribute);
+    };
+}
+
+#endif
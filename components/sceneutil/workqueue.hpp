@@ -66,6 +66,8 @@ namespace SceneUtil
 
         unsigned int getNumActiveThreads() const;
 
+        std::size_t getNumThreads() const { return mThreads.size(); }
+
     private:
         bool mIsReleased;
         std::deque<osg::ref_ptr<WorkItem>> mQueue;
@@ -16,8 +16,8 @@ namespace Sqlite3
     Db makeDb(std::string_view path, const char* schema)
     {
         sqlite3* handle = nullptr;
-        // All uses of NavMeshDb are protected by a mutex (navmeshtool) or serialized in a single thread (DbWorker)
-        // so additional synchronization between threads is not required and SQLITE_OPEN_NOMUTEX can be used.
+        // All uses of NavMeshDb are protected by a mutex (navmeshtool) or each connection is used by a single thread
+        // (DbWorker) so additional synchronization between threads is not required and SQLITE_OPEN_NOMUTEX can be used.
         // This is unsafe to use NavMeshDb without external synchronization because of internal state.
         const int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
         if (const int ec = sqlite3_open_v2(std::string(path).c_str(), &handle, flags, nullptr); ec != SQLITE_OK)
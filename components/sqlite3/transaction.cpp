@@ -6,6 +6,7 @@
 
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace Sqlite3
 {
@@ -55,4 +56,37 @@ namespace Sqlite3
                 + std::to_string(ec) + ")");
         (void)mDb.release();
     }
+
+    Savepoint::Savepoint(sqlite3& db, std::string name)
+        : mDb(&db)
+        , mName(std::move(name))
+    {
+        const std::string statement = "SAVEPOINT " + mName;
+        if (const int ec = sqlite3_exec(&db, statement.c_str(), nullptr, nullptr, nullptr); ec != SQLITE_OK)
+        {
+            (void)mDb.release();
+            throw std::runtime_error(
+                "Failed to start savepoint: " + std::string(sqlite3_errmsg(&db)) + " (" + std::to_string(ec) + ")");
+        }
+    }
+
+    Savepoint::~Savepoint()
+    {
+        if (mDb == nullptr)
+            return;
+        // Rolling back to a savepoint keeps it open, it has to be released as well
+        const std::string statement = "ROLLBACK TO " + mName + "; RELEASE " + mName;
+        if (const int ec = sqlite3_exec(mDb.get(), statement.c_str(), nullptr, nullptr, nullptr); ec != SQLITE_OK)
+            Log(Debug::Debug) << "Failed to rollback SQLite3 savepoint: " << sqlite3_errmsg(mDb.get()) << " (" << ec
+                              << ")";
+    }
+
+    void Savepoint::release()
+    {
+        const std::string statement = "RELEASE " + mName;
+        if (const int ec = sqlite3_exec(mDb.get(), statement.c_str(), nullptr, nullptr, nullptr); ec != SQLITE_OK)
+            throw std::runtime_error("Failed to release savepoint: " + std::string(sqlite3_errmsg(mDb.get())) + " ("
+                + std::to_string(ec) + ")");
+        (void)mDb.release();
+    }
 }
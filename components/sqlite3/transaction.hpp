@@ -2,6 +2,7 @@
 #define OPENMW_COMPONENTS_SQLITE3_TRANSACTION_H
 
 #include <memory>
+#include <string>
 
 struct sqlite3;
 
@@ -30,6 +31,28 @@ namespace Sqlite3
     private:
         std::unique_ptr<sqlite3, Rollback> mDb;
     };
+
+    // Nested transaction, changes made since its start are rolled back on destruction unless it is released.
+    class Savepoint
+    {
+    public:
+        explicit Savepoint(sqlite3& db, std::string name);
+
+        Savepoint(Savepoint&& other) noexcept = default;
+
+        ~Savepoint();
+
+        void release();
+
+    private:
+        struct Deleter
+        {
+            void operator()(sqlite3*) const {}
+        };
+
+        std::unique_ptr<sqlite3, Deleter> mDb;
+        std::string mName;
+    };
 }
 
 #endif
@@ -0,0 +1,464 @@
+#include "chunkdiskcache.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/files/collections.hpp>
+#include <components/files/conversion.hpp>
+#include <components/files/hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+namespace Terrain
+{
+    namespace
+    {
+        constexpr std::string_view packPrefix = "terrain-";
+        constexpr std::string_view packExtension = ".bin";
+        constexpr std::array<char, 8> packMagic = { 'O', 'M', 'W', 'T', 'C', 'H', 'N', 'K' };
+        constexpr std::uint32_t packVersion = 2;
+
+        // Magic, version, number of entries
+        constexpr std::size_t headerSize = packMagic.size() + 2 * sizeof(std::uint32_t);
+        // Center x, center y, size, lod, offset, size
+        constexpr std::size_t indexEntrySize = 3 * sizeof(float) + sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+        template <class T>
+        void writeValue(std::vector<char>& buffer, const T& value)
+        {
+            const char* const data = reinterpret_cast<const char*>(&value);
+            buffer.insert(buffer.end(), data, data + sizeof(T));
+        }
+
+        template <class T>
+        T readValue(const char*& data)
+        {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            data += sizeof(T);
+            return value;
+        }
+
+        template <class ArrayType>
+        void writeArray(std::vector<char>& buffer, const ArrayType& array)
+        {
+            const char* const data = static_cast<const char*>(array.getDataPointer());
+            buffer.insert(buffer.end(), data, data + array.getTotalDataSize());
+        }
+
+        template <class ArrayType>
+        const char* readArray(const char* data, std::size_t numVertices, ArrayType& array)
+        {
+            array.resize(numVertices);
+            const std::size_t size = numVertices * sizeof(typename ArrayType::ElementDataType);
+            if (numVertices > 0)
+                std::memcpy(&array.front(), data, size);
+            array.dirty();
+            return data + size;
+        }
+
+        std::size_t getBlobSize(std::size_t numVertices)
+        {
+            return sizeof(std::uint32_t) + numVertices * (2 * sizeof(osg::Vec3f) + sizeof(osg::Vec4ub));
+        }
+    }
+
+    std::string makeContentDigest(
+        const Files::Collections& fileCollections, const std::vector<std::string>& contentFiles)
+    {
+        std::ostringstream description;
+        description << packVersion << '\n';
+        for (const std::string& file : contentFiles)
+        {
+            description << file;
+            const auto extension = Files::pathToUnicodeString(Files::pathFromUnicodeString(file).extension());
+            const Files::MultiDirCollection& collection = fileCollections.getCollection(extension);
+            if (collection.doesExist(file))
+            {
+                const std::filesystem::path path = collection.getPath(file);
+                std::error_code ec;
+                const auto size = std::filesystem::file_size(path, ec);
+                const auto time = std::filesystem::last_write_time(path, ec);
+                description << ' ' << size << ' ' << time.time_since_epoch().count();
+            }
+            description << '\n';
+        }
+
+        std::istringstream stream(description.str());
+        const std::array<std::uint64_t, 2> hash = Files::getHash("content", stream);
+
+        std::ostringstream result;
+        result << std::hex << std::setfill('0') << std::setw(16) << hash[0] << std::setw(16) << hash[1];
+        return result.str();
+    }
+
+    ChunkDiskCache::ChunkDiskCache(const std::filesystem::path& directory, const std::string& contentDigest,
+        std::size_t maxPendingDataSize, std::size_t maxContentDigests)
+        : mDirectory(directory)
+        , mContentDigest(contentDigest)
+        , mMaxPendingDataSize(maxPendingDataSize)
+        , mMaxContentDigests(std::max<std::size_t>(maxContentDigests, 1))
+    {
+        try
+        {
+            open();
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Failed to open terrain chunk cache " << mDirectory << ": " << e.what();
+        }
+    }
+
+    ChunkDiskCache::~ChunkDiskCache()
+    {
+        try
+        {
+            flush();
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to flush terrain chunk cache " << mDirectory << ": " << e.what();
+        }
+    }
+
+    void ChunkDiskCache::open()
+    {
+        if (!std::filesystem::exists(mDirectory))
+            return;
+
+        struct OtherContent
+        {
+            std::filesystem::file_time_type mLastUsed;
+            std::vector<std::filesystem::path> mFiles;
+        };
+
+        std::map<unsigned, std::filesystem::path> ownSegments;
+        std::map<std::string, OtherContent> otherContents;
+        for (const auto& file : std::filesystem::directory_iterator(mDirectory))
+        {
+            const std::string name = Files::pathToUnicodeString(file.path().filename());
+            if (!name.starts_with(packPrefix) || !name.ends_with(packExtension))
+                continue;
+            const std::string_view stem = std::string_view(name).substr(
+                packPrefix.size(), name.size() - packPrefix.size() - packExtension.size());
+            const std::size_t separator = stem.rfind('-');
+            unsigned number = 0;
+            if (separator == std::string_view::npos
+                || std::from_chars(stem.data() + separator + 1, stem.data() + stem.size(), number).ec != std::errc())
+            {
+                // Left by an older version
+                std::error_code ec;
+                std::filesystem::remove(file.path(), ec);
+                continue;
+            }
+            const std::string_view digest = stem.substr(0, separator);
+            if (digest == mContentDigest)
+            {
+                ownSegments.emplace(number, file.path());
+                continue;
+            }
+            std::error_code ec;
+            const std::filesystem::file_time_type time = std::filesystem::last_write_time(file.path(), ec);
+            OtherContent& content = otherContents[std::string(digest)];
+            content.mLastUsed = std::max(content.mLastUsed, time);
+            content.mFiles.push_back(file.path());
+        }
+
+        // Segments of the least recently used content digests are removed
+        std::vector<const OtherContent*> byLastUsed;
+        for (const auto& [digest, content] : otherContents)
+            byLastUsed.push_back(&content);
+        std::sort(byLastUsed.begin(), byLastUsed.end(),
+            [](const OtherContent* l, const OtherContent* r) { return l->mLastUsed > r->mLastUsed; });
+        for (std::size_t i = mMaxContentDigests - 1; i < byLastUsed.size(); ++i)
+            for (const std::filesystem::path& path : byLastUsed[i]->mFiles)
+            {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+
+        const auto now = std::filesystem::file_time_type::clock::now();
+        std::size_t numEntries = 0;
+        for (const auto& [number, path] : ownSegments)
+        {
+            mNextSegment = number + 1;
+            try
+            {
+                mSegments.push_back(openSegment(path));
+                numEntries += mSegments.back().mIndex.size();
+            }
+            catch (const std::exception& e)
+            {
+                Log(Debug::Warning) << "Removing invalid terrain chunk cache segment " << path << ": " << e.what();
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+                continue;
+            }
+            // Marks the content digest as used
+            std::error_code ec;
+            std::filesystem::last_write_time(path, now, ec);
+        }
+
+        Log(Debug::Verbose) << "Loaded terrain chunk cache " << mDirectory << " with " << mSegments.size()
+                            << " segments and " << numEntries << " entries";
+    }
+
+    ChunkDiskCache::Segment ChunkDiskCache::openSegment(const std::filesystem::path& path)
+    {
+        Segment segment;
+        segment.mFile.open(path.native());
+        const char* data = segment.mFile.data();
+        const std::size_t fileSize = segment.mFile.size();
+
+        if (fileSize < headerSize || !std::equal(packMagic.begin(), packMagic.end(), data))
+            throw std::runtime_error("not a terrain chunk cache");
+        data += packMagic.size();
+
+        const auto version = readValue<std::uint32_t>(data);
+        if (version != packVersion)
+            throw std::runtime_error("unsupported version " + std::to_string(version));
+
+        const auto count = readValue<std::uint32_t>(data);
+        if (fileSize < headerSize + count * indexEntrySize)
+            throw std::runtime_error("truncated index");
+
+        segment.mIndex.reserve(count);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            const auto x = readValue<float>(data);
+            const auto y = readValue<float>(data);
+            const auto size = readValue<float>(data);
+            const auto lod = static_cast<unsigned char>(readValue<std::uint32_t>(data));
+            const auto offset = readValue<std::uint64_t>(data);
+            const auto blobSize = readValue<std::uint64_t>(data);
+            if (offset > fileSize || blobSize > fileSize - offset)
+                throw std::runtime_error("entry is out of bounds");
+            segment.mIndex.push_back(IndexEntry{ Key(x, y, size, lod), offset, blobSize });
+        }
+
+        if (!std::is_sorted(segment.mIndex.begin(), segment.mIndex.end(),
+                [](const IndexEntry& l, const IndexEntry& r) { return l.mKey < r.mKey; }))
+            throw std::runtime_error("index is not sorted");
+
+        return segment;
+    }
+
+    void ChunkDiskCache::writeSegment(const std::filesystem::path& directory, const std::filesystem::path& path,
+        const std::map<Key, std::vector<char>>& entries)
+    {
+        std::vector<char> header;
+        header.reserve(headerSize + entries.size() * indexEntrySize);
+        header.insert(header.end(), packMagic.begin(), packMagic.end());
+        writeValue(header, packVersion);
+        writeValue(header, static_cast<std::uint32_t>(entries.size()));
+
+        // Entries of the map are already sorted by key
+        std::uint64_t offset = headerSize + entries.size() * indexEntrySize;
+        for (const auto& [key, blob] : entries)
+        {
+            writeValue(header, std::get<0>(key));
+            writeValue(header, std::get<1>(key));
+            writeValue(header, std::get<2>(key));
+            writeValue(header, static_cast<std::uint32_t>(std::get<3>(key)));
+            writeValue(header, offset);
+            writeValue(header, static_cast<std::uint64_t>(blob.size()));
+            offset += blob.size();
+        }
+
+        std::filesystem::create_directories(directory);
+
+        // Readers of the directory never see a partially written segment
+        std::filesystem::path tmpPath = path;
+        tmpPath += ".tmp";
+        {
+            std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!stream)
+                throw std::runtime_error("failed to open " + Files::pathToUnicodeString(tmpPath) + " for writing");
+            stream.write(header.data(), header.size());
+            for (const auto& [key, blob] : entries)
+                stream.write(blob.data(), blob.size());
+            if (!stream)
+                throw std::runtime_error("failed to write " + Files::pathToUnicodeString(tmpPath));
+        }
+
+        std::filesystem::rename(tmpPath, path);
+    }
+
+    const ChunkDiskCache::IndexEntry* ChunkDiskCache::findEntry(const std::vector<IndexEntry>& index, const Key& key)
+    {
+        const auto it = std::lower_bound(
+            index.begin(), index.end(), key, [](const IndexEntry& entry, const Key& k) { return entry.mKey < k; });
+        if (it == index.end() || it->mKey != key)
+            return nullptr;
+        return &*it;
+    }
+
+    std::filesystem::path ChunkDiskCache::getSegmentPath(unsigned number) const
+    {
+        return mDirectory
+            / Files::pathFromUnicodeString(
+                std::string(packPrefix) + mContentDigest + '-' + std::to_string(number) + std::string(packExtension));
+    }
+
+    const std::vector<char>* ChunkDiskCache::findBlob(const Key& key) const
+    {
+        if (const auto it = mPending.find(key); it != mPending.end())
+            return &it->second;
+        if (const auto it = mWriting.find(key); it != mWriting.end())
+            return &it->second;
+        return nullptr;
+    }
+
+    bool ChunkDiskCache::contains(const Key& key) const
+    {
+        if (findBlob(key) != nullptr)
+            return true;
+        return std::any_of(mSegments.begin(), mSegments.end(),
+            [&](const Segment& segment) { return findEntry(segment.mIndex, key) != nullptr; });
+    }
+
+    bool ChunkDiskCache::read(float size, const osg::Vec2f& center, unsigned char lod, osg::Vec3Array& positions,
+        osg::Vec3Array& normals, osg::Vec4ubArray& colours) const
+    {
+        const Key key(center.x(), center.y(), size, lod);
+        const std::lock_guard lock(mMutex);
+
+        const char* data = nullptr;
+        std::size_t blobSize = 0;
+        if (const std::vector<char>* blob = findBlob(key))
+        {
+            data = blob->data();
+            blobSize = blob->size();
+        }
+        else
+        {
+            for (const Segment& segment : mSegments)
+            {
+                if (const IndexEntry* entry = findEntry(segment.mIndex, key))
+                {
+                    data = segment.mFile.data() + entry->mOffset;
+                    blobSize = static_cast<std::size_t>(entry->mSize);
+                    break;
+                }
+            }
+            if (data == nullptr)
+                return false;
+        }
+
+        if (blobSize < sizeof(std::uint32_t))
+            return false;
+        const std::size_t numVertices = readValue<std::uint32_t>(data);
+        if (getBlobSize(numVertices) != blobSize)
+            return false;
+
+        data = readArray(data, numVertices, positions);
+        data = readArray(data, numVertices, normals);
+        readArray(data, numVertices, colours);
+        return true;
+    }
+
+    void ChunkDiskCache::write(float size, const osg::Vec2f& center, unsigned char lod, const osg::Vec3Array& positions,
+        const osg::Vec3Array& normals, const osg::Vec4ubArray& colours)
+    {
+        const std::size_t numVertices = positions.size();
+        if (normals.size() != numVertices || colours.size() != numVertices)
+            return;
+
+        std::vector<char> blob;
+        blob.reserve(getBlobSize(numVertices));
+        writeValue(blob, static_cast<std::uint32_t>(numVertices));
+        writeArray(blob, positions);
+        writeArray(blob, normals);
+        writeArray(blob, colours);
+
+        const Key key(center.x(), center.y(), size, lod);
+        {
+            const std::lock_guard lock(mMutex);
+            if (contains(key))
+                return;
+            mPendingDataSize += blob.size();
+            mPending.emplace(key, std::move(blob));
+            if (mPendingDataSize <= mMaxPendingDataSize)
+                return;
+        }
+
+        // The thread already writing a segment doesn't take these entries, they go into the next one
+        const std::unique_lock flushLock(mFlushMutex, std::try_to_lock);
+        if (!flushLock.owns_lock())
+            return;
+
+        try
+        {
+            writePending();
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to flush terrain chunk cache " << mDirectory << ": " << e.what();
+        }
+    }
+
+    void ChunkDiskCache::flush()
+    {
+        const std::lock_guard flushLock(mFlushMutex);
+        writePending();
+    }
+
+    void ChunkDiskCache::writePending()
+    {
+        std::filesystem::path path;
+        {
+            const std::lock_guard lock(mMutex);
+            if (mPending.empty())
+                return;
+            mWriting = std::move(mPending);
+            mPending.clear();
+            mPendingDataSize = 0;
+            path = getSegmentPath(mNextSegment);
+        }
+
+        // Only this thread changes mWriting until it is cleared, the other ones only read it
+        Segment segment;
+        try
+        {
+            writeSegment(mDirectory, path, mWriting);
+            segment = openSegment(path);
+        }
+        catch (...)
+        {
+            // Drop the entries rather than keeping every generated chunk in memory
+            const std::lock_guard lock(mMutex);
+            mWriting.clear();
+            throw;
+        }
+
+        Log(Debug::Verbose) << "Written terrain chunk cache segment " << path << " with " << segment.mIndex.size()
+                            << " entries";
+
+        const std::lock_guard lock(mMutex);
+        mSegments.push_back(std::move(segment));
+        mWriting.clear();
+        ++mNextSegment;
+    }
+
+    std::size_t ChunkDiskCache::getNumEntries() const
+    {
+        const std::lock_guard lock(mMutex);
+        std::size_t result = mPending.size() + mWriting.size();
+        for (const Segment& segment : mSegments)
+            result += segment.mIndex.size();
+        return result;
+    }
+
+    std::size_t ChunkDiskCache::getPendingDataSize() const
+    {
+        const std::lock_guard lock(mMutex);
+        return mPendingDataSize;
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef OPENMW_COMPONENTS_TERRAIN_CHUNKDISKCACHE_H
+#define OPENMW_COMPONENTS_TERRAIN_CHUNKDISKCACHE_H
+
+#include <osg/Array>
+#include <osg/Vec2f>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace Files
+{
+    class Collections;
+}
+
+namespace Terrain
+{
+    /// @brief Identifies the content files a cache was generated from. Changes when a content file is added, removed,
+    /// reordered or modified (detected by size and modification time to avoid reading the files at startup).
+    std::string makeContentDigest(
+        const Files::Collections& fileCollections, const std::vector<std::string>& contentFiles);
+
+    /// @brief Persistent cache of terrain chunk vertex data, stored in memory mapped segment files per content digest.
+    /// Entries added with write() are kept in memory until flush() appends them as a new segment, which write() does
+    /// itself once the pending entries exceed the given size. Existing segments are never rewritten.
+    /// Segments of other content digests are kept for the most recently used ones up to the given number.
+    /// @note Thread safe, writing a segment doesn't block read().
+    class ChunkDiskCache
+    {
+    public:
+        static constexpr std::size_t defaultMaxPendingDataSize = 64 * 1024 * 1024;
+        static constexpr std::size_t defaultMaxContentDigests = 4;
+
+        /// @param directory Directory holding the segment files, created on flush if missing.
+        /// @param contentDigest See makeContentDigest.
+        /// @param maxPendingDataSize Size in bytes of the pending entries above which write() flushes them.
+        /// @param maxContentDigests Number of content digests including this one to keep the segments of.
+        ChunkDiskCache(const std::filesystem::path& directory, const std::string& contentDigest,
+            std::size_t maxPendingDataSize = defaultMaxPendingDataSize,
+            std::size_t maxContentDigests = defaultMaxContentDigests);
+
+        /// Flushes pending entries.
+        ~ChunkDiskCache();
+
+        /// @return true if the chunk was found, in which case the arrays are filled with the cached data
+        bool read(float size, const osg::Vec2f& center, unsigned char lod, osg::Vec3Array& positions,
+            osg::Vec3Array& normals, osg::Vec4ubArray& colours) const;
+
+        void write(float size, const osg::Vec2f& center, unsigned char lod, const osg::Vec3Array& positions,
+            const osg::Vec3Array& normals, const osg::Vec4ubArray& colours);
+
+        /// Write the pending entries into a new segment file.
+        void flush();
+
+        std::size_t getNumEntries() const;
+
+        /// @return total size in bytes of the entries waiting for flush()
+        std::size_t getPendingDataSize() const;
+
+    private:
+        using Key = std::tuple<float, float, float, unsigned char>; // Center x, center y, size, lod
+
+        struct IndexEntry
+        {
+            Key mKey;
+            std::uint64_t mOffset;
+            std::uint64_t mSize;
+        };
+
+        struct Segment
+        {
+            boost::iostreams::mapped_file_source mFile;
+            std::vector<IndexEntry> mIndex;
+        };
+
+        const std::filesystem::path mDirectory;
+        const std::string mContentDigest;
+        const std::size_t mMaxPendingDataSize;
+        const std::size_t mMaxContentDigests;
+        // Held while writing a segment, mMutex is only locked to take the pending entries and add the segment
+        std::mutex mFlushMutex;
+        mutable std::mutex mMutex;
+        std::vector<Segment> mSegments;
+        std::map<Key, std::vector<char>> mPending;
+        // Entries being written into a new segment, still readable meanwhile
+        std::map<Key, std::vector<char>> mWriting;
+        std::size_t mPendingDataSize = 0;
+        unsigned mNextSegment = 0;
+
+        static Segment openSegment(const std::filesystem::path& path);
+
+        static void writeSegment(const std::filesystem::path& directory, const std::filesystem::path& path,
+            const std::map<Key, std::vector<char>>& entries);
+
+        static const IndexEntry* findEntry(const std::vector<IndexEntry>& index, const Key& key);
+
+        void open();
+
+        std::filesystem::path getSegmentPath(unsigned number) const;
+
+        void writePending();
+
+        const std::vector<char>* findBlob(const Key& key) const;
+
+        bool contains(const Key& key) const;
+    };
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "chunkmanager.hpp"
 
+#include <osg/Image>
 #include <osg/Material>
 #include <osg/Texture2D>
 
@@ -10,6 +11,9 @@
 
 #include <components/sceneutil/lightmanager.hpp>
 
+#include <algorithm>
+
+#include "chunkdiskcache.hpp"
 #include "compositemaprenderer.hpp"
 #include "material.hpp"
 #include "storage.hpp"
@@ -18,6 +22,55 @@
 
 namespace Terrain
 {
+    class Blendmaps : public osg::Object
+    {
+    public:
+        Blendmaps() = default;
+
+        Blendmaps(const Blendmaps& copy, const osg::CopyOp&)
+            : mLayerList(copy.mLayerList)
+            , mTextures(copy.mTextures)
+        {
+        }
+
+        META_Object(Terrain, Blendmaps)
+
+        void releaseGLObjects(osg::State* state) const override
+        {
+            for (const osg::ref_ptr<osg::Texture2D>& texture : mTextures)
+                texture->releaseGLObjects(state);
+        }
+
+        std::vector<LayerInfo> mLayerList;
+        // Each one holds 4 layers, see Storage::getBlendmaps
+        std::vector<osg::ref_ptr<osg::Texture2D>> mTextures;
+    };
+
+    namespace
+    {
+        osg::ref_ptr<osg::Texture2D> createBlendmapTexture(osg::Image* image)
+        {
+            osg::ref_ptr<osg::Texture2D> texture(new osg::Texture2D);
+            texture->setImage(image);
+            texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+            texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+            texture->setResizeNonPowerOfTwoHint(false);
+            return texture;
+        }
+
+        // Fixed function pipeline can only blend with the alpha channel
+        osg::ref_ptr<osg::Image> extractBlendmapLayer(const osg::Image& blendmap, unsigned int channel)
+        {
+            osg::ref_ptr<osg::Image> image(new osg::Image);
+            image->allocateImage(blendmap.s(), blendmap.t(), 1, GL_ALPHA, GL_UNSIGNED_BYTE);
+            const unsigned char* const src = blendmap.data();
+            unsigned char* const dst = image->data();
+            const std::size_t size = static_cast<std::size_t>(blendmap.s()) * blendmap.t();
+            for (std::size_t i = 0; i < size; ++i)
+                dst[i] = src[i * 4 + channel];
+            return image;
+        }
+    }
 
     ChunkManager::ChunkManager(Storage* storage, Resource::SceneManager* sceneMgr, TextureManager* textureManager,
         CompositeMapRenderer* renderer)
@@ -26,6 +79,9 @@ namespace Terrain
         , mSceneManager(sceneMgr)
         , mTextureManager(textureManager)
         , mCompositeMapRenderer(renderer)
+        , mBlendmapCache(new Resource::GenericObjectCache<BlendmapId>)
+        , mDiskCache(nullptr)
+        , mNumDiskCacheHits(0)
         , mNodeMask(0)
         , mCompositeMapSize(512)
         , mCompositeMapLevel(1.f)
@@ -38,6 +94,12 @@ namespace Terrain
         mMultiPassRoot->setAttributeAndModes(material, osg::StateAttribute::ON);
     }
 
+    ChunkManager::~ChunkManager()
+    {
+        // Composite maps waiting for preparation refer to this object
+        mCompositeMapRenderer->cancelPreparation();
+    }
+
     struct FindChunkTemplate
     {
         void operator()(ChunkId id, osg::Object* obj)
@@ -66,7 +128,8 @@ namespace Terrain
             mCache->call(find);
             TerrainDrawable* templateGeometry
                 = find.mFoundTemplate ? static_cast<TerrainDrawable*>(find.mFoundTemplate.get()) : nullptr;
-            osg::ref_ptr<osg::Node> node = createChunk(size, center, lod, lodFlags, compile, templateGeometry);
+            osg::ref_ptr<osg::Node> node
+                = createChunk(size, center, lod, lodFlags, viewPoint, compile, templateGeometry);
             mCache->addEntryToObjectCache(id, node.get());
             return node;
         }
@@ -75,18 +138,44 @@ namespace Terrain
     void ChunkManager::reportStats(unsigned int frameNumber, osg::Stats* stats) const
     {
         stats->setAttribute(frameNumber, "Terrain Chunk", mCache->getCacheSize());
+        stats->setAttribute(frameNumber, "Terrain Blendmap", mBlendmapCache->getCacheSize());
+        if (mDiskCache != nullptr)
+            stats->setAttribute(frameNumber, "Terrain Chunk Disk Hit", mNumDiskCacheHits.load());
+    }
+
+    void ChunkManager::updateCache(double referenceTime)
+    {
+        GenericResourceManager<ChunkId>::updateCache(referenceTime);
+
+        // Chunk passes reference only the textures
+        std::vector<BlendmapId> used;
+        const auto findUsed = [&](const BlendmapId& id, osg::Object* object) {
+            const Blendmaps& blendmaps = static_cast<const Blendmaps&>(*object);
+            if (std::any_of(blendmaps.mTextures.begin(), blendmaps.mTextures.end(),
+                    [](const osg::ref_ptr<osg::Texture2D>& v) { return v->referenceCount() > 1; }))
+                used.push_back(id);
+        };
+        mBlendmapCache->call(findUsed);
+        for (const BlendmapId& id : used)
+            mBlendmapCache->checkInObjectCache(id, referenceTime);
+
+        mBlendmapCache->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
+        mBlendmapCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
     }
 
     void ChunkManager::clearCache()
     {
         GenericResourceManager<ChunkId>::clearCache();
 
+        mBlendmapCache->clear();
+
         mBufferCache.clearCache();
     }
 
     void ChunkManager::releaseGLObjects(osg::State* state)
     {
         GenericResourceManager<ChunkId>::releaseGLObjects(state);
+        mBlendmapCache->releaseGLObjects(state);
         mBufferCache.releaseGLObjects(state);
     }
 
@@ -148,12 +237,27 @@ namespace Terrain
         }
     }
 
+    osg::ref_ptr<const Blendmaps> ChunkManager::getBlendmaps(float chunkSize, const osg::Vec2f& chunkCenter)
+    {
+        const BlendmapId id(chunkCenter, chunkSize);
+        if (osg::ref_ptr<osg::Object> obj = mBlendmapCache->getRefFromObjectCache(id))
+            return static_cast<const Blendmaps*>(obj.get());
+
+        osg::ref_ptr<Blendmaps> blendmaps(new Blendmaps);
+        std::vector<osg::ref_ptr<osg::Image>> images;
+        mStorage->getBlendmaps(chunkSize, chunkCenter, images, blendmaps->mLayerList);
+        for (const osg::ref_ptr<osg::Image>& image : images)
+            blendmaps->mTextures.push_back(createBlendmapTexture(image));
+
+        mBlendmapCache->addEntryToObjectCache(id, blendmaps);
+        return blendmaps;
+    }
+
     std::vector<osg::ref_ptr<osg::StateSet>> ChunkManager::createPasses(
         float chunkSize, const osg::Vec2f& chunkCenter, bool forCompositeMap)
     {
-        std::vector<LayerInfo> layerList;
-        std::vector<osg::ref_ptr<osg::Image>> blendmaps;
-        mStorage->getBlendmaps(chunkSize, chunkCenter, blendmaps, layerList);
+        const osg::ref_ptr<const Blendmaps> blendmaps = getBlendmaps(chunkSize, chunkCenter);
+        const std::vector<LayerInfo>& layerList = blendmaps->mLayerList;
 
         bool useShaders = mSceneManager->getForceShaders();
         if (!mSceneManager->getClampLighting())
@@ -184,14 +288,13 @@ namespace Terrain
             useShaders = false;
 
         std::vector<osg::ref_ptr<osg::Texture2D>> blendmapTextures;
-        for (std::vector<osg::ref_ptr<osg::Image>>::const_iterator it = blendmaps.begin(); it != blendmaps.end(); ++it)
+        if (useShaders)
+            blendmapTextures = blendmaps->mTextures;
+        else if (!blendmaps->mTextures.empty())
         {
-            osg::ref_ptr<osg::Texture2D> texture(new osg::Texture2D);
-            texture->setImage(*it);
-            texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
-            texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
-            texture->setResizeNonPowerOfTwoHint(false);
-            blendmapTextures.push_back(texture);
+            for (unsigned int i = 0; i < layerList.size(); ++i)
+                blendmapTextures.push_back(
+                    createBlendmapTexture(extractBlendmapLayer(*blendmaps->mTextures[i / 4]->getImage(), i % 4)));
         }
 
         float blendmapScale = mStorage->getBlendmapScale(chunkSize);
@@ -201,7 +304,7 @@ namespace Terrain
     }
 
     osg::ref_ptr<osg::Node> ChunkManager::createChunk(float chunkSize, const osg::Vec2f& chunkCenter, unsigned char lod,
-        unsigned int lodFlags, bool compile, TerrainDrawable* templateGeometry)
+        unsigned int lodFlags, const osg::Vec3f& viewPoint, bool compile, TerrainDrawable* templateGeometry)
     {
         osg::ref_ptr<TerrainDrawable> geometry(new TerrainDrawable);
 
@@ -212,7 +315,14 @@ namespace Terrain
             osg::ref_ptr<osg::Vec4ubArray> colors(new osg::Vec4ubArray);
             colors->setNormalize(true);
 
-            mStorage->fillVertexBuffers(lod, chunkSize, chunkCenter, positions, normals, colors);
+            if (mDiskCache != nullptr && mDiskCache->read(chunkSize, chunkCenter, lod, *positions, *normals, *colors))
+                ++mNumDiskCacheHits;
+            else
+            {
+                mStorage->fillVertexBuffers(lod, chunkSize, chunkCenter, positions, normals, colors);
+                if (mDiskCache != nullptr)
+                    mDiskCache->write(chunkSize, chunkCenter, lod, *positions, *normals, *colors);
+            }
 
             osg::ref_ptr<osg::VertexBufferObject> vbo(new osg::VertexBufferObject);
             positions->setVertexBufferObject(vbo);
@@ -277,10 +387,12 @@ namespace Terrain
             {
                 osg::ref_ptr<CompositeMap> compositeMap = new CompositeMap;
                 compositeMap->mTexture = createCompositeMapRTT();
-
-                createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0, 0, 1, 1), *compositeMap);
-
-                mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
+                // The geometry is created by the renderer, in the background unless the map is required right away
+                compositeMap->mPrepare = [this, chunkSize, chunkCenter](CompositeMap& map) {
+                    createCompositeMapGeometry(chunkSize, chunkCenter, osg::Vec4f(0, 0, 1, 1), map);
+                };
+                const osg::Vec2f worldCenter = chunkCenter * mStorage->getCellWorldSize();
+                compositeMap->mDistance = (osg::Vec2f(viewPoint.x(), viewPoint.y()) - worldCenter).length();
 
                 geometry->setCompositeMap(compositeMap);
                 geometry->setCompositeMapRenderer(mCompositeMapRenderer);
@@ -292,6 +404,10 @@ namespace Terrain
                 geometry->setPasses(::Terrain::createPasses(
                     mSceneManager->getForceShaders() || !mSceneManager->getClampLighting(), mSceneManager,
                     std::vector<TextureLayer>(1, layer), std::vector<osg::ref_ptr<osg::Texture2D>>(), 1.f, 1.f));
+
+                // Only once the passes reference the texture, without a work queue the map is prepared right away and
+                // maps whose texture is not referenced are skipped as dropped
+                mCompositeMapRenderer->addCompositeMap(compositeMap.get(), false);
             }
             else
             {
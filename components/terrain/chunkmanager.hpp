@@ -1,6 +1,7 @@
 #ifndef OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 #define OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 
+#include <atomic>
 #include <tuple>
 
 #include <components/resource/resourcemanager.hpp>
@@ -27,9 +28,13 @@ namespace Terrain
     class Storage;
     class CompositeMap;
     class TerrainDrawable;
+    class ChunkDiskCache;
+    class Blendmaps;
 
     typedef std::tuple<osg::Vec2f, unsigned char, unsigned int> ChunkId; // Center, Lod, Lod Flags
 
+    typedef std::tuple<osg::Vec2f, float> BlendmapId; // Center, Size
+
     /// @brief Handles loading and caching of terrain chunks
     class ChunkManager : public Resource::GenericResourceManager<ChunkId>, public QuadTreeWorld::ChunkManager
     {
@@ -37,6 +42,8 @@ namespace Terrain
         ChunkManager(Storage* storage, Resource::SceneManager* sceneMgr, TextureManager* textureManager,
             CompositeMapRenderer* renderer);
 
+        ~ChunkManager();
+
         osg::ref_ptr<osg::Node> getChunk(float size, const osg::Vec2f& center, unsigned char lod, unsigned int lodFlags,
             bool activeGrid, const osg::Vec3f& viewPoint, bool compile) override;
 
@@ -44,18 +51,23 @@ namespace Terrain
         void setCompositeMapLevel(float level) { mCompositeMapLevel = level; }
         void setMaxCompositeGeometrySize(float maxCompGeometrySize) { mMaxCompGeometrySize = maxCompGeometrySize; }
 
+        /// Set a persistent cache to load chunk vertex data from and to store newly generated vertex data to.
+        void setDiskCache(ChunkDiskCache* cache) { mDiskCache = cache; }
+
         void setNodeMask(unsigned int mask) { mNodeMask = mask; }
         unsigned int getNodeMask() override { return mNodeMask; }
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats) const override;
 
+        void updateCache(double referenceTime) override;
+
         void clearCache() override;
 
         void releaseGLObjects(osg::State* state) override;
 
     private:
         osg::ref_ptr<osg::Node> createChunk(float size, const osg::Vec2f& center, unsigned char lod,
-            unsigned int lodFlags, bool compile, TerrainDrawable* templateGeometry);
+            unsigned int lodFlags, const osg::Vec3f& viewPoint, bool compile, TerrainDrawable* templateGeometry);
 
         osg::ref_ptr<osg::Texture2D> createCompositeMapRTT();
 
@@ -65,11 +77,17 @@ namespace Terrain
         std::vector<osg::ref_ptr<osg::StateSet>> createPasses(
             float chunkSize, const osg::Vec2f& chunkCenter, bool forCompositeMap);
 
+        osg::ref_ptr<const Blendmaps> getBlendmaps(float chunkSize, const osg::Vec2f& chunkCenter);
+
         Terrain::Storage* mStorage;
         Resource::SceneManager* mSceneManager;
         TextureManager* mTextureManager;
         CompositeMapRenderer* mCompositeMapRenderer;
         BufferCache mBufferCache;
+        // Blendmaps don't depend on the lod, so chunks of the same area share them
+        osg::ref_ptr<Resource::GenericObjectCache<BlendmapId>> mBlendmapCache;
+        ChunkDiskCache* mDiskCache;
+        std::atomic<std::size_t> mNumDiskCacheHits;
 
         osg::ref_ptr<osg::StateSet> mMultiPassRoot;
 
@@ -4,14 +4,40 @@
 #include <osg/RenderInfo>
 #include <osg/Texture2D>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include <algorithm>
+#include <cstddef>
 
 namespace Terrain
 {
+    namespace
+    {
+        // Maps prepared by one work item, so that a long prepare queue doesn't hold a preload thread
+        constexpr std::size_t maxPreparedPerWorkItem = 4;
+    }
+
+    class CompositeMapRenderer::PrepareWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        explicit PrepareWorkItem(CompositeMapRenderer* renderer)
+            : mRenderer(renderer)
+        {
+        }
+
+        void doWork() override { mRenderer->prepareCompositeMaps(); }
+
+    private:
+        osg::ref_ptr<CompositeMapRenderer> mRenderer;
+    };
 
     CompositeMapRenderer::CompositeMapRenderer()
         : mTargetFrameRate(120)
         , mMinimumTimeAvailable(0.0025)
+        , mPrepareQueued(false)
+        , mPreparingImmediate(false)
+        , mPrepareTime(0)
+        , mCompileTime(0)
     {
         setSupportsDisplayList(false);
         setCullingActive(false);
@@ -37,6 +63,8 @@ namespace Terrain
         if (mImmediateCompileSet.empty() && mCompileSet.empty())
             return;
 
+        osg::Timer compileTimer;
+
         while (!mImmediateCompileSet.empty())
         {
             osg::ref_ptr<CompositeMap> node = *mImmediateCompileSet.begin();
@@ -65,9 +93,58 @@ namespace Terrain
                 mCompileSet.insert(node);
             }
         }
+        mCompileTime += compileTimer.time_s();
         mTimer.setStartTick();
     }
 
+    void CompositeMapRenderer::prepare(CompositeMap& compositeMap)
+    {
+        if (!compositeMap.mPrepare)
+            return;
+
+        // don't spend any time on maps of chunks that were dropped while the map was waiting
+        if (compositeMap.mTexture->referenceCount() > 1)
+        {
+            osg::Timer timer;
+            compositeMap.mPrepare(compositeMap);
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPrepareTime += timer.time_s();
+        }
+
+        compositeMap.mPrepare = nullptr;
+    }
+
+    void CompositeMapRenderer::prepareCompositeMaps()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        for (std::size_t prepared = 0; prepared < maxPreparedPerWorkItem && !mPrepareSet.empty(); ++prepared)
+        {
+            osg::ref_ptr<CompositeMap> node = *mPrepareSet.begin();
+            mPrepareSet.erase(mPrepareSet.begin());
+            mPreparing = node;
+            mPreparingImmediate = false;
+
+            lock.unlock();
+            prepare(*node);
+            lock.lock();
+
+            if (mPreparingImmediate)
+                mImmediateCompileSet.insert(node);
+            else
+                mCompileSet.insert(node);
+
+            mPreparing = nullptr;
+            mPrepareDone.notify_all();
+        }
+
+        // Let the other work items run before the remaining maps
+        if (!mPrepareSet.empty() && mWorkQueue != nullptr)
+            mWorkQueue->addWorkItem(new PrepareWorkItem(this));
+        else
+            mPrepareQueued = false;
+    }
+
     void CompositeMapRenderer::compile(CompositeMap& compositeMap, osg::RenderInfo& renderInfo, double* timeLeft) const
     {
         // if there are no more external references we can assume the texture is no longer required
@@ -153,9 +230,38 @@ namespace Terrain
         mTargetFrameRate = framerate;
     }
 
-    void CompositeMapRenderer::addCompositeMap(CompositeMap* compositeMap, bool immediate)
+    void CompositeMapRenderer::setWorkQueue(SceneUtil::WorkQueue* workQueue)
     {
         std::lock_guard<std::mutex> lock(mMutex);
+        mWorkQueue = workQueue;
+    }
+
+    void CompositeMapRenderer::cancelPreparation()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWorkQueue = nullptr;
+        mPrepareSet.clear();
+        mPrepareDone.wait(lock, [&] { return mPreparing == nullptr; });
+    }
+
+    void CompositeMapRenderer::addCompositeMap(CompositeMap* compositeMap, bool immediate)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (!immediate && compositeMap->mPrepare && mWorkQueue)
+        {
+            mPrepareSet.insert(compositeMap);
+            if (!mPrepareQueued)
+            {
+                mPrepareQueued = true;
+                mWorkQueue->addWorkItem(new PrepareWorkItem(this));
+            }
+            return;
+        }
+
+        lock.unlock();
+        prepare(*compositeMap);
+        lock.lock();
+
         if (immediate)
             mImmediateCompileSet.insert(compositeMap);
         else
@@ -164,15 +270,29 @@ namespace Terrain
 
     void CompositeMapRenderer::setImmediate(CompositeMap* compositeMap)
     {
-        std::lock_guard<std::mutex> lock(mMutex);
+        std::unique_lock<std::mutex> lock(mMutex);
         CompileSet::iterator found = mCompileSet.find(compositeMap);
-        if (found == mCompileSet.end())
-            return;
-        else
+        if (found != mCompileSet.end())
         {
             mImmediateCompileSet.insert(compositeMap);
             mCompileSet.erase(found);
+            return;
+        }
+
+        found = mPrepareSet.find(compositeMap);
+        if (found != mPrepareSet.end())
+        {
+            // required now, so don't wait for the work queue to get to it
+            mPrepareSet.erase(found);
+            lock.unlock();
+            prepare(*compositeMap);
+            lock.lock();
+            mImmediateCompileSet.insert(compositeMap);
+            return;
         }
+
+        if (mPreparing.get() == compositeMap)
+            mPreparingImmediate = true;
     }
 
     unsigned int CompositeMapRenderer::getCompileSetSize() const
@@ -181,8 +301,24 @@ namespace Terrain
         return mCompileSet.size();
     }
 
+    unsigned int CompositeMapRenderer::getPrepareSetSize() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPrepareSet.size() + (mPreparing != nullptr ? 1 : 0);
+    }
+
+    void CompositeMapRenderer::takeTimeSpent(double& prepareTime, double& compileTime)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        prepareTime = mPrepareTime;
+        compileTime = mCompileTime;
+        mPrepareTime = 0;
+        mCompileTime = 0;
+    }
+
     CompositeMap::CompositeMap()
         : mCompiled(0)
+        , mDistance(0)
     {
     }
 
@@ -3,8 +3,11 @@
 
 #include <osg/Drawable>
 
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <set>
+#include <utility>
 
 namespace osg
 {
@@ -13,6 +16,11 @@ namespace osg
     class Texture2D;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Terrain
 {
 
@@ -24,6 +32,11 @@ namespace Terrain
         std::vector<osg::ref_ptr<osg::Drawable>> mDrawables;
         osg::ref_ptr<osg::Texture2D> mTexture;
         unsigned int mCompiled;
+        /// Creates mDrawables, called once by the CompositeMapRenderer before the map is compiled.
+        /// May be empty when mDrawables are created up front.
+        std::function<void(CompositeMap&)> mPrepare;
+        /// Distance to the camera at the time the map was requested, closer maps are prepared and compiled first.
+        float mDistance;
     };
 
     /**
@@ -46,7 +59,14 @@ namespace Terrain
         /// If current frame rate is higher than this, the extra time will be set aside to do more compiling
         void setTargetFrameRate(float framerate);
 
-        /// Add a composite map to be rendered
+        /// Set the queue to prepare composite maps on. Without one, maps are prepared when they are added.
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
+        /// Drop the composite maps waiting to be prepared and wait for the one being prepared, if any.
+        /// @note Must be called before anything the CompositeMap::mPrepare functions refer to is destroyed.
+        void cancelPreparation();
+
+        /// Add a composite map to be rendered. Unless it is immediate, it is prepared on the work queue first.
         void addCompositeMap(CompositeMap* map, bool immediate = false);
 
         /// Mark this composite map to be required for the current frame
@@ -54,16 +74,49 @@ namespace Terrain
 
         unsigned int getCompileSetSize() const;
 
+        unsigned int getPrepareSetSize() const;
+
+        /// Get the time in seconds spent preparing and compiling composite maps since the previous call
+        void takeTimeSpent(double& prepareTime, double& compileTime);
+
     private:
+        class PrepareWorkItem;
+
+        struct CloserCompositeMap
+        {
+            bool operator()(const osg::ref_ptr<CompositeMap>& lhs, const osg::ref_ptr<CompositeMap>& rhs) const
+            {
+                return std::make_pair(lhs->mDistance, lhs.get()) < std::make_pair(rhs->mDistance, rhs.get());
+            }
+        };
+
+        void prepare(CompositeMap& compositeMap);
+
+        /// Prepare a few of the closest waiting composite maps and queue another work item for the rest, runs on the
+        /// work queue
+        void prepareCompositeMaps();
+
         float mTargetFrameRate;
         double mMinimumTimeAvailable;
         mutable osg::Timer mTimer;
 
-        typedef std::set<osg::ref_ptr<CompositeMap>> CompileSet;
+        typedef std::set<osg::ref_ptr<CompositeMap>, CloserCompositeMap> CompileSet;
 
         mutable CompileSet mCompileSet;
         mutable CompileSet mImmediateCompileSet;
 
+        CompileSet mPrepareSet;
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        // Whether a PrepareWorkItem is queued or running
+        bool mPrepareQueued;
+        // Composite map being prepared on the work queue and whether it was made immediate meanwhile
+        osg::ref_ptr<CompositeMap> mPreparing;
+        bool mPreparingImmediate;
+        std::condition_variable mPrepareDone;
+
+        double mPrepareTime;
+        mutable double mCompileTime;
+
         mutable std::mutex mMutex;
 
         osg::ref_ptr<osg::FrameBufferObject> mFBO;
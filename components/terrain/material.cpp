@@ -13,6 +13,7 @@
 #include <components/shader/shadermanager.hpp>
 #include <components/stereo/stereomanager.hpp>
 
+#include <array>
 #include <mutex>
 
 namespace
@@ -207,6 +208,7 @@ namespace
         osg::ref_ptr<osg::Uniform> mBlendMap;
         osg::ref_ptr<osg::Uniform> mNormalMap;
         osg::ref_ptr<osg::Uniform> mColorMode;
+        std::array<osg::ref_ptr<osg::Uniform>, 4> mBlendMapChannel;
 
         UniformCollection()
             : mDiffuseMap(new osg::Uniform("diffuseMap", 0))
@@ -214,6 +216,12 @@ namespace
             , mNormalMap(new osg::Uniform("normalMap", 2))
             , mColorMode(new osg::Uniform("colorMode", 2))
         {
+            for (std::size_t i = 0; i < mBlendMapChannel.size(); ++i)
+            {
+                osg::Vec4f mask;
+                mask[i] = 1.f;
+                mBlendMapChannel[i] = new osg::Uniform("blendMapChannel", mask);
+            }
         }
     };
 }
@@ -227,7 +235,7 @@ namespace Terrain
         auto& shaderManager = sceneManager->getShaderManager();
         std::vector<osg::ref_ptr<osg::StateSet>> passes;
 
-        unsigned int blendmapIndex = 0;
+        unsigned int layerIndex = 0;
         for (std::vector<TextureLayer>::const_iterator it = layers.begin(); it != layers.end(); ++it)
         {
             bool firstLayer = (it == layers.begin());
@@ -264,11 +272,12 @@ namespace Terrain
 
                 if (!blendmaps.empty())
                 {
-                    osg::ref_ptr<osg::Texture2D> blendmap = blendmaps.at(blendmapIndex++);
+                    osg::ref_ptr<osg::Texture2D> blendmap = blendmaps.at(layerIndex / 4);
 
                     stateset->setTextureAttributeAndModes(1, blendmap.get());
                     stateset->setTextureAttributeAndModes(1, BlendmapTexMat::value(blendmapScale));
                     stateset->addUniform(UniformCollection::value().mBlendMap);
+                    stateset->addUniform(UniformCollection::value().mBlendMapChannel[layerIndex % 4]);
                 }
 
                 if (it->mNormalMap)
@@ -303,7 +312,7 @@ namespace Terrain
                 // Multiply by the alpha map
                 if (!blendmaps.empty())
                 {
-                    osg::ref_ptr<osg::Texture2D> blendmap = blendmaps.at(blendmapIndex++);
+                    osg::ref_ptr<osg::Texture2D> blendmap = blendmaps.at(layerIndex);
 
                     stateset->setTextureAttributeAndModes(1, blendmap.get());
 
@@ -314,6 +323,7 @@ namespace Terrain
             }
 
             passes.push_back(stateset);
+            ++layerIndex;
         }
         return passes;
     }
@@ -24,6 +24,8 @@ namespace Terrain
         bool mSpecular;
     };
 
+    /// @param blendmaps With shaders, RGBA blendmaps holding 4 layers each as written by Storage::getBlendmaps.
+    ///        Without shaders, one alpha blendmap per layer. Empty if there is nothing to blend.
     std::vector<osg::ref_ptr<osg::StateSet>> createPasses(bool useShaders, Resource::SceneManager* sceneManager,
         const std::vector<TextureLayer>& layers, const std::vector<osg::ref_ptr<osg::Texture2D>>& blendmaps,
         int blendmapScale, float layerTileSize);
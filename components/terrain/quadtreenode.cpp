@@ -111,18 +111,7 @@ namespace Terrain
 
     void QuadTreeNode::traverseNodes(ViewData* vd, const osg::Vec3f& viewPoint, LodCallback* lodCallback)
     {
-        if (!hasValidBounds())
-            return;
-        LodCallback::ReturnValue lodResult = lodCallback->isSufficientDetail(this, distance(viewPoint));
-        if (lodResult == LodCallback::StopTraversal)
-            return;
-        else if (lodResult == LodCallback::Deeper && getNumChildren())
-        {
-            for (unsigned int i = 0; i < getNumChildren(); ++i)
-                getChild(i)->traverseNodes(vd, viewPoint, lodCallback);
-        }
-        else
-            vd->add(this);
+        traverseNodes(viewPoint, *lodCallback, [vd](QuadTreeNode* node) { vd->add(node); });
     }
 
     void QuadTreeNode::setBoundingBox(const osg::BoundingBox& boundingBox)
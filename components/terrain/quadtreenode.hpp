@@ -80,6 +80,25 @@ namespace Terrain
         /// Traverse nodes according to LOD selection.
         void traverseNodes(ViewData* vd, const osg::Vec3f& viewPoint, LodCallback* lodCallback);
 
+        /// Traverse nodes according to LOD selection, calling f for each selected node in the same order as the
+        /// overload adding them to a ViewData.
+        template <class Function>
+        void traverseNodes(const osg::Vec3f& viewPoint, LodCallback& lodCallback, Function&& f)
+        {
+            if (!hasValidBounds())
+                return;
+            LodCallback::ReturnValue lodResult = lodCallback.isSufficientDetail(this, distance(viewPoint));
+            if (lodResult == LodCallback::StopTraversal)
+                return;
+            else if (lodResult == LodCallback::Deeper && getNumChildren())
+            {
+                for (unsigned int i = 0; i < getNumChildren(); ++i)
+                    getChild(i)->traverseNodes(viewPoint, lodCallback, f);
+            }
+            else
+                f(this);
+        }
+
     private:
         QuadTreeNode* mParent;
 
@@ -5,13 +5,17 @@
 #include <osg/ShapeDrawable>
 #include <osgUtil/CullVisitor>
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
+#include <vector>
 
 #include <components/loadinglistener/reporter.hpp>
 #include <components/misc/constants.hpp>
 #include <components/misc/mathutil.hpp>
 #include <components/resource/resourcesystem.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 #include "chunkmanager.hpp"
 #include "compositemaprenderer.hpp"
@@ -31,6 +35,76 @@ namespace
         return targetlevel;
     }
 
+    // Subtrees this deep below the root are traversed as separate tasks, giving up to 4^depth tasks.
+    constexpr unsigned int parallelTraversalDepth = 3;
+
+    // Views which selected fewer nodes last time are traversed faster than the tasks can be handed over.
+    constexpr unsigned int minEntriesForParallelTraversal = 256;
+
+    struct TraversalSlot
+    {
+        // Subtree to traverse, or nullptr if the selection was already done while splitting the tree.
+        Terrain::QuadTreeNode* mRoot;
+        std::vector<Terrain::QuadTreeNode*> mSelected;
+    };
+
+    class TraversalWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        TraversalWorkItem(const osg::Vec3f& viewPoint, Terrain::LodCallback& lodCallback)
+            : mViewPoint(viewPoint)
+            , mLodCallback(lodCallback)
+        {
+        }
+
+        void addSlot(TraversalSlot& slot) { mSlots.push_back(&slot); }
+
+        /// Ensures the work is done only once, by whichever of the culling thread and the worker gets to it first.
+        bool claim() { return !mClaimed.exchange(true); }
+
+        void doWork() override
+        {
+            if (claim())
+                run();
+        }
+
+        void run()
+        {
+            for (TraversalSlot* slot : mSlots)
+                slot->mRoot->traverseNodes(mViewPoint, mLodCallback,
+                    [slot](Terrain::QuadTreeNode* node) { slot->mSelected.push_back(node); });
+        }
+
+    private:
+        const osg::Vec3f mViewPoint;
+        Terrain::LodCallback& mLodCallback;
+        std::vector<TraversalSlot*> mSlots;
+        std::atomic_bool mClaimed{ false };
+    };
+
+    /// Same as QuadTreeNode::traverseNodes down to parallelTraversalDepth, leaving the deeper subtrees for later.
+    void splitTraversal(Terrain::QuadTreeNode* node, unsigned int depth, const osg::Vec3f& viewPoint,
+        Terrain::LodCallback& lodCallback, std::vector<TraversalSlot>& slots)
+    {
+        if (depth == parallelTraversalDepth)
+        {
+            slots.push_back(TraversalSlot{ node, {} });
+            return;
+        }
+        if (!node->hasValidBounds())
+            return;
+        const Terrain::LodCallback::ReturnValue lodResult
+            = lodCallback.isSufficientDetail(node, node->distance(viewPoint));
+        if (lodResult == Terrain::LodCallback::StopTraversal)
+            return;
+        else if (lodResult == Terrain::LodCallback::Deeper && node->getNumChildren())
+        {
+            for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+                splitTraversal(node->getChild(i), depth + 1, viewPoint, lodCallback, slots);
+        }
+        else
+            slots.push_back(TraversalSlot{ nullptr, { node } });
+    }
 }
 
 namespace Terrain
@@ -279,7 +353,7 @@ namespace Terrain
         , mLodFactor(lodFactor)
         , mVertexLodMod(vertexLodMod)
         , mViewDistance(std::numeric_limits<float>::max())
-        , mMinSize(1 / 8.f)
+        , mMinSize(minQuadTreeNodeSize)
         , mDebugTerrainChunks(debugChunks)
     {
         mChunkManager->setCompositeMapSize(compMapResolution);
@@ -301,14 +375,18 @@ namespace Terrain
     /// data set, NOT relative to mMinSize as is the case with node LODs.
     unsigned int getVertexLod(QuadTreeNode* node, int vertexLodMod)
     {
-        unsigned int vertexLod = DefaultLodCallback::getNativeLodLevel(node, 1);
+        return getVertexLod(node->getSize(), vertexLodMod);
+    }
+
+    unsigned int getVertexLod(float size, int vertexLodMod)
+    {
+        unsigned int vertexLod = Log2(static_cast<unsigned int>(size));
         if (vertexLodMod > 0)
         {
             vertexLod = static_cast<unsigned int>(std::max(0, static_cast<int>(vertexLod) - vertexLodMod));
         }
         else if (vertexLodMod < 0)
         {
-            float size = node->getSize();
             // Stop to simplify at this level since with size = 1 the node already covers the whole cell and has
             // getCellVertices() vertices.
             while (size < 1)
@@ -462,12 +540,14 @@ namespace Terrain
         osg::Object* viewer = isCullVisitor ? static_cast<osgUtil::CullVisitor*>(&nv)->getCurrentCamera() : nullptr;
         bool needsUpdate = true;
         osg::Vec3f viewPoint = viewer ? nv.getViewPoint() : nv.getEyePoint();
-        ViewData* vd = mViewDataMap->getViewData(viewer, viewPoint, mActiveGrid, needsUpdate);
+        std::unique_lock<std::mutex> viewLock;
+        ViewData* vd = mViewDataMap->getViewData(viewer, viewPoint, mActiveGrid, needsUpdate, viewLock);
         if (needsUpdate)
         {
+            const unsigned int previousNumEntries = vd->getNumEntries();
             vd->reset();
             DefaultLodCallback lodCallback(mLodFactor, mMinSize, mViewDistance, mActiveGrid);
-            mRootNode->traverseNodes(vd, viewPoint, &lodCallback);
+            traverseNodes(vd, viewPoint, lodCallback, previousNumEntries);
         }
 
         const float cellWorldSize = mStorage->getCellWorldSize();
@@ -489,10 +569,59 @@ namespace Terrain
         if (referenceTime != 0.0)
         {
             vd->setLastUsageTimeStamp(referenceTime);
+            viewLock.unlock();
             mViewDataMap->clearUnusedViews(referenceTime);
         }
     }
 
+    void QuadTreeWorld::traverseNodes(
+        ViewData* vd, const osg::Vec3f& viewPoint, LodCallback& lodCallback, unsigned int previousNumEntries)
+    {
+        if (!mTraversalWorkQueue || previousNumEntries < minEntriesForParallelTraversal)
+        {
+            mRootNode->traverseNodes(vd, viewPoint, &lodCallback);
+            return;
+        }
+
+        std::vector<TraversalSlot> slots;
+        splitTraversal(mRootNode, 0, viewPoint, lodCallback, slots);
+
+        const std::size_t numSubtrees = std::count_if(
+            slots.begin(), slots.end(), [](const TraversalSlot& slot) { return slot.mRoot != nullptr; });
+        std::vector<osg::ref_ptr<TraversalWorkItem>> items(
+            std::min(numSubtrees, mTraversalWorkQueue->getNumThreads() + 1));
+        for (osg::ref_ptr<TraversalWorkItem>& item : items)
+            item = new TraversalWorkItem(viewPoint, lodCallback);
+
+        std::size_t next = 0;
+        for (TraversalSlot& slot : slots)
+            if (slot.mRoot != nullptr)
+                items[next++ % items.size()]->addSlot(slot);
+
+        for (std::size_t i = 1; i < items.size(); ++i)
+            mTraversalWorkQueue->addWorkItem(items[i]);
+
+        // Items no worker has picked up yet are done on this thread, so culling never waits for unrelated work.
+        for (const osg::ref_ptr<TraversalWorkItem>& item : items)
+        {
+            if (item->claim())
+                item->run();
+            else
+                item->waitTillDone();
+        }
+
+        for (const TraversalSlot& slot : slots)
+            for (QuadTreeNode* node : slot.mSelected)
+                vd->add(node);
+    }
+
+    void QuadTreeWorld::setTraversalThreads(unsigned int numThreads)
+    {
+        if (mTraversalWorkQueue)
+            mTraversalWorkQueue->stop();
+        mTraversalWorkQueue = numThreads > 0 ? new SceneUtil::WorkQueue(numThreads) : nullptr;
+    }
+
     void QuadTreeWorld::ensureQuadTreeBuilt()
     {
         std::lock_guard<std::mutex> lock(mQuadTreeMutex);
@@ -572,7 +701,15 @@ namespace Terrain
     void QuadTreeWorld::reportStats(unsigned int frameNumber, osg::Stats* stats)
     {
         if (mCompositeMapRenderer)
+        {
             stats->setAttribute(frameNumber, "Composite", mCompositeMapRenderer->getCompileSetSize());
+            stats->setAttribute(frameNumber, "Composite Pending", mCompositeMapRenderer->getPrepareSetSize());
+            double prepareTime = 0;
+            double compileTime = 0;
+            mCompositeMapRenderer->takeTimeSpent(prepareTime, compileTime);
+            stats->setAttribute(frameNumber, "Composite Prepare us", prepareTime * 1e6);
+            stats->setAttribute(frameNumber, "Composite Compile us", compileTime * 1e6);
+        }
     }
 
     void QuadTreeWorld::loadCell(int x, int y)
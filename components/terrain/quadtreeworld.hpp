@@ -14,8 +14,14 @@ namespace osg
     class Stats;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Terrain
 {
+    class LodCallback;
     class RootNode;
     class ViewDataMap;
     class ViewData;
@@ -23,6 +29,13 @@ namespace Terrain
 
     class DebugChunkManager;
 
+    /// get the level of vertex detail to render a quad tree node of the given size (in cell units) at, expressed
+    /// relative to the native resolution of the vertex data set.
+    unsigned int getVertexLod(float size, int vertexLodMod);
+
+    /// Size of the smallest quad tree node in cell units.
+    constexpr float minQuadTreeNodeSize = 1 / 8.f;
+
     /// @brief Terrain implementation that loads cells into a Quad Tree, with geometry LOD and texture LOD.
     class QuadTreeWorld
         : public TerrainGrid // note: derived from TerrainGrid is only to render default cells (see loadCell)
@@ -54,6 +67,10 @@ namespace Terrain
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats) override;
 
+        /// Select the nodes of views with many nodes on the given number of worker threads in addition to the
+        /// culling thread, 0 to select them on the culling thread only.
+        void setTraversalThreads(unsigned int numThreads);
+
         class ChunkManager
         {
         public:
@@ -80,6 +97,8 @@ namespace Terrain
         void ensureQuadTreeBuilt();
         void loadRenderingNode(
             ViewDataEntry& entry, ViewData* vd, float cellWorldSize, const osg::Vec4i& gridbounds, bool compile);
+        void traverseNodes(ViewData* vd, const osg::Vec3f& viewPoint, LodCallback& lodCallback,
+            unsigned int previousNumEntries);
 
         osg::ref_ptr<RootNode> mRootNode;
 
@@ -95,6 +114,7 @@ namespace Terrain
         float mMinSize;
         bool mDebugTerrainChunks;
         std::unique_ptr<DebugChunkManager> mDebugChunkManager;
+        osg::ref_ptr<SceneUtil::WorkQueue> mTraversalWorkQueue;
     };
 
 }
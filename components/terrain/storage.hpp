@@ -69,7 +69,8 @@ namespace Terrain
         /// @note May be called from background threads. Make sure to only call thread-safe functions from here!
         /// @param chunkSize size of the terrain chunk in cell units
         /// @param chunkCenter center of the chunk in cell units
-        /// @param blendmaps created blendmaps will be written here
+        /// @param blendmaps created blendmaps will be written here, RGBA images holding blend values of 4 layers each:
+        ///        layer i is stored in the channel i % 4 of the image i / 4. Empty when there is only one layer.
         /// @param layerList names of the layer textures used will be written here
         virtual void getBlendmaps(
             float chunkSize, const osg::Vec2f& chunkCenter, ImageVector& blendmaps, std::vector<LayerInfo>& layerList)
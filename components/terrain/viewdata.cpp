@@ -3,6 +3,7 @@
 #include "quadtreenode.hpp"
 
 #include <algorithm>
+#include <limits>
 
 namespace Terrain
 {
@@ -126,28 +127,42 @@ namespace Terrain
         }
     }
 
-    ViewData* ViewDataMap::getViewData(
-        osg::Object* viewer, const osg::Vec3f& viewPoint, const osg::Vec4i& activeGrid, bool& needsUpdate)
+    ViewData* ViewDataMap::getViewData(osg::Object* viewer, const osg::Vec3f& viewPoint, const osg::Vec4i& activeGrid,
+        bool& needsUpdate, std::unique_lock<std::mutex>& lock)
     {
-        ViewerMap::const_iterator found = mViewers.find(viewer);
+        const std::lock_guard mapLock(mMutex);
+
+        ViewerMap::const_iterator found = std::find_if(mViewers.begin(), mViewers.end(),
+            [&](const ViewerMap::value_type& pair) { return pair.first == viewer; });
         ViewData* vd = nullptr;
         if (found == mViewers.end())
         {
-            vd = createOrReuseView();
-            mViewers[viewer] = vd;
+            vd = createOrReuseViewImpl();
+            mViewers.emplace_back(viewer, vd);
         }
         else
             vd = found->second;
         needsUpdate = false;
 
+        // The view is only used by the thread culling its viewer. Other views may be in use by other threads, they
+        // are skipped rather than waited for, which also rules out lock order inversions.
+        lock = std::unique_lock(vd->getMutex());
+
         if (!(vd->suitableToUse(activeGrid)
                 && (vd->getViewPoint() - viewPoint).length2() < mReuseDistance * mReuseDistance
                 && vd->getWorldUpdateRevision() >= mWorldUpdateRevision))
         {
             float shortestDist = viewer ? mReuseDistance * mReuseDistance : std::numeric_limits<float>::max();
-            const ViewData* mostSuitableView = nullptr;
-            for (const ViewData* other : mUsedViews)
+            ViewData* mostSuitableView = nullptr;
+            for (ViewData* other : mUsedViews)
             {
+                std::unique_lock<std::mutex> otherLock;
+                if (other != vd)
+                {
+                    otherLock = std::unique_lock(other->getMutex(), std::try_to_lock);
+                    if (!otherLock.owns_lock())
+                        continue;
+                }
                 if (other->suitableToUse(activeGrid) && other->getWorldUpdateRevision() >= mWorldUpdateRevision)
                 {
                     float dist = (viewPoint - other->getViewPoint()).length2();
@@ -160,10 +175,15 @@ namespace Terrain
             }
             if (mostSuitableView && mostSuitableView != vd)
             {
-                vd->copyFrom(*mostSuitableView);
-                return vd;
+                const std::unique_lock otherLock(mostSuitableView->getMutex(), std::try_to_lock);
+                if (otherLock.owns_lock())
+                {
+                    vd->copyFrom(*mostSuitableView);
+                    return vd;
+                }
+                mostSuitableView = nullptr;
             }
-            else if (!mostSuitableView)
+            if (!mostSuitableView)
             {
                 if (vd->getWorldUpdateRevision() != mWorldUpdateRevision)
                 {
@@ -179,12 +199,18 @@ namespace Terrain
     }
 
     ViewData* ViewDataMap::createOrReuseView()
+    {
+        const std::lock_guard lock(mMutex);
+        return createOrReuseViewImpl();
+    }
+
+    ViewData* ViewDataMap::createOrReuseViewImpl()
     {
         ViewData* vd = nullptr;
         if (mUnusedViews.size())
         {
-            vd = mUnusedViews.front();
-            mUnusedViews.pop_front();
+            vd = mUnusedViews.back();
+            mUnusedViews.pop_back();
         }
         else
         {
@@ -205,28 +231,43 @@ namespace Terrain
 
     void ViewDataMap::clearUnusedViews(double referenceTime)
     {
-        for (ViewerMap::iterator it = mViewers.begin(); it != mViewers.end();)
-        {
-            if (it->second->getLastUsageTimeStamp() + mExpiryDelay < referenceTime)
-                mViewers.erase(it++);
-            else
-                ++it;
-        }
-        for (std::deque<ViewData*>::iterator it = mUsedViews.begin(); it != mUsedViews.end();)
+        const std::lock_guard lock(mMutex);
+
+        // Every view of a frame calls this with the same time
+        if (referenceTime == mLastClearTime)
+            return;
+        mLastClearTime = referenceTime;
+
+        const std::size_t numUnusedViews = mUnusedViews.size();
+        for (std::size_t i = 0; i < mUsedViews.size();)
         {
-            if ((*it)->getLastUsageTimeStamp() + mExpiryDelay < referenceTime)
+            ViewData* vd = mUsedViews[i];
+            // Views locked by another thread are in use
+            const std::unique_lock viewLock(vd->getMutex(), std::try_to_lock);
+            if (viewLock.owns_lock() && vd->getLastUsageTimeStamp() + mExpiryDelay < referenceTime)
             {
-                (*it)->clear();
-                mUnusedViews.push_back(*it);
-                it = mUsedViews.erase(it);
+                vd->clear();
+                mUnusedViews.push_back(vd);
+                mUsedViews[i] = mUsedViews.back();
+                mUsedViews.pop_back();
             }
             else
-                ++it;
+                ++i;
         }
+
+        if (numUnusedViews == mUnusedViews.size())
+            return;
+
+        const auto isExpired = [&](const ViewerMap::value_type& pair) {
+            return std::find(mUnusedViews.begin() + numUnusedViews, mUnusedViews.end(), pair.second)
+                != mUnusedViews.end();
+        };
+        mViewers.erase(std::remove_if(mViewers.begin(), mViewers.end(), isExpired), mViewers.end());
     }
 
     void ViewDataMap::rebuildViews()
     {
+        const std::lock_guard lock(mMutex);
         ++mWorldUpdateRevision;
     }
 
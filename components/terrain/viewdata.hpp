@@ -1,7 +1,9 @@
 #ifndef OPENMW_COMPONENTS_TERRAIN_VIEWDATA_H
 #define OPENMW_COMPONENTS_TERRAIN_VIEWDATA_H
 
-#include <deque>
+#include <list>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include <osg/Node>
@@ -79,7 +81,11 @@ namespace Terrain
 
         void removeNodeFromIndex(const QuadTreeNode* node);
 
+        /// Guards the view while it is updated or traversed, as views of different cameras may be culled in parallel.
+        std::mutex& getMutex() { return mMutex; }
+
     private:
+        std::mutex mMutex;
         std::vector<ViewDataEntry> mEntries;
         std::vector<const QuadTreeNode*> mNodes;
         unsigned int mNumEntries;
@@ -105,8 +111,10 @@ namespace Terrain
         {
         }
 
-        ViewData* getViewData(
-            osg::Object* viewer, const osg::Vec3f& viewPoint, const osg::Vec4i& activeGrid, bool& needsUpdate);
+        /// @param lock Receives the lock of the returned view's mutex, to hold for as long as the view is used.
+        /// @note Does not allocate once the views of all viewers were created.
+        ViewData* getViewData(osg::Object* viewer, const osg::Vec3f& viewPoint, const osg::Vec4i& activeGrid,
+            bool& needsUpdate, std::unique_lock<std::mutex>& lock);
 
         ViewData* createOrReuseView();
         ViewData* createIndependentView() const;
@@ -117,9 +125,12 @@ namespace Terrain
         float getReuseDistance() const { return mReuseDistance; }
 
     private:
+        std::mutex mMutex;
+
         std::list<ViewData> mViewVector;
 
-        typedef std::map<osg::ref_ptr<osg::Object>, ViewData*> ViewerMap;
+        // There are only a handful of viewers, a linear search is faster than a tree and does not allocate.
+        typedef std::vector<std::pair<osg::ref_ptr<osg::Object>, ViewData*>> ViewerMap;
         ViewerMap mViewers;
 
         float mReuseDistance;
@@ -127,8 +138,12 @@ namespace Terrain
 
         unsigned int mWorldUpdateRevision;
 
-        std::deque<ViewData*> mUsedViews;
-        std::deque<ViewData*> mUnusedViews;
+        double mLastClearTime = 0.0;
+
+        std::vector<ViewData*> mUsedViews;
+        std::vector<ViewData*> mUnusedViews;
+
+        ViewData* createOrReuseViewImpl();
     };
 
 }
@@ -6,6 +6,7 @@
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/scenemanager.hpp>
 
+#include "chunkdiskcache.hpp"
 #include "chunkmanager.hpp"
 #include "compositemaprenderer.hpp"
 #include "heightcull.hpp"
@@ -122,6 +123,19 @@ namespace Terrain
         mCompositeMapRenderer->setTargetFrameRate(rate);
     }
 
+    void World::setWorkQueue(SceneUtil::WorkQueue* workQueue)
+    {
+        if (mCompositeMapRenderer)
+            mCompositeMapRenderer->setWorkQueue(workQueue);
+    }
+
+    void World::setChunkDiskCache(std::unique_ptr<ChunkDiskCache> cache)
+    {
+        mChunkDiskCache = std::move(cache);
+        if (mChunkManager)
+            mChunkManager->setDiskCache(mChunkDiskCache.get());
+    }
+
     float World::getHeightAt(const osg::Vec3f& worldPos)
     {
         return mStorage->getHeightAt(worldPos);
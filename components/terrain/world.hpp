@@ -26,12 +26,18 @@ namespace Loading
     class Reporter;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Terrain
 {
     class Storage;
 
     class TextureManager;
     class ChunkManager;
+    class ChunkDiskCache;
     class CompositeMapRenderer;
     class View;
     class HeightCullCallback;
@@ -55,6 +61,13 @@ namespace Terrain
         /// See CompositeMapRenderer::setTargetFrameRate
         void setTargetFrameRate(float rate);
 
+        /// See CompositeMapRenderer::setWorkQueue
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
+        /// Load chunk vertex data from a persistent cache and store newly generated data to it.
+        /// The cache is flushed when the world is destroyed.
+        void setChunkDiskCache(std::unique_ptr<ChunkDiskCache> cache);
+
         /// Apply the scene manager's texture filtering settings to all cached textures.
         /// @note Thread safe.
         void updateTextureFiltering();
@@ -117,6 +130,8 @@ namespace Terrain
         Resource::ResourceSystem* mResourceSystem;
 
         std::unique_ptr<TextureManager> mTextureManager;
+        // Declared before the chunk manager using it, so that it is destroyed (and flushed) after it
+        std::unique_ptr<ChunkDiskCache> mChunkDiskCache;
         std::unique_ptr<ChunkManager> mChunkManager;
 
         std::unique_ptr<CellBorder> mCellBorder;
@@ -18,6 +18,7 @@ uniform sampler2D normalMap;
 
 #if @blendMap
 uniform sampler2D blendMap;
+uniform vec4 blendMapChannel;
 #endif
 
 varying float euclideanDepth;
@@ -78,7 +79,7 @@ void main()
 
 #if @blendMap
     vec2 blendMapUV = (gl_TextureMatrix[1] * vec4(uv, 0.0, 1.0)).xy;
-    gl_FragData[0].a *= texture2D(blendMap, blendMapUV).a;
+    gl_FragData[0].a *= dot(texture2D(blendMap, blendMapUV), blendMapChannel);
 #endif
 
     vec4 diffuseColor = getDiffuseColor();